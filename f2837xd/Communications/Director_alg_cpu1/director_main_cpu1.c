@@ -3,7 +3,18 @@
 #include "device.h"
 #include "inc/hw_ipc.h"
 
+#include "system.h"
+#include "CoreLink.h"
+#include "Trace.h"
+#include "signals.h"
+
 void configGPIOs(void);
+static void controlStep(uint16_t worker, volatile const uint16_t *measurement, uint16_t *setpoint);
+#if BROADCAST_CHUNK > 0
+static void sharedStep(uint16_t *broadcast);
+#endif
+
+__interrupt void coreLinkISR(void);
 
 
 void main(void)
@@ -34,6 +45,7 @@ void main(void)
     // Configure CPU2 to control the LED GPIO
     GPIO_setMasterCore(DEVICE_GPIO_PIN_LED2, GPIO_CORE_CPU2);
 
+    // SYSTEM_LSPCLK_DIV (system.h), the comms core sets up its SPI and SCI for it
     SysCtl_setLowSpeedClock(SYSCTL_LSPCLK_PRESCALE_14);
 
 
@@ -42,10 +54,14 @@ void main(void)
     // Hand-over the SPI modules access to CPU2
     SysCtl_selectCPUForPeripheral(SYSCTL_CPUSEL6_SPI, 1, SYSCTL_CPUSEL_CPU2);// Hand-over SPI A
     SysCtl_selectCPUForPeripheral(SYSCTL_CPUSEL6_SPI, 2, SYSCTL_CPUSEL_CPU2);// Hand-over SPI B
+    SysCtl_selectCPUForPeripheral(SYSCTL_CPUSEL5_SCI, 1, SYSCTL_CPUSEL_CPU2);// Hand-over SCI A (telemetry)
 
 
     MemCfg_setGSRAMMasterSel(MEMCFG_SECT_GS0 | MEMCFG_SECT_GS1 , MEMCFG_GSRAMCONTROLLER_CPU2);
 
+    // GS2 stays with CPU1: CoreLink publish slots, read by the CPU2 DMA
+    MemCfg_setGSRAMMasterSel(MEMCFG_SECT_GS2, MEMCFG_GSRAMCONTROLLER_CPU1);
+
     // Sync CPU1 and CPU2. Send IPC flag 31 to CPU2.
     HWREG(IPC_BASE + IPC_O_SET) = IPC_ACK_IPC31;
 
@@ -56,6 +72,13 @@ void main(void)
     // Service Routines (ISR).
     Interrupt_initVectorTable();
 
+    Trace_Init(TRACE_NODE_DIRECTOR, 1);
+
+    // Frames handed over by CPU2
+    CoreLink_InitConsumer();
+    Interrupt_register(INT_IPC_0, &coreLinkISR);
+    Interrupt_enable(INT_IPC_0);
+
     // Enable Global Interrupt (INTM) and realtime interrupt (DBGM)
     EINT;
     ERTM;
@@ -138,6 +161,70 @@ void configGPIOs(void)
     GPIO_setPinConfig(GPIO_65_SPICLKB);
     GPIO_setPadConfig(65, GPIO_PIN_TYPE_PULLUP);
     GPIO_setQualificationMode(65, GPIO_QUAL_ASYNC);
+
+    // Initialize GPIOs used by SCIA, telemetry to the host through the USB-to-UART bridge of the probe.
+
+    // SCIRXDA
+    GPIO_setMasterCore(DEVICE_GPIO_PIN_SCIRXDA, GPIO_CORE_CPU2);
+    GPIO_setPinConfig(DEVICE_GPIO_CFG_SCIRXDA);
+    GPIO_setPadConfig(DEVICE_GPIO_PIN_SCIRXDA, GPIO_PIN_TYPE_STD);
+    GPIO_setQualificationMode(DEVICE_GPIO_PIN_SCIRXDA, GPIO_QUAL_ASYNC);
+
+    // SCITXDA
+    GPIO_setMasterCore(DEVICE_GPIO_PIN_SCITXDA, GPIO_CORE_CPU2);
+    GPIO_setPinConfig(DEVICE_GPIO_CFG_SCITXDA);
+    GPIO_setPadConfig(DEVICE_GPIO_PIN_SCITXDA, GPIO_PIN_TYPE_STD);
+    GPIO_setQualificationMode(DEVICE_GPIO_PIN_SCITXDA, GPIO_QUAL_ASYNC);
+}
+
+// Placeholder control law, measurement is NULL if the worker's frame failed its CRC
+static void controlStep(uint16_t worker, volatile const uint16_t *measurement, uint16_t *setpoint)
+{
+    // Placeholder references, distinct per worker
+    Setpoint_Set_reset_faults(setpoint, false);
+    Setpoint_Write_i_d_ref(setpoint, 10.0f * (worker + 1));
+    Setpoint_Write_i_q_ref(setpoint, 0.0f);
+    Setpoint_Write_p_ref(setpoint, 0.0f);
+}
+
+#if BROADCAST_CHUNK > 0
+// Placeholder references common to all workers, sent once in the broadcast chunk
+static void sharedStep(uint16_t *broadcast)
+{
+    Broadcast_Set_enable(broadcast, true);
+    Broadcast_Set_mode(broadcast, 1);
+    Broadcast_Write_v_dc_ref(broadcast, 700.0f);
+}
+#endif
+
+// Ring image ready on CPU2. Measurements are read in place in GS1, the setpoint payloads are written to a
+// publish slot and moved into the ring by CPU2 before the next launch.
+__interrupt void coreLinkISR(void)
+{
+    volatile CoreLinkDown_t *image = CoreLink_Acquire();
+
+    if (image != NULL) {
+        uint16_t *slot = CoreLink_PublishBuffer();
+        uint16_t token = image->Token;
+        uint16_t worker;
+
+        Trace_Event(TRACE_EV_ACQUIRE, token, image->MeasurementsValid);
+        for (worker = 0; worker < NUM_WORKERS; worker++) {
+            bool fresh = (image->MeasurementsValid >> worker) & 1U;
+            controlStep(worker, fresh ? image->Measurements[worker]->data : NULL, CORELINK_PUBLISH_SETPOINT(slot, worker));
+        }
+#if BROADCAST_CHUNK > 0
+        sharedStep(CORELINK_PUBLISH_BROADCAST(slot));
+#endif
+
+        // Only results computed from an image that was not overwritten meanwhile are published
+        if (CoreLink_Release()) {
+            CoreLink_Publish(token);
+            Trace_Event(TRACE_EV_PUBLISH, token, 0);
+        }
+    }
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
 }
 
 // End of File
@@ -43,7 +43,8 @@ PAGE 1 :
 
    RAMGS0      : origin = 0x00C000, length = 0x001000
    RAMGS1      : origin = 0x00D000, length = 0x001000
-   RAMGS2      : origin = 0x00E000, length = 0x001000
+   CORELINK_PUB : origin = 0x00E000, length = 0x000400     /* CoreLink publish slots, owned by CPU1 */
+   RAMGS2      : origin = 0x00E400, length = 0x000C00
    RAMGS3      : origin = 0x00F000, length = 0x001000
    RAMGS4      : origin = 0x010000, length = 0x001000
    RAMGS5      : origin = 0x011000, length = 0x001000
@@ -66,8 +67,10 @@ PAGE 1 :
 //   RAMGS15_RSVD : origin = 0x01BFF8, length = 0x000008    /* Reserve and do not use for code as per the errata advisory "Memory: Prefetching Beyond Valid Memory" */
                                                             /* Only on F28379D, F28377D, F28375D devices. Remove line on other devices. */
 
-   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000400
-   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000400
+   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000380
+   CORELINK_DOWN   : origin = 0x03FB80, length = 0x000080     /* CoreLink descriptor, written by CPU2 */
+   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000380
+   CORELINK_UP     : origin = 0x03FF80, length = 0x000080     /* CoreLink status, written by CPU1 */
 
    CANA_MSG_RAM     : origin = 0x049000, length = 0x000800
    CANB_MSG_RAM     : origin = 0x04B000, length = 0x000800
@@ -111,6 +114,11 @@ SECTIONS
    #endif
 #endif
 
+   /* CoreLink data plane, see ring/CoreLink.h. CPU1 allocates what it writes, the rest is mapped only */
+   CoreLinkDown     : > CORELINK_DOWN,  PAGE = 1, TYPE = DSECT
+   CoreLinkUp       : > CORELINK_UP,    PAGE = 1
+   CoreLinkPublish  : > CORELINK_PUB,   PAGE = 1
+
    /* The following section definitions are required when using the IPC API Drivers */
     GROUP : > CPU1TOCPU2RAM, PAGE = 1
     {
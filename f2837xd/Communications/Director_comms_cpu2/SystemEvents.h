@@ -34,6 +34,11 @@ extern "C" {
 
 void InnerLoop_Handler(void * args);
 
+void MailboxService_Handler(void * args);
+
+void LatencyExport_Handler(void * args);
+void TelemetryService_Handler(void * args);
+
 
 
 #ifdef __cplusplus
@@ -0,0 +1,232 @@
+/**
+ ********************************************************************************
+ * @file    Telemetry.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "device.h"
+#include "Telemetry.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define QUEUE_MASK      (TELEMETRY_BUFFER_WORDS - 1U)
+#define ALL_WORKERS     ((uint16_t)((1UL << NUM_WORKERS) - 1U))
+#define ALL_WORDS       ((uint16_t)((1UL << MEASUREMENT_WORDS) - 1U))
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// Selections are 16 bit masks, and a frame with everything selected must fit in the queue
+typedef char telemetrySelectionCheck[(NUM_WORKERS <= 16 && MEASUREMENT_WORDS <= 16) ? 1 : -1];
+typedef char telemetryQueueCheck[((TELEMETRY_BUFFER_WORDS & QUEUE_MASK) == 0 &&
+                                  TELEMETRY_MAX_WORDS < TELEMETRY_BUFFER_WORDS) ? 1 : -1];
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+static uint16_t bitCount(uint16_t Mask)
+{
+    uint16_t n = 0;
+
+    while (Mask) {
+        Mask &= Mask - 1U;
+        n++;
+    }
+    return n;
+}
+
+// Moves whole words from the queue into the TX FIFO, as long as there is room for both bytes
+static void fill(Telemetry_t *Telemetry)
+{
+    uint16_t tail = Telemetry->Tail;
+
+    while (tail != Telemetry->Head && SCI_getTxFIFOStatus(TELEMETRY_SCI_BASE) <= SCI_FIFO_TX14) {
+        uint16_t word = Telemetry->Queue[tail];
+        SCI_writeCharNonBlocking(TELEMETRY_SCI_BASE, word & 0xFFU);
+        SCI_writeCharNonBlocking(TELEMETRY_SCI_BASE, word >> 8);
+        tail = (tail + 1U) & QUEUE_MASK;
+    }
+    Telemetry->Tail = tail;
+}
+
+static void command(Telemetry_t *Telemetry)
+{
+    uint16_t *words = Telemetry->Command;
+
+    if (crcFast(words + 1, TELEMETRY_COMMAND_WORDS - 2) != words[TELEMETRY_COMMAND_WORDS - 1] ||
+        !Telemetry_Select(Telemetry, words[1], words[2], words[3])) {
+        Telemetry->CommandErrors++;
+        return;
+    }
+    Telemetry->Commands++;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void Telemetry_Init(Telemetry_t *Telemetry)
+{
+    Telemetry->Head = 0;
+    Telemetry->Tail = 0;
+    Telemetry->Decimation = 0;
+    Telemetry->Workers = 0;
+    Telemetry->Words = 0;
+    Telemetry->Countdown = 0;
+    Telemetry->Seq = 0;
+    Telemetry->CommandBytes = 0;
+    Telemetry->Frames = 0;
+    Telemetry->Dropped = 0;
+    Telemetry->Commands = 0;
+    Telemetry->CommandErrors = 0;
+    Telemetry->RxErrors = 0;
+
+    SCI_performSoftwareReset(TELEMETRY_SCI_BASE);
+    SCI_setConfig(TELEMETRY_SCI_BASE, SYSTEM_LSPCLK_FREQ, TELEMETRY_BAUD,
+                  SCI_CONFIG_WLEN_8 | SCI_CONFIG_STOP_ONE | SCI_CONFIG_PAR_NONE);
+    SCI_resetChannels(TELEMETRY_SCI_BASE);
+    SCI_enableFIFO(TELEMETRY_SCI_BASE);
+    SCI_resetTxFIFO(TELEMETRY_SCI_BASE);
+    SCI_resetRxFIFO(TELEMETRY_SCI_BASE);
+
+    // Refilled with 7 words whenever 2 bytes are left, the line never idles while frames are queued
+    SCI_setFIFOInterruptLevel(TELEMETRY_SCI_BASE, SCI_FIFO_TX2, SCI_FIFO_RX16);
+    SCI_disableInterrupt(TELEMETRY_SCI_BASE, SCI_INT_TXFF | SCI_INT_RXFF | SCI_INT_RXERR);
+    SCI_clearInterruptStatus(TELEMETRY_SCI_BASE, SCI_INT_TXFF | SCI_INT_RXFF);
+    SCI_enableModule(TELEMETRY_SCI_BASE);
+}
+
+bool Telemetry_Select(Telemetry_t *Telemetry, uint16_t Decimation, uint16_t Workers, uint16_t Words)
+{
+    if ((Workers & ~ALL_WORKERS) || (Words & ~ALL_WORDS)) return false;
+
+    uint16_t status = __disable_interrupts();
+    Telemetry->Decimation = Decimation;
+    Telemetry->Workers = Workers;
+    Telemetry->Words = Words;
+    Telemetry->Countdown = 1;
+    __restore_interrupts(status);
+    return true;
+}
+
+void Telemetry_Capture(Telemetry_t *Telemetry, uint16_t Token, uint32_t Time, uint16_t Valid,
+                       volatile Frame *const Measurements[])
+{
+    if (Telemetry->Decimation == 0 || --Telemetry->Countdown != 0) return;
+    Telemetry->Countdown = Telemetry->Decimation;
+
+    uint16_t workers = Telemetry->Workers;
+    uint16_t words = Telemetry->Words;
+    uint16_t length = TELEMETRY_HEADER_WORDS + bitCount(workers) * bitCount(words) + 1U;
+    uint16_t seq = Telemetry->Seq++;
+
+    // Dropped whole, the host sees the gap in the sequence numbers
+    uint16_t head = Telemetry->Head;
+    if (length > ((Telemetry->Tail - head - 1U) & QUEUE_MASK)) {
+        Telemetry->Dropped++;
+        return;
+    }
+
+    uint16_t *frame = Telemetry->Frame;
+    uint16_t n = 0;
+    uint16_t w, i;
+
+    frame[n++] = TELEMETRY_SYNC;
+    frame[n++] = seq;
+    frame[n++] = Token;
+    frame[n++] = (uint16_t)Time;
+    frame[n++] = (uint16_t)(Time >> 16);
+    frame[n++] = Valid;
+    frame[n++] = workers;
+    frame[n++] = words;
+    for (w = 0; w < NUM_WORKERS; w++) {
+        if (!(workers & (1U << w))) continue;
+        volatile const uint16_t *data = Measurements[w]->data;
+        for (i = 0; i < MEASUREMENT_WORDS; i++) {
+            if (words & (1U << i)) frame[n++] = data[i];
+        }
+    }
+    frame[n] = crcFast(frame + 1, n - 1);
+    n++;
+
+    for (i = 0; i < n; i++) {
+        Telemetry->Queue[(head + i) & QUEUE_MASK] = frame[i];
+    }
+    bool idle = (Telemetry->Tail == head);
+    Telemetry->Head = (head + n) & QUEUE_MASK;
+    Telemetry->Frames++;
+
+    // The TX interrupt is only enabled while words are queued, an idle line is started from here
+    if (idle) {
+        fill(Telemetry);
+        SCI_enableInterrupt(TELEMETRY_SCI_BASE, SCI_INT_TXFF);
+    }
+}
+
+void Telemetry_Transmit(Telemetry_t *Telemetry)
+{
+    fill(Telemetry);
+    if (Telemetry->Tail == Telemetry->Head) {
+        SCI_disableInterrupt(TELEMETRY_SCI_BASE, SCI_INT_TXFF);
+    }
+    SCI_clearInterruptStatus(TELEMETRY_SCI_BASE, SCI_INT_TXFF);
+}
+
+void Telemetry_Service(Telemetry_t *Telemetry)
+{
+    if ((SCI_getRxStatus(TELEMETRY_SCI_BASE) & SCI_RXSTATUS_ERROR) || SCI_getOverflowStatus(TELEMETRY_SCI_BASE)) {
+        Telemetry->RxErrors++;
+        Telemetry->CommandBytes = 0;
+        SCI_performSoftwareReset(TELEMETRY_SCI_BASE);
+        SCI_clearOverflowStatus(TELEMETRY_SCI_BASE);
+        SCI_resetRxFIFO(TELEMETRY_SCI_BASE);
+        return;
+    }
+
+    while (SCI_getRxFIFOStatus(TELEMETRY_SCI_BASE) != SCI_FIFO_RX0) {
+        uint16_t byte = SCI_readCharNonBlocking(TELEMETRY_SCI_BASE) & 0xFFU;
+        uint16_t at = Telemetry->CommandBytes;
+
+        // Hunting for the sync word, a 0xA5 that breaks it may start the next one
+        if (at == 0 && byte != (TELEMETRY_SYNC & 0xFFU)) continue;
+        if (at == 1 && byte != (TELEMETRY_SYNC >> 8)) {
+            Telemetry->CommandBytes = (byte == (TELEMETRY_SYNC & 0xFFU)) ? 1 : 0;
+            continue;
+        }
+
+        if (at & 1U) {
+            Telemetry->Command[at >> 1] |= byte << 8;
+        } else {
+            Telemetry->Command[at >> 1] = byte;
+        }
+        if (++Telemetry->CommandBytes == 2 * TELEMETRY_COMMAND_WORDS) {
+            Telemetry->CommandBytes = 0;
+            command(Telemetry);
+        }
+    }
+}
+
+/*** end of file ***/
@@ -0,0 +1,137 @@
+/**
+ ********************************************************************************
+ * @file    Telemetry.h
+ * @brief   Streaming of selected measurement words to the host over SCI A.
+ *
+ *          Every TELEMETRY decimation-th frame, the ring interrupt copies the selected
+ *          words of the measurements into a telemetry frame and queues it; the SCI TX
+ *          FIFO interrupt shifts the queue out, low byte of each word first:
+ *
+ *            [sync][seq][token][launch time (2)][valid][workers][words][data][crc]
+ *
+ *          Data holds, for each worker of the workers mask in ascending order, the
+ *          measurement payload words of the words mask. The CRC (crc.c) covers every
+ *          word after the sync word. The masks travel in each frame, so the host decodes
+ *          the stream without knowing the selection. A frame that does not fit in the
+ *          queue is dropped whole and leaves a gap in the sequence numbers.
+ *
+ *          The host changes the selection with a command, in the same framing:
+ *
+ *            [sync][decimation][workers][words][crc]
+ *
+ *          A decimation of 0 stops the stream. See tools/telemetry.py.
+ *
+ *          The DMA has no access to the SCI on this device, hence the FIFO interrupt.
+ ********************************************************************************
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TELEMETRY_SCI_BASE      SCIA_BASE
+#define TELEMETRY_SCI_TX_INT    INT_SCIA_TX
+#define TELEMETRY_BAUD          892857U     /*!< SYSTEM_LSPCLK_FREQ / 16, the fastest rate of the SCI, 89 kB/s */
+
+#define TELEMETRY_SYNC          0x5AA5U     /*!< Sent as 0xA5, 0x5A */
+#define TELEMETRY_HEADER_WORDS  8U
+#define TELEMETRY_MAX_WORDS     (TELEMETRY_HEADER_WORDS + NUM_WORKERS * MEASUREMENT_WORDS + 1U)
+#define TELEMETRY_COMMAND_WORDS 5U
+#define TELEMETRY_BUFFER_WORDS  256U        /*!< Queue length, power of 2 */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Telemetry stream.
+ *
+ * The queue is written by the ring interrupt and read by the SCI TX interrupt; the selection is changed
+ * from the background loop.
+ */
+typedef struct {
+    volatile uint16_t Queue[TELEMETRY_BUFFER_WORDS];    /*!< Frames waiting for the SCI */
+    volatile uint16_t Head;         /*!< Next word written */
+    volatile uint16_t Tail;         /*!< Next word sent */
+    uint16_t Frame[TELEMETRY_MAX_WORDS];    /*!< Frame being assembled */
+    volatile uint16_t Decimation;   /*!< Frames per telemetry frame, 0 when stopped */
+    volatile uint16_t Workers;      /*!< Bit w: worker w selected */
+    volatile uint16_t Words;        /*!< Bit i: measurement payload word i selected */
+    uint16_t Countdown;             /*!< Frames left before the next telemetry frame */
+    uint16_t Seq;                   /*!< Sequence number of the next telemetry frame */
+    uint16_t Command[TELEMETRY_COMMAND_WORDS];  /*!< Command being received */
+    uint16_t CommandBytes;          /*!< Bytes of Command received, 0 while looking for the sync word */
+    uint32_t Frames;                /*!< Frames queued */
+    uint32_t Dropped;               /*!< Frames dropped, queue full */
+    uint32_t Commands;              /*!< Commands applied */
+    uint32_t CommandErrors;         /*!< Commands rejected: CRC or selection out of range */
+    uint32_t RxErrors;              /*!< SCI receive errors */
+} Telemetry_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Configures SCI A for the stream, stopped. The TX interrupt is registered and enabled by the
+ *              caller, and calls Telemetry_Transmit.
+ */
+void Telemetry_Init(Telemetry_t *Telemetry);
+
+/**
+ * @brief       Changes the selection.
+ *
+ * @param[in]   Decimation: Frames per telemetry frame, 0 to stop.
+ * @param[in]   Workers: Bit w selects worker w.
+ * @param[in]   Words: Bit i selects measurement payload word i.
+ * @return      false if the selection names a worker or word that does not exist.
+ */
+bool Telemetry_Select(Telemetry_t *Telemetry, uint16_t Decimation, uint16_t Workers, uint16_t Words);
+
+/**
+ * @brief       Queues a telemetry frame if one is due, from the ring interrupt once the measurements are
+ *              checked.
+ *
+ * @param[in]   Token: Cycle token of the frame.
+ * @param[in]   Time: Launch time of the frame.
+ * @param[in]   Valid: Bit w set if the measurement of worker w is valid.
+ * @param[in]   Measurements: Decoded measurement of each worker.
+ */
+void Telemetry_Capture(Telemetry_t *Telemetry, uint16_t Token, uint32_t Time, uint16_t Valid,
+                       volatile Frame *const Measurements[]);
+
+/**
+ * @brief       Refills the SCI TX FIFO, from the SCI TX interrupt.
+ */
+void Telemetry_Transmit(Telemetry_t *Telemetry);
+
+/**
+ * @brief       Takes the commands of the host, from the background loop often enough not to overflow the
+ *              16 byte RX FIFO.
+ */
+void Telemetry_Service(Telemetry_t *Telemetry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_H */
+
+/*** end of file ***/
@@ -5,9 +5,21 @@
 #include "Timers.h"
 #include "EventsEngine.h"
 #include "SystemEvents.h"
+#include "Timestamp.h"
 
 #include "system.h"
 #include "crc.h"
+#include "Latency.h"
+#include "PhaseAlign.h"
+#include "CoreLink.h"
+#include "DeltaCodec.h"
+#include "Mailbox.h"
+#include "FwUpdate.h"
+#include "LinkStats.h"
+#include "Trace.h"
+#include "FrameIntegrity.h"
+#include "Realign.h"
+#include "Telemetry.h"
 
 
 //#define NUM_WORKERS 2
@@ -15,40 +27,92 @@
 
 //#define MEM_BUFFER_SIZE (2 * NUM_WORKERS * CHUNK_SIZE)
 
-#define FIFO_LVL      8                     // FIFO Interrupt Level
 
 
-#define DMA_TRANSFER_SIZE_TX ((MEM_BUFFER_SIZE - 1) / (16 - FIFO_LVL))
+#define DMA_TRANSFER_SIZE_TX (RING_CLOCKED_WORDS / (16 - FIFO_LVL))
 #define DMA_BURST_SIZE_TX (16 - FIFO_LVL)
 
-#define DMA_TRANSFER_SIZE_RX ((NUM_WORKERS * CHUNK_SIZE) / FIFO_LVL)
+#define DMA_TRANSFER_SIZE_RX ((NUM_WORKERS * MEASUREMENT_CHUNK) / FIFO_LVL)
 #define DMA_BURST_SIZE_RX (FIFO_LVL)
 
+#define FW_CONTROL_FRAMES 1         // Control frames between two firmware bulk frames during an update
+
+// Frame period, in soft timer ticks (microseconds, TIMER_GRANULARITY_US resolution)
+#ifndef DIRECTOR_FRAME_PERIOD_US
+#define DIRECTOR_FRAME_PERIOD_US 100000UL
+#endif
+
+// Words the TX channel takes as soon as it starts, the depth of the SPI TX FIFO. Further on it only reads
+// 16 - FIFO_LVL words ahead of each FIFO_LVL words shifted out.
+#define TX_PREFILL_WORDS 16
+
 
 
 #pragma DATA_SECTION(mem_buffer, "SHARERAMGS1");  // map the RX data to memory
 
-volatile uint16_t mem_buffer[MEM_BUFFER_SIZE];
+volatile uint16_t mem_buffer[MEM_BUFFER_SIZE + REALIGN_MAX_SLIP];     // Slack for an early image, see Realign.h
 
+volatile Frame * broadcast = NULL;     // Shared references, NULL without broadcast chunk
 volatile Frame * setpoints[NUM_WORKERS];
 volatile Frame * measurements[NUM_WORKERS];
 
+#if MEASUREMENT_DELTA
+// Decoded measurements, handed to CPU1 instead of the delta encoded chunks. Kept between frames, a worker only
+// sends the words that changed.
+#pragma DATA_SECTION(measurementView, "SHARERAMGS1");
+volatile Frame measurementView[NUM_WORKERS];
+#endif
+
+// TX image of the firmware bulk frames, CH5 is pointed at it instead of mem_buffer for those frames
+#pragma DATA_SECTION(fwBulk, "SHARERAMGS1");
+volatile uint16_t fwBulk[RING_CLOCKED_WORDS];
+
 
-volatile uint16_t dma5_count = 0;
-volatile uint16_t dma6_count = 0;
+uint16_t cycleToken = 0;            // Token stamped in the setpoint headers of the current frame
 
-volatile uint16_t packet_count = 0;
+Timestamp_t lastLaunch = FRAME_TIME_NONE; // Launch timestamp of the previous frame, distributed as cluster time reference
+int32_t syncError[NUM_WORKERS];     // Cluster time reported by each worker minus actual launch time, in ticks
+int16_t phaseError[NUM_WORKERS];    // Residual PWM carrier phase error reported by each worker, in TBCLK
+int32_t sampleAge[NUM_WORKERS];     // Launch of the frame carrying each measurement minus its sampling instant, in ticks
 
-char interruptOrder[256];
-uint16_t order_idx = 0;
+LatencyReport_t latencyExport;      // Latency histograms, refreshed by LatencyExport_Handler
+
+#if MAILBOX_WORDS > 0
+Mailbox_t mailboxes[NUM_WORKERS];   // Slow channel to each worker, in its setpoint and measurement
+MailboxMessage_t mailboxInbox[NUM_WORKERS];     // Last message received from each worker
+#endif
+
+FwSender_t fwSender;                // Firmware image distribution to the workers
+const uint16_t *fwImage = NULL;     // Update request, set from the debugger: image, length in words and a
+uint32_t fwImageWords = 0;          // non-zero id, then fwStart. Requesting the same id again resumes.
+uint16_t fwImageId = 0;
+volatile uint16_t fwStart = 0;
+uint16_t fwControlFrames = 0;       // Control frames since the last bulk frame
+
+LinkStats_t linkStats;              // Link health counters of the Director
+FrameIntegrity_t frameIntegrity;    // Classifies each returning frame, recovers the channels after a bad one
+Realign_t realign;                  // Moves the RX DMA destination after a word slip in the ring
+RealignChunk_t realignChunks[NUM_WORKERS];  // The measurements
+LinkStats_t workerLinkStats[NUM_WORKERS];   // As last reported by each worker over the mailbox
+volatile uint16_t rxPending = 0;    // Set at launch, cleared once the measurements are received
+
+Telemetry_t telemetry;              // Measurement stream to the host over SCI A
+volatile Frame * telemetrySource[NUM_WORKERS];  // Decoded measurement of each worker
 
 Timer_t InnerLoop;
+Timer_t LatencyExport;
+Timer_t MailboxService;
+Timer_t TelemetryService;
 
 void initSPIAMaster(void);
 void initSPIBSlave(void);
 
+static void stampSetpoint(int Worker, Timestamp_t Previous);
+static uint16_t txWordsRead(void);
+
 __interrupt void dmaCh5ISR(void);
 __interrupt void dmaCh6ISR(void);
+__interrupt void sciaTxISR(void);
 
 
 void main(void)
@@ -76,28 +140,57 @@ void main(void)
 
     // Compute pointers to chunks of memory
     int worker;
+#if BROADCAST_CHUNK > 0
+    broadcast = (Frame *)(mem_buffer + DIRECTOR_BROADCAST_OFFSET);
+#endif
     for (worker = 0; worker < NUM_WORKERS; worker++) {
-        setpoints[worker] = (Frame *)(mem_buffer + (NUM_WORKERS - 1 - worker) * CHUNK_SIZE);
-        measurements[worker] = (Frame *)(mem_buffer + (2 * NUM_WORKERS - 1 - worker) * CHUNK_SIZE);
+        setpoints[worker] = (Frame *)(mem_buffer + DIRECTOR_SETPOINT_OFFSET(worker));
+        measurements[worker] = (Frame *)(mem_buffer + DIRECTOR_MEASUREMENT_OFFSET(worker));
+#if MEASUREMENT_DELTA
+        telemetrySource[worker] = &measurementView[worker];
+#else
+        telemetrySource[worker] = measurements[worker];
+#endif
     }
 
 
     // Fill SETPOINTS with some dummy data
     uint16_t i,j;
     for (i = 0; i < NUM_WORKERS; i++) {
-        for (j = 0; j < CHUNK_SIZE; j++) {
-             mem_buffer[(NUM_WORKERS - 1 - i) * CHUNK_SIZE + j] = (i+1) * 1000 + j;
+        for (j = 0; j < SETPOINT_CHUNK; j++) {
+             mem_buffer[DIRECTOR_SETPOINT_OFFSET(i) + j] = (i+1) * 1000 + j;
         }
 
     }
 
+#if MAILBOX_WORDS > 0
+    for (i = 0; i < NUM_WORKERS; i++) {
+        Mailbox_Init(&mailboxes[i]);
+        Mailbox_Transmit(&mailboxes[i], setpoints[i]->data + SETPOINT_MAILBOX_OFFSET);
+    }
+#endif
+
     // Initialize CRC LUT
     crcInit();
 
+    LinkStats_Init(&linkStats);
+    for (i = 0; i < NUM_WORKERS; i++) {
+        LinkStats_Init(&workerLinkStats[i]);
+    }
+    Trace_Init(TRACE_NODE_DIRECTOR, 2);
+
+    Latency_Init(TIMESTAMP_TICKS_PER_US, DIRECTOR_FRAME_PERIOD_US);
+    PhaseAlign_InitReference(Timestamp_now());
+
 
   for (i = 0; i < NUM_WORKERS; i++) {
-      setpoints[i]->hdr.crc = crcFast(AFTER_CRC(setpoints[i]), sizeof(Frame) - sizeof(crc_t));
+      setpoints[i]->hdr.sync = FRAME_SYNC;
+      setpoints[i]->hdr.crc = SETPOINT_CRC(setpoints[i], i);
   }
+#if BROADCAST_CHUNK > 0
+  broadcast->hdr.sync = FRAME_SYNC;
+  broadcast->hdr.crc = BROADCAST_CRC(broadcast);
+#endif
 
 
 
@@ -130,7 +223,7 @@ void main(void)
 
         // configure DMA CH6 for RX
 
-        DMA_configAddresses(DMA_CH6_BASE, (const void *)mem_buffer + NUM_WORKERS * CHUNK_SIZE, (const void *)(SPIB_BASE + SPI_O_RXBUF));
+        DMA_configAddresses(DMA_CH6_BASE, (const void *)(mem_buffer + DIRECTOR_MEASUREMENT_OFFSET(NUM_WORKERS - 1)), (const void *)(SPIB_BASE + SPI_O_RXBUF));
         DMA_configBurst(DMA_CH6_BASE,DMA_BURST_SIZE_RX,0,1);
         DMA_configTransfer(DMA_CH6_BASE,DMA_TRANSFER_SIZE_RX,0,1);
         DMA_configMode(DMA_CH6_BASE,    DMA_TRIGGER_SPIBRX,
@@ -145,6 +238,29 @@ void main(void)
 
         
 
+        // CH4 moves the broadcast and setpoint payloads published by CPU1 into the ring image
+#if MEASUREMENT_DELTA
+        volatile Frame * views[NUM_WORKERS];
+        for (worker = 0; worker < NUM_WORKERS; worker++) {
+            views[worker] = &measurementView[worker];
+        }
+        CoreLink_Init(broadcast, setpoints, views, CORELINK_NO_WORKER);
+#else
+        CoreLink_Init(broadcast, setpoints, measurements, CORELINK_NO_WORKER);
+#endif
+
+        FrameIntegrity_Init(&frameIntegrity, &linkStats, DMA_CH5_BASE, DMA_CH6_BASE, SPIA_BASE, SPIB_BASE,
+                            DMA_BURST_SIZE_RX, NUM_WORKERS * MEASUREMENT_CHUNK);
+
+        // Only an early image is realigned: a late one would land over setpoint 0, which is still to be sent
+        for (worker = 0; worker < NUM_WORKERS; worker++) {
+            realignChunks[worker].Offset = DIRECTOR_MEASUREMENT_OFFSET(worker);
+            realignChunks[worker].Words = MEASUREMENT_CHUNK;
+            realignChunks[worker].Key = CHUNK_KEY(worker);
+        }
+        Realign_Init(&realign, &linkStats, mem_buffer, MEM_BUFFER_SIZE + REALIGN_MAX_SLIP, realignChunks,
+                     NUM_WORKERS, 0, REALIGN_MAX_SLIP);
+
         // Ensure DMA is connected to Peripheral Frame 2 bridge (EALLOW protected)
         SysCtl_selectSecMaster(SYSCTL_SEC_MASTER_DMA, SYSCTL_SEC_MASTER_DMA);
     }
@@ -168,12 +284,30 @@ void main(void)
         DMA_startChannel(DMA_CH6_BASE);
     }
 
+    {   // SCI, stopped until the host selects what to stream
+
+        Telemetry_Init(&telemetry);
+        Interrupt_register(TELEMETRY_SCI_TX_INT, &sciaTxISR);
+        Interrupt_enable(TELEMETRY_SCI_TX_INT);
+    }
+
     // Enable Global Interrupt (INTM) and realtime interrupt (DBGM)
     EINT;
     ERTM;
 
     TimerInit(&InnerLoop, InnerLoop_Handler, 0);    // initializing timer and timer handler
-    TimerStart(&InnerLoop, SECONDS_TO_TICKS(0.1f));      // Start timer
+    TimerStart(&InnerLoop, DIRECTOR_FRAME_PERIOD_US);    // Start timer
+
+    TimerInit(&LatencyExport, LatencyExport_Handler, 0);
+    TimerStart(&LatencyExport, SECONDS_TO_TICKS(1.0f));
+
+#if MAILBOX_WORDS > 0
+    TimerInit(&MailboxService, MailboxService_Handler, 0);
+    TimerStart(&MailboxService, SECONDS_TO_TICKS(0.01f));
+#endif
+
+    TimerInit(&TelemetryService, TelemetryService_Handler, 0);
+    TimerStart(&TelemetryService, SECONDS_TO_TICKS(0.005f));
 
 //    memset((void *)&master_sData, dma5_count, MEM_BUFFER_SIZE );
 //    memset((void *)&master_rData, 0, MEM_BUFFER_SIZE );
@@ -192,23 +326,140 @@ void InnerLoop_Handler(void * args) {
 //    SPI_clearInterruptStatus(SPIA_BASE, SPI_INT_TXFF);
     
 
-    // DEBUG
-    if (++packet_count % 20 == 0) {
-        interruptOrder[order_idx++] = 'B';if (order_idx > 255) order_idx = 0;
-    }
+    // The image is rewritten from here until the measurements are received, CPU1 must be done with it
+    CoreLink_Close();
 
-    // Compute CRC16 for each setpoint chunk
-    int i;
-    for (i = 0; i < NUM_WORKERS; i++) {
-        setpoints[i]->hdr.crc = crcFast(AFTER_CRC(setpoints[i]), sizeof(Frame) - sizeof(crc_t));
+    // Latest setpoints from the algorithm core, if any. Headers and CRCs are stamped below, in ring order.
+    CoreLink_TakePublished();
+
+    // During a firmware update, a bulk frame follows every FW_CONTROL_FRAMES control frames. It is sent from its
+    // own image and leaves the cycle token, the launch time and the control image alone, so the control loop
+    // only runs slower.
+    if (fwStart) {
+        fwStart = 0;
+        FwUpdate_Start(&fwSender, fwImage, fwImageWords, fwImageId);
     }
+    bool bulk = false;
+    int next = -1;                  // Setpoint still to be stamped, in ring order
+    Timestamp_t previous = 0;       // Launch time of the previous frame, stamped in the headers
+    if (fwSender.Active && ++fwControlFrames > FW_CONTROL_FRAMES) {
+        fwControlFrames = 0;
+        bulk = FwUpdate_NextBulk(&fwSender, fwBulk);
+    }
+
+    if (bulk) {
+        linkStats.BulkFrames++;
+        Trace_Event(TRACE_EV_LAUNCH, cycleToken, 1);
+        DMA_configAddresses(DMA_CH5_BASE, (const void *)(SPIA_BASE + SPI_O_TXBUF), (const void *)fwBulk);
+    } else {
+        cycleToken++;
+        previous = lastLaunch;
+        next = NUM_WORKERS - 1;
+#if BROADCAST_CHUNK > 0
+        broadcast->hdr.token = cycleToken;
+        broadcast->hdr.time = previous;
+        broadcast->hdr.phase = 0;
+        broadcast->hdr.crc = BROADCAST_CRC(broadcast);
+#endif
+        // Setpoints are sent from worker N - 1 down to 0. Those the TX channel takes at once are stamped before
+        // the launch, the others while the first ones are shifted out.
+        while (next >= 0 && DIRECTOR_SETPOINT_OFFSET(next) < TX_PREFILL_WORDS) {
+            stampSetpoint(next--, previous);
+        }
 
+        DMA_configAddresses(DMA_CH5_BASE, (const void *)(SPIA_BASE + SPI_O_TXBUF), (const void *)mem_buffer);
+        lastLaunch = Timestamp_now();
+        if (lastLaunch == FRAME_TIME_NONE) lastLaunch++;     // One tick late, once in a counter wrap
+        Latency_FrameLaunched(cycleToken, lastLaunch);
+        Trace_Event(TRACE_EV_LAUNCH, cycleToken, 0);
+    }
+    // The measurements of the previous frame never completed, the ring returned a short frame. The RX channel
+    // would go on from where it stopped, it is reset to receive this frame aligned.
+    if (rxPending) {
+        linkStats.CsOverruns++;
+        FrameIntegrity_Check(&frameIntegrity);
+        FrameIntegrity_Recover(&frameIntegrity);
+    }
+    rxPending = 1;
 
     DMA_startChannel(DMA_CH5_BASE);
 
     SPI_enableModule(SPIB_BASE);
     DMA_startChannel(DMA_CH6_BASE);
 
+    // Each chunk is done long before the TX channel reaches it, it only reads a FIFO ahead of the shift register.
+    // The first deferred chunk starts past the prefill, so it is read once FIFO_LVL words have been shifted out:
+    // with FIFO_LVL 8 at RING_SPI_BIT_RATE (system.h, 143.4 us a word), about 1.15 ms.
+    for (; next >= 0; next--) {
+        stampSetpoint(next, previous);
+        if (txWordsRead() > DIRECTOR_SETPOINT_OFFSET(next)) linkStats.LateChunks++;
+    }
+
+    TimerRestart((Timer_t *)args);
+}
+
+// Stamps the header of a setpoint chunk for the current frame, then its CRC
+static void stampSetpoint(int Worker, Timestamp_t Previous) {
+    setpoints[Worker]->hdr.token = cycleToken;
+    setpoints[Worker]->hdr.time = Previous;
+    setpoints[Worker]->hdr.phase = PhaseAlign_Reference(Previous, Worker);
+#if MAILBOX_WORDS > 0
+    Mailbox_Transmit(&mailboxes[Worker], setpoints[Worker]->data + SETPOINT_MAILBOX_OFFSET);
+#endif
+    setpoints[Worker]->hdr.crc = SETPOINT_CRC(setpoints[Worker], Worker);
+}
+
+// Words of the image the TX channel has read, counting the burst in progress. TRANSFER_COUNT is the bursts left
+// after the current one, and is only loaded at the first burst. It is decremented as a burst ends, so between
+// two bursts it already counts the next one.
+static uint16_t txWordsRead(void) {
+    uint16_t control = HWREGH(DMA_CH5_BASE + DMA_O_CONTROL);
+    uint16_t bursts;
+
+    if (!(control & DMA_CONTROL_RUNSTS)) return RING_CLOCKED_WORDS;
+    if (!(control & DMA_CONTROL_TRANSFERSTS)) return 0;
+    bursts = DMA_TRANSFER_SIZE_TX - HWREGH(DMA_CH5_BASE + DMA_O_TRANSFER_COUNT);
+    if (!(control & DMA_CONTROL_BURSTSTS)) bursts--;
+    return bursts * DMA_BURST_SIZE_TX;
+}
+
+// Publish a coherent copy of the latency histograms for the debugger / host
+void LatencyExport_Handler(void * args) {
+    Latency_Export(&latencyExport);
+
+    TimerRestart((Timer_t *)args);
+}
+
+// Collects the messages of the workers, keeping their link statistics. Idle links are checked with an echo
+// request once per second.
+void MailboxService_Handler(void * args) {
+#if MAILBOX_WORDS > 0
+    static uint16_t ticks = 0;
+    static uint16_t echo = 0;
+    int i;
+
+    bool check = (++ticks >= 100);
+    if (check) {
+        ticks = 0;
+        echo++;
+    }
+    for (i = 0; i < NUM_WORKERS; i++) {
+        if (Mailbox_Take(&mailboxes[i], &mailboxInbox[i]) && mailboxInbox[i].Type == MAILBOX_TYPE_LINK_STATS) {
+            LinkStats_Unpack(&workerLinkStats[i], mailboxInbox[i].Data, mailboxInbox[i].Length);
+        }
+        if (check) {
+            Mailbox_Send(&mailboxes[i], MAILBOX_TYPE_ECHO, &echo, 1);
+        }
+    }
+#endif
+
+    TimerRestart((Timer_t *)args);
+}
+
+// Takes the selection commands of the telemetry host. A command is 10 bytes, well within the RX FIFO.
+void TelemetryService_Handler(void * args) {
+    Telemetry_Service(&telemetry);
+
     TimerRestart((Timer_t *)args);
 }
 
@@ -219,7 +470,7 @@ void initSPIAMaster(void)
     SPI_disableModule(SPIA_BASE);
 
     // SPI configuration. Use a 500kHz SPICLK and 16-bit word size.
-    SPI_setConfig(SPIA_BASE, DEVICE_LSPCLK_FREQ, SPI_PROT_POL0PHA0, SPI_MODE_MASTER, DEVICE_LSPCLK_FREQ / 128, 16);
+    SPI_setConfig(SPIA_BASE, SYSTEM_LSPCLK_FREQ, SPI_PROT_POL0PHA0, SPI_MODE_MASTER, RING_SPI_BIT_RATE, 16);
 //    SPI_enableHighSpeedMode(SPIA_BASE);
     SPI_disableLoopback(SPIA_BASE);
     SPI_setEmulationMode(SPIA_BASE, SPI_EMULATION_FREE_RUN);
@@ -241,7 +492,7 @@ void initSPIBSlave(void)
     SPI_disableModule(SPIB_BASE);
 
     // SPI configuration. Use a 500kHz SPICLK and 16-bit word size.
-    SPI_setConfig(SPIB_BASE, DEVICE_LSPCLK_FREQ, SPI_PROT_POL0PHA0, SPI_MODE_SLAVE,  DEVICE_LSPCLK_FREQ / 128, 16);
+    SPI_setConfig(SPIB_BASE, SYSTEM_LSPCLK_FREQ, SPI_PROT_POL0PHA0, SPI_MODE_SLAVE,  RING_SPI_BIT_RATE, 16);
 //    SPI_enableHighSpeedMode(SPIB_BASE);
     SPI_disableLoopback(SPIB_BASE);
     SPI_setEmulationMode(SPIB_BASE, SPI_EMULATION_FREE_RUN);
@@ -265,8 +516,8 @@ __interrupt void dmaCh5ISR(void) {
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
     EDIS;
 
-    interruptOrder[order_idx++] = 't';if (order_idx > 255) order_idx = 0; // DEBUG
-
+    linkStats.FramesSent++;
+    Trace_Event(TRACE_EV_TX_DONE, 0, 0);
 
     return;
 }
@@ -279,23 +530,92 @@ __interrupt void dmaCh6ISR(void) {
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
     EDIS;
 
-    // When buffer filled, stop receving for frame.
+    Timestamp_t rxComplete = Timestamp_now();
+
+    // When buffer filled, stop receving for frame. Words still in the FIFO mean the ring returned more than
+    // the measurements; the CRCs tell whether the measurements received are usable.
     SPI_disableModule(SPIB_BASE);
+    if (FrameIntegrity_Check(&frameIntegrity) != FRAME_COMPLETE) {
+        FrameIntegrity_Recover(&frameIntegrity);
+    }
     SPI_resetRxFIFO(SPIB_BASE);
 
-    interruptOrder[order_idx++] = 'r';if (order_idx > 255) order_idx = 0; // DEBUG
+    linkStats.FramesReceived++;
+    rxPending = 0;
+
+    // Recompute CRC of every measurement, only valid ones contribute to the latency statistics
+    uint16_t valid = 0;
+    uint16_t matched = 0;           // Chunks passing their CRC, as a measurement or as an update status
+    int i;
+
+    // Words lost upstream in the middle of the frame, the chunks behind the slip are not taken
+    Realign_Check(&realign);
+    for (i = 0; i < NUM_WORKERS; i++) {
+        crc_t crc_check = MEASUREMENT_CRC(measurements[i], i);
+
+        if (!CHUNK_IN_PLACE(measurements[i]) ||
+            !Realign_InStep(&realign, (volatile const uint16_t *)measurements[i], MEASUREMENT_CHUNK)) {
+            linkStats.MeasurementCrcErrors[i]++;
+            continue;
+        }
+        if (crc_check != measurements[i]->hdr.crc) {
+            // Update status answering a bulk frame, in place of the measurement
+            if ((crc_t)(crc_check ^ FW_CRC_XOR) == measurements[i]->hdr.crc) {
+                FwUpdate_ReceiveStatus(&fwSender, i, &measurements[i]->hdr);
+                matched |= 1U << i;
+                continue;
+            }
+            linkStats.MeasurementCrcErrors[i]++;
+            continue;
+        }
+        matched |= 1U << i;
+#if MEASUREMENT_DELTA
+        if (!DeltaCodec_Decode(measurements[i]->data, measurementView[i].data)) {
+            linkStats.DecodeErrors++;
+            continue;
+        }
+        measurementView[i].hdr = measurements[i]->hdr;
+#endif
+        valid |= 1U << i;
+
+#if MAILBOX_WORDS > 0
+        Mailbox_Receive(&mailboxes[i], measurements[i]->data + MEASUREMENT_MAILBOX_OFFSET);
+#endif
 
-    dma6_count++;
+        Latency_Record(i, measurements[i]->hdr.token, rxComplete);
+
+        // Each worker reports its cluster time of the launch of the frame it echoes
+        Timestamp_t launch;
+        if (Latency_LaunchTime(measurements[i]->hdr.token, &launch)) {
+            syncError[i] = (int32_t)(measurements[i]->hdr.time - launch);
+        }
+        phaseError[i] = (int16_t)measurements[i]->hdr.phase;
+        sampleAge[i] = (int32_t)(lastLaunch - measurements[i]->hdr.sample);
+    }
 
-    // Recompute CRC
-    crc_t crc_check = crcFast(AFTER_CRC(measurements[0]), sizeof(Frame) - sizeof(crc_t));
+    Trace_Event(TRACE_EV_RX_DONE, valid, 0);
 
-    if (crc_check != measurements[0]->hdr.crc) {
-        interruptOrder[order_idx++] = 'C';if (order_idx > 255) order_idx = 0;
+    // No measurement passes its CRC: the image may have slipped by a few words in the ring. The next frame is
+    // received where the chunks were found.
+    if (!matched && Realign_Search(&realign)) {
+        DMA_configAddresses(DMA_CH6_BASE,
+                            (const void *)(mem_buffer + DIRECTOR_MEASUREMENT_OFFSET(NUM_WORKERS - 1) + realign.Shift),
+                            (const void *)(SPIB_BASE + SPI_O_RXBUF));
     }
 
+    Telemetry_Capture(&telemetry, cycleToken, lastLaunch, valid, telemetrySource);
+
+    // Hand the measurements over to the algorithm core, read in place until the next launch
+    CoreLink_Ready(cycleToken, true, CORELINK_ALL_WORKERS, valid);
 
     return;
 }
 
+// Telemetry TX FIFO running low
+__interrupt void sciaTxISR(void) {
+    Telemetry_Transmit(&telemetry);
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP9);
+}
+
 // End of File
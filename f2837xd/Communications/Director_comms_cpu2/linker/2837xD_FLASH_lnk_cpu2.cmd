@@ -48,9 +48,12 @@ PAGE 1 :
 
    RAMGS0          : origin = 0x00C000, length = 0x001000
    RAMGS1          : origin = 0x00D000, length = 0x001000
-   RAMGS2          : origin = 0x00E000, length = 0x001000
-   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000400
-   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000400
+   CORELINK_PUB    : origin = 0x00E000, length = 0x000400     /* CoreLink publish slots, owned by CPU1 */
+   RAMGS2          : origin = 0x00E400, length = 0x000C00
+   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000380
+   CORELINK_DOWN   : origin = 0x03FB80, length = 0x000080     /* CoreLink descriptor, written by CPU2 */
+   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000380
+   CORELINK_UP     : origin = 0x03FF80, length = 0x000080     /* CoreLink status, written by CPU1 */
 }
 
 SECTIONS
@@ -125,6 +128,11 @@ SECTIONS
     #endif
 #endif
 
+   /* CoreLink data plane, see ring/CoreLink.h. CPU2 allocates what it writes, the rest is mapped only */
+   CoreLinkDown     : > CORELINK_DOWN,  PAGE = 1
+   CoreLinkUp       : > CORELINK_UP,    PAGE = 1, TYPE = DSECT
+   CoreLinkPublish  : > CORELINK_PUB,   PAGE = 1, TYPE = DSECT
+
    /* The following section definitions are required when using the IPC API Drivers */
     GROUP : > CPU2TOCPU1RAM, PAGE = 1
     {
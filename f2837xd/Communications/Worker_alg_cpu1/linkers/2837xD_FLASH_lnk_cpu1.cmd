@@ -50,7 +50,8 @@ PAGE 1 : /* Data Memory */
 
    RAMGS0      : origin = 0x00C000, length = 0x001000
    RAMGS1      : origin = 0x00D000, length = 0x001000
-   RAMGS2      : origin = 0x00E000, length = 0x001000
+   CORELINK_PUB : origin = 0x00E000, length = 0x000400     /* CoreLink publish slots, owned by CPU1 */
+   RAMGS2      : origin = 0x00E400, length = 0x000C00
    RAMGS3      : origin = 0x00F000, length = 0x001000
    RAMGS4      : origin = 0x010000, length = 0x001000
    RAMGS5      : origin = 0x011000, length = 0x001000
@@ -68,8 +69,10 @@ PAGE 1 : /* Data Memory */
    RAMGS12     : origin = 0x018000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
    RAMGS13     : origin = 0x019000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
 
-   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000400
-   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000400
+   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000380
+   CORELINK_DOWN   : origin = 0x03FB80, length = 0x000080     /* CoreLink descriptor, written by CPU2 */
+   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000380
+   CORELINK_UP     : origin = 0x03FF80, length = 0x000080     /* CoreLink status, written by CPU1 */
 }
 
 SECTIONS
@@ -146,6 +149,11 @@ SECTIONS
 
 #endif
 
+   /* CoreLink data plane, see ring/CoreLink.h. CPU1 allocates what it writes, the rest is mapped only */
+   CoreLinkDown     : > CORELINK_DOWN,  PAGE = 1, TYPE = DSECT
+   CoreLinkUp       : > CORELINK_UP,    PAGE = 1
+   CoreLinkPublish  : > CORELINK_PUB,   PAGE = 1
+
    /* The following section definitions are required when using the IPC API Drivers */
     GROUP : > CPU1TOCPU2RAM, PAGE = 1
     {
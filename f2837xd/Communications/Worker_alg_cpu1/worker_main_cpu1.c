@@ -3,7 +3,15 @@
 #include "device.h"
 #include "inc/hw_ipc.h"
 
+#include "system.h"
+#include "CoreLink.h"
+#include "Trace.h"
+#include "signals.h"
+
 void configGPIOs(void);
+static void controlStep(volatile const uint16_t *broadcast, volatile const uint16_t *setpoint, uint16_t *measurement);
+
+__interrupt void coreLinkISR(void);
 
 
 void main(void)
@@ -33,6 +41,7 @@ void main(void)
     // Configure CPU2 to control the LED GPIO
     GPIO_setMasterCore(DEVICE_GPIO_PIN_LED2, GPIO_CORE_CPU2);
 
+    // SYSTEM_LSPCLK_DIV (system.h), the comms core sets up its SPI and SCI for it
     SysCtl_setLowSpeedClock(SYSCTL_LSPCLK_PRESCALE_14);
 
 
@@ -40,9 +49,17 @@ void main(void)
     configGPIOs();
     // Hand-over the SCIA module access to CPU2
     SysCtl_selectCPUForPeripheral(SYSCTL_CPUSEL6_SPI, 1, SYSCTL_CPUSEL_CPU2);// Hand-over SPI A
+    SysCtl_selectCPUForPeripheral(SYSCTL_CPUSEL1_ECAP, 1, SYSCTL_CPUSEL_CPU2);// Hand-over ECAP1 (CS timestamping)
+    SysCtl_selectCPUForPeripheral(SYSCTL_CPUSEL0_EPWM, 1, SYSCTL_CPUSEL_CPU2);// Hand-over EPWM1 (converter carrier)
+#if MEASUREMENT_ADC_WORDS > 0
+    SysCtl_selectCPUForPeripheral(SYSCTL_CPUSEL11_ADC, MEASUREMENT_ADC_MODULE + 1, SYSCTL_CPUSEL_CPU2);// Hand-over the measurement ADC
+#endif
 
     MemCfg_setGSRAMMasterSel(MEMCFG_SECT_GS0 | MEMCFG_SECT_GS1 , MEMCFG_GSRAMCONTROLLER_CPU2);
 
+    // GS2 stays with CPU1: CoreLink publish slots, read by the CPU2 DMA
+    MemCfg_setGSRAMMasterSel(MEMCFG_SECT_GS2, MEMCFG_GSRAMCONTROLLER_CPU1);
+
     // Sync CPU1 and CPU2. Send IPC flag 31 to CPU2.
     HWREG(IPC_BASE + IPC_O_SET) = IPC_ACK_IPC31;
 
@@ -53,6 +70,13 @@ void main(void)
     // Service Routines (ISR).
     Interrupt_initVectorTable();
 
+    Trace_Init(TRACE_NODE_UNKNOWN, 1);
+
+    // Frames handed over by CPU2
+    CoreLink_InitConsumer();
+    Interrupt_register(INT_IPC_0, &coreLinkISR);
+    Interrupt_enable(INT_IPC_0);
+
     // Enable Global Interrupt (INTM) and realtime interrupt (DBGM)
     EINT;
     ERTM;
@@ -115,6 +139,14 @@ void configGPIOs(void)
 
     GPIO_setMasterCore(22, GPIO_CORE_CPU2);
 
+    // Route the CS pin to ECAP1 (INPUT XBAR 7) for hardware edge timestamping on CPU2
+    XBAR_setInputPin(XBAR_INPUT7, 22);
+
+    // GPIO0 is EPWM1A, the phase-aligned converter carrier
+    GPIO_setMasterCore(0, GPIO_CORE_CPU2);
+    GPIO_setPinConfig(GPIO_0_EPWM1A);
+    GPIO_setPadConfig(0, GPIO_PIN_TYPE_STD);
+
     // Slave ID Set
 
     GPIO_setDirectionMode(97,GPIO_DIR_MODE_IN);          // input
@@ -124,4 +156,47 @@ void configGPIOs(void)
     GPIO_setMasterCore(97, GPIO_CORE_CPU2);
 }
 
+// Placeholder control law: the measurement follows the setpoint references. broadcast is NULL without
+// broadcast chunk.
+static void controlStep(volatile const uint16_t *broadcast, volatile const uint16_t *setpoint, uint16_t *measurement)
+{
+    // Placeholder plant: follows the references. v_dc and temperature are sampled by the ADC on CPU2.
+#if BROADCAST_CHUNK > 0
+    Measurement_Set_running(measurement, Broadcast_Get_enable(broadcast));
+#endif
+    Measurement_Set_ready(measurement, true);
+    Measurement_Set_fault(measurement, false);
+    Measurement_Write_i_d(measurement, Setpoint_Read_i_d_ref(setpoint));
+    Measurement_Write_i_q(measurement, Setpoint_Read_i_q_ref(setpoint));
+}
+
+// Ring image ready on CPU2. The broadcast and own setpoint are read in place in GS1, the measurement payload is
+// written to a publish slot and moved into the ring by CPU2 before the next frame.
+__interrupt void coreLinkISR(void)
+{
+    volatile CoreLinkDown_t *image = CoreLink_Acquire();
+
+    if (image != NULL) {
+        uint16_t self = image->Self;
+        uint16_t token = image->Token;
+        bool fresh = ((image->SetpointsValid >> self) & 1U) && image->BroadcastValid;
+
+        if (trace.Node != self) Trace_SetNode(self);
+        Trace_Event(TRACE_EV_ACQUIRE, token, fresh);
+
+        if (fresh) {
+            controlStep(image->Broadcast != NULL ? image->Broadcast->data : NULL, image->Setpoints[self]->data,
+                        CORELINK_PUBLISH_MEASUREMENT(CoreLink_PublishBuffer()));
+        }
+
+        // Only results computed from an image that was not overwritten meanwhile are published
+        if (CoreLink_Release() && fresh) {
+            CoreLink_Publish(token);
+            Trace_Event(TRACE_EV_PUBLISH, token, 0);
+        }
+    }
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
+}
+
 // End of File
@@ -0,0 +1,146 @@
+/**
+ ********************************************************************************
+ * @file    AdcCapture.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "device.h"
+#include "system.h"
+#include "PhaseAlign.h"
+#include "AdcCapture.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#if MEASUREMENT_ADC_MODULE == 0
+#define ADC_BASE                ADCA_BASE
+#define ADC_RESULT_BASE         ADCARESULT_BASE
+#define ADC_DMA_TRIGGER         DMA_TRIGGER_ADCA1
+#elif MEASUREMENT_ADC_MODULE == 1
+#define ADC_BASE                ADCB_BASE
+#define ADC_RESULT_BASE         ADCBRESULT_BASE
+#define ADC_DMA_TRIGGER         DMA_TRIGGER_ADCB1
+#elif MEASUREMENT_ADC_MODULE == 2
+#define ADC_BASE                ADCC_BASE
+#define ADC_RESULT_BASE         ADCCRESULT_BASE
+#define ADC_DMA_TRIGGER         DMA_TRIGGER_ADCC1
+#else
+#define ADC_BASE                ADCD_BASE
+#define ADC_RESULT_BASE         ADCDRESULT_BASE
+#define ADC_DMA_TRIGGER         DMA_TRIGGER_ADCD1
+#endif
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+#if MEASUREMENT_ADC_WORDS > 0
+static const uint16_t channels[MEASUREMENT_ADC_WORDS] = { MEASUREMENT_ADC_CHANNELS };  /*!< ADCIN of each SOC */
+#endif
+static uint32_t carrierBase;
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void AdcCapture_Init(uint32_t CarrierBase, volatile uint16_t *Payload)
+{
+#if MEASUREMENT_ADC_WORDS > 0
+    uint16_t soc;
+
+    carrierBase = CarrierBase;
+
+    ADC_setPrescaler(ADC_BASE, ADC_CLK_DIV_4_0);
+    ADC_setMode(ADC_BASE, ADC_RESOLUTION_12BIT, ADC_MODE_SINGLE_ENDED);
+    ADC_setInterruptPulseMode(ADC_BASE, ADC_PULSE_END_OF_CONV);
+    ADC_enableConverter(ADC_BASE);
+    DEVICE_DELAY_US(1000);
+
+    for (soc = 0; soc < MEASUREMENT_ADC_WORDS; soc++) {
+        ADC_setupSOC(ADC_BASE, (ADC_SOCNumber)soc, ADC_TRIGGER_EPWM1_SOCA, (ADC_Channel)channels[soc],
+                     ADC_CAPTURE_ACQ_CYCLES);
+    }
+
+    // ADCINT1 at the end of the last SOC, not continuous: one DMA trigger until the flag is cleared
+    ADC_setInterruptSource(ADC_BASE, ADC_INT_NUMBER1, (ADC_SOCNumber)(MEASUREMENT_ADC_WORDS - 1));
+    ADC_disableContinuousMode(ADC_BASE, ADC_INT_NUMBER1);
+    ADC_enableInterrupt(ADC_BASE, ADC_INT_NUMBER1);
+    ADC_clearInterruptStatus(ADC_BASE, ADC_INT_NUMBER1);
+
+    // SOCA at every carrier zero once enabled
+    EPWM_disableADCTrigger(carrierBase, EPWM_SOC_A);
+    EPWM_setADCTriggerSource(carrierBase, EPWM_SOC_A, EPWM_SOC_TBCTR_ZERO);
+    EPWM_setADCTriggerEventPrescale(carrierBase, EPWM_SOC_A, 1);
+
+    // Every result register into the payload, in one burst
+    DMA_configAddresses(ADC_CAPTURE_DMA_BASE, (const void *)(Payload + MEASUREMENT_ADC_OFFSET),
+                        (const void *)(ADC_RESULT_BASE + ADC_O_RESULT0));
+    DMA_configBurst(ADC_CAPTURE_DMA_BASE, MEASUREMENT_ADC_WORDS, 1, 1);
+    DMA_configTransfer(ADC_CAPTURE_DMA_BASE, 1, 0, 0);
+    DMA_configMode(ADC_CAPTURE_DMA_BASE, ADC_DMA_TRIGGER,
+                                         DMA_CFG_ONESHOT_DISABLE     |
+                                         DMA_CFG_CONTINUOUS_DISABLE  |
+                                         DMA_CFG_SIZE_16BIT);
+    DMA_setInterruptMode(ADC_CAPTURE_DMA_BASE, DMA_INT_AT_END);
+    DMA_enableTrigger(ADC_CAPTURE_DMA_BASE);
+    DMA_enableInterrupt(ADC_CAPTURE_DMA_BASE);
+    DMA_disableOverrunInterrupt(ADC_CAPTURE_DMA_BASE);
+#endif
+}
+
+void AdcCapture_Start(void)
+{
+    // Drop a conversion left over from a halted capture
+    ADC_clearInterruptStatus(ADC_BASE, ADC_INT_NUMBER1);
+    ADC_clearInterruptOverflowStatus(ADC_BASE, ADC_INT_NUMBER1);
+    DMA_clearTriggerFlag(ADC_CAPTURE_DMA_BASE);
+
+    DMA_startChannel(ADC_CAPTURE_DMA_BASE);
+    EPWM_enableADCTrigger(carrierBase, EPWM_SOC_A);
+}
+
+bool AdcCapture_Stop(Timestamp_t *SampleTime)
+{
+    EPWM_disableADCTrigger(carrierBase, EPWM_SOC_A);
+
+    // The burst in progress, if any, completes the transfer
+    while (DMA_getBurstStatusFlag(ADC_CAPTURE_DMA_BASE)) { }
+    if (DMA_getRunStatusFlag(ADC_CAPTURE_DMA_BASE)) {
+        DMA_stopChannel(ADC_CAPTURE_DMA_BASE);
+        return false;
+    }
+    ADC_clearInterruptStatus(ADC_BASE, ADC_INT_NUMBER1);
+
+    // The SOC was at the last carrier zero: position 0 of the up-down period
+    uint16_t counter = EPWM_getTimeBaseCounterValue(carrierBase);
+    bool countingUp = (EPWM_getTimeBaseCounterDirection(carrierBase) == EPWM_TIME_BASE_STATUS_COUNT_UP);
+    uint16_t position = countingUp ? counter : (PWM_CARRIER_TBCLK - counter);
+
+    *SampleTime = Timestamp_now() - (uint32_t)position * PWM_TBCLK_DIV;
+    return true;
+}
+
+/*** end of file ***/
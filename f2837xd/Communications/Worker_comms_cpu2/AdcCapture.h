@@ -0,0 +1,82 @@
+/**
+ ********************************************************************************
+ * @file    AdcCapture.h
+ * @brief   ADC sampling of the measurement signals, moved into the ring by DMA.
+ *
+ *          The measurement signals with an "adc" source in system.json are the last
+ *          MEASUREMENT_ADC_WORDS words of the payload, one SOC each on the same ADC
+ *          module. Once per frame AdcCapture_Start() lets the next zero of the carrier
+ *          (EPWM SOCA) start the conversions; ADCINT1, at the end of the last one,
+ *          triggers DMA CH3, which moves the result registers straight into the payload
+ *          in a single burst and interrupts. No CPU copy is involved, the comms core
+ *          only finishes the header and CRC from that interrupt.
+ *
+ *          The SOC trigger is only enabled for one carrier zero, so the payload is not
+ *          rewritten while it is being shifted out or after its CRC.
+ ********************************************************************************
+ */
+
+#ifndef ADCCAPTURE_H
+#define ADCCAPTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Timestamp.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define ADC_CAPTURE_DMA_BASE    DMA_CH3_BASE
+#define ADC_CAPTURE_INT         INT_DMA_CH3
+#define ADC_CAPTURE_ACQ_CYCLES  15U     /*!< S+H window in SYSCLK cycles, 75 ns: the 12-bit minimum */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Powers up the ADC module and sets up one SOC per ADC signal, triggered by SOCA of the
+ *              carrier at counter zero, and the DMA channel. The DMA interrupt is registered and enabled
+ *              by the caller.
+ *
+ * @param[in]   CarrierBase: EPWM module of the carrier, up-down count.
+ * @param[in]   Payload: Measurement payload the ADC words are moved into, at MEASUREMENT_ADC_OFFSET.
+ */
+void AdcCapture_Init(uint32_t CarrierBase, volatile uint16_t *Payload);
+
+/**
+ * @brief       Samples at the next carrier zero. The DMA interrupt follows the conversions.
+ */
+void AdcCapture_Start(void);
+
+/**
+ * @brief       Disables the SOC trigger. Called from the DMA interrupt, or when the frame starts before it.
+ *
+ * @param[out]  SampleTime: Carrier zero the words were sampled at, set if they were moved. Only
+ *              valid within one carrier period of the sampling instant.
+ * @return      true if the samples are in the payload, false if the channel was halted before.
+ */
+bool AdcCapture_Stop(Timestamp_t *SampleTime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADCCAPTURE_H */
+
+/*** end of file ***/
@@ -0,0 +1,110 @@
+/**
+ ********************************************************************************
+ * @file    CsCapture.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "device.h"
+#include "CsCapture.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define ALL_ECAP_INTERRUPTS     (ECAP_ISR_SOURCE_CAPTURE_EVENT_1  | \
+                                 ECAP_ISR_SOURCE_CAPTURE_EVENT_2  | \
+                                 ECAP_ISR_SOURCE_CAPTURE_EVENT_3  | \
+                                 ECAP_ISR_SOURCE_CAPTURE_EVENT_4  | \
+                                 ECAP_ISR_SOURCE_COUNTER_OVERFLOW | \
+                                 ECAP_ISR_SOURCE_COUNTER_PERIOD   | \
+                                 ECAP_ISR_SOURCE_COUNTER_COMPARE)
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint32_t lastStartCapture;   /*!< CAP1 of the previous valid frame, for the period measurement */
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+volatile FrameTiming_t frameTiming;
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void CsCapture_Init(void)
+{
+    ECAP_disableInterrupt(CS_CAPTURE_BASE, ALL_ECAP_INTERRUPTS);
+    ECAP_clearInterrupt(CS_CAPTURE_BASE, ALL_ECAP_INTERRUPTS);
+    ECAP_disableTimeStampCapture(CS_CAPTURE_BASE);
+    ECAP_stopCounter(CS_CAPTURE_BASE);
+
+    // Continuous capture, wrap after event 2: CAP1 = CS falling, CAP2 = CS rising.
+    // The counter is never reset so captures are absolute SYSCLK timestamps.
+    ECAP_enableCaptureMode(CS_CAPTURE_BASE);
+    ECAP_setCaptureMode(CS_CAPTURE_BASE, ECAP_CONTINUOUS_CAPTURE_MODE, ECAP_EVENT_2);
+    ECAP_setEventPrescaler(CS_CAPTURE_BASE, 0);
+    ECAP_setEventPolarity(CS_CAPTURE_BASE, ECAP_EVENT_1, ECAP_EVNT_FALLING_EDGE);
+    ECAP_setEventPolarity(CS_CAPTURE_BASE, ECAP_EVENT_2, ECAP_EVNT_RISING_EDGE);
+    ECAP_disableCounterResetOnEvent(CS_CAPTURE_BASE, ECAP_EVENT_1);
+    ECAP_disableCounterResetOnEvent(CS_CAPTURE_BASE, ECAP_EVENT_2);
+    ECAP_disableLoadCounter(CS_CAPTURE_BASE);
+    ECAP_setSyncOutMode(CS_CAPTURE_BASE, ECAP_SYNC_OUT_DISABLED);
+    ECAP_setEmulationMode(CS_CAPTURE_BASE, ECAP_EMULATION_FREE_RUN);
+
+    frameTiming.MinLength = UINT32_MAX;
+
+    ECAP_enableTimeStampCapture(CS_CAPTURE_BASE);
+    ECAP_startCounter(CS_CAPTURE_BASE);
+    ECAP_reArm(CS_CAPTURE_BASE);
+
+    ECAP_enableInterrupt(CS_CAPTURE_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_2);
+}
+
+bool CsCapture_FrameEnd(void)
+{
+    uint32_t start = ECAP_getEventTimeStamp(CS_CAPTURE_BASE, ECAP_EVENT_1);
+    uint32_t end = ECAP_getEventTimeStamp(CS_CAPTURE_BASE, ECAP_EVENT_2);
+    uint32_t length = end - start;
+    bool valid = (length >= CS_MIN_FRAME_TICKS);
+
+    if (valid) {
+        frameTiming.Start = CsCapture_ToTimestamp(start);
+        frameTiming.End = CsCapture_ToTimestamp(end);
+        frameTiming.Length = length;
+        frameTiming.Period = start - lastStartCapture;
+        if (length < frameTiming.MinLength) frameTiming.MinLength = length;
+        if (length > frameTiming.MaxLength) frameTiming.MaxLength = length;
+        frameTiming.Frames++;
+        lastStartCapture = start;
+    } else {
+        frameTiming.Glitches++;
+    }
+
+    ECAP_clearInterrupt(CS_CAPTURE_BASE, ECAP_ISR_SOURCE_CAPTURE_EVENT_2);
+    ECAP_clearGlobalInterrupt(CS_CAPTURE_BASE);
+
+    return valid;
+}
+
+/*** end of file ***/
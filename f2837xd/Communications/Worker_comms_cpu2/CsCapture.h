@@ -0,0 +1,104 @@
+/**
+ ********************************************************************************
+ * @file    CsCapture.h
+ * @brief   Hardware timestamping of the chip-select edges with ECAP1.
+ *
+ *          The CS line (GPIO22) is routed to ECAP1 through INPUT XBAR 7 by CPU1. ECAP1 runs
+ *          in continuous capture mode with absolute timestamps: CAP1 latches the falling
+ *          edge (frame start) and CAP2 the rising edge (frame end), at SYSCLK resolution
+ *          and independently of the interrupt latency.
+ ********************************************************************************
+ */
+
+#ifndef CSCAPTURE_H
+#define CSCAPTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Timestamp.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define CS_CAPTURE_BASE         ECAP1_BASE
+#define CS_CAPTURE_INT          INT_ECAP1
+#define CS_MIN_FRAME_TICKS      US_TO_TIMESTAMP(10)    /*!< CS low pulses shorter than this are glitches, not frames */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Per-frame timing record, in Timestamp_t time base.
+ */
+typedef struct {
+    Timestamp_t Start;      /*!< CS falling edge of the last frame */
+    Timestamp_t End;        /*!< CS rising edge of the last frame */
+    uint32_t    Length;     /*!< CS low time of the last frame, in ticks */
+    uint32_t    Period;     /*!< Time between the last two frame starts, in ticks */
+    uint32_t    MinLength;  /*!< Shortest valid frame seen, in ticks */
+    uint32_t    MaxLength;  /*!< Longest valid frame seen, in ticks */
+    uint32_t    Frames;     /*!< Number of valid frames timed */
+    uint32_t    Glitches;   /*!< Number of CS pulses rejected as glitches */
+} FrameTiming_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+extern volatile FrameTiming_t frameTiming;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief   Configures ECAP1 to timestamp both CS edges and interrupt on the rising edge.
+ *          The ECAP1 interrupt itself is registered and enabled by the caller.
+ */
+void CsCapture_Init(void);
+
+/**
+ * @brief   Converts an ECAP capture into the Timestamp_t time base.
+ *
+ *          Both counters run at SYSCLK, so the age of the capture measured on the ECAP
+ *          counter is subtracted from the current timestamp.
+ *
+ * @param[in] Capture: Value of an ECAP capture register.
+ * @return  Timestamp of the captured edge.
+ */
+static inline Timestamp_t CsCapture_ToTimestamp(uint32_t Capture)
+{
+    Timestamp_t now = Timestamp_now();
+    return now - (ECAP_getTimeBaseCounter(CS_CAPTURE_BASE) - Capture);
+}
+
+/**
+ * @brief   Timestamp of the latest CS falling edge.
+ */
+static inline Timestamp_t CsCapture_LastFall(void)
+{
+    return CsCapture_ToTimestamp(ECAP_getEventTimeStamp(CS_CAPTURE_BASE, ECAP_EVENT_1));
+}
+
+/**
+ * @brief   Updates the frame timing record at the end of a frame. Must be called from the
+ *          ECAP1 interrupt (CS rising edge), the interrupt flags are cleared here.
+ *
+ * @return  true if the CS pulse was long enough to be a frame, false for a glitch.
+ */
+bool CsCapture_FrameEnd(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CSCAPTURE_H */
+
+/*** end of file ***/
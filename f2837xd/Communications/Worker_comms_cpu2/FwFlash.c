@@ -0,0 +1,158 @@
+/**
+ ********************************************************************************
+ * @file    FwFlash.c
+ * @brief   Flash writer of the worker (FwFlash_t, FwUpdate.h) on the F021 flash API.
+ *
+ *          The staging area is sectors G to J of the CPU2 flash bank, which the
+ *          linker command file leaves free. The API and the calls into it run from
+ *          RAM. While its state machine works on the bank nothing may be fetched from
+ *          it, and the ring interrupts run from flash: each command is waited for
+ *          with interrupts disabled. A sector erase holds them for about 0.1 s, the
+ *          frames lost meanwhile are what the comms watchdog is for.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "device.h"
+#include "F021_F2837xD_C28x.h"
+#include "FwUpdate.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define STAGING_START           0x098000UL  /*!< FLASHG */
+#define STAGING_SECTOR_WORDS    0x8000UL    /*!< FLASHG to FLASHJ are 32K words each */
+#define STAGING_SECTORS         4U
+#define STAGING_WORDS           (STAGING_SECTORS * STAGING_SECTOR_WORDS)
+
+#define PROGRAM_WORDS           8U          /*!< 128 bits, the most programmed at once */
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// Segments are programmed from 128 bit boundaries
+typedef char fwFlashSegmentCheck[(FW_SEGMENT_WORDS % PROGRAM_WORDS == 0) ? 1 : -1];
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static bool initialized = false;
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+static bool fwFlashErase(uint32_t Words);
+static bool fwFlashProgram(uint32_t Offset, const uint16_t *Data, uint16_t Words);
+static bool fwFlashInit(void);
+static bool fwFlashWait(void);
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+const FwFlash_t fwFlash = { fwFlashErase, fwFlashProgram };     /*!< Flash writer of the worker code */
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+__attribute__((ramfunc))
+static bool fwFlashInit(void)
+{
+    Fapi_StatusType status;
+
+    if (initialized) return true;
+
+    EALLOW;
+    status = Fapi_initializeAPI(F021_CPU0_BASE_ADDRESS, DEVICE_SYSCLK_FREQ / 1000000U);
+    if (status == Fapi_Status_Success) {
+        status = Fapi_setActiveFlashBank(Fapi_FlashBank0);
+    }
+    EDIS;
+
+    initialized = (status == Fapi_Status_Success);
+    return initialized;
+}
+
+// Waits for the command just issued, interrupts are disabled by the caller. False if the state machine failed it.
+__attribute__((ramfunc))
+static bool fwFlashWait(void)
+{
+    while (Fapi_checkFsmForReady() != Fapi_Status_FsmReady) {
+    }
+    return Fapi_getFsmStatus() == 0U;
+}
+
+__attribute__((ramfunc))
+static bool fwFlashErase(uint32_t Words)
+{
+    Fapi_FlashStatusWordType check;
+    bool ok = true;
+    uint16_t sector;
+
+    if (Words > STAGING_WORDS || !fwFlashInit()) return false;
+
+    Flash_claimPumpSemaphore(FLASHPUMPSEMAPHORE_BASE, FLASH_CPU2_WRAPPER);
+    for (sector = 0; ok && (uint32_t)sector * STAGING_SECTOR_WORDS < Words; sector++) {
+        uint32_t *address = (uint32_t *)(STAGING_START + (uint32_t)sector * STAGING_SECTOR_WORDS);
+        uint16_t status = __disable_interrupts();
+
+        EALLOW;
+        ok = Fapi_issueAsyncCommandWithAddress(Fapi_EraseSector, address) == Fapi_Status_Success && fwFlashWait();
+        EDIS;
+        __restore_interrupts(status);
+
+        // Length in 32 bit words
+        ok = ok && Fapi_doBlankCheck(address, STAGING_SECTOR_WORDS / 2U, &check) == Fapi_Status_Success;
+    }
+    Flash_releasePumpSemaphore(FLASHPUMPSEMAPHORE_BASE);
+    return ok;
+}
+
+__attribute__((ramfunc))
+static bool fwFlashProgram(uint32_t Offset, const uint16_t *Data, uint16_t Words)
+{
+    Fapi_FlashStatusWordType check;
+    uint32_t buffer[PROGRAM_WORDS / 2U];
+    uint16_t *words = (uint16_t *)buffer;
+    bool ok = true;
+    uint16_t done;
+
+    if (Offset % PROGRAM_WORDS != 0U || Offset + Words > STAGING_WORDS || !fwFlashInit()) return false;
+
+    Flash_claimPumpSemaphore(FLASHPUMPSEMAPHORE_BASE, FLASH_CPU2_WRAPPER);
+    for (done = 0; ok && done < Words; done += PROGRAM_WORDS) {
+        uint32_t *address = (uint32_t *)(STAGING_START + Offset + done);
+        uint16_t status;
+        uint16_t i;
+
+        // The last block of an image is padded with erased words
+        for (i = 0; i < PROGRAM_WORDS; i++) {
+            words[i] = (done + i < Words) ? Data[done + i] : 0xFFFFU;
+        }
+
+        status = __disable_interrupts();
+        EALLOW;
+        ok = Fapi_issueProgrammingCommand(address, words, PROGRAM_WORDS, 0, 0, Fapi_AutoEccGeneration) ==
+             Fapi_Status_Success && fwFlashWait();
+        EDIS;
+        __restore_interrupts(status);
+
+        // Read back at the verify margins, length in 32 bit words
+        ok = ok && Fapi_doVerify(address, PROGRAM_WORDS / 2U, buffer, &check) == Fapi_Status_Success;
+    }
+    Flash_releasePumpSemaphore(FLASHPUMPSEMAPHORE_BASE);
+    return ok;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+
+/*** end of file ***/
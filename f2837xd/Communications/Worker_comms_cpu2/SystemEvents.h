@@ -34,6 +34,10 @@ extern "C" {
 
 void InnerLoop_Handler(void * args);
 
+void MailboxService_Handler(void * args);
+
+void FwService_Handler(void * args);
+
 
 
 #ifdef __cplusplus
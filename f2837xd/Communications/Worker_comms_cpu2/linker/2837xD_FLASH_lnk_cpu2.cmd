@@ -7,9 +7,7 @@ PAGE 0 :
    BEGIN           	: origin = 0x080000, length = 0x000002
    RAMM0           	: origin = 0x0000A2, length = 0x00035E
    RAMD0           	: origin = 0x00B000, length = 0x000800
-   RAMLS0          	: origin = 0x008000, length = 0x000800
-   RAMLS1          	: origin = 0x008800, length = 0x000800
-   RAMLS2      		: origin = 0x009000, length = 0x000800
+   RAMLS012        	: origin = 0x008000, length = 0x001800     /* RAM functions and the F021 flash API */
    RAMLS3      		: origin = 0x009800, length = 0x000800
    RAMLS4      		: origin = 0x00A000, length = 0x000800
    RAMGS14          : origin = 0x01A000, length = 0x001000     /* Only Available on F28379D, F28377D, F28375D devices. Remove line on other devices. */
@@ -26,6 +24,7 @@ PAGE 0 :
    FLASHD           : origin = 0x086000, length = 0x002000	/* on-chip Flash */
    FLASHE           : origin = 0x088000, length = 0x008000	/* on-chip Flash */
    FLASHF           : origin = 0x090000, length = 0x008000	/* on-chip Flash */
+   /* FLASHG to FLASHJ, 0x098000 to 0x0B7FFF: firmware update staging area (FwFlash.c), nothing is allocated there */
    FLASHG           : origin = 0x098000, length = 0x008000	/* on-chip Flash */
    FLASHH           : origin = 0x0A0000, length = 0x008000	/* on-chip Flash */
    FLASHI           : origin = 0x0A8000, length = 0x008000	/* on-chip Flash */
@@ -48,9 +47,12 @@ PAGE 1 :
 
    RAMGS0          : origin = 0x00C000, length = 0x001000
    RAMGS1          : origin = 0x00D000, length = 0x001000
-   RAMGS2          : origin = 0x00E000, length = 0x001000
-   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000400
-   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000400
+   CORELINK_PUB    : origin = 0x00E000, length = 0x000400     /* CoreLink publish slots, owned by CPU1 */
+   RAMGS2          : origin = 0x00E400, length = 0x000C00
+   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000380
+   CORELINK_DOWN   : origin = 0x03FB80, length = 0x000080     /* CoreLink descriptor, written by CPU2 */
+   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000380
+   CORELINK_UP     : origin = 0x03FF80, length = 0x000080     /* CoreLink status, written by CPU1 */
 }
 
 SECTIONS
@@ -92,8 +94,13 @@ SECTIONS
 #ifdef __TI_COMPILER_VERSION__
     #if __TI_COMPILER_VERSION__ >= 15009000
         #if defined(__TI_EABI__)
-            .TI.ramfunc : {} LOAD = FLASHD,
-                                 RUN = RAMLS0,
+            /* The F021 flash API runs from RAM along with the functions that call it */
+            GROUP
+            {
+                .TI.ramfunc
+                { -l F021_API_F2837xD_FPU32_EABI.lib }
+            }                    LOAD = FLASHD,
+                                 RUN = RAMLS012,
                                  LOAD_START(RamfuncsLoadStart),
                                  LOAD_SIZE(RamfuncsLoadSize),
                                  LOAD_END(RamfuncsLoadEnd),
@@ -102,8 +109,12 @@ SECTIONS
                                  RUN_END(RamfuncsRunEnd),
                                  PAGE = 0, ALIGN(8)
         #else
-            .TI.ramfunc : {} LOAD = FLASHD,
-                             RUN = RAMLS0,
+            GROUP
+            {
+                .TI.ramfunc
+                { -l F021_API_F2837xD_FPU32.lib }
+            }                LOAD = FLASHD,
+                             RUN = RAMLS012,
                              LOAD_START(_RamfuncsLoadStart),
                              LOAD_SIZE(_RamfuncsLoadSize),
                              LOAD_END(_RamfuncsLoadEnd),
@@ -114,7 +125,7 @@ SECTIONS
         #endif
     #else
    ramfuncs            : LOAD = FLASHD,
-                         RUN = RAMLS0,
+                         RUN = RAMLS012,
                          LOAD_START(_RamfuncsLoadStart),
                          LOAD_SIZE(_RamfuncsLoadSize),
                          LOAD_END(_RamfuncsLoadEnd),
@@ -125,6 +136,11 @@ SECTIONS
     #endif
 #endif
 
+   /* CoreLink data plane, see ring/CoreLink.h. CPU2 allocates what it writes, the rest is mapped only */
+   CoreLinkDown     : > CORELINK_DOWN,  PAGE = 1
+   CoreLinkUp       : > CORELINK_UP,    PAGE = 1, TYPE = DSECT
+   CoreLinkPublish  : > CORELINK_PUB,   PAGE = 1, TYPE = DSECT
+
    /* The following section definitions are required when using the IPC API Drivers */
     GROUP : > CPU2TOCPU1RAM, PAGE = 1
     {
@@ -5,10 +5,24 @@
 #include "Timers.h"
 #include "EventsEngine.h"
 #include "SystemEvents.h"
+#include "Timestamp.h"
 
 //#include "..\..\system\system.h"
 #include "system.h"
 #include "crc.h"
+#include "ClockSync.h"
+#include "CsCapture.h"
+#include "PhaseAlign.h"
+#include "CoreLink.h"
+#include "DeltaCodec.h"
+#include "Mailbox.h"
+#include "FwUpdate.h"
+#include "LinkStats.h"
+#include "Trace.h"
+#include "CommsWatchdog.h"
+#include "FrameIntegrity.h"
+#include "Realign.h"
+#include "AdcCapture.h"
 
 
 #ifndef WORKER_ID
@@ -21,17 +35,75 @@
 
 // Defines
 
-#define FIFO_LVL      8                     // FIFO Interrupt Level
 
+#define CARRIER_BASE            EPWM1_BASE
+#define CARRIER_TRIM_LATENCY    4       // TBCLK elapsed between sampling the carrier and the forced sync
+#define CARRIER_MEP_STEPS       66      // MEP steps per TBCLK, nominal 150 ps at 100 MHz. The TI SFO library
+                                        // calibrates it; what a wrong scale leaves of the skew, the phase step takes.
+
+// Pre-armed DMA mode. When set, both DMA channels are re-armed at the end of each frame and the TX FIFO is
+// preloaded, so the SPI FIFO triggers start the transfer as soon as the Director clocks, without waiting for
+// the CPU at CS falling. Otherwise the DMA channels are started from the XINT1 ISR at CS falling, and the
+// Director must leave at least csSetupMax between CS falling and the first SCLK edge.
+#ifndef WORKER_DMA_PREARM
+#define WORKER_DMA_PREARM 0
+#endif
+
+// Firmware update receiver (FwUpdate.h). It writes through fwFlash, on the F021 flash API to a staging area
+// of the CPU2 flash (FwFlash.c), on the host sim to a simulated one (sim/SimFlash.c). Without it bulk frames
+// are answered with an idle status.
+#ifndef WORKER_FW_UPDATE
+#define WORKER_FW_UPDATE 1
+#endif
+
+// Comms watchdog (CommsWatchdog.h): missed or invalid frames before the fail-safe path, what it does, for how
+// many frame periods before the trip, and valid frames that clear a trip (0: latched until reset)
+#ifndef WORKER_WD_FRAMES
+#define WORKER_WD_FRAMES        3
+#endif
+#ifndef WORKER_WD_POLICY
+#define WORKER_WD_POLICY        COMMS_WD_POLICY_RAMP
+#endif
+#ifndef WORKER_WD_POLICY_FRAMES
+#define WORKER_WD_POLICY_FRAMES 8
+#endif
+#ifndef WORKER_WD_REARM_FRAMES
+#define WORKER_WD_REARM_FRAMES  0
+#endif
+
+// Own measurement prepared this long before the CS falling edge expected from the frame period: latest results
+// of the algorithm core, encoding, CRC, and in pre-armed mode the TX FIFO preload. With ADC signals the hook
+// runs a carrier period earlier still, the samples are taken at the next carrier zero.
+#ifndef WORKER_PREPARE_LEAD_US
+#define WORKER_PREPARE_LEAD_US  20
+#endif
+
+#define WD_TIMER_BASE           CPUTIMER2_BASE  // Deadline timer of the watchdog, clocked by SYSCLK like the timestamps
+#define PREPARE_TIMER_BASE      CPUTIMER1_BASE  // Measurement prepare hook, same clock
+#if MEASUREMENT_ADC_WORDS > 0
+#define PREPARE_LEAD_TICKS      (US_TO_TIMESTAMP(WORKER_PREPARE_LEAD_US) + PWM_CARRIER_TICKS)
+#else
+#define PREPARE_LEAD_TICKS      US_TO_TIMESTAMP(WORKER_PREPARE_LEAD_US)
+#endif
+#define CARRIER_SAFE_COMPARE    PWM_TBPRD       // CMPA of the carrier at 0% duty
+
+// Delay between the Director launch timestamp and the CS falling edge timestamp on this worker
+#define CS_DETECT_DELAY_TICKS   US_TO_TIMESTAMP(1)  // Director DMA start to STE
+#define CS_HOP_DELAY_TICKS      4                   // CS propagation per ring position (20 ns)
+#define CS_PATH_DELAY_TICKS     (CS_DETECT_DELAY_TICKS + CS_HOP_DELAY_TICKS * (WORKER_ID + 1))
 
 
 
-#define DMA_TRANSFER_SIZE_TX ((MEM_BUFFER_SIZE - 1) / (16 - FIFO_LVL))
+
+#define DMA_TRANSFER_SIZE_TX (RING_CLOCKED_WORDS / (16 - FIFO_LVL))
 #define DMA_BURST_SIZE_TX (16 - FIFO_LVL)
 
-#define DMA_TRANSFER_SIZE_RX ((MEM_BUFFER_SIZE - 1) / FIFO_LVL)
+#define DMA_TRANSFER_SIZE_RX (RING_CLOCKED_WORDS / FIFO_LVL)
 #define DMA_BURST_SIZE_RX (FIFO_LVL)
 
+// A late image is realigned over the end of the own measurement chunk, which precedes the RX area
+typedef char realignSlipCheck[(REALIGN_MAX_SLIP < MEASUREMENT_CHUNK) ? 1 : -1];
+
 
 // DEBUG
 
@@ -41,44 +113,109 @@ SPI_RxFIFOLevel rxFifoStatus;
 SPI_TxFIFOLevel txFifoStatusEndFrame;
 SPI_RxFIFOLevel rxFifoStatusEndFrame;
 
-uint16_t nFalling = 0;
-uint16_t nRising = 0;
-uint16_t nFrames = 0;
+LinkStats_t linkStats;                  // Link health counters, sent to the Director once per second
+FrameIntegrity_t frameIntegrity;        // Classifies each frame at CS rising, recovers the channels after a bad one
+Realign_t realign;                      // Moves the RX DMA destination after a word slip upstream
+RealignChunk_t realignChunks[2 * NUM_WORKERS];  // Every chunk received: broadcast, setpoints, other measurements
+
+volatile uint16_t pendingTxComplete = 0;
+volatile uint16_t pendingRxComplete = 0;
+volatile uint16_t frameEnded = 0;       // CS has risen since the channels were last armed
 
-char interruptOrder[256];
-uint16_t order_idx = 0;
+uint32_t csSetupMax = 0;                // Longest CS falling to DMA start delay seen, in ticks (ISR mode only)
 
-uint16_t pendingTxComplete = 0;
-uint16_t pendingRxComplete = 0;
+volatile uint16_t prepared = 1;         // Own measurement of the next frame is ready, the channels may be armed
+uint16_t measurementDue = 0;            // The last frame carried our setpoint, a fresh measurement answers it
+uint16_t imageOpen = 1;                 // The algorithm core holds the ring image, closed before it is rewritten
+Timestamp_t preparedAt;                 // Time the own measurement was last prepared
+uint32_t measurementAge = 0;            // Preparation to CS falling edge of the last frame, in ticks
+uint32_t measurementAgeMax = 0;
+uint16_t prepareLate = 0;               // Frames that started before their prepare hook ran
+volatile uint16_t sampling = 0;         // ADC words of the own measurement awaited from the DMA (AdcCapture.h)
+Timestamp_t sampledAt;                  // Sampling instant of the own measurement payload
 
 Timer_t InnerLoop;
+Timer_t MailboxService;
+Timer_t FwService;
+
+CommsWatchdog_t watchdog;               // Fail-safe path when the Director stops clocking
+uint16_t heldCompare;                   // Carrier CMPA when the watchdog ramp started
+bool compareHeld = false;               // heldCompare is to be restored when the watchdog resumes
 
 
 
 
 #pragma DATA_SECTION(mem_buffer, "SHARERAMGS1");  // map the RX data to memory
 
-volatile uint16_t mem_buffer[MEM_BUFFER_SIZE];
+volatile uint16_t mem_buffer[MEM_BUFFER_SIZE + REALIGN_MAX_SLIP];     // Slack for an early image, see Realign.h
 
+volatile Frame * broadcast = NULL;     // Shared references, NULL without broadcast chunk
 volatile Frame * setpoints[NUM_WORKERS];
 volatile Frame * measurements[NUM_WORKERS];
 
+#if MEASUREMENT_DELTA
+// Raw own measurement payload as published by CPU1 (CH4 only reaches GS RAM), delta encoded into the own chunk.
+// The measurements of the other workers are read encoded, only the Director decodes them.
+#pragma DATA_SECTION(measurementRaw, "SHARERAMGS1");
+volatile Frame measurementRaw;
+DeltaEncoder_t deltaEncoder;
+#endif
+
+#if MAILBOX_WORDS > 0
+Mailbox_t mailbox;                      // Slow channel to the Director, in the own setpoint and measurement
+#endif
+
+// Firmware images distributed by the Director, see WORKER_FW_UPDATE
+#if WORKER_FW_UPDATE
+extern const FwFlash_t fwFlash;
+#endif
+FwReceiver_t fwReceiver;
+
 volatile uint16_t * currRxBuffer;
 volatile uint16_t * nextRxBuffer;
 
 volatile uint16_t * currTxBuffer;
 volatile uint16_t * nextTxBuffer;
 
+volatile Timestamp_t csFallTime;        // Local timestamp of the CS falling edge of the current frame
+Timestamp_t prevFallTime;               // CS falling edge timestamp of the previous valid frame
+uint16_t prevFrameToken;                // Token of the previous valid frame
+bool prevValid = false;                 // prevFallTime and prevFrameToken were taken from a valid frame
+
 volatile uint16_t txPacketCount = 0;
 volatile uint16_t rxPacketCount = 0;
 
 void initSPIASlave(void);
+void initCarrier(void);
+static int16_t alignCarrier(uint32_t refTime, uint16_t phase);
+#if WORKER_DMA_PREARM
+static void armNextFrame(void);
+static void armWhenReady(void);
+#endif
+static void closeImage(void);
+static bool chunkValid(volatile Frame *Chunk, uint16_t Words, crc_t Crc);
+static void prepareMeasurement(void);
+static void finishMeasurement(void);
+static void scheduleTimer(uint32_t Base, Timestamp_t Time);
+static void watchdogSchedule(Timestamp_t Time);
+static void watchdogRamp(uint16_t Step, uint16_t Steps);
+static void watchdogTrip(void);
+static void watchdogResume(void);
+static void traceWatchdog(uint16_t PrevState);
+
+static const CommsWatchdogOutput_t watchdogOutput = { watchdogSchedule, watchdogRamp, watchdogTrip, watchdogResume };
 
 __interrupt void dmaCh5ISR(void);
 __interrupt void dmaCh6ISR(void);
+#if MEASUREMENT_ADC_WORDS > 0
+__interrupt void adcDmaISR(void);
+#endif
 
 
 __interrupt void spiCSISR(void);
+__interrupt void ecapCSISR(void);
+__interrupt void cpuTimer1ISR(void);
+__interrupt void cpuTimer2ISR(void);
 
 
 //uint16_t* selectNextTxBuffer(void);
@@ -106,8 +243,8 @@ void main(void)
      Device_init();
 
 //
-    currRxBuffer = mem_buffer + CHUNK_SIZE;
-    nextRxBuffer = mem_buffer + CHUNK_SIZE;
+    currRxBuffer = mem_buffer + MEASUREMENT_CHUNK;
+    nextRxBuffer = mem_buffer + MEASUREMENT_CHUNK;
 
     currTxBuffer = mem_buffer;
     nextTxBuffer = mem_buffer;
@@ -115,21 +252,42 @@ void main(void)
 
     // Compute pointers to chunks of memory, depending on own WORKER_ID
     int worker;
+#if BROADCAST_CHUNK > 0
+    broadcast = (Frame *)(mem_buffer + WORKER_BROADCAST_OFFSET(WORKER_ID));
+#endif
     for (worker = 0; worker < NUM_WORKERS; worker++) {
-        setpoints[worker] = (Frame *)(mem_buffer + (NUM_WORKERS - 1 - worker + (WORKER_ID + 1)) * CHUNK_SIZE);
-        measurements[worker] = (Frame*)(mem_buffer + ((2 * NUM_WORKERS - 1 - worker + (WORKER_ID + 1)) % (2 * NUM_WORKERS)) * CHUNK_SIZE);
+        setpoints[worker] = (Frame *)(mem_buffer + WORKER_SETPOINT_OFFSET(WORKER_ID, worker));
+        measurements[worker] = (Frame*)(mem_buffer + WORKER_MEASUREMENT_OFFSET(WORKER_ID, worker));
 
     }
 
     // Populate some dummy values
     uint16_t i;
-    for (i = 0; i < CHUNK_SIZE; i++) {
+    for (i = 0; i < MEASUREMENT_CHUNK; i++) {
         mem_buffer[i] = (100 + WORKER_ID) * 100 + i;
     }
+    measurements[WORKER_ID]->hdr.sync = FRAME_SYNC;
+
+#if MAILBOX_WORDS > 0
+    Mailbox_Init(&mailbox);
+    Mailbox_Transmit(&mailbox, measurements[WORKER_ID]->data + MEASUREMENT_MAILBOX_OFFSET);
+#endif
 
     // Initialize CRC LUT
     crcInit();
 
+#if WORKER_FW_UPDATE
+    FwUpdate_InitReceiver(&fwReceiver, &fwFlash);
+#else
+    FwUpdate_InitReceiver(&fwReceiver, NULL);
+#endif
+    LinkStats_Init(&linkStats);
+    Trace_Init(WORKER_ID, 2);
+
+    initCarrier();
+
+    ClockSync_Init(CS_PATH_DELAY_TICKS);
+
     // Initialize GPIO and configure the GPIO pin as a push-pull output
     // This is configured by CPU1
 
@@ -172,7 +330,7 @@ void main(void)
 
         // configure DMA CH6 for RX
 
-        DMA_configAddresses(DMA_CH6_BASE, (const void *)mem_buffer + CHUNK_SIZE, (const void *)(SPIA_BASE + SPI_O_RXBUF));
+        DMA_configAddresses(DMA_CH6_BASE, (const void *)(mem_buffer + MEASUREMENT_CHUNK), (const void *)(SPIA_BASE + SPI_O_RXBUF));
         DMA_configBurst(DMA_CH6_BASE,DMA_BURST_SIZE_RX,0,1);
         DMA_configTransfer(DMA_CH6_BASE,DMA_TRANSFER_SIZE_RX,0,1);
         DMA_configMode(DMA_CH6_BASE,    DMA_TRIGGER_SPIARX, 
@@ -185,7 +343,43 @@ void main(void)
         DMA_enableInterrupt(DMA_CH6_BASE);
         DMA_disableOverrunInterrupt(DMA_CH6_BASE);
 
-        
+        // CH4 moves the measurement payload published by CPU1 into the own chunk, or into the raw copy to encode
+#if MEASUREMENT_DELTA
+        volatile Frame * linked[NUM_WORKERS];
+        for (worker = 0; worker < NUM_WORKERS; worker++) {
+            linked[worker] = measurements[worker];
+        }
+        linked[WORKER_ID] = &measurementRaw;
+        DeltaCodec_InitEncoder(&deltaEncoder);
+        CoreLink_Init(broadcast, setpoints, linked, WORKER_ID);
+        AdcCapture_Init(CARRIER_BASE, measurementRaw.data);
+#else
+        CoreLink_Init(broadcast, setpoints, measurements, WORKER_ID);
+        AdcCapture_Init(CARRIER_BASE, measurements[WORKER_ID]->data);
+#endif
+
+        FrameIntegrity_Init(&frameIntegrity, &linkStats, DMA_CH5_BASE, DMA_CH6_BASE, SPIA_BASE, SPIA_BASE,
+                            DMA_BURST_SIZE_RX, RING_CLOCKED_WORDS);
+
+        // A late image is received over the end of the own measurement, which fails at the Director until the
+        // ring is back in step. An early one spills into the slack.
+        uint16_t chunks = 0;
+#if BROADCAST_CHUNK > 0
+        realignChunks[chunks].Offset = WORKER_BROADCAST_OFFSET(WORKER_ID);
+        realignChunks[chunks].Words = BROADCAST_CHUNK;
+        realignChunks[chunks++].Key = 0;
+#endif
+        for (worker = 0; worker < NUM_WORKERS; worker++) {
+            realignChunks[chunks].Offset = WORKER_SETPOINT_OFFSET(WORKER_ID, worker);
+            realignChunks[chunks].Words = SETPOINT_CHUNK;
+            realignChunks[chunks++].Key = CHUNK_KEY(worker);
+            if (worker == WORKER_ID) continue;
+            realignChunks[chunks].Offset = WORKER_MEASUREMENT_OFFSET(WORKER_ID, worker);
+            realignChunks[chunks].Words = MEASUREMENT_CHUNK;
+            realignChunks[chunks++].Key = CHUNK_KEY(worker);
+        }
+        Realign_Init(&realign, &linkStats, mem_buffer, MEM_BUFFER_SIZE + REALIGN_MAX_SLIP, realignChunks, chunks,
+                     -REALIGN_MAX_SLIP, REALIGN_MAX_SLIP);
 
         // Ensure DMA is connected to Peripheral Frame 2 bridge (EALLOW protected)
         SysCtl_selectSecMaster(SYSCTL_SEC_MASTER_DMA, SYSCTL_SEC_MASTER_DMA);
@@ -203,17 +397,52 @@ void main(void)
         Interrupt_register(INT_DMA_CH5, &dmaCh5ISR);
         Interrupt_register(INT_DMA_CH6, &dmaCh6ISR);
 
-//        DMA_startChannel(DMA_CH5_BASE);
-//        DMA_startChannel(DMA_CH6_BASE);
+#if MEASUREMENT_ADC_WORDS > 0
+        Interrupt_register(ADC_CAPTURE_INT, &adcDmaISR);
+        Interrupt_enable(ADC_CAPTURE_INT);
+#endif
+
+#if WORKER_DMA_PREARM
+        armNextFrame();
+#endif
     }
 
-    GPIO_setInterruptType(GPIO_INT_XINT1, GPIO_INT_TYPE_BOTH_EDGES);
+    // CS falling edge opens the frame (and starts the DMA unless pre-armed), CS rising edge is timestamped and
+    // reported by ECAP1
+    GPIO_setInterruptType(GPIO_INT_XINT1, GPIO_INT_TYPE_FALLING_EDGE);
 
     GPIO_enableInterrupt(GPIO_INT_XINT1);
 
     Interrupt_register(INT_XINT1, &spiCSISR);
     Interrupt_enable(INT_XINT1);
 
+    CsCapture_Init();
+
+    Interrupt_register(CS_CAPTURE_INT, &ecapCSISR);
+    Interrupt_enable(CS_CAPTURE_INT);
+
+    // Watchdog deadline timer, stopped until the frame period is learned. CPU timer 2 is a direct CPU interrupt
+    // (INT14), without PIE acknowledge.
+    CommsWatchdog_Init(&watchdog, &watchdogOutput, WORKER_WD_POLICY, WORKER_WD_FRAMES, WORKER_WD_POLICY_FRAMES,
+                       WORKER_WD_REARM_FRAMES);
+    CPUTimer_stopTimer(WD_TIMER_BASE);
+    CPUTimer_setPreScaler(WD_TIMER_BASE, 0);
+    CPUTimer_setEmulationMode(WD_TIMER_BASE, CPUTIMER_EMULATIONMODE_STOPAFTERNEXTDECREMENT);
+    CPUTimer_clearOverflowFlag(WD_TIMER_BASE);
+    CPUTimer_enableInterrupt(WD_TIMER_BASE);
+    Interrupt_register(INT_TIMER2, &cpuTimer2ISR);
+    Interrupt_enable(INT_TIMER2);
+
+    // Measurement prepare hook, scheduled every frame once the watchdog has learned the frame period. CPU timer 1
+    // is a direct CPU interrupt as well (INT13).
+    CPUTimer_stopTimer(PREPARE_TIMER_BASE);
+    CPUTimer_setPreScaler(PREPARE_TIMER_BASE, 0);
+    CPUTimer_setEmulationMode(PREPARE_TIMER_BASE, CPUTIMER_EMULATIONMODE_STOPAFTERNEXTDECREMENT);
+    CPUTimer_clearOverflowFlag(PREPARE_TIMER_BASE);
+    CPUTimer_enableInterrupt(PREPARE_TIMER_BASE);
+    Interrupt_register(INT_TIMER1, &cpuTimer1ISR);
+    Interrupt_enable(INT_TIMER1);
+
 
     // Enable Global Interrupt (INTM) and realtime interrupt (DBGM)
     EINT;
@@ -222,6 +451,16 @@ void main(void)
     TimerInit(&InnerLoop, InnerLoop_Handler, 0);    // initializing timer and timer handler
     TimerStart(&InnerLoop, SECONDS_TO_TICKS(0.5f));      // Start timer
 
+#if MAILBOX_WORDS > 0
+    TimerInit(&MailboxService, MailboxService_Handler, 0);
+    TimerStart(&MailboxService, SECONDS_TO_TICKS(0.01f));
+#endif
+
+#if WORKER_FW_UPDATE
+    TimerInit(&FwService, FwService_Handler, 0);
+    TimerStart(&FwService, SECONDS_TO_TICKS(0.001f));
+#endif
+
 
     txFifoStatus = SPI_getTxFIFOStatus(SPIA_BASE);
     rxFifoStatus = SPI_getRxFIFOStatus(SPIA_BASE);
@@ -234,10 +473,39 @@ void main(void)
 void InnerLoop_Handler(void * args) {
     GPIO_togglePin(DEVICE_GPIO_PIN_LED2);
 
-    // compute CRC for own data, save in first word
-//    mem_buffer[0] = crcFast((mem_buffer + 1), (CHUNK_SIZE - 1));
+    TimerRestart((Timer_t *)args);
+}
 
-    measurements[WORKER_ID]->hdr.crc = crcFast(AFTER_CRC(measurements[WORKER_ID]), sizeof(Frame) - sizeof(crc_t));
+// Mailbox requests from the Director. A request is only taken once the reply can be queued, the Director
+// sees the mailbox busy meanwhile. The link statistics go out once per second, between replies.
+void MailboxService_Handler(void * args) {
+#if MAILBOX_WORDS > 0
+    static MailboxMessage_t request;
+    static uint16_t ticks = 0;
+    static uint16_t stats[LINK_STATS_WORDS];
+
+    if (!mailbox.TxBusy && Mailbox_Take(&mailbox, &request)) {
+        if (request.Type == MAILBOX_TYPE_ECHO) {
+            Mailbox_Send(&mailbox, MAILBOX_TYPE_ECHO, request.Data, request.Length);
+        }
+    }
+
+    if (ticks < 100) ticks++;
+    if (ticks >= 100 && !mailbox.TxBusy) {
+        LinkStats_Pack(&linkStats, stats);
+        Mailbox_Send(&mailbox, MAILBOX_TYPE_LINK_STATS, stats, LINK_STATS_WORDS);
+        ticks = 0;
+    }
+#endif
+
+    TimerRestart((Timer_t *)args);
+}
+
+// Erases the staging area and writes the firmware segments received, blocking in the flash operations
+void FwService_Handler(void * args) {
+#if WORKER_FW_UPDATE
+    FwUpdate_Service(&fwReceiver);
+#endif
 
     TimerRestart((Timer_t *)args);
 }
@@ -249,7 +517,7 @@ void initSPIASlave(void)
     SPI_disableModule(SPIA_BASE);
 
     // SPI configuration. Use a 500kHz SPICLK and 16-bit word size.
-    SPI_setConfig(SPIA_BASE, DEVICE_LSPCLK_FREQ, SPI_PROT_POL0PHA0, SPI_MODE_SLAVE,  DEVICE_LSPCLK_FREQ / 128, 16);
+    SPI_setConfig(SPIA_BASE, SYSTEM_LSPCLK_FREQ, SPI_PROT_POL0PHA0, SPI_MODE_SLAVE,  RING_SPI_BIT_RATE, 16);
 //    SPI_enableHighSpeedMode(SPIA_BASE);
     SPI_disableLoopback(SPIA_BASE);
     SPI_setEmulationMode(SPIA_BASE, SPI_EMULATION_FREE_RUN);
@@ -271,6 +539,77 @@ void initSPIASlave(void)
 
 
 
+// Configure the converter PWM carrier: up-down count, phase loadable by a software sync pulse
+void initCarrier(void)
+{
+    SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
+
+    EPWM_setClockPrescaler(CARRIER_BASE, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_1);
+    EPWM_setTimeBasePeriod(CARRIER_BASE, PWM_TBPRD);
+    EPWM_setTimeBaseCounter(CARRIER_BASE, 0);
+    EPWM_setTimeBaseCounterMode(CARRIER_BASE, EPWM_COUNTER_MODE_UP_DOWN);
+    EPWM_setPhaseShift(CARRIER_BASE, 0);
+    EPWM_enablePhaseShiftLoad(CARRIER_BASE);
+    EPWM_setSyncOutPulseMode(CARRIER_BASE, EPWM_SYNC_OUT_PULSE_DISABLED);
+    EPWM_setEmulationMode(CARRIER_BASE, EPWM_EMULATION_FREE_RUN);
+
+    // High-resolution period, for the frequency trim of alignCarrier(). Nominal until the clock is locked.
+    HRPWM_setMEPEdgeSelect(CARRIER_BASE, HRPWM_CHANNEL_A, HRPWM_MEP_CTRL_RISING_AND_FALLING_EDGE);
+    HRPWM_setMEPControlMode(CARRIER_BASE, HRPWM_CHANNEL_A, HRPWM_MEP_DUTY_PERIOD_CTRL);
+    HRPWM_setMEPStep(CARRIER_BASE, CARRIER_MEP_STEPS);
+    HRPWM_enableAutoConversion(CARRIER_BASE);
+    HRPWM_setTimeBasePeriod(CARRIER_BASE, (uint32_t)PWM_TBPRD << PWM_TBPRD_HR_BITS);
+    HRPWM_enablePeriodControl(CARRIER_BASE);
+
+    // 50% duty on EPWM1A until the control algorithm drives it
+    EPWM_setCounterCompareValue(CARRIER_BASE, EPWM_COUNTER_COMPARE_A, PWM_TBPRD / 2);
+    EPWM_setActionQualifierAction(CARRIER_BASE, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_HIGH, EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA);
+    EPWM_setActionQualifierAction(CARRIER_BASE, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_LOW, EPWM_AQ_OUTPUT_ON_TIMEBASE_DOWN_CMPA);
+
+    // Watchdog trip: a forced one-shot trip holds EPWM1A low until the flag is cleared
+    EPWM_setTripZoneAction(CARRIER_BASE, EPWM_TZ_ACTION_EVENT_TZA, EPWM_TZ_ACTION_LOW);
+    EPWM_clearTripZoneFlag(CARRIER_BASE, EPWM_TZ_INTERRUPT | EPWM_TZ_FLAG_OST);
+
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
+}
+
+// Measures the carrier phase error against the Director reference and, once the cluster time is locked, runs
+// the carrier at the cluster rate and trims the time-base by at most PHASE_MAX_STEP_TBCLK. Returns the error
+// measured before the trim.
+static int16_t alignCarrier(uint32_t refTime, uint16_t phase)
+{
+    uint16_t counter = EPWM_getTimeBaseCounterValue(CARRIER_BASE);
+    uint16_t countingUp = (EPWM_getTimeBaseCounterDirection(CARRIER_BASE) == EPWM_TIME_BASE_STATUS_COUNT_UP);
+    uint32_t now = ClockSync_ToCluster(Timestamp_now());
+
+    // Position in the full up-down period
+    uint16_t position = countingUp ? counter : (PWM_CARRIER_TBCLK - counter);
+    int16_t error = PhaseAlign_Error(refTime, phase, now, position);
+
+    if (!ClockSync_IsLocked()) return error;
+
+    HRPWM_setTimeBasePeriod(CARRIER_BASE, PhaseAlign_Period(ClockSync_Rate(), CLOCKSYNC_RATE_SHIFT));
+
+    int16_t step = PhaseAlign_Step(error);
+    if (step == 0) return error;
+
+    int32_t target = (int32_t)position - step + CARRIER_TRIM_LATENCY;
+    if (target < 0) target += PWM_CARRIER_TBCLK;
+    if (target >= (int32_t)PWM_CARRIER_TBCLK) target -= PWM_CARRIER_TBCLK;
+
+    // Load the trimmed position with the matching count direction
+    if (target < (int32_t)PWM_TBPRD) {
+        EPWM_setPhaseShift(CARRIER_BASE, (uint16_t)target);
+        EPWM_setCountModeAfterSync(CARRIER_BASE, EPWM_COUNT_MODE_UP_AFTER_SYNC);
+    } else {
+        EPWM_setPhaseShift(CARRIER_BASE, (uint16_t)(PWM_CARRIER_TBCLK - target));
+        EPWM_setCountModeAfterSync(CARRIER_BASE, EPWM_COUNT_MODE_DOWN_AFTER_SYNC);
+    }
+    EPWM_forceSyncPulse(CARRIER_BASE);
+
+    return error;
+}
+
 // TX Interrupt
 // Interrupts when Transfer from RAM to SPI TX FIFO completes
 
@@ -279,7 +618,8 @@ __interrupt void dmaCh5ISR(void) {
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
     EDIS;
 
-    interruptOrder[order_idx++] = 't';if (order_idx > 255) order_idx = 0;
+    linkStats.FramesSent++;
+    Trace_Event(TRACE_EV_TX_DONE, 0, 0);
     pendingTxComplete = 0;
 
 //    SPI_clearInterruptStatus(SPIA_BASE, SPI_INT_TXFF);
@@ -302,44 +642,155 @@ __interrupt void dmaCh5ISR(void) {
 // RX Interrupt
 // Interrupts when Transfer from SPI RX FIFO to RAM completes
 __interrupt void dmaCh6ISR(void) {
+    Timestamp_t entry = Timestamp_now();
 
     EALLOW;
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
     EDIS;
 
-    interruptOrder[order_idx++] = 'r';if (order_idx > 255) order_idx = 0;
+    linkStats.FramesReceived++;
     pendingRxComplete = 0;
 
+    // ECAP1 CAP1 still holds the falling edge of this frame
+    csFallTime = CsCapture_LastFall();
+
+    // Firmware bulk frame: no control data, the own measurement chunk answers with the update status instead.
+    // Frame token and time are left alone, so clock sync pairs the surrounding control frames.
+    volatile uint16_t * bulk = mem_buffer + WORKER_IMAGE_OFFSET(WORKER_ID, 0);
+    if (FwUpdate_IsBulk(bulk)) {
+        linkStats.BulkFrames++;
+        Trace_Event(TRACE_EV_BULK, 0, 0);
+#if WORKER_FW_UPDATE
+        FwUpdate_ReceiveBulk(&fwReceiver, bulk);
+#endif
+        FwUpdate_WriteStatus(&fwReceiver, measurements[WORKER_ID], WORKER_ID);
+        measurementDue = 0;
+        prepared = 1;
+
+        // The Director is alive, the setpoints of the previous frame stay current
+        uint16_t state = watchdog.State;
+        CommsWatchdog_Frame(&watchdog, true, csFallTime);
+        traceWatchdog(state);
+
+        // Keeps the exchange with the algorithm core paired, nothing new for it in this frame
+        CoreLink_Ready(prevFrameToken, false, 0, 0);
+        imageOpen = 1;
+#if WORKER_DMA_PREARM
+        armWhenReady();
+#endif
+        return;
+    }
+
     crc_t crc_check;
+    bool broadcastValid = true;
+    uint16_t setpointsValid = 0;
+    uint16_t measurementsValid = 1U << WORKER_ID;
 
     int i;
 
+    // Words lost upstream in the middle of the frame, the chunks behind the slip are not taken
+    Realign_Check(&realign);
+
+#if BROADCAST_CHUNK > 0
+    // Shared references, read in transit. Only usable along with the own setpoint of the same frame.
+    broadcastValid = chunkValid(broadcast, BROADCAST_CHUNK, BROADCAST_CRC(broadcast));
+    if (!broadcastValid) linkStats.BroadcastCrcErrors++;
+#endif
+
     // CHeck all received CRCs
     for (i = 0; i < NUM_WORKERS; i++) {
         // Recompute CRC
-        crc_check = crcFast(AFTER_CRC(setpoints[i]), sizeof(Frame) - sizeof(crc_t));
+        crc_check = SETPOINT_CRC(setpoints[i], i);
 
         // Check agaist recieved CRC
-        if (crc_check != setpoints[i]->hdr.crc) {
-            interruptOrder[order_idx++] = 'C';if (order_idx > 255) order_idx = 0;
-            interruptOrder[order_idx++] = 'S';if (order_idx > 255) order_idx = 0;
-            interruptOrder[order_idx++] = '0' + i;if (order_idx > 255) order_idx = 0;
+        if (!chunkValid(setpoints[i], SETPOINT_CHUNK, crc_check)) {
+            linkStats.SetpointCrcErrors[i]++;
+        } else {
+            setpointsValid |= 1U << i;
+        }
+
+        if (i == WORKER_ID && (setpointsValid & (1U << i))) {
+            uint16_t token = setpoints[WORKER_ID]->hdr.token;
+
+            // The setpoint carries the Director launch time of the previous frame, pair it with our own
+            // timestamp of that frame only if no frame was missed in between, and only if the Director did launch
+            // one before
+            if (prevValid && token == (uint16_t)(prevFrameToken + 1) &&
+                setpoints[WORKER_ID]->hdr.time != FRAME_TIME_NONE) {
+                ClockSync_Update(setpoints[WORKER_ID]->hdr.time, prevFallTime);
+            }
+            // Cluster time offset, from time to time, puts this node on the Director timeline of the trace
+            if ((token & (TRACE_CLOCK_FRAMES - 1U)) == 0) {
+                uint32_t offset = ClockSync_ToCluster(csFallTime) - csFallTime;
+                Trace_Event(TRACE_EV_CLOCK, (uint16_t)offset, (uint16_t)(offset >> 16));
+            }
+            prevFrameToken = token;
+            prevFallTime = csFallTime;
+            prevValid = true;
+
+#if MAILBOX_WORDS > 0
+            Mailbox_Receive(&mailbox, setpoints[WORKER_ID]->data + SETPOINT_MAILBOX_OFFSET);
+#endif
+
+            // Echo the cycle token of our setpoint so the Director can measure the loop latency, along with
+            // our cluster time estimate of its launch: the CS falling edge less the path delay, so the Director
+            // reads the sync error straight off it. Own measurement is only shifted out at the start of the
+            // next frame, its payload and CRC are prepared below.
+            measurements[WORKER_ID]->hdr.token = token;
+            measurements[WORKER_ID]->hdr.time = ClockSync_ToCluster(csFallTime) - CS_PATH_DELAY_TICKS;
+
+            // Frame end is the common cycle boundary at which every worker trims its carrier phase
+            measurements[WORKER_ID]->hdr.phase = (uint16_t)alignCarrier(setpoints[WORKER_ID]->hdr.time, setpoints[WORKER_ID]->hdr.phase);
+            measurementDue = 1;
         }
 
         if (i == WORKER_ID) continue;
 
-        crc_check = crcFast(AFTER_CRC(measurements[i]), sizeof(Frame) - sizeof(crc_t));
+        crc_check = MEASUREMENT_CRC(measurements[i], i);
         // Check agaist recieved CRC
-        if (crc_check != measurements[i]->hdr.crc) {
-            interruptOrder[order_idx++] = 'C';if (order_idx > 255) order_idx = 0;
-            interruptOrder[order_idx++] = 'M';if (order_idx > 255) order_idx = 0;
-            interruptOrder[order_idx++] = '0' + i;if (order_idx > 255) order_idx = 0;
+        if (!chunkValid(measurements[i], MEASUREMENT_CHUNK, crc_check)) {
+            linkStats.MeasurementCrcErrors[i]++;
+        } else {
+            measurementsValid |= 1U << i;
         }
+    }
 
+    Trace_Event(TRACE_EV_RX_DONE, setpointsValid, measurementsValid);
 
+    // Nothing received passes its CRC: the image may have slipped by a few words upstream. The next frame is
+    // received where the chunks were found, the channel is not running until the next CS falling edge or re-arm.
+    // Clock sync starts pairing again from the first frame taken after that.
+    bool received = (setpointsValid != 0) || (measurementsValid != (1U << WORKER_ID));
+#if BROADCAST_CHUNK > 0
+    received = received || broadcastValid;
+#endif
+    if (!received && Realign_Search(&realign)) {
+        DMA_configAddresses(DMA_CH6_BASE, (const void *)(mem_buffer + MEASUREMENT_CHUNK + realign.Shift),
+                            (const void *)(SPIA_BASE + SPI_O_RXBUF));
+        prevValid = false;
+    }
 
+    // Hand the frame over to the algorithm core, read in place until the next CS falling edge
+#if BROADCAST_CHUNK > 0
+    if (broadcast->hdr.token != setpoints[WORKER_ID]->hdr.token) broadcastValid = false;
+#endif
+    uint16_t state = watchdog.State;
+    CommsWatchdog_Frame(&watchdog, broadcastValid && (setpointsValid & (1U << WORKER_ID)), csFallTime);
+    traceWatchdog(state);
+
+    // Own measurement of the next frame: prepared just before the next CS falling edge once the frame period is
+    // known, so it carries the results the algorithm core computes from this frame. Until then, right away.
+    Timestamp_t prepareAt = csFallTime + watchdog.Period - PREPARE_LEAD_TICKS;
+    if (watchdog.Learned >= COMMS_WD_LEARN_FRAMES && (int32_t)(prepareAt - Timestamp_now()) > 0) {
+        prepared = 0;
+        scheduleTimer(PREPARE_TIMER_BASE, prepareAt);
+    } else {
+        prepareMeasurement();
     }
 
+    CoreLink_Ready(setpoints[WORKER_ID]->hdr.token, broadcastValid, setpointsValid, measurementsValid);
+    imageOpen = 1;
+
     // Update DMA RX Destination
 
 //    currRxBuffer = nextRxBuffer;
@@ -347,87 +798,277 @@ __interrupt void dmaCh6ISR(void) {
 //
 //    DMA_configAddresses(DMA_CH6_BASE, (const void *)nextRxBuffer, (const void *)(SPIA_BASE + SPI_O_RXBUF));
 
+#if WORKER_DMA_PREARM
+    // Own measurement is up to date, preload it for the next frame if CS already rose
+    armWhenReady();
+#endif
 
+    LinkStats_RxIsr(&linkStats, Timestamp_now() - entry);
 }
 
+#if WORKER_DMA_PREARM
+// Starts both channels for the next frame. The TX DMA fills the TX FIFO immediately with the start of the own
+// measurement chunk, the RX DMA waits for the RX FIFO trigger.
+static void armNextFrame(void) {
+    frameEnded = 0;
+    pendingTxComplete = 1;
+    pendingRxComplete = 1;
 
-uint16_t txPacketEnd;
-uint16_t rxPacketEnd;
+    SPI_resetTxFIFO(SPIA_BASE);
+    SPI_resetRxFIFO(SPIA_BASE);
 
-uint16_t txPacketStart;
-uint16_t rxPacketStart;
+    DMA_startChannel(DMA_CH5_BASE);
+    DMA_startChannel(DMA_CH6_BASE);
+}
 
+// Arms the channels once the frame is over and the own measurement of the next one is prepared
+static void armWhenReady(void) {
+    if (frameEnded && prepared && !pendingTxComplete && !pendingRxComplete) {
+        armNextFrame();
+    }
+}
+#endif
 
-__interrupt void spiCSISR(void) {
+// A received chunk is taken if it is in place, in front of any slip in the frame, and passes its CRC
+static bool chunkValid(volatile Frame *Chunk, uint16_t Words, crc_t Crc) {
+    return CHUNK_IN_PLACE(Chunk) && Realign_InStep(&realign, (volatile const uint16_t *)Chunk, Words) &&
+           Crc == Chunk->hdr.crc;
+}
 
-    static int lastEdge = 1;
+// Ends the lease of the algorithm core on the ring image, once per frame
+static void closeImage(void) {
+    if (imageOpen) {
+        imageOpen = 0;
+        CoreLink_Close();
+    }
+}
 
-    // If Pin is low (FALLING EDGE)
-    if (GPIO_readPin(22) == 0) {
-        if (lastEdge == 1) { // Debouncing
-            lastEdge = 0;
+// Latest measurement payload from the algorithm core, if any, then the ADC words sampled at the next carrier
+// zero: the ADC DMA interrupt finishes the measurement. Left alone if the last frame did not carry our setpoint,
+// the measurement echoes its token.
+static void prepareMeasurement(void) {
+    closeImage();
+    if (!measurementDue) {
+        preparedAt = Timestamp_now();
+        prepared = 1;
+        return;
+    }
+    measurementDue = 0;
+    CoreLink_TakePublished();
+#if MEASUREMENT_ADC_WORDS > 0
+    sampling = 1;
+    AdcCapture_Start();
+#else
+    sampledAt = Timestamp_now();
+    finishMeasurement();
+#endif
+}
 
-            nFalling++;
-            interruptOrder[order_idx++] = '\\';if (order_idx > 255) order_idx = 0;
+// Encodes the own measurement and closes it with its sampling instant and CRC
+static void finishMeasurement(void) {
+    measurements[WORKER_ID]->hdr.sample = ClockSync_ToCluster(sampledAt);
+#if MEASUREMENT_DELTA
+    // Encoded every frame, unchanged words still advance the refresh slice
+    DeltaCodec_Encode(&deltaEncoder, measurementRaw.data, measurements[WORKER_ID]->data);
+#endif
+#if MAILBOX_WORDS > 0
+    Mailbox_Transmit(&mailbox, measurements[WORKER_ID]->data + MEASUREMENT_MAILBOX_OFFSET);
+#endif
+    measurements[WORKER_ID]->hdr.crc = MEASUREMENT_CRC(measurements[WORKER_ID], WORKER_ID);
+    preparedAt = Timestamp_now();
+    prepared = 1;
+}
 
-            txPacketStart = txPacketCount;
-            rxPacketStart = rxPacketCount;
+// Raises the interrupt of a CPU timer at Time. The timer interrupts PRD + 1 ticks after the reload.
+static void scheduleTimer(uint32_t Base, Timestamp_t Time) {
+    int32_t ticks = (int32_t)(Time - Timestamp_now());
 
-            if (pendingTxComplete || pendingRxComplete) {
-                interruptOrder[order_idx++] = 'X';if (order_idx > 255) order_idx = 0;
-            }
+    CPUTimer_stopTimer(Base);
+    CPUTimer_setPeriod(Base, ticks > 1 ? (uint32_t)ticks - 1U : 0U);
+    CPUTimer_reloadTimerCounter(Base);
+    CPUTimer_startTimer(Base);
+}
 
-            // Start transfer at CS falling
-            DMA_startChannel(DMA_CH5_BASE);
-            DMA_startChannel(DMA_CH6_BASE);
+// Watchdog deadline and HOLD or RAMP steps
+static void watchdogSchedule(Timestamp_t Time) {
+    scheduleTimer(WD_TIMER_BASE, Time);
+}
 
-        }
+// Moves the carrier duty linearly from its last value to 0%
+static void watchdogRamp(uint16_t Step, uint16_t Steps) {
+    if (!compareHeld) {
+        heldCompare = EPWM_getCounterCompareValue(CARRIER_BASE, EPWM_COUNTER_COMPARE_A);
+        compareHeld = true;
+    }
+    int32_t compare = heldCompare + ((int32_t)CARRIER_SAFE_COMPARE - heldCompare) * Step / Steps;
+    EPWM_setCounterCompareValue(CARRIER_BASE, EPWM_COUNTER_COMPARE_A, (uint16_t)compare);
+}
 
-    } else { // RISING EDGE, Frame transfer complete
-        if (lastEdge == 0) {
-            lastEdge = 1;
+static void watchdogTrip(void) {
+    EPWM_forceTripZoneEvent(CARRIER_BASE, EPWM_TZ_FORCE_EVENT_OST);
+}
 
-            txPacketEnd = txPacketCount;
-            rxPacketEnd = rxPacketCount;
+static void watchdogResume(void) {
+    if (compareHeld) {
+        EPWM_setCounterCompareValue(CARRIER_BASE, EPWM_COUNTER_COMPARE_A, heldCompare);
+        compareHeld = false;
+    }
+    EPWM_clearTripZoneFlag(CARRIER_BASE, EPWM_TZ_INTERRUPT | EPWM_TZ_FLAG_OST);
+}
 
-            // Set TX address back to control_output
-            // Allow RX to continue until its completed transferring its data.
-            // DONT DO ANYTHING HERE ?
-            interruptOrder[order_idx++] = '/';if (order_idx > 255) order_idx = 0;
-            nRising++;
-            nFrames++;
+static void traceWatchdog(uint16_t PrevState) {
+    uint16_t state = watchdog.State;
 
-            // CHECK LAST RX BUFFER HAS VALID ID
+    if (state == PrevState) return;
+    uint16_t reaction = (PrevState == COMMS_WD_RUNNING) ?
+                        (watchdog.Reaction > 0xFFFFU ? 0xFFFFU : (uint16_t)watchdog.Reaction) : 0;
+    Trace_Event(TRACE_EV_WATCHDOG, state, reaction);
+}
+
+#if MEASUREMENT_ADC_WORDS > 0
+// ADC words of the own measurement moved into the payload, shortly after the carrier zero
+__interrupt void adcDmaISR(void) {
+    EALLOW;
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
+    EDIS;
+
+    // Already finished by the CS falling edge otherwise
+    if (!sampling) return;
+    sampling = 0;
+    AdcCapture_Stop(&sampledAt);
+    finishMeasurement();
+#if WORKER_DMA_PREARM
+    armWhenReady();
+#endif
+}
+#endif
+
+// Measurement prepare hook, shortly before the expected CS falling edge
+__interrupt void cpuTimer1ISR(void) {
+    CPUTimer_stopTimer(PREPARE_TIMER_BASE);
+    CPUTimer_clearOverflowFlag(PREPARE_TIMER_BASE);
+
+    if (prepared) return;
+    prepareMeasurement();
+#if WORKER_DMA_PREARM
+    armWhenReady();
+#endif
+}
+
+// Watchdog deadline, or next HOLD or RAMP step
+__interrupt void cpuTimer2ISR(void) {
+    CPUTimer_stopTimer(WD_TIMER_BASE);
+    CPUTimer_clearOverflowFlag(WD_TIMER_BASE);
+
+    uint16_t state = watchdog.State;
+    CommsWatchdog_Expired(&watchdog, Timestamp_now());
+    traceWatchdog(state);
+}
+
+
+uint16_t txPacketEnd;
+uint16_t rxPacketEnd;
+
+uint16_t txPacketStart;
+uint16_t rxPacketStart;
 
-            // Check packet count it right
-//
-//            if (txPacketEnd != 2 * NUM_WORKERS) {
-//                txPacketEnd = 1;
-//                interruptOrder[order_idx++] = 'E';if (order_idx > 255) order_idx = 0;
-//
-//                interruptOrder[order_idx++] = 't';if (order_idx > 255) order_idx = 0;
-//
-//            }
-//
-//            if (rxPacketEnd != 2 * NUM_WORKERS - 1) {
-//                rxPacketEnd = 0;
-//                interruptOrder[order_idx++] = 'E';if (order_idx > 255) order_idx = 0;
-//                interruptOrder[order_idx++] = 'r';if (order_idx > 255) order_idx = 0;
-//            }
-//
-//            txPacketCount = 1;
-//            rxPacketCount = 0;
 
+volatile uint16_t frameOpen = 0;    // Set at CS falling, cleared at CS rising
 
+// CS falling edge, frame start. The edge is timestamped in hardware by ECAP1.
+__interrupt void spiCSISR(void) {
 
+    uint32_t latency = Timestamp_now() - CsCapture_LastFall();
+    LinkStats_Latency(&linkStats, latency);
+    Trace_Event(TRACE_EV_CS_FALL, latency > 0xFFFFU ? 0xFFFFU : (uint16_t)latency, 0);
+
+    // A falling edge while a frame is still open means the rising edge was a glitch
+    if (!frameOpen) {
+        frameOpen = 1;
+
+
+        txPacketStart = txPacketCount;
+        rxPacketStart = rxPacketCount;
+
+        // The frame came before its prepare hook, the measurement goes out as fresh as it gets now. Pre-armed
+        // channels are only started here, the Director must then leave csSetupMax before clocking.
+        if (!prepared) {
+            prepareLate++;
+            if (!sampling) prepareMeasurement();
+#if MEASUREMENT_ADC_WORDS > 0
+            // No carrier zero left before the frame: the samples of the last frame go out again, with their
+            // instant, unless the DMA just moved new ones
+            if (sampling) {
+                sampling = 0;
+                AdcCapture_Stop(&sampledAt);
+                finishMeasurement();
+            }
+#endif
+#if WORKER_DMA_PREARM
+            armWhenReady();
+#endif
+        } else {
+            measurementAge = CsCapture_LastFall() - preparedAt;
+            if (measurementAge > measurementAgeMax) measurementAgeMax = measurementAge;
         }
 
+        // The ring image is rewritten from now on, CPU1 must be done with the previous frame
+        closeImage();
+
+#if !WORKER_DMA_PREARM
+        // The previous frame was not closed by a CS rising edge, start from clean channels rather than where
+        // they stopped
+        if (pendingTxComplete || pendingRxComplete) {
+            linkStats.CsOverruns++;
+            FrameIntegrity_Recover(&frameIntegrity);
+        }
+
+        // Start transfer at CS falling
+        pendingTxComplete = 1;
+        pendingRxComplete = 1;
+        DMA_startChannel(DMA_CH5_BASE);
+        DMA_startChannel(DMA_CH6_BASE);
+
+        // The Director must not clock before the first TX burst is in the FIFO
+        uint32_t setup = Timestamp_now() - CsCapture_LastFall();
+        if (setup > csSetupMax) csSetupMax = setup;
+#endif
     }
 
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
 
 }
 
+// CS rising edge, frame transfer complete. Only raised by ECAP1 event 2.
+// In pre-armed mode this is the only CS interrupt, it also re-arms the DMA when the frame is fully received.
+__interrupt void ecapCSISR(void) {
+
+    // Pulses shorter than CS_MIN_FRAME_TICKS are rejected here without touching the DMA
+    if (CsCapture_FrameEnd()) {
+        Trace_Event(TRACE_EV_CS_RISE, 0, 0);
+        frameOpen = 0;
+        frameEnded = 1;
+
+        // A bad frame only costs this cycle: the channels are reset and the next CS falling edge (or the pre-arm
+        // below) starts them aligned. A short frame never completes its RX DMA.
+        if (FrameIntegrity_Check(&frameIntegrity) != FRAME_COMPLETE) {
+            FrameIntegrity_Recover(&frameIntegrity);
+            pendingTxComplete = 0;
+            pendingRxComplete = 0;
+        }
+
+#if WORKER_DMA_PREARM
+        armWhenReady();
+#endif
+
+        txPacketEnd = txPacketCount;
+        rxPacketEnd = rxPacketCount;
+    }
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP4);
+
+}
+
 
 
 //uint16_t* selectNextTxBuffer(void) {
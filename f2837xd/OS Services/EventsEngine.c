@@ -107,19 +107,31 @@ static inline void * EventPopIsr(Queue_t * const Queue) {
 }
 
 __attribute__((ramfunc))
-void EventsEngine(void)
+bool EventsEngineRun(void)
 {
     Event_t * Ev;
+    bool processed = false;
+
+    // Process all high priority events
+    while ((Ev = EventPopIsr(&IsrEventsQueue)) != NULL) {
+            (*Ev->CallbackFunc)(Ev); // Process the task
+            processed = true;
+    }
+
+    // Process the rest of the events
+    while ((Ev = QueuePopFromHead(&EventsQueue)) != NULL) {
+            (*Ev->CallbackFunc)(Ev); // Process the task
+            processed = true;
+    }
+
+    return processed;
+}
+
+__attribute__((ramfunc))
+void EventsEngine(void)
+{
     for(;;) {
-        // Process all high priority events
-        while ((Ev = EventPopIsr(&IsrEventsQueue)) != NULL) {
-                (*Ev->CallbackFunc)(Ev); // Process the task
-        }
-
-        // Process the rest of the events
-        while ((Ev = QueuePopFromHead(&EventsQueue)) != NULL) {
-                (*Ev->CallbackFunc)(Ev); // Process the task
-        }
+        EventsEngineRun();
     }
 }
 
@@ -18,7 +18,7 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 #include "Queue.h"
-#include "inc\hw_types.h"
+#include "inc/hw_types.h"
 
 /************************************
  * MACROS AND DEFINES
@@ -121,6 +121,16 @@ void EventPostIsr(Event_t * const Ev);
  */
 void EventsEngine(void);
 
+/**
+ * @brief       Processes the events pending, high priority ones first, and returns. EventsEngine() calls it
+ *              forever; the host ring simulator (sim/) calls it whenever it has run an interrupt of the node.
+ * 
+ * @param[in]   None.
+ * 
+ * @return      true if any event was processed.
+ */
+bool EventsEngineRun(void);
+
 /**
  * @brief       Initializes the events engine.
  * @param[in]   None.
@@ -12,7 +12,7 @@
 #include <stdbool.h>
 
 #include "Queue.h"
-#include "inc\hw_types.h"
+#include "inc/hw_types.h"
 
 /************************************
  * EXTERN VARIABLES
@@ -19,7 +19,7 @@ extern "C" {
  ************************************/
 #include <stdint.h>
 #include <stdbool.h>
-#include "inc\hw_types.h"
+#include "inc/hw_types.h"
 
 
 /************************************
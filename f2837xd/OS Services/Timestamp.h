@@ -0,0 +1,84 @@
+/**
+ ********************************************************************************
+ * @file    Timestamp.h
+ * @brief   Free-running timestamp service based on the IPC counter.
+ *
+ *          The IPC counter is a 64-bit free-running counter clocked by SYSCLK and
+ *          shared by CPU1 and CPU2, so timestamps taken on either core can be compared
+ *          directly. No CPU timer is consumed by this service.
+ ********************************************************************************
+ */
+
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include "device.h"
+#include "inc/hw_ipc.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TIMESTAMP_TICKS_PER_US  ((uint32_t)(DEVICE_SYSCLK_FREQ / 1000000UL))   /*!< Timestamp ticks per microsecond */
+
+/**
+ * Macro for scaling time in microseconds to timestamp ticks.
+ */
+#define US_TO_TIMESTAMP(us)     ((uint32_t)((us) * TIMESTAMP_TICKS_PER_US))
+
+/**
+ * Macro for scaling timestamp ticks to microseconds.
+ */
+#define TIMESTAMP_TO_US(ticks)  ((uint32_t)(ticks) / TIMESTAMP_TICKS_PER_US)
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+typedef uint32_t Timestamp_t;   /*!< Low 32 bits of the IPC counter, wraps every ~21 s at 200 MHz. Use unsigned differences. */
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Returns the low 32 bits of the IPC counter.
+ *
+ *              Intervals shorter than the wrap period are obtained with a plain
+ *              unsigned subtraction (later - earlier).
+ *
+ * @return      Current timestamp in SYSCLK ticks.
+ */
+static inline Timestamp_t Timestamp_now(void)
+{
+    return HWREG(IPC_BASE + IPC_O_COUNTERL);
+}
+
+/**
+ * @brief       Returns the full 64-bit IPC counter.
+ *
+ *              Reading COUNTERL latches COUNTERH, so the two halves are coherent.
+ *
+ * @return      Current timestamp in SYSCLK ticks.
+ */
+static inline uint64_t Timestamp_now64(void)
+{
+    uint32_t low  = HWREG(IPC_BASE + IPC_O_COUNTERL);
+    uint32_t high = HWREG(IPC_BASE + IPC_O_COUNTERH);
+
+    return ((uint64_t)high << 32) | low;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMESTAMP_H */
+
+/*** end of file ***/
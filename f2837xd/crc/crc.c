@@ -2,6 +2,7 @@
 #include "crc.h"
 
 crc_t  crcTable[256];
+crc_t  crcTableHigh[256];
 
 
 void crcInit(void)
@@ -45,6 +46,16 @@ void crcInit(void)
         crcTable[dividend] = remainder;
     }
 
+    /*
+     * Remainder of a dividend byte followed by 16 zero bits, for the
+     * high byte of a word processed at once.
+     */
+    for (dividend = 0; dividend < 256; ++dividend)
+    {
+        remainder = crcTable[dividend];
+        crcTableHigh[dividend] = (crc_t)(remainder << 8) ^ crcTable[remainder >> (WIDTH - 8)];
+    }
+
 }   /* crcInit() */
 
 
@@ -61,20 +72,15 @@ crc_t crcFast(uint16_t const message[], int nBytes)
 
 
     /*
-     * Divide the message by the polynomial, a byte at a time.
+     * Divide the message by the polynomial, a 16-bit byte at a time: the
+     * two table lookups are independent, there is no remainder carried
+     * from the high half to the low half.
      */
     int byte;
     for (byte = 0; byte < nBytes; ++byte)
     {
-        uint16_t firstHalf = message[byte] >> 8;
-
-        uint16_t secondHalf = message[byte] & (0xFF);
-
-        data = firstHalf ^ (remainder >> (WIDTH - 8));
-        remainder = crcTable[data] ^ (remainder << 8);
-
-        data = secondHalf ^ (remainder >> (WIDTH - 8));
-        remainder = crcTable[data] ^ (remainder << 8);
+        data = message[byte] ^ remainder;
+        remainder = crcTableHigh[data >> 8] ^ crcTable[data & 0xFF];
     }
 
     /*
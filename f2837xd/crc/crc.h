@@ -28,6 +28,7 @@ typedef uint16_t crc_t;
 #define TOPBIT (1 << (WIDTH - 1))
 
 extern crc_t  crcTable[256];
+extern crc_t  crcTableHigh[256];
 
 void crcInit(void);
 crc_t crcFast(uint16_t const message[], int nBytes);
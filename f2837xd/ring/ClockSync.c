@@ -0,0 +1,120 @@
+/**
+ ********************************************************************************
+ * @file    ClockSync.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "ClockSync.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+ClockSync_t clockSync;  /*!< Servo state, also readable from the debugger */
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+/**
+ * @brief   Offset predicted by the servo model at a local time.
+ */
+static inline int32_t predictOffset(uint32_t LocalTime)
+{
+    int32_t elapsed = (int32_t)(LocalTime - clockSync.Reference);
+    return clockSync.Offset + (int32_t)(((int64_t)clockSync.Rate * elapsed) >> CLOCKSYNC_RATE_SHIFT);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void ClockSync_Init(uint32_t PathDelay)
+{
+    memset(&clockSync, 0, sizeof(clockSync));
+    clockSync.PathDelay = PathDelay;
+}
+
+void ClockSync_Update(uint32_t MasterTime, uint32_t LocalTime)
+{
+    int32_t measured = (int32_t)(LocalTime - (MasterTime + clockSync.PathDelay));
+
+    if (clockSync.Samples == 0) {
+        // First sample, step the clock
+        clockSync.Offset = measured;
+        clockSync.Reference = LocalTime;
+        clockSync.Samples = 1;
+        return;
+    }
+
+    int32_t elapsed = (int32_t)(LocalTime - clockSync.Reference);
+    int32_t predicted = predictOffset(LocalTime);
+    int32_t residual = measured - predicted;
+
+    if (clockSync.Samples == 1 && elapsed > 0) {
+        // Second sample, coarse frequency estimate from the two raw offsets
+        clockSync.Rate = (int32_t)(((int64_t)residual << CLOCKSYNC_RATE_SHIFT) / elapsed);
+        predicted = measured;
+        residual = 0;
+    } else if (elapsed > 0) {
+        // PI servo: proportional correction of the offset, integral correction of the skew
+        clockSync.Rate += (int32_t)((((int64_t)residual << CLOCKSYNC_RATE_SHIFT) / elapsed) >> CLOCKSYNC_KI_SHIFT);
+        predicted += residual >> CLOCKSYNC_KP_SHIFT;
+    }
+
+    clockSync.Offset = predicted;
+    clockSync.Reference = LocalTime;
+    clockSync.Residual = residual;
+    clockSync.Samples++;
+
+    if (residual < CLOCKSYNC_LOCK_THRESHOLD && residual > -CLOCKSYNC_LOCK_THRESHOLD) {
+        if (clockSync.LockCount < CLOCKSYNC_LOCK_SAMPLES) clockSync.LockCount++;
+    } else {
+        clockSync.LockCount = 0;
+    }
+}
+
+uint32_t ClockSync_ToCluster(uint32_t LocalTime)
+{
+    return LocalTime - (uint32_t)predictOffset(LocalTime);
+}
+
+int32_t ClockSync_Offset(uint32_t LocalTime)
+{
+    return predictOffset(LocalTime);
+}
+
+int32_t ClockSync_Rate(void)
+{
+    return clockSync.Rate;
+}
+
+bool ClockSync_IsLocked(void)
+{
+    return clockSync.LockCount >= CLOCKSYNC_LOCK_SAMPLES;
+}
+
+/*** end of file ***/
@@ -0,0 +1,127 @@
+/**
+ ********************************************************************************
+ * @file    ClockSync.h
+ * @brief   PTP-like cluster time synchronization for the worker ring.
+ *
+ *          The Director is the time master: its own timestamp is the cluster time.
+ *          Each setpoint frame carries the Director timestamp of the previous frame launch
+ *          (two-step, "follow-up" style, since the exact launch is only known once the DMA
+ *          has started). A worker pairs it with its own timestamp of the chip-select falling
+ *          edge of that same frame, removes its ring position delay and feeds the resulting
+ *          offset to a PI servo that tracks both offset and frequency skew of its local clock.
+ ********************************************************************************
+ */
+
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+// Servo gains and lock detection, overridable for the convergence sweep of sim/syncsweep.c (make syncsweep)
+#ifndef CLOCKSYNC_KP_SHIFT
+#define CLOCKSYNC_KP_SHIFT          1       /*!< Proportional gain of the servo, 1 / 2^KP_SHIFT */
+#endif
+#ifndef CLOCKSYNC_KI_SHIFT
+#define CLOCKSYNC_KI_SHIFT          3       /*!< Integral gain of the servo, 1 / 2^KI_SHIFT */
+#endif
+#define CLOCKSYNC_RATE_SHIFT        24      /*!< Skew is stored in ticks per 2^RATE_SHIFT ticks */
+#ifndef CLOCKSYNC_LOCK_THRESHOLD
+#define CLOCKSYNC_LOCK_THRESHOLD    200     /*!< |residual| in ticks under which a sample counts as locked (1 us) */
+#endif
+#ifndef CLOCKSYNC_LOCK_SAMPLES
+#define CLOCKSYNC_LOCK_SAMPLES      8       /*!< Consecutive locked samples required to report lock */
+#endif
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief State of the cluster time servo.
+ *
+ * Offset is local time minus cluster time at local time Reference. The offset at any other
+ * local time t is Offset + Rate * (t - Reference) / 2^CLOCKSYNC_RATE_SHIFT.
+ */
+typedef struct {
+    uint32_t PathDelay;     /*!< Chip-select propagation and detection delay for this ring position, in ticks */
+    uint32_t Reference;     /*!< Local time at which Offset was last evaluated */
+    int32_t  Offset;        /*!< Local minus cluster time at Reference, in ticks */
+    int32_t  Rate;          /*!< Local clock skew, in ticks per 2^CLOCKSYNC_RATE_SHIFT ticks */
+    int32_t  Residual;      /*!< Last measured offset minus predicted offset, in ticks */
+    uint32_t Samples;       /*!< Number of offset samples processed */
+    uint16_t LockCount;     /*!< Consecutive samples within CLOCKSYNC_LOCK_THRESHOLD */
+} ClockSync_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Initializes the servo, the local clock is assumed to be the cluster clock until
+ *              the first sample is received.
+ *
+ * @param[in]   PathDelay: Delay between the Director launch timestamp and the chip-select edge
+ *                         being timestamped on this node, in ticks.
+ */
+void ClockSync_Init(uint32_t PathDelay);
+
+/**
+ * @brief       Feeds one master/local timestamp pair of the same frame to the servo.
+ *
+ * @param[in]   MasterTime: Director timestamp of the frame launch.
+ * @param[in]   LocalTime: Local timestamp of the chip-select falling edge of that frame.
+ */
+void ClockSync_Update(uint32_t MasterTime, uint32_t LocalTime);
+
+/**
+ * @brief       Converts a local timestamp into cluster time.
+ *
+ * @param[in]   LocalTime: Local timestamp.
+ * @return      Cluster time corresponding to LocalTime.
+ */
+uint32_t ClockSync_ToCluster(uint32_t LocalTime);
+
+/**
+ * @brief       Returns the current offset estimate (local minus cluster time) at a local time.
+ *
+ * @param[in]   LocalTime: Local timestamp.
+ * @return      Offset estimate, in ticks.
+ */
+int32_t ClockSync_Offset(uint32_t LocalTime);
+
+/**
+ * @brief       Returns the skew estimate of the local clock.
+ *
+ * @return      Local minus cluster ticks per 2^CLOCKSYNC_RATE_SHIFT local ticks.
+ */
+int32_t ClockSync_Rate(void);
+
+/**
+ * @brief       Reports whether the servo has converged.
+ *
+ * @return      true after CLOCKSYNC_LOCK_SAMPLES consecutive residuals within CLOCKSYNC_LOCK_THRESHOLD.
+ */
+bool ClockSync_IsLocked(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCKSYNC_H */
+
+/*** end of file ***/
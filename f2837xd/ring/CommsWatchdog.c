@@ -0,0 +1,193 @@
+/**
+ ********************************************************************************
+ * @file    CommsWatchdog.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "CommsWatchdog.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+// Averages an interval between consecutive valid frames into the period. An interval over 1.5 periods spans a
+// missed frame and is ignored; the first interval is taken as is and may be one, the lower bound of a third lets
+// the period come down from it.
+static void learn(CommsWatchdog_t *Watchdog, uint32_t Interval)
+{
+    uint32_t period = Watchdog->Period;
+
+    if (Watchdog->Learned == 0) {
+        Watchdog->Period = Interval;
+    } else if (Interval > period / 3U && Interval < period + period / 2U) {
+        Watchdog->Period = period + (int32_t)(Interval - period) / (1L << COMMS_WD_PERIOD_SHIFT);
+    } else {
+        return;
+    }
+    if (Watchdog->Learned < COMMS_WD_LEARN_FRAMES) Watchdog->Learned++;
+}
+
+static void trip(CommsWatchdog_t *Watchdog)
+{
+    Watchdog->State = COMMS_WD_TRIPPED;
+    Watchdog->Good = 0;
+    Watchdog->Trips++;
+    Watchdog->Output->Trip();
+}
+
+// Enters the fail-safe path. Reference is the deadline or the time of the last invalid frame.
+static void lose(CommsWatchdog_t *Watchdog, Timestamp_t Reference, Timestamp_t Now)
+{
+    Watchdog->Reaction = Now - Reference;
+    if (Watchdog->Reaction > Watchdog->ReactionMax) Watchdog->ReactionMax = Watchdog->Reaction;
+    Watchdog->Losses++;
+    Watchdog->Step = 0;
+    Watchdog->Next = Now + Watchdog->Period;
+
+    if (Watchdog->Policy == COMMS_WD_POLICY_TRIP || Watchdog->PolicyFrames == 0) {
+        trip(Watchdog);
+    } else if (Watchdog->Policy == COMMS_WD_POLICY_RAMP) {
+        // The first step is taken now, the output starts moving within the reaction time
+        Watchdog->State = COMMS_WD_RAMP;
+        Watchdog->Step = 1;
+        Watchdog->Output->Ramp(1, Watchdog->PolicyFrames);
+        if (Watchdog->PolicyFrames == 1) {
+            trip(Watchdog);
+        } else {
+            Watchdog->Output->Schedule(Watchdog->Next);
+        }
+    } else {
+        Watchdog->State = COMMS_WD_HOLD;
+        Watchdog->Output->Schedule(Watchdog->Next);
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void CommsWatchdog_Init(CommsWatchdog_t *Watchdog, const CommsWatchdogOutput_t *Output, uint16_t Policy,
+                        uint16_t Frames, uint16_t PolicyFrames, uint16_t RearmFrames)
+{
+    Watchdog->Output = Output;
+    Watchdog->Policy = Policy;
+    Watchdog->Frames = Frames ? Frames : 1;
+    Watchdog->PolicyFrames = PolicyFrames;
+    Watchdog->RearmFrames = RearmFrames;
+    Watchdog->State = COMMS_WD_LEARNING;
+    Watchdog->Learned = 0;
+    Watchdog->PrevValid = 0;
+    Watchdog->Invalid = 0;
+    Watchdog->Good = 0;
+    Watchdog->Step = 0;
+    Watchdog->Period = 0;
+    Watchdog->LastValid = 0;
+    Watchdog->Deadline = 0;
+    Watchdog->Next = 0;
+    Watchdog->Reaction = 0;
+    Watchdog->ReactionMax = 0;
+    Watchdog->Losses = 0;
+    Watchdog->Trips = 0;
+    Watchdog->Recoveries = 0;
+}
+
+void CommsWatchdog_Frame(CommsWatchdog_t *Watchdog, bool Valid, Timestamp_t Time)
+{
+    if (!Valid) {
+        Watchdog->PrevValid = 0;
+        Watchdog->Good = 0;
+        if (++Watchdog->Invalid >= Watchdog->Frames && Watchdog->State == COMMS_WD_RUNNING) {
+            lose(Watchdog, Time, Timestamp_now());
+        }
+        return;
+    }
+
+    if (Watchdog->PrevValid) learn(Watchdog, Time - Watchdog->LastValid);
+    Watchdog->PrevValid = 1;
+    Watchdog->LastValid = Time;
+    Watchdog->Invalid = 0;
+
+    switch (Watchdog->State) {
+    case COMMS_WD_LEARNING:
+        if (Watchdog->Learned < COMMS_WD_LEARN_FRAMES) return;
+        Watchdog->State = COMMS_WD_RUNNING;
+        break;
+    case COMMS_WD_HOLD:
+    case COMMS_WD_RAMP:
+        Watchdog->State = COMMS_WD_RUNNING;
+        Watchdog->Recoveries++;
+        Watchdog->Output->Resume();
+        break;
+    case COMMS_WD_TRIPPED:
+        if (Watchdog->RearmFrames == 0 || ++Watchdog->Good < Watchdog->RearmFrames) return;
+        Watchdog->State = COMMS_WD_RUNNING;
+        Watchdog->Recoveries++;
+        Watchdog->Output->Resume();
+        break;
+    default:
+        break;
+    }
+
+    Watchdog->Deadline = Time + Watchdog->Frames * Watchdog->Period + Watchdog->Period / 2U;
+    Watchdog->Output->Schedule(Watchdog->Deadline);
+}
+
+void CommsWatchdog_Expired(CommsWatchdog_t *Watchdog, Timestamp_t Now)
+{
+    switch (Watchdog->State) {
+    case COMMS_WD_RUNNING:
+        // Timer raised just before a valid frame moved the deadline
+        if ((int32_t)(Now - Watchdog->Deadline) < 0) {
+            Watchdog->Output->Schedule(Watchdog->Deadline);
+            return;
+        }
+        lose(Watchdog, Watchdog->Deadline, Now);
+        break;
+    case COMMS_WD_HOLD:
+    case COMMS_WD_RAMP:
+        if ((int32_t)(Now - Watchdog->Next) < 0) {
+            Watchdog->Output->Schedule(Watchdog->Next);
+            return;
+        }
+        Watchdog->Step++;
+        if (Watchdog->State == COMMS_WD_RAMP) Watchdog->Output->Ramp(Watchdog->Step, Watchdog->PolicyFrames);
+        if (Watchdog->Step >= Watchdog->PolicyFrames) {
+            trip(Watchdog);
+        } else {
+            Watchdog->Next += Watchdog->Period;
+            Watchdog->Output->Schedule(Watchdog->Next);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/*** end of file ***/
@@ -0,0 +1,142 @@
+/**
+ ********************************************************************************
+ * @file    CommsWatchdog.h
+ * @brief   Loss of communication watchdog of a worker.
+ *
+ *          The watchdog learns the frame period from the intervals between consecutive
+ *          valid frames, then expects a valid frame every period. Once COMMS_WD_LEARN_FRAMES
+ *          intervals are averaged, each valid frame moves the deadline to
+ *
+ *            frame time + Frames * Period + Period / 2
+ *
+ *          and reprograms a hardware timer for it, so the fail-safe path is entered Frames
+ *          frames after the last valid one whether the frames stop or keep arriving broken;
+ *          Frames consecutive invalid frames enter it at once. The reaction time is the
+ *          latency of the timer interrupt, recorded against the deadline.
+ *
+ *          Fail-safe policies:
+ *            HOLD  keeps the last output for PolicyFrames periods, then trips.
+ *            RAMP  moves the output to its safe value in PolicyFrames periods, then trips.
+ *            TRIP  trips at once.
+ *          A valid frame during HOLD or RAMP resumes normal operation. A trip is latched,
+ *          unless RearmFrames consecutive valid frames are received after it.
+ *
+ *          The watchdog only drives the hardware through CommsWatchdogOutput_t. Frame and
+ *          timer calls come from interrupts that do not nest.
+ ********************************************************************************
+ */
+
+#ifndef COMMSWATCHDOG_H
+#define COMMSWATCHDOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Timestamp.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define COMMS_WD_LEARN_FRAMES   4U      /*!< Frame intervals averaged before the watchdog is armed */
+#define COMMS_WD_PERIOD_SHIFT   3U      /*!< Period filter gain, 1 / 2^PERIOD_SHIFT */
+
+// Fail-safe policies
+#define COMMS_WD_POLICY_HOLD    0U
+#define COMMS_WD_POLICY_RAMP    1U
+#define COMMS_WD_POLICY_TRIP    2U
+
+// States
+#define COMMS_WD_LEARNING       0U      /*!< Frame period not known yet, not armed */
+#define COMMS_WD_RUNNING        1U      /*!< Armed, frames on time */
+#define COMMS_WD_HOLD           2U      /*!< Lost, output held */
+#define COMMS_WD_RAMP           3U      /*!< Lost, output moving to its safe value */
+#define COMMS_WD_TRIPPED        4U      /*!< Output tripped */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Hardware of the fail-safe path, called from the frame and timer interrupts.
+ */
+typedef struct {
+    void (*Schedule)(Timestamp_t Time);             /*!< Calls CommsWatchdog_Expired at Time, replaces the previous call */
+    void (*Ramp)(uint16_t Step, uint16_t Steps);    /*!< Output at Step / Steps of the way to its safe value */
+    void (*Trip)(void);                             /*!< Output to its safe state, latched */
+    void (*Resume)(void);                           /*!< Output back under control */
+} CommsWatchdogOutput_t;
+
+/**
+ * @brief Watchdog of one worker.
+ */
+typedef struct {
+    const CommsWatchdogOutput_t *Output;    /*!< Fail-safe hardware */
+    uint16_t Policy;                /*!< COMMS_WD_POLICY_* */
+    uint16_t Frames;                /*!< Missed or invalid frames that enter the fail-safe path */
+    uint16_t PolicyFrames;          /*!< Periods of HOLD or RAMP before the trip */
+    uint16_t RearmFrames;           /*!< Consecutive valid frames that clear a trip, 0 latches it */
+    volatile uint16_t State;        /*!< COMMS_WD_* */
+    uint16_t Learned;               /*!< Frame intervals averaged into Period */
+    uint16_t PrevValid;             /*!< The previous frame was valid, its interval can be learned */
+    uint16_t Invalid;               /*!< Consecutive invalid frames */
+    uint16_t Good;                  /*!< Consecutive valid frames since the trip */
+    uint16_t Step;                  /*!< Periods spent in HOLD or RAMP */
+    uint32_t Period;                /*!< Expected frame period, in ticks */
+    Timestamp_t LastValid;          /*!< Time of the last valid frame */
+    Timestamp_t Deadline;           /*!< Time by which the next valid frame must have arrived */
+    Timestamp_t Next;               /*!< Time of the next HOLD or RAMP step */
+    uint32_t Reaction;              /*!< Deadline, or invalid frame, to fail-safe entry of the last loss, in ticks */
+    uint32_t ReactionMax;           /*!< Longest Reaction */
+    uint32_t Losses;                /*!< Fail-safe entries */
+    uint32_t Trips;                 /*!< Trips */
+    uint32_t Recoveries;            /*!< Returns to normal operation */
+} CommsWatchdog_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Initializes the watchdog, not armed until the frame period is learned.
+ *
+ * @param[in]   Output: Fail-safe hardware.
+ * @param[in]   Policy: COMMS_WD_POLICY_*.
+ * @param[in]   Frames: Missed or invalid frames that enter the fail-safe path, at least 1.
+ * @param[in]   PolicyFrames: Periods of HOLD or RAMP before the trip.
+ * @param[in]   RearmFrames: Consecutive valid frames that clear a trip, 0 latches it.
+ */
+void CommsWatchdog_Init(CommsWatchdog_t *Watchdog, const CommsWatchdogOutput_t *Output, uint16_t Policy,
+                        uint16_t Frames, uint16_t PolicyFrames, uint16_t RearmFrames);
+
+/**
+ * @brief       Reports a received frame, from the ring interrupt.
+ *
+ * @param[in]   Valid: The frame carries a usable setpoint for this worker.
+ * @param[in]   Time: Timestamp of the start of the frame.
+ */
+void CommsWatchdog_Frame(CommsWatchdog_t *Watchdog, bool Valid, Timestamp_t Time);
+
+/**
+ * @brief       Runs the deadline or the next HOLD or RAMP step, from the timer interrupt.
+ *
+ * @param[in]   Now: Current timestamp.
+ */
+void CommsWatchdog_Expired(CommsWatchdog_t *Watchdog, Timestamp_t Now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMSWATCHDOG_H */
+
+/*** end of file ***/
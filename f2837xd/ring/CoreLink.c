@@ -0,0 +1,221 @@
+/**
+ ********************************************************************************
+ * @file    CoreLink.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "device.h"
+#include "CoreLink.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define IPC_REG(offset)     HWREG(IPC_BASE + (offset))
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint32_t lease;          /*!< Image version sampled at acquire */
+static Timestamp_t acquired;    /*!< Time the lease was taken */
+
+static uint16_t moveOffset;             /*!< Offset of the private payloads in the publish slot */
+static volatile uint16_t *moveDest;     /*!< First private payload in the image */
+static uint16_t moveChunks;             /*!< Private payloads moved */
+static uint16_t moveWords;              /*!< Words of each private payload */
+static int16_t moveStep;                /*!< Distance between private chunks in the image */
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+#pragma DATA_SECTION(coreLinkDown, "CoreLinkDown");
+volatile CoreLinkDown_t coreLinkDown;
+
+#pragma DATA_SECTION(coreLinkUp, "CoreLinkUp");
+volatile CoreLinkUp_t coreLinkUp;
+
+#pragma DATA_SECTION(corePublish, "CoreLinkPublish");
+uint16_t corePublish[CORELINK_PUBLISH_SLOTS][CORELINK_PUBLISH_WORDS];
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+static void move(const uint16_t *Src, volatile uint16_t *Dest, uint16_t Chunks, uint16_t Words, int16_t Step);
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+// One software trigger moves Chunks payloads of Words words, one word per burst. The destination wraps to the
+// next chunk (Step words from the previous one) after each payload, skipping the frame headers.
+static void move(const uint16_t *Src, volatile uint16_t *Dest, uint16_t Chunks, uint16_t Words, int16_t Step)
+{
+    DMA_configAddresses(CORELINK_MOVER_BASE, (const void *)Dest, (const void *)Src);
+    DMA_configTransfer(CORELINK_MOVER_BASE, (uint32_t)Chunks * Words, 1, 1);
+    DMA_configWrap(CORELINK_MOVER_BASE, 0x10000UL, 0, Words, Step);
+    DMA_startChannel(CORELINK_MOVER_BASE);
+    DMA_forceTrigger(CORELINK_MOVER_BASE);
+    while (DMA_getRunStatusFlag(CORELINK_MOVER_BASE)) { }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void CoreLink_Init(volatile Frame *Broadcast, volatile Frame * const *Setpoints, volatile Frame * const *Measurements,
+                   uint16_t Self)
+{
+    uint16_t i;
+    coreLinkDown.Broadcast = Broadcast;
+    for (i = 0; i < NUM_WORKERS; i++) {
+        coreLinkDown.Setpoints[i] = Setpoints[i];
+        coreLinkDown.Measurements[i] = Measurements[i];
+    }
+    coreLinkDown.Self = Self;
+    coreLinkDown.Token = 0;
+    coreLinkDown.BroadcastValid = 0;
+    coreLinkDown.SetpointsValid = 0;
+    coreLinkDown.MeasurementsValid = 0;
+    coreLinkDown.Sequence = 0;
+    coreLinkDown.Version = 1;   // No image yet
+    coreLinkDown.Ready = 0;
+    coreLinkDown.Overruns = 0;
+    coreLinkDown.Published = 0;
+
+    // Director: setpoint payloads, one chunk lower in the image for each worker. Worker: own measurement payload.
+    // Payload words only, the mailbox words that follow are written by CPU2.
+    moveStep = 0;
+    if (Self == CORELINK_NO_WORKER) {
+        moveOffset = CORELINK_PUBLISH_SETPOINT(0, 0);
+        moveDest = Setpoints[0]->data;
+        moveChunks = NUM_WORKERS;
+        moveWords = SETPOINT_WORDS;
+        if (NUM_WORKERS > 1) moveStep = (int16_t)((volatile uint16_t *)Setpoints[1] - (volatile uint16_t *)Setpoints[0]);
+    } else {
+        moveOffset = CORELINK_PUBLISH_MEASUREMENT(0);
+        moveDest = Measurements[Self]->data;
+        moveChunks = 1;
+        moveWords = MEASUREMENT_WORDS - MEASUREMENT_ADC_WORDS;  // The ADC words at the end are moved in by CPU2
+    }
+
+    DMA_configBurst(CORELINK_MOVER_BASE, 1, 0, 0);
+    DMA_configMode(CORELINK_MOVER_BASE, DMA_TRIGGER_SOFTWARE,
+                                        DMA_CFG_ONESHOT_ENABLE      |
+                                        DMA_CFG_CONTINUOUS_DISABLE  |
+                                        DMA_CFG_SIZE_16BIT);
+    DMA_enableTrigger(CORELINK_MOVER_BASE);
+    DMA_disableInterrupt(CORELINK_MOVER_BASE);
+    DMA_disableOverrunInterrupt(CORELINK_MOVER_BASE);
+}
+
+void CoreLink_Ready(uint16_t Token, bool BroadcastValid, uint16_t SetpointsValid, uint16_t MeasurementsValid)
+{
+    coreLinkDown.Token = Token;
+    coreLinkDown.BroadcastValid = BroadcastValid;
+    coreLinkDown.SetpointsValid = SetpointsValid;
+    coreLinkDown.MeasurementsValid = MeasurementsValid;
+    coreLinkDown.Sequence++;
+    coreLinkDown.Ready = Timestamp_now();
+    Snapshot_WriteEnd(&coreLinkDown.Version);
+
+    IPC_REG(IPC_O_SET) = CORELINK_READY_FLAG;
+}
+
+void CoreLink_Close(void)
+{
+    // Flag still pending: CPU1 has not released the image the ring is about to overwrite
+    if (IPC_REG(IPC_O_FLG) & CORELINK_READY_FLAG) {
+        coreLinkDown.Overruns++;
+    }
+    Snapshot_WriteBegin(&coreLinkDown.Version);
+}
+
+bool CoreLink_TakePublished(void)
+{
+    if (!(IPC_REG(IPC_O_STS) & CORELINK_PUBLISH_FLAG)) return false;
+
+    const uint16_t *slot = corePublish[coreLinkUp.Slot];
+
+    // The broadcast payload has its own length, the Director moves it separately
+    if (coreLinkDown.Self == CORELINK_NO_WORKER && coreLinkDown.Broadcast != NULL) {
+        move(CORELINK_PUBLISH_BROADCAST(slot), coreLinkDown.Broadcast->data, 1, BROADCAST_DATA_LEN, 0);
+    }
+    move(slot + moveOffset, moveDest, moveChunks, moveWords, moveStep);
+
+    // Slot handed back to CPU1
+    IPC_REG(IPC_O_ACK) = CORELINK_PUBLISH_FLAG;
+    coreLinkDown.Published++;
+
+    return true;
+}
+
+void CoreLink_InitConsumer(void)
+{
+    lease = 0;
+    coreLinkUp.Slot = CORELINK_PUBLISH_SLOTS - 1;
+    coreLinkUp.Token = 0;
+    coreLinkUp.Consumed = 0;
+    coreLinkUp.Late = 0;
+    coreLinkUp.ConsumeLatency = 0;
+    coreLinkUp.ConsumeLatencyMax = 0;
+    coreLinkUp.HoldMax = 0;
+}
+
+volatile CoreLinkDown_t * CoreLink_Acquire(void)
+{
+    if (!(IPC_REG(IPC_O_STS) & CORELINK_READY_FLAG)) return NULL;
+
+    acquired = Timestamp_now();
+    lease = Snapshot_ReadBegin(&coreLinkDown.Version);
+
+    uint32_t latency = acquired - coreLinkDown.Ready;
+    coreLinkUp.ConsumeLatency = latency;
+    if (latency > coreLinkUp.ConsumeLatencyMax) coreLinkUp.ConsumeLatencyMax = latency;
+
+    return &coreLinkDown;
+}
+
+bool CoreLink_Release(void)
+{
+    uint32_t hold = Timestamp_now() - acquired;
+    bool intact = !Snapshot_ReadRetry(&coreLinkDown.Version, lease);
+
+    IPC_REG(IPC_O_ACK) = CORELINK_READY_FLAG;
+
+    coreLinkUp.Consumed++;
+    if (!intact) coreLinkUp.Late++;
+    if (hold > coreLinkUp.HoldMax) coreLinkUp.HoldMax = hold;
+
+    return intact;
+}
+
+uint16_t * CoreLink_PublishBuffer(void)
+{
+    return corePublish[(coreLinkUp.Slot + 1) % CORELINK_PUBLISH_SLOTS];
+}
+
+bool CoreLink_Publish(uint16_t Token)
+{
+    // CPU2 still owns the previously committed slot
+    if (IPC_REG(IPC_O_FLG) & CORELINK_PUBLISH_FLAG) return false;
+
+    coreLinkUp.Slot = (coreLinkUp.Slot + 1) % CORELINK_PUBLISH_SLOTS;
+    coreLinkUp.Token = Token;
+
+    IPC_REG(IPC_O_SET) = CORELINK_PUBLISH_FLAG;
+
+    return true;
+}
+
+/*** end of file ***/
@@ -0,0 +1,193 @@
+/**
+ ********************************************************************************
+ * @file    CoreLink.h
+ * @brief   Zero-copy data plane between the comms core (CPU2) and the algorithm core (CPU1).
+ *
+ *          Down (CPU2 to CPU1): after validating a received frame, CPU2 fills the
+ *          CoreLinkDown_t descriptor in CPU2-to-CPU1 message RAM and raises IPC flag 0.
+ *          CPU1 reads the broadcast, setpoints and measurements in place in the GS1 ring image (it has
+ *          read-only access) between CoreLink_Acquire() and CoreLink_Release(). The lease
+ *          ends when the ring starts overwriting the image (CoreLink_Close() on CPU2), which
+ *          also makes the image version odd (see Snapshot.h); a release after that reports
+ *          the read as torn. Other readers can use the version directly.
+ *
+ *          Up (CPU1 to CPU2): CPU1 writes its outgoing payload into a free slot of a
+ *          double buffer in GS2 (CPU1 owned, read-only for CPU2) and commits it with IPC
+ *          flag 4. CPU2 moves the committed slot into the ring image with a software
+ *          triggered DMA block move, then acknowledges the flag to hand the slot back.
+ *
+ *          The descriptors and the publish buffer live at fixed addresses set in the
+ *          linker command files: each core allocates what it writes and maps what it
+ *          only reads as a DSECT.
+ ********************************************************************************
+ */
+
+#ifndef CORELINK_H
+#define CORELINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+#include "Timestamp.h"
+#include "Snapshot.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define CORELINK_READY_FLAG     IPC_SET_IPC0    /*!< CPU2 to CPU1: ring image ready, raises INT_IPC_0 on CPU1 */
+#define CORELINK_PUBLISH_FLAG   IPC_SET_IPC4    /*!< CPU1 to CPU2: publish slot committed, polled by CPU2 */
+
+#define CORELINK_MOVER_BASE     DMA_CH4_BASE    /*!< DMA channel moving the publish slot into the ring image */
+
+#define CORELINK_NO_WORKER      0xFFFFU         /*!< CoreLinkDown_t.Self on the Director */
+#define CORELINK_ALL_WORKERS    ((uint16_t)((1UL << NUM_WORKERS) - 1))  /*!< Valid mask with every worker set */
+#define CORELINK_PUBLISH_SLOTS  2U
+
+/*! Publish slot layout: the Director's broadcast payload, then one setpoint payload per worker. A worker
+ *  only publishes its measurement payload, at the start of the slot. */
+#define CORELINK_PUBLISH_BROADCAST(slot)        (slot)
+#define CORELINK_PUBLISH_SETPOINT(slot, w)      ((slot) + BROADCAST_DATA_LEN + (w) * SETPOINT_WORDS)
+#define CORELINK_PUBLISH_MEASUREMENT(slot)      (slot)
+
+#define CORELINK_PUBLISH_WORDS  ((BROADCAST_DATA_LEN + NUM_WORKERS * SETPOINT_WORDS) > MEASUREMENT_WORDS ? \
+                                 (BROADCAST_DATA_LEN + NUM_WORKERS * SETPOINT_WORDS) : MEASUREMENT_WORDS)
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Ring image descriptor, written by CPU2 only.
+ */
+typedef struct {
+    volatile Frame *Broadcast;                  /*!< Broadcast frame in the ring image, NULL if there is none */
+    volatile Frame *Setpoints[NUM_WORKERS];     /*!< Setpoint frames in the ring image */
+    volatile Frame *Measurements[NUM_WORKERS];  /*!< Measurement frames in the ring image, decoded views on the
+                                                     Director with MEASUREMENT_DELTA */
+    uint16_t    Self;               /*!< Index of this worker, CORELINK_NO_WORKER on the Director */
+    uint16_t    Token;              /*!< Cycle token of the image */
+    uint16_t    BroadcastValid;     /*!< Broadcast passed its CRC and belongs to the same cycle as the setpoints */
+    uint16_t    SetpointsValid;     /*!< Bit w set if setpoint w passed its CRC */
+    uint16_t    MeasurementsValid;  /*!< Bit w set if measurement w passed its CRC */
+    uint32_t    Sequence;           /*!< Number of images handed over, identifies the current lease */
+    SnapshotVersion_t Version;      /*!< Seqlock over the ring image, odd while it is being written */
+    Timestamp_t Ready;              /*!< Time the ready flag was raised */
+    uint32_t    Overruns;           /*!< Images overwritten while CPU1 still held them */
+    uint32_t    Published;          /*!< Publish slots moved into the ring image */
+} CoreLinkDown_t;
+
+/**
+ * @brief Algorithm core status, written by CPU1 only.
+ */
+typedef struct {
+    uint16_t    Slot;               /*!< Last committed publish slot */
+    uint16_t    Token;              /*!< Token of the image the committed payload was computed from */
+    uint32_t    Consumed;           /*!< Images released */
+    uint32_t    Late;               /*!< Images released after their lease was closed */
+    uint32_t    ConsumeLatency;     /*!< Ready flag to acquire time of the last image, in ticks */
+    uint32_t    ConsumeLatencyMax;  /*!< Longest ready flag to acquire time, in ticks */
+    uint32_t    HoldMax;            /*!< Longest acquire to release time, in ticks */
+} CoreLinkUp_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+extern volatile CoreLinkDown_t coreLinkDown;
+extern volatile CoreLinkUp_t coreLinkUp;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Initializes the descriptor and the publish DMA channel (CPU2). DMA_initController()
+ *              must have been called. The Director moves the broadcast payload and the payload of
+ *              every setpoint, a worker the payload of its own measurement.
+ *
+ * @param[in]   Broadcast: Broadcast frame of the ring image, NULL if there is none.
+ * @param[in]   Setpoints: Setpoint frame pointers of the ring image.
+ * @param[in]   Measurements: Measurement frame pointers of the ring image. With MEASUREMENT_DELTA, the
+ *              Director passes its decoded views and a worker its raw measurement frame as its own entry.
+ * @param[in]   Self: Worker index, CORELINK_NO_WORKER on the Director.
+ */
+void CoreLink_Init(volatile Frame *Broadcast, volatile Frame * const *Setpoints, volatile Frame * const *Measurements,
+                   uint16_t Self);
+
+/**
+ * @brief       Hands the ring image over to CPU1 (CPU2), once all frames are received and checked.
+ *
+ * @param[in]   Token: Cycle token of the image.
+ * @param[in]   BroadcastValid: Broadcast passed its CRC and carries Token (always true without broadcast).
+ * @param[in]   SetpointsValid: Bit mask of the setpoints that passed their CRC.
+ * @param[in]   MeasurementsValid: Bit mask of the measurements that passed their CRC.
+ */
+void CoreLink_Ready(uint16_t Token, bool BroadcastValid, uint16_t SetpointsValid, uint16_t MeasurementsValid);
+
+/**
+ * @brief       Ends the lease of the current image and opens a write of the image version (CPU2).
+ *              Must be called before the ring or CPU2 write the image again, i.e. before the
+ *              outgoing frames are prepared or the receive DMA of the next frame is started.
+ */
+void CoreLink_Close(void);
+
+/**
+ * @brief       Moves the payload committed by CPU1, if any, into the ring image (CPU2). Must be
+ *              called before the CRCs of the outgoing frames are computed. Busy-waits on the DMA
+ *              for the length of the block moves (CORELINK_PUBLISH_WORDS words at most).
+ *
+ * @return      true if a new payload was moved.
+ */
+bool CoreLink_TakePublished(void);
+
+/**
+ * @brief       Initializes the CPU1 side of the link.
+ */
+void CoreLink_InitConsumer(void);
+
+/**
+ * @brief       Takes the lease on the ring image (CPU1), normally from the INT_IPC_0 interrupt.
+ *
+ * @return      The descriptor, or NULL if no image is ready.
+ */
+volatile CoreLinkDown_t * CoreLink_Acquire(void);
+
+/**
+ * @brief       Returns the lease on the ring image to CPU2 (CPU1).
+ *
+ * @return      true if the image was not overwritten while held, i.e. everything read between
+ *              acquire and release is consistent.
+ */
+bool CoreLink_Release(void);
+
+/**
+ * @brief       Publish slot CPU1 may write into, laid out as given by the CORELINK_PUBLISH_*
+ *              macros. The Director fills the broadcast and one setpoint payload per worker, a
+ *              worker its own measurement payload.
+ *
+ * @return      Pointer to the free slot.
+ */
+uint16_t * CoreLink_PublishBuffer(void);
+
+/**
+ * @brief       Commits the slot returned by CoreLink_PublishBuffer() (CPU1). Fails while CPU2
+ *              has not taken the previous commit; the slot is then kept and can be rewritten.
+ *
+ * @param[in]   Token: Token of the image the payload was computed from.
+ * @return      true if committed.
+ */
+bool CoreLink_Publish(uint16_t Token);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORELINK_H */
+
+/*** end of file ***/
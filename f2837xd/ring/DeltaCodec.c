@@ -0,0 +1,150 @@
+/**
+ ********************************************************************************
+ * @file    DeltaCodec.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "DeltaCodec.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BIT_WORD(i)     (DELTA_BITMAP_OFFSET + ((i) >> 4))
+#define BIT_MASK(i)     (1U << ((i) & 15U))
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// The encoded payload must fit the measurement chunk
+#if MEASUREMENT_DELTA
+typedef char deltaEncodedFitsCheck[(DELTA_ENCODED_WORDS <= MEASUREMENT_DATA_LEN) ? 1 : -1];
+#endif
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+// Without delta encoding the slot and refresh counts are 0, and nothing calls the codec
+#if MEASUREMENT_DELTA
+void DeltaCodec_InitEncoder(DeltaEncoder_t *Encoder)
+{
+    uint16_t i;
+    for (i = 0; i < DELTA_WORDS; i++) {
+        Encoder->Sent[i] = 0;
+    }
+    Encoder->Cursor = 0;
+    Encoder->Scan = 0;
+    Encoder->Deferred = 0;
+}
+
+uint16_t DeltaCodec_Encode(DeltaEncoder_t *Encoder, volatile const uint16_t *Payload, volatile uint16_t *Encoded)
+{
+    uint16_t i, n;
+
+    // Refresh slice, sent whether it changed or not
+    Encoded[0] = Encoder->Cursor;
+    i = Encoder->Cursor;
+    for (n = 0; n < MEASUREMENT_REFRESH_WORDS; n++) {
+        uint16_t value = Payload[i];
+        Encoded[DELTA_REFRESH_OFFSET + n] = value;
+        Encoder->Sent[i] = value;
+        if (++i == DELTA_WORDS) i = 0;
+    }
+    Encoder->Cursor = i;
+
+    // Pick the changed words, starting after the last one sent
+    for (n = 0; n < DELTA_BITMAP_WORDS; n++) {
+        Encoded[DELTA_BITMAP_OFFSET + n] = 0;
+    }
+
+    uint16_t picked = 0;
+    uint16_t deferred = 0;
+    i = Encoder->Scan;
+    for (n = 0; n < DELTA_WORDS; n++) {
+        if (Payload[i] != Encoder->Sent[i]) {
+            if (picked < MEASUREMENT_DELTA_SLOTS) {
+                Encoded[BIT_WORD(i)] |= BIT_MASK(i);
+                picked++;
+                Encoder->Scan = (i + 1 == DELTA_WORDS) ? 0 : i + 1;
+            } else {
+                deferred++;
+            }
+        }
+        if (++i == DELTA_WORDS) i = 0;
+    }
+
+    // Changed words go out in ascending order, the decoder walks the bitmap
+    uint16_t slot = 0;
+    for (i = 0; i < DELTA_WORDS && slot < picked; i++) {
+        if (Encoded[BIT_WORD(i)] & BIT_MASK(i)) {
+            uint16_t value = Payload[i];
+            Encoded[DELTA_CHANGED_OFFSET + slot++] = value;
+            Encoder->Sent[i] = value;
+        }
+    }
+    for (; slot < MEASUREMENT_DELTA_SLOTS; slot++) {
+        Encoded[DELTA_CHANGED_OFFSET + slot] = 0;
+    }
+
+    Encoder->Deferred = deferred;
+    return deferred;
+}
+
+bool DeltaCodec_Decode(volatile const uint16_t *Encoded, volatile uint16_t *Payload)
+{
+    uint16_t i, n;
+    uint16_t cursor = Encoded[0];
+
+    if (cursor >= DELTA_WORDS) return false;
+
+    // Validate the bitmap before touching the view
+    uint16_t present = 0;
+    for (n = 0; n < DELTA_BITMAP_WORDS; n++) {
+        uint16_t bits = Encoded[DELTA_BITMAP_OFFSET + n];
+        if (n == DELTA_BITMAP_WORDS - 1 && (DELTA_WORDS & 15U) && (bits >> (DELTA_WORDS & 15U))) return false;
+        for (; bits; bits &= bits - 1) present++;
+    }
+    if (present > MEASUREMENT_DELTA_SLOTS) return false;
+
+    uint16_t slot = 0;
+    for (i = 0; i < DELTA_WORDS && slot < present; i++) {
+        if (Encoded[BIT_WORD(i)] & BIT_MASK(i)) {
+            Payload[i] = Encoded[DELTA_CHANGED_OFFSET + slot++];
+        }
+    }
+
+    i = cursor;
+    for (n = 0; n < MEASUREMENT_REFRESH_WORDS; n++) {
+        Payload[i] = Encoded[DELTA_REFRESH_OFFSET + n];
+        if (++i == DELTA_WORDS) i = 0;
+    }
+
+    return true;
+}
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,102 @@
+/**
+ ********************************************************************************
+ * @file    DeltaCodec.h
+ * @brief   Delta encoding of measurement payloads with rolling keyframes.
+ *
+ *          With MEASUREMENT_DELTA, a worker sends its measurement payload encoded in
+ *          the data words of its (shorter) measurement chunk:
+ *
+ *            [cursor][bitmap][changed words][refresh words]
+ *
+ *          Bit i of the bitmap is set if payload word i is sent in the changed words,
+ *          which follow in ascending order of i, up to MEASUREMENT_DELTA_SLOTS of them
+ *          (unused slots are 0). The MEASUREMENT_REFRESH_WORDS refresh words are payload
+ *          words cursor, cursor + 1, ... (modulo the payload length), sent whether they
+ *          changed or not. The cursor walks the whole payload once every keyframe period,
+ *          which repairs the decoded view after a lost frame.
+ *
+ *          All words carry absolute values, so applying a frame twice does no harm: a
+ *          worker resends its chunk unchanged when its setpoint fails the CRC. When more
+ *          words change than there are slots, the others are sent in the next frames;
+ *          the scan resumes after the last word sent so that none is starved.
+ ********************************************************************************
+ */
+
+#ifndef DELTACODEC_H
+#define DELTACODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define DELTA_WORDS             (MEASUREMENT_WORDS ? MEASUREMENT_WORDS : 1)    /*!< Decoded payload length */
+#define DELTA_BITMAP_WORDS      ((DELTA_WORDS + 15) / 16)
+
+#define DELTA_BITMAP_OFFSET     1
+#define DELTA_CHANGED_OFFSET    (DELTA_BITMAP_OFFSET + DELTA_BITMAP_WORDS)
+#define DELTA_REFRESH_OFFSET    (DELTA_CHANGED_OFFSET + MEASUREMENT_DELTA_SLOTS)
+#define DELTA_ENCODED_WORDS     (DELTA_REFRESH_OFFSET + MEASUREMENT_REFRESH_WORDS)
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Encoder state, kept by the worker.
+ */
+typedef struct {
+    uint16_t Sent[DELTA_WORDS];     /*!< Payload as last sent, i.e. the decoded view if no frame was lost */
+    uint16_t Cursor;                /*!< First word of the next refresh slice */
+    uint16_t Scan;                  /*!< Word the next changed word scan starts at */
+    uint16_t Deferred;              /*!< Changed words left over for the next frames by the last encode */
+} DeltaEncoder_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Resets the encoder. The first frames then refresh a view that starts all zero.
+ */
+void DeltaCodec_InitEncoder(DeltaEncoder_t *Encoder);
+
+/**
+ * @brief       Encodes the payload for the next frame.
+ *
+ * @param[in]   Payload: Raw measurement payload, DELTA_WORDS words.
+ * @param[out]  Encoded: DELTA_ENCODED_WORDS words, normally the data of the own measurement chunk.
+ * @return      Changed words that did not fit and are left for the next frames.
+ */
+uint16_t DeltaCodec_Encode(DeltaEncoder_t *Encoder, volatile const uint16_t *Payload, volatile uint16_t *Encoded);
+
+/**
+ * @brief       Applies an encoded payload to the decoded view. Only call it for chunks that
+ *              passed their CRC.
+ *
+ * @param[in]   Encoded: Data of the received measurement chunk.
+ * @param[in,out] Payload: Decoded view, DELTA_WORDS words, kept between frames.
+ * @return      false if the encoding is malformed; the view is then left untouched.
+ */
+bool DeltaCodec_Decode(volatile const uint16_t *Encoded, volatile uint16_t *Payload);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DELTACODEC_H */
+
+/*** end of file ***/
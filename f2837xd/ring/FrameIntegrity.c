@@ -0,0 +1,137 @@
+/**
+ ********************************************************************************
+ * @file    FrameIntegrity.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "device.h"
+#include "FrameIntegrity.h"
+#include "Trace.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+static void resetChannel(uint32_t Base)
+{
+    DMA_stopChannel(Base);
+    DMA_triggerSoftReset(Base);
+    DMA_clearTriggerFlag(Base);
+    DMA_clearErrorFlag(Base);
+}
+
+// Software reset of the SPI state machine, drops a partly shifted word. Configuration and FIFOs are kept.
+static void resetSpi(uint32_t Base)
+{
+    bool enabled = (HWREGH(Base + SPI_O_CCR) & SPI_CCR_SPISWRESET) != 0U;
+
+    SPI_disableModule(Base);
+    if (enabled) SPI_enableModule(Base);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void FrameIntegrity_Init(FrameIntegrity_t *Frame, LinkStats_t *Stats, uint32_t TxDma, uint32_t RxDma,
+                         uint32_t TxSpi, uint32_t RxSpi, uint16_t RxBurst, uint16_t RxWords)
+{
+    Frame->Stats = Stats;
+    Frame->TxDma = TxDma;
+    Frame->RxDma = RxDma;
+    Frame->TxSpi = TxSpi;
+    Frame->RxSpi = RxSpi;
+    Frame->RxBurst = RxBurst;
+    Frame->RxWords = RxWords;
+    Frame->Last = FRAME_COMPLETE;
+    Frame->Missing = 0;
+}
+
+uint16_t FrameIntegrity_Check(FrameIntegrity_t *Frame)
+{
+    uint16_t rx, fifo, left;
+
+    // Nothing more is clocked in, the counts are stable once the burst in progress is done
+    while (DMA_getBurstStatusFlag(Frame->RxDma)) { }
+
+    rx = HWREGH(Frame->RxDma + DMA_O_CONTROL);
+    fifo = (uint16_t)SPI_getRxFIFOStatus(Frame->RxSpi);
+
+    if (((rx | HWREGH(Frame->TxDma + DMA_O_CONTROL)) & DMA_CONTROL_OVRFLG) ||
+        (SPI_getInterruptStatus(Frame->RxSpi) & SPI_INT_RXFF_OVERFLOW)) {
+        Frame->Last = FRAME_OVERRUN;
+        Frame->Missing = 0;
+        Frame->Stats->DmaOverruns++;
+    } else {
+        // Words the RX channel still expects: TRANSFER_COUNT is the bursts left after the current one, and is
+        // only loaded at the first burst
+        if (!(rx & DMA_CONTROL_RUNSTS)) {
+            left = 0;
+        } else if (!(rx & DMA_CONTROL_TRANSFERSTS)) {
+            left = Frame->RxWords;
+        } else {
+            left = (HWREGH(Frame->RxDma + DMA_O_TRANSFER_COUNT) + 1U) * Frame->RxBurst;
+        }
+
+        if (fifo < left) {
+            Frame->Last = FRAME_SHORT;
+            Frame->Missing = left - fifo;
+            Frame->Stats->ShortFrames++;
+        } else if (fifo > left) {
+            Frame->Last = FRAME_LONG;
+            Frame->Missing = fifo - left;
+            Frame->Stats->LengthErrors++;
+        } else {
+            Frame->Last = FRAME_COMPLETE;
+            Frame->Missing = 0;
+        }
+    }
+
+    if (Frame->Last != FRAME_COMPLETE) Trace_Event(TRACE_EV_FRAME_ERROR, Frame->Last, Frame->Missing);
+    return Frame->Last;
+}
+
+void FrameIntegrity_Recover(FrameIntegrity_t *Frame)
+{
+    resetChannel(Frame->TxDma);
+    resetChannel(Frame->RxDma);
+
+    resetSpi(Frame->RxSpi);
+    if (Frame->TxSpi != Frame->RxSpi) resetSpi(Frame->TxSpi);
+    SPI_resetTxFIFO(Frame->TxSpi);
+    SPI_resetRxFIFO(Frame->RxSpi);
+    SPI_clearInterruptStatus(Frame->RxSpi, SPI_INT_RXFF | SPI_INT_RXFF_OVERFLOW);
+    SPI_clearInterruptStatus(Frame->TxSpi, SPI_INT_TXFF);
+
+    Frame->Stats->Recoveries++;
+}
+
+/*** end of file ***/
@@ -0,0 +1,102 @@
+/**
+ ********************************************************************************
+ * @file    FrameIntegrity.h
+ * @brief   Classification of ring frames from the DMA and SPI status, and recovery
+ *          of the channels after a bad one.
+ *
+ *          At the end of a frame (CS rising on a worker, RX completion or the next
+ *          launch on the Director) the status of the ring DMA channels and of the SPI
+ *          RX FIFO tells how the frame went:
+ *
+ *            COMPLETE  every word received, or the last burst about to be moved
+ *            SHORT     the RX channel still waits for words that will not come
+ *            LONG      the RX channel is done and words are left in the RX FIFO
+ *            OVERRUN   a DMA trigger was lost or the RX FIFO overflowed
+ *
+ *          Anything but COMPLETE is recovered in place: both channels are halted and
+ *          soft reset, so the next start reloads their addresses, and the SPI state
+ *          machine and FIFOs are reset. A bad frame costs its own cycle only, the next
+ *          one starts aligned. The CRCs of the frame are checked as usual; a LONG or
+ *          OVERRUN frame whose chunks pass them is still used.
+ ********************************************************************************
+ */
+
+#ifndef FRAMEINTEGRITY_H
+#define FRAMEINTEGRITY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include "LinkStats.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define FRAME_COMPLETE          0U
+#define FRAME_SHORT             1U
+#define FRAME_LONG              2U
+#define FRAME_OVERRUN           3U
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Ring channels of one node.
+ */
+typedef struct {
+    LinkStats_t *Stats;     /*!< Counters of the frame classes and recoveries */
+    uint32_t TxDma;         /*!< DMA channel shifting the frame out */
+    uint32_t RxDma;         /*!< DMA channel receiving the frame */
+    uint32_t TxSpi;         /*!< SPI module fed by TxDma */
+    uint32_t RxSpi;         /*!< SPI module read by RxDma */
+    uint16_t RxBurst;       /*!< Words per RX burst */
+    uint16_t RxWords;       /*!< Words received per frame */
+    uint16_t Last;          /*!< FRAME_* of the last frame checked */
+    uint16_t Missing;       /*!< Words missing from the last SHORT frame, or left over from the last LONG one */
+} FrameIntegrity_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Describes the ring channels. Worker: SPI A both ways. Director: SPI A out, SPI B in.
+ *
+ * @param[in]   Stats: Link statistics to count into.
+ * @param[in]   RxBurst: Words per RX burst, the SPI RX FIFO trigger level.
+ * @param[in]   RxWords: Words of a complete frame, a multiple of RxBurst.
+ */
+void FrameIntegrity_Init(FrameIntegrity_t *Frame, LinkStats_t *Stats, uint32_t TxDma, uint32_t RxDma,
+                         uint32_t TxSpi, uint32_t RxSpi, uint16_t RxBurst, uint16_t RxWords);
+
+/**
+ * @brief       Classifies the frame that just ended and counts it. The sender must have stopped
+ *              clocking; waits for an RX burst in progress, a few cycles at most.
+ *
+ * @return      FRAME_*. Anything but FRAME_COMPLETE calls for FrameIntegrity_Recover().
+ */
+uint16_t FrameIntegrity_Check(FrameIntegrity_t *Frame);
+
+/**
+ * @brief       Halts and resets both channels and clears the SPI state, ready for the channels to be
+ *              started for the next frame. The SPI modules are left enabled or disabled as found.
+ */
+void FrameIntegrity_Recover(FrameIntegrity_t *Frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAMEINTEGRITY_H */
+
+/*** end of file ***/
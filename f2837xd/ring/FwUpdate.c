@@ -0,0 +1,387 @@
+/**
+ ********************************************************************************
+ * @file    FwUpdate.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "FwUpdate.h"
+#include "crc.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BULK_CRC            0
+#define BULK_MAGIC          1
+#define BULK_IMAGE_ID       2
+#define BULK_WORDS_LO       3
+#define BULK_WORDS_HI       4
+#define BULK_SEGMENT        5
+#define BULK_BLOCK          6
+#define BULK_SEGMENT_CRC    7
+
+#define HAVE(map, s)        ((map)[(s) >> 4] & (1U << ((s) & 15U)))
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// A block must carry data, the status reports the workers in a 16 bit mask
+typedef char fwBlockCheck[(FW_BLOCK_WORDS > 0 && NUM_WORKERS <= 16 && FW_MAX_SEGMENTS % 16 == 0) ? 1 : -1];
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+static uint16_t segmentsOf(uint32_t Words)
+{
+    return (uint16_t)((Words + FW_SEGMENT_WORDS - 1) / FW_SEGMENT_WORDS);
+}
+
+// Words of segment s, the last one may be short
+static uint16_t segmentWords(uint32_t Words, uint16_t s)
+{
+    uint32_t left = Words - (uint32_t)s * FW_SEGMENT_WORDS;
+    return left > FW_SEGMENT_WORDS ? FW_SEGMENT_WORDS : (uint16_t)left;
+}
+
+static uint16_t blocksOf(uint16_t Words)
+{
+    return (Words + FW_BLOCK_WORDS - 1) / FW_BLOCK_WORDS;
+}
+
+// Next segment after the current one that a worker still misses and that was not sent too recently
+static uint16_t nextSegment(FwSender_t *Sender)
+{
+    uint16_t k, w;
+    uint16_t s = Sender->Segment;
+
+    for (k = 0; k < Sender->Segments; k++) {
+        if (++s >= Sender->Segments) s = 0;
+        if ((uint16_t)((uint16_t)Sender->BulkFrames - Sender->SentAt[s]) < FW_RESEND_HOLDOFF) continue;
+
+        for (w = 0; w < NUM_WORKERS; w++) {
+            if ((Sender->Reported & (1U << w)) && Sender->Missing[w] != 0 && !HAVE(Sender->Have[w], s)) {
+                return s;
+            }
+        }
+    }
+    return FW_PROBE;
+}
+
+static bool allDone(const FwSender_t *Sender)
+{
+    uint16_t w;
+
+    for (w = 0; w < NUM_WORKERS; w++) {
+        if ((Sender->Reported & (1U << w)) && Sender->Missing[w] != 0) return false;
+    }
+    return true;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+bool FwUpdate_Start(FwSender_t *Sender, const uint16_t *Image, uint32_t Words, uint16_t ImageId)
+{
+    uint16_t i, w;
+
+    if (ImageId == FW_NO_IMAGE || Words == 0 || Words > (uint32_t)FW_MAX_SEGMENTS * FW_SEGMENT_WORDS) return false;
+
+    Sender->Active = 0;
+    Sender->Image = Image;
+    Sender->Words = Words;
+    Sender->ImageId = ImageId;
+    Sender->Segments = segmentsOf(Words);
+    Sender->Probes = Sender->Segments / 16 + 2;     // One full turn of the status windows, plus the round trip
+    Sender->Segment = Sender->Segments - 1;         // Segment 0 goes first
+    Sender->Block = 0;
+    Sender->SegmentCrc = 0;
+    Sender->Reported = 0;
+    for (w = 0; w < NUM_WORKERS; w++) {
+        Sender->Missing[w] = Sender->Segments;
+        for (i = 0; i < FW_MAX_SEGMENTS / 16; i++) {
+            Sender->Have[w][i] = 0;
+        }
+    }
+    for (i = 0; i < FW_MAX_SEGMENTS; i++) {
+        Sender->SentAt[i] = (uint16_t)(0U - FW_RESEND_HOLDOFF);
+    }
+    Sender->BulkFrames = 0;
+    Sender->SegmentsSent = 0;
+    Sender->Active = 1;
+    return true;
+}
+
+bool FwUpdate_NextBulk(FwSender_t *Sender, volatile uint16_t *Bulk)
+{
+    uint16_t i;
+    uint16_t segment = FW_PROBE;
+    uint16_t block = 0;
+    uint16_t words = 0;
+
+    if (!Sender->Active) return false;
+
+    if (Sender->Block != 0) {
+        // Rest of the segment being sent
+        segment = Sender->Segment;
+        block = Sender->Block;
+    } else if (Sender->Probes != 0) {
+        Sender->Probes--;
+    } else {
+        segment = nextSegment(Sender);
+        if (segment == FW_PROBE && allDone(Sender)) {
+            // Also ends an update no worker answered to
+            Sender->Active = 0;
+            return false;
+        }
+        if (segment != FW_PROBE) {
+            Sender->Segment = segment;
+            Sender->SegmentCrc = crcFast(Sender->Image + (uint32_t)segment * FW_SEGMENT_WORDS,
+                                         segmentWords(Sender->Words, segment));
+            Sender->SegmentsSent++;
+        }
+    }
+
+    Bulk[BULK_MAGIC] = FW_BULK_MAGIC;
+    Bulk[BULK_IMAGE_ID] = Sender->ImageId;
+    Bulk[BULK_WORDS_LO] = (uint16_t)Sender->Words;
+    Bulk[BULK_WORDS_HI] = (uint16_t)(Sender->Words >> 16);
+    Bulk[BULK_SEGMENT] = segment;
+    Bulk[BULK_BLOCK] = block;
+    Bulk[BULK_SEGMENT_CRC] = segment == FW_PROBE ? 0 : Sender->SegmentCrc;
+
+    if (segment != FW_PROBE) {
+        uint16_t length = segmentWords(Sender->Words, segment);
+        uint16_t first = block * FW_BLOCK_WORDS;
+        const uint16_t *data = Sender->Image + (uint32_t)segment * FW_SEGMENT_WORDS + first;
+
+        words = length - first;
+        if (words > FW_BLOCK_WORDS) words = FW_BLOCK_WORDS;
+        for (i = 0; i < words; i++) {
+            Bulk[FW_BULK_HEADER_WORDS + i] = data[i];
+        }
+
+        if (++block < blocksOf(length)) {
+            Sender->Block = block;
+        } else {
+            // Holdoff counts from the last block, the workers write the segment from then on
+            Sender->Block = 0;
+            Sender->SentAt[segment] = (uint16_t)Sender->BulkFrames;
+        }
+    }
+    for (i = words; i < FW_BLOCK_WORDS; i++) {
+        Bulk[FW_BULK_HEADER_WORDS + i] = 0;
+    }
+
+    Bulk[BULK_CRC] = crcFast((uint16_t const *)Bulk + 1, FW_BULK_WORDS - 1) ^ FW_CRC_XOR;
+    Sender->BulkFrames++;
+    return true;
+}
+
+void FwUpdate_ReceiveStatus(FwSender_t *Sender, uint16_t Worker, volatile const FrameHeader *Status)
+{
+    uint16_t base = (uint16_t)Status->time;
+    uint16_t have = (uint16_t)(Status->time >> 16);
+
+    if (!Sender->Active || Worker >= NUM_WORKERS || Status->token != Sender->ImageId) return;
+
+    Sender->Reported |= 1U << Worker;
+    Sender->Missing[Worker] = Status->phase;
+    if ((base & 15U) == 0 && base < Sender->Segments) {
+        Sender->Have[Worker][base >> 4] = have;
+    }
+}
+
+void FwUpdate_InitReceiver(FwReceiver_t *Receiver, const FwFlash_t *Flash)
+{
+    uint16_t i;
+
+    Receiver->Flash = Flash;
+    Receiver->ImageId = FW_NO_IMAGE;
+    Receiver->ErasedId = FW_NO_IMAGE;
+    Receiver->Words = 0;
+    Receiver->Segments = 0;
+    Receiver->Missing = 0;
+    Receiver->Window = 0;
+    for (i = 0; i < FW_MAX_SEGMENTS / 16; i++) {
+        Receiver->Have[i] = 0;
+    }
+    for (i = 0; i < FW_SEGMENT_BUFFERS; i++) {
+        Receiver->Buffer[i].State = FW_BUFFER_FREE;
+    }
+    Receiver->Blocks = 0;
+    Receiver->Evicted = 0;
+    Receiver->CrcErrors = 0;
+    Receiver->FlashErrors = 0;
+}
+
+bool FwUpdate_IsBulk(volatile const uint16_t *Bulk)
+{
+    // Magic first, control frames almost never get past it
+    if (Bulk[BULK_MAGIC] != FW_BULK_MAGIC) return false;
+    return (crc_t)(crcFast((uint16_t const *)Bulk + 1, FW_BULK_WORDS - 1) ^ FW_CRC_XOR) == Bulk[BULK_CRC];
+}
+
+void FwUpdate_ReceiveBulk(FwReceiver_t *Receiver, volatile const uint16_t *Bulk)
+{
+    uint16_t i;
+    uint16_t id = Bulk[BULK_IMAGE_ID];
+    uint32_t words = Bulk[BULK_WORDS_LO] | ((uint32_t)Bulk[BULK_WORDS_HI] << 16);
+    uint16_t segment = Bulk[BULK_SEGMENT];
+    uint16_t block = Bulk[BULK_BLOCK];
+    uint16_t crc = Bulk[BULK_SEGMENT_CRC];
+
+    if (id == FW_NO_IMAGE || words == 0 || words > (uint32_t)FW_MAX_SEGMENTS * FW_SEGMENT_WORDS) return;
+
+    if (id != Receiver->ImageId) {
+        // New image: segments in progress are dropped, the background loop erases and starts over
+        Receiver->Words = words;
+        Receiver->Segments = segmentsOf(words);
+        Receiver->Window = 0;
+        for (i = 0; i < FW_SEGMENT_BUFFERS; i++) {
+            if (Receiver->Buffer[i].State == FW_BUFFER_ASSEMBLING) Receiver->Buffer[i].State = FW_BUFFER_FREE;
+        }
+        Receiver->ImageId = id;
+    }
+
+    if (segment == FW_PROBE || segment >= Receiver->Segments) return;
+    if (Receiver->ErasedId == id && HAVE(Receiver->Have, segment)) return;
+
+    uint16_t length = segmentWords(Receiver->Words, segment);
+    if (block >= blocksOf(length)) return;
+
+    // Buffer of this segment, else a free one, else the other segment being assembled
+    FwSegmentBuffer_t *buffer = NULL;
+    FwSegmentBuffer_t *spare = NULL;
+    for (i = 0; i < FW_SEGMENT_BUFFERS; i++) {
+        FwSegmentBuffer_t *b = &Receiver->Buffer[i];
+        if (b->State == FW_BUFFER_FREE) {
+            if (spare == NULL || spare->State != FW_BUFFER_FREE) spare = b;
+        } else if (b->ImageId == id && b->Segment == segment) {
+            if (b->State != FW_BUFFER_ASSEMBLING) return;   // Complete, waits to be written
+            buffer = b;
+            break;
+        } else if (b->State == FW_BUFFER_ASSEMBLING && spare == NULL) {
+            spare = b;
+        }
+    }
+
+    if (buffer == NULL || buffer->Crc != crc) {
+        if (buffer == NULL) {
+            if (spare == NULL) return;  // Both buffers wait to be written, the segment is sent again later
+            if (spare->State == FW_BUFFER_ASSEMBLING) Receiver->Evicted++;
+            buffer = spare;
+        }
+
+        buffer->State = FW_BUFFER_ASSEMBLING;
+        buffer->ImageId = id;
+        buffer->Segment = segment;
+        buffer->Words = length;
+        buffer->Crc = crc;
+        buffer->Received = 0;
+        for (i = 0; i < (FW_SEGMENT_BLOCKS + 15) / 16; i++) {
+            buffer->Blocks[i] = 0;
+        }
+    }
+
+    Receiver->Blocks++;
+    if (HAVE(buffer->Blocks, block)) return;
+
+    uint16_t first = block * FW_BLOCK_WORDS;
+    uint16_t n = length - first;
+    if (n > FW_BLOCK_WORDS) n = FW_BLOCK_WORDS;
+    for (i = 0; i < n; i++) {
+        buffer->Data[first + i] = Bulk[FW_BULK_HEADER_WORDS + i];
+    }
+    buffer->Blocks[block >> 4] |= 1U << (block & 15U);
+
+    // Hands the buffer over to the background loop
+    if (++buffer->Received == blocksOf(length)) buffer->State = FW_BUFFER_COMPLETE;
+}
+
+void FwUpdate_WriteStatus(FwReceiver_t *Receiver, volatile Frame *Measurement, uint16_t Worker)
+{
+    uint16_t base = Receiver->Window;
+    uint16_t have = 0;
+    uint16_t missing = Receiver->Segments;
+
+    // Nothing is written until the staging area was erased for this image
+    if (Receiver->ErasedId == Receiver->ImageId && Receiver->ImageId != FW_NO_IMAGE) {
+        have = Receiver->Have[base >> 4];
+        missing = Receiver->Missing;
+    }
+
+    Measurement->hdr.token = Receiver->ImageId;
+    Measurement->hdr.time = ((uint32_t)have << 16) | base;
+    Measurement->hdr.phase = missing;
+    Measurement->hdr.crc = MEASUREMENT_CRC(Measurement, Worker) ^ FW_CRC_XOR;
+
+    Receiver->Window = (base + 16 >= Receiver->Segments) ? 0 : base + 16;
+}
+
+void FwUpdate_Service(FwReceiver_t *Receiver)
+{
+    uint16_t i;
+    uint16_t id = Receiver->ImageId;
+
+    if (id == FW_NO_IMAGE) return;
+
+    if (Receiver->ErasedId != id) {
+        // Written segments are forgotten before the erase, the status reports them missing meanwhile
+        Receiver->ErasedId = FW_NO_IMAGE;
+        for (i = 0; i < FW_MAX_SEGMENTS / 16; i++) {
+            Receiver->Have[i] = 0;
+        }
+        Receiver->Missing = Receiver->Segments;
+
+        if (!Receiver->Flash->Erase(Receiver->Words)) {
+            Receiver->FlashErrors++;
+            return;
+        }
+        Receiver->ErasedId = id;
+        return;
+    }
+
+    for (i = 0; i < FW_SEGMENT_BUFFERS; i++) {
+        FwSegmentBuffer_t *buffer = &Receiver->Buffer[i];
+        uint16_t segment = buffer->Segment;
+
+        if (buffer->State != FW_BUFFER_COMPLETE) continue;
+        buffer->State = FW_BUFFER_WRITING;
+
+        if (buffer->ImageId == id && !HAVE(Receiver->Have, segment)) {
+            if (crcFast(buffer->Data, buffer->Words) != buffer->Crc) {
+                Receiver->CrcErrors++;
+            } else if (!Receiver->Flash->Program((uint32_t)segment * FW_SEGMENT_WORDS, buffer->Data, buffer->Words)) {
+                Receiver->FlashErrors++;
+            } else if (Receiver->ImageId == id) {
+                Receiver->Have[segment >> 4] |= 1U << (segment & 15U);
+                Receiver->Missing--;
+            }
+        }
+
+        buffer->State = FW_BUFFER_FREE;
+    }
+}
+
+/*** end of file ***/
@@ -0,0 +1,206 @@
+/**
+ ********************************************************************************
+ * @file    FwUpdate.h
+ * @brief   Firmware image distribution to all workers at once, over the ring.
+ *
+ *          During an update the Director interleaves bulk frames with the control frames.
+ *          A bulk frame replaces the broadcast and setpoint chunks, which every worker reads
+ *          in transit, with a single bulk chunk carrying one block of a segment of the image:
+ *
+ *            [crc][magic][image id][image words (2)][segment][block][segment crc][data]
+ *
+ *          Its CRC is XORed with FW_CRC_XOR so it can never pass for control chunks. Workers
+ *          assemble each segment of FW_SEGMENT_WORDS words, check it against the segment CRC
+ *          and hand it to the flash writer of their bootloader stub (FwFlash_t), from the
+ *          background loop. The Director sends each segment in full, block after block.
+ *
+ *          In the frame after a bulk frame, a worker answers with an update status in its
+ *          measurement header instead of a measurement (CRC XORed with FW_CRC_XOR too): the
+ *          image id, 16 segments of its written segment bitmap, rotating over the image, and
+ *          its count of missing segments. The Director keeps a bitmap per worker from these
+ *          and only sends the segments some worker still misses, so a segment lost to a CRC
+ *          error, or an update that was interrupted and started again with the same image id,
+ *          resumes where it stopped. Workers that never answer are left out.
+ ********************************************************************************
+ */
+
+#ifndef FWUPDATE_H
+#define FWUPDATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define FW_BULK_WORDS           (BROADCAST_CHUNK + NUM_WORKERS * SETPOINT_CHUNK)   /*!< Seen by every worker */
+#define FW_BULK_HEADER_WORDS    8U
+#define FW_BLOCK_WORDS          (FW_BULK_WORDS - FW_BULK_HEADER_WORDS)             /*!< Image words per bulk frame */
+
+#define FW_SEGMENT_WORDS        512U    /*!< Image words checked and written at once */
+#define FW_SEGMENT_BLOCKS       ((FW_SEGMENT_WORDS + FW_BLOCK_WORDS - 1) / FW_BLOCK_WORDS)
+#define FW_SEGMENT_BUFFERS      2U      /*!< Segments a worker assembles or writes at the same time */
+#define FW_MAX_SEGMENTS         512U    /*!< Longest image, in segments, multiple of 16 */
+
+#define FW_BULK_MAGIC           0xF1A5U
+#define FW_CRC_XOR              0xB007U /*!< Applied to the CRC of bulk chunks and status headers */
+#define FW_PROBE                0xFFFFU /*!< Segment of a bulk frame that only asks for the status */
+#define FW_NO_IMAGE             0U      /*!< Image ids are non-zero */
+
+#define FW_RESEND_HOLDOFF       64U     /*!< Bulk frames before a segment is sent again, covers its write */
+
+// Segment buffer states. The ring interrupt fills FREE and ASSEMBLING buffers, the background loop
+// writes COMPLETE buffers out and frees them.
+#define FW_BUFFER_FREE          0U
+#define FW_BUFFER_ASSEMBLING    1U
+#define FW_BUFFER_COMPLETE      2U
+#define FW_BUFFER_WRITING       3U
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Flash writer of the bootloader stub. Both calls block and return false on failure.
+ */
+typedef struct {
+    bool (*Erase)(uint32_t Words);                                  /*!< Erases the staging area for an image */
+    bool (*Program)(uint32_t Offset, const uint16_t *Data, uint16_t Words); /*!< Programs and verifies */
+} FwFlash_t;
+
+/**
+ * @brief Director side of an update.
+ */
+typedef struct {
+    const uint16_t *Image;                          /*!< Image being distributed */
+    uint32_t Words;                                 /*!< Image length in words */
+    uint16_t ImageId;                               /*!< Image id, FW_NO_IMAGE when idle */
+    uint16_t Segments;                              /*!< Segments of the image */
+    uint16_t Active;                                /*!< Update running */
+    uint16_t Probes;                                /*!< Status only bulk frames left before data is sent */
+    uint16_t Segment;                               /*!< Segment being sent */
+    uint16_t Block;                                 /*!< Next block of Segment, 0 between segments */
+    uint16_t SegmentCrc;                            /*!< CRC of Segment */
+    uint16_t Reported;                              /*!< Bit w set once worker w reported on this image */
+    uint16_t Missing[NUM_WORKERS];                  /*!< Segments each worker still misses */
+    uint16_t Have[NUM_WORKERS][FW_MAX_SEGMENTS / 16];   /*!< Segments written by each worker, as last reported */
+    uint16_t SentAt[FW_MAX_SEGMENTS];               /*!< BulkFrames when each segment was last sent */
+    uint32_t BulkFrames;                            /*!< Bulk frames sent for this image */
+    uint32_t SegmentsSent;                          /*!< Segments sent, resent ones included */
+} FwSender_t;
+
+/**
+ * @brief Segment being assembled or written by a worker.
+ */
+typedef struct {
+    volatile uint16_t State;                        /*!< FW_BUFFER_* */
+    uint16_t ImageId;                               /*!< Image the segment belongs to */
+    uint16_t Segment;                               /*!< Segment index */
+    uint16_t Words;                                 /*!< Words of the segment */
+    uint16_t Crc;                                   /*!< Expected CRC of the segment */
+    uint16_t Received;                              /*!< Blocks received */
+    uint16_t Blocks[(FW_SEGMENT_BLOCKS + 15) / 16]; /*!< Bit b set once block b was received */
+    uint16_t Data[FW_SEGMENT_WORDS];                /*!< Segment data */
+} FwSegmentBuffer_t;
+
+/**
+ * @brief Worker side of an update.
+ */
+typedef struct {
+    const FwFlash_t *Flash;                         /*!< Flash writer */
+    volatile uint16_t ImageId;                      /*!< Image being received, FW_NO_IMAGE if none */
+    volatile uint16_t ErasedId;                     /*!< Image the staging area was erased for */
+    uint32_t Words;                                 /*!< Image length in words */
+    uint16_t Segments;                              /*!< Segments of the image */
+    uint16_t Missing;                               /*!< Segments not written yet */
+    uint16_t Window;                                /*!< First segment of the next status */
+    uint16_t Have[FW_MAX_SEGMENTS / 16];            /*!< Segments written */
+    FwSegmentBuffer_t Buffer[FW_SEGMENT_BUFFERS];   /*!< Segments in progress */
+    uint32_t Blocks;                                /*!< Blocks received */
+    uint32_t Evicted;                               /*!< Segments given up for a newer one before completion */
+    uint32_t CrcErrors;                             /*!< Segments that failed their CRC */
+    uint32_t FlashErrors;                           /*!< Failed erases and writes */
+} FwReceiver_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Starts distributing an image (Director). The first bulk frames only collect the
+ *              status of the workers, so an update started again with the same image id resumes.
+ *
+ * @param[in]   Image: Image, kept until the update is done.
+ * @param[in]   Words: Image length in words, at most FW_MAX_SEGMENTS * FW_SEGMENT_WORDS.
+ * @param[in]   ImageId: Non-zero image id.
+ * @return      false if the image is too long or the id is FW_NO_IMAGE.
+ */
+bool FwUpdate_Start(FwSender_t *Sender, const uint16_t *Image, uint32_t Words, uint16_t ImageId);
+
+/**
+ * @brief       Prepares the next bulk frame (Director).
+ *
+ * @param[out]  Bulk: Start of the Director TX image of the bulk frame, FW_BULK_WORDS words.
+ * @return      false once every worker that answered has written the whole image; the update is
+ *              then over.
+ */
+bool FwUpdate_NextBulk(FwSender_t *Sender, volatile uint16_t *Bulk);
+
+/**
+ * @brief       Takes the update status a worker returned in its measurement header (Director).
+ *              Only call it for headers whose CRC XORed with FW_CRC_XOR matches.
+ */
+void FwUpdate_ReceiveStatus(FwSender_t *Sender, uint16_t Worker, volatile const FrameHeader *Status);
+
+/**
+ * @brief       Initializes the worker side.
+ *
+ * @param[in]   Flash: Flash writer, NULL for a worker that never takes a bulk frame and only reports idle.
+ */
+void FwUpdate_InitReceiver(FwReceiver_t *Receiver, const FwFlash_t *Flash);
+
+/**
+ * @brief       Tells a bulk frame from a control frame (worker).
+ *
+ * @param[in]   Bulk: Director offset 0 of the received image, FW_BULK_WORDS words.
+ */
+bool FwUpdate_IsBulk(volatile const uint16_t *Bulk);
+
+/**
+ * @brief       Takes the block of a bulk frame, from the ring interrupt (worker).
+ */
+void FwUpdate_ReceiveBulk(FwReceiver_t *Receiver, volatile const uint16_t *Bulk);
+
+/**
+ * @brief       Writes the update status into the own measurement header, in place of the
+ *              measurement of the next frame (worker).
+ *
+ * @param[in]   Worker: Own worker id, keys the CRC like that of the measurement (MEASUREMENT_CRC()).
+ */
+void FwUpdate_WriteStatus(FwReceiver_t *Receiver, volatile Frame *Measurement, uint16_t Worker);
+
+/**
+ * @brief       Erases the staging area of a new image and writes the completed segments, from the
+ *              background loop (worker). Blocks for the duration of the flash operations.
+ */
+void FwUpdate_Service(FwReceiver_t *Receiver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FWUPDATE_H */
+
+/*** end of file ***/
@@ -0,0 +1,146 @@
+/**
+ ********************************************************************************
+ * @file    Latency.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "Latency.h"
+#include "cpu.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define TOKEN_SLOT(token)   ((token) & (LATENCY_TOKEN_HISTORY - 1))
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+    uint16_t Token;     /*!< Token of the launched frame */
+    uint16_t Valid;     /*!< Slot has been written at least once */
+    uint32_t Launch;    /*!< Launch timestamp */
+} Launch_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static Launch_t launches[LATENCY_TOKEN_HISTORY];   /*!< Launch history, indexed by token */
+static uint32_t ticksPerUs;
+static uint32_t periodUs;
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+LatencyReport_t latency;    /*!< Live statistics, also readable from the debugger */
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static void clearReport(uint16_t Sequence)
+{
+    uint16_t i;
+
+    memset(&latency, 0, sizeof(latency));
+    latency.Sequence = Sequence;
+    latency.NumWorkers = NUM_WORKERS;
+    latency.LatencyOriginTicks = periodUs * ticksPerUs;
+    latency.LatencyBinTicks = LATENCY_BIN_US * ticksPerUs;
+    latency.JitterBinTicks = JITTER_BIN_US * ticksPerUs;
+    for (i = 0; i < NUM_WORKERS; i++) {
+        latency.Worker[i].Min = UINT32_MAX;
+    }
+}
+
+static inline uint16_t binOf(uint32_t Value, uint32_t BinWidth)
+{
+    uint32_t bin = Value / BinWidth;
+    return (bin < LATENCY_NUM_BINS) ? (uint16_t)bin : (LATENCY_NUM_BINS - 1);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void Latency_Init(uint32_t TicksPerUs, uint32_t PeriodUs)
+{
+    ticksPerUs = TicksPerUs;
+    periodUs = PeriodUs;
+    memset(launches, 0, sizeof(launches));
+    clearReport(0);
+}
+
+void Latency_FrameLaunched(uint16_t Token, uint32_t Now)
+{
+    Launch_t * const slot = &launches[TOKEN_SLOT(Token)];
+
+    slot->Token = Token;
+    slot->Launch = Now;
+    slot->Valid = 1;
+    latency.Frames++;
+}
+
+void Latency_Record(uint16_t Worker, uint16_t Token, uint32_t Now)
+{
+    if (Worker >= NUM_WORKERS) return;
+
+    Launch_t const * const slot = &launches[TOKEN_SLOT(Token)];
+    WorkerLatency_t * const w = &latency.Worker[Worker];
+
+    // The slot may have been reused by a more recent frame if the worker lags too far behind
+    if (!slot->Valid || slot->Token != Token) {
+        w->Stale++;
+        return;
+    }
+
+    uint32_t lat = Now - slot->Launch;
+
+    if (w->Samples != 0) {
+        uint32_t jitter = (lat > w->Last) ? (lat - w->Last) : (w->Last - lat);
+        w->JitterHist[binOf(jitter, latency.JitterBinTicks)]++;
+    }
+
+    if (lat < w->Min) w->Min = lat;
+    if (lat > w->Max) w->Max = lat;
+    w->Last = lat;
+    w->LatencyHist[binOf((lat > latency.LatencyOriginTicks) ? lat - latency.LatencyOriginTicks : 0,
+                         latency.LatencyBinTicks)]++;
+    w->Samples++;
+}
+
+bool Latency_LaunchTime(uint16_t Token, uint32_t * const Launch)
+{
+    Launch_t const * const slot = &launches[TOKEN_SLOT(Token)];
+
+    if (!slot->Valid || slot->Token != Token) return false;
+
+    *Launch = slot->Launch;
+    return true;
+}
+
+void Latency_Export(LatencyReport_t * const Report)
+{
+    DINT;
+    memcpy(Report, &latency, sizeof(LatencyReport_t));
+    EINT;
+}
+
+void Latency_Reset(void)
+{
+    DINT;
+    clearReport(latency.Sequence + 1);
+    EINT;
+}
+
+/*** end of file ***/
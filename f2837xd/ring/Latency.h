@@ -0,0 +1,145 @@
+/**
+ ********************************************************************************
+ * @file    Latency.h
+ * @brief   End-to-end ring latency and jitter histograms, kept by the Director.
+ *
+ *          Every frame the Director stamps a cycle token into the setpoint headers and
+ *          timestamps the frame launch. Workers echo the token of the last valid setpoint
+ *          they received in their measurement header. When the measurement comes back, the
+ *          latency of worker k is the time from the launch of the frame that carried the
+ *          echoed token to the RX completion of the frame that returned it.
+ *
+ *          The token comes back a frame later, so the latency is a frame period plus the
+ *          ring transit. The latency histogram is of what exceeds the period, which is what
+ *          varies: bin 0 starts at the period and also collects anything shorter.
+ ********************************************************************************
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define LATENCY_NUM_BINS        32      /*!< Number of histogram bins, the last bin collects every overflow */
+#define LATENCY_BIN_US          100UL   /*!< Width of a latency bin in microseconds, past the frame period */
+#define JITTER_BIN_US           10UL    /*!< Width of a jitter bin in microseconds */
+
+#define LATENCY_TOKEN_HISTORY   8       /*!< Number of launched frames remembered, must be a power of 2 */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Latency statistics of a single worker.
+ *
+ * Latencies are expressed in timestamp ticks (SYSCLK). The jitter is the absolute difference
+ * between two consecutive latency samples of the same worker.
+ */
+typedef struct {
+    uint32_t Samples;                           /*!< Number of latency samples recorded */
+    uint32_t Stale;                             /*!< Echoed tokens that were not found in the launch history */
+    uint32_t Min;                               /*!< Minimum latency, in ticks */
+    uint32_t Max;                               /*!< Maximum latency, in ticks */
+    uint32_t Last;                              /*!< Last latency, in ticks */
+    uint32_t LatencyHist[LATENCY_NUM_BINS];     /*!< Latency histogram past LatencyOriginTicks, LATENCY_BIN_US wide bins */
+    uint32_t JitterHist[LATENCY_NUM_BINS];      /*!< Jitter histogram, JITTER_BIN_US wide bins */
+} WorkerLatency_t;
+
+/**
+ * @brief Exportable latency report, one entry per worker.
+ *
+ * Sequence is incremented every time the report is reset so a host reading the report
+ * can tell two collection windows apart.
+ */
+typedef struct {
+    uint16_t Sequence;                          /*!< Collection window identifier */
+    uint16_t NumWorkers;                        /*!< Number of valid entries in Worker[] */
+    uint32_t Frames;                            /*!< Number of frames launched in this window */
+    uint32_t LatencyOriginTicks;                /*!< Start of the first latency bin, the frame period in ticks */
+    uint32_t LatencyBinTicks;                   /*!< Width of a latency bin in ticks */
+    uint32_t JitterBinTicks;                    /*!< Width of a jitter bin in ticks */
+    WorkerLatency_t Worker[NUM_WORKERS];        /*!< Per-worker statistics */
+} LatencyReport_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Initializes the latency statistics and clears all histograms.
+ *
+ * @param[in]   TicksPerUs: Timestamp ticks per microsecond, used to scale the histogram bins.
+ * @param[in]   PeriodUs: Frame period in microseconds, where the latency histogram starts.
+ */
+void Latency_Init(uint32_t TicksPerUs, uint32_t PeriodUs);
+
+/**
+ * @brief       Records the launch of a frame.
+ *
+ *              Must be called right before the TX DMA is started, with the token written in the
+ *              setpoint headers of that frame.
+ *
+ * @param[in]   Token: Cycle token carried by the frame.
+ * @param[in]   Now: Timestamp of the launch.
+ */
+void Latency_FrameLaunched(uint16_t Token, uint32_t Now);
+
+/**
+ * @brief       Records the token echoed by a worker when its measurement is received.
+ *
+ *              Must only be called for measurements whose CRC is valid.
+ *
+ * @param[in]   Worker: Index of the worker that echoed the token.
+ * @param[in]   Token: Token found in the measurement header.
+ * @param[in]   Now: Timestamp of the RX completion.
+ */
+void Latency_Record(uint16_t Worker, uint16_t Token, uint32_t Now);
+
+/**
+ * @brief       Looks up the launch timestamp of a recent frame.
+ *
+ * @param[in]   Token: Token carried by the frame.
+ * @param[out]  Launch: Launch timestamp of the frame, when found.
+ * @return      true if the frame is still in the launch history.
+ */
+bool Latency_LaunchTime(uint16_t Token, uint32_t * const Launch);
+
+/**
+ * @brief       Copies the current statistics into a report.
+ *
+ *              Interrupts are disabled while copying so the report is coherent with the
+ *              RX interrupt that updates the statistics.
+ *
+ * @param[out]  Report: Destination of the copy.
+ */
+void Latency_Export(LatencyReport_t * const Report);
+
+/**
+ * @brief       Clears all histograms and opens a new collection window.
+ */
+void Latency_Reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATENCY_H */
+
+/*** end of file ***/
@@ -0,0 +1,95 @@
+/**
+ ********************************************************************************
+ * @file    LinkStats.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "LinkStats.h"
+#include "Mailbox.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// A block must fit a single mailbox message
+typedef char linkStatsFitsCheck[(LINK_STATS_WORDS <= MAILBOX_MESSAGE_WORDS) ? 1 : -1];
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void LinkStats_Init(LinkStats_t *Stats)
+{
+    uint16_t *words = (uint16_t *)Stats;
+    uint16_t i;
+
+    for (i = 0; i < LINK_STATS_WORDS; i++) {
+        words[i] = 0;
+    }
+}
+
+void LinkStats_Latency(LinkStats_t *Stats, uint32_t Ticks)
+{
+    uint16_t ticks = Ticks > 0xFFFFU ? 0xFFFFU : (uint16_t)Ticks;
+
+    if (ticks > Stats->IsrLatencyMax) Stats->IsrLatencyMax = ticks;
+}
+
+void LinkStats_RxIsr(LinkStats_t *Stats, uint32_t Ticks)
+{
+    uint16_t ticks = Ticks > 0xFFFFU ? 0xFFFFU : (uint16_t)Ticks;
+
+    if (ticks > Stats->RxIsrMax) Stats->RxIsrMax = ticks;
+}
+
+void LinkStats_Pack(const LinkStats_t *Stats, uint16_t *Data)
+{
+    const uint16_t *words = (const uint16_t *)Stats;
+    uint16_t i;
+
+    for (i = 0; i < LINK_STATS_WORDS; i++) {
+        Data[i] = words[i];
+    }
+}
+
+bool LinkStats_Unpack(LinkStats_t *Stats, const uint16_t *Data, uint16_t Length)
+{
+    uint16_t *words = (uint16_t *)Stats;
+    uint16_t i;
+
+    if (Length != LINK_STATS_WORDS) return false;
+
+    for (i = 0; i < LINK_STATS_WORDS; i++) {
+        words[i] = Data[i];
+    }
+    return true;
+}
+
+/*** end of file ***/
@@ -0,0 +1,114 @@
+/**
+ ********************************************************************************
+ * @file    LinkStats.h
+ * @brief   Link health counters, kept by every node of the ring.
+ *
+ *          All counters are 16 bit and wrap around; readers work with differences
+ *          between two reads. Each one is updated with a single increment (one INC
+ *          instruction on the C28x), so the ISRs that share a block never lock it.
+ *          Workers send their block to the Director over the mailbox channel as a
+ *          MAILBOX_TYPE_LINK_STATS message, which the Director keeps per worker.
+ ********************************************************************************
+ */
+
+#ifndef LINKSTATS_H
+#define LINKSTATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define LINK_STATS_WORDS        WORDS(LinkStats_t)     /*!< Words of a MAILBOX_TYPE_LINK_STATS message */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Link statistics of one node. Every field is a word, in message order.
+ *
+ * Setpoint CRC errors are the Director to worker direction, measurement CRC errors the worker
+ * to Director direction. The Director only checks measurements; workers check every chunk
+ * that passes them.
+ */
+typedef struct {
+    uint16_t FramesSent;                        /*!< TX DMA completions */
+    uint16_t FramesReceived;                    /*!< RX DMA completions */
+    uint16_t BroadcastCrcErrors;                /*!< Broadcast chunks failing their CRC (workers) */
+    uint16_t SetpointCrcErrors[NUM_WORKERS];    /*!< Setpoint chunks failing their CRC, per worker (workers) */
+    uint16_t MeasurementCrcErrors[NUM_WORKERS]; /*!< Measurement chunks failing their CRC, per worker */
+    uint16_t DecodeErrors;                      /*!< Delta encoded measurements rejected (Director) */
+    uint16_t LateChunks;                        /*!< Setpoints stamped after the TX channel reached them (Director) */
+    uint16_t CsOverruns;                        /*!< Frames started before the previous transfer completed */
+    uint16_t DmaOverruns;                       /*!< Frames that lost a ring DMA trigger or overflowed the RX FIFO */
+    uint16_t LengthErrors;                      /*!< Frames that left words in the RX FIFO */
+    uint16_t ShortFrames;                       /*!< Frames that ended before every word was received */
+    uint16_t Recoveries;                        /*!< Ring DMA channels and SPI reset after a bad frame */
+    uint16_t Realignments;                      /*!< RX DMA destination moved after a word slip (Realign.h) */
+    uint16_t SlippedFrames;                     /*!< Frames with a word slip past their first chunks (Realign.h) */
+    uint16_t BulkFrames;                        /*!< Firmware bulk frames */
+    uint16_t IsrLatencyMax;                     /*!< Longest CS falling edge to ISR entry, in ticks, saturated (workers) */
+    uint16_t RxIsrMax;                          /*!< Longest RX DMA interrupt of a control frame, in ticks, saturated (workers) */
+} LinkStats_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Clears every counter.
+ */
+void LinkStats_Init(LinkStats_t *Stats);
+
+/**
+ * @brief       Records an ISR latency, keeping the longest.
+ *
+ * @param[in]   Ticks: Hardware event to ISR entry, in timestamp ticks.
+ */
+void LinkStats_Latency(LinkStats_t *Stats, uint32_t Ticks);
+
+/**
+ * @brief       Records the duration of an RX DMA interrupt, keeping the longest.
+ *
+ * @param[in]   Ticks: ISR entry to exit, in timestamp ticks.
+ */
+void LinkStats_RxIsr(LinkStats_t *Stats, uint32_t Ticks);
+
+/**
+ * @brief       Copies the counters into a message.
+ *
+ * @param[out]  Data: LINK_STATS_WORDS words.
+ */
+void LinkStats_Pack(const LinkStats_t *Stats, uint16_t *Data);
+
+/**
+ * @brief       Takes the counters out of a received message.
+ *
+ * @param[in]   Data: Message data.
+ * @param[in]   Length: Words of Data.
+ * @return      false if the message does not hold a block of this configuration; Stats is then
+ *              left untouched.
+ */
+bool LinkStats_Unpack(LinkStats_t *Stats, const uint16_t *Data, uint16_t Length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINKSTATS_H */
+
+/*** end of file ***/
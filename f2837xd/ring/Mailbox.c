@@ -0,0 +1,221 @@
+/**
+ ********************************************************************************
+ * @file    Mailbox.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "Mailbox.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// Cumulative acknowledgements modulo 16 stay unambiguous with less than 8 fragments in flight
+typedef char mailboxWindowCheck[(MAILBOX_WINDOW >= 1 && MAILBOX_WINDOW < 8) ? 1 : -1];
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+// Word i of a message as sent: type, then data
+static uint16_t messageWord(const MailboxMessage_t *Message, uint16_t i)
+{
+    return i == 0 ? Message->Type : Message->Data[i - 1];
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void Mailbox_Init(Mailbox_t *Mailbox)
+{
+    Mailbox->TxBusy = 0;
+    Mailbox->RxReady = 0;
+    Mailbox->Synced = 0;
+    Mailbox->TxSeq = 0;
+    Mailbox->TxFragments = 0;
+    Mailbox->TxBase = 0;
+    Mailbox->TxNext = 0;
+    Mailbox->TxSent = 0;
+    Mailbox->TxStall = 0;
+    Mailbox->PeerExpected = 0;
+    Mailbox->RxExpected = 0;
+    Mailbox->RxWords = 0;
+    Mailbox->Sent = 0;
+    Mailbox->Received = 0;
+    Mailbox->Retransmits = 0;
+    Mailbox->Resyncs = 0;
+    Mailbox->Rejected = 0;
+}
+
+bool Mailbox_Send(Mailbox_t *Mailbox, uint16_t Type, const uint16_t *Data, uint16_t Length)
+{
+    uint16_t i;
+
+    if (Mailbox->TxBusy || Length > MAILBOX_MESSAGE_WORDS) return false;
+
+    Mailbox->Tx.Type = Type;
+    Mailbox->Tx.Length = Length;
+    for (i = 0; i < Length; i++) {
+        Mailbox->Tx.Data[i] = Data[i];
+    }
+    Mailbox->TxFragments = (Length + 1 + MAILBOX_FRAGMENT_WORDS - 1) / MAILBOX_FRAGMENT_WORDS;
+    Mailbox->TxBase = 0;
+    Mailbox->TxNext = 0;
+    Mailbox->TxSent = 0;
+    Mailbox->TxStall = 0;
+
+    // Hands Tx over to the ring interrupt
+    Mailbox->TxBusy = 1;
+    return true;
+}
+
+bool Mailbox_Take(Mailbox_t *Mailbox, MailboxMessage_t *Message)
+{
+    uint16_t i;
+
+    if (!Mailbox->RxReady) return false;
+
+    Message->Type = Mailbox->Rx.Type;
+    Message->Length = Mailbox->Rx.Length;
+    for (i = 0; i < Mailbox->Rx.Length; i++) {
+        Message->Data[i] = Mailbox->Rx.Data[i];
+    }
+
+    // Hands Rx back to the ring interrupt
+    Mailbox->RxReady = 0;
+    return true;
+}
+
+void Mailbox_Transmit(Mailbox_t *Mailbox, volatile uint16_t *Slot)
+{
+    uint16_t control = (Mailbox->RxExpected << MAILBOX_ACK_S) & MAILBOX_ACK_M;
+    uint16_t words = 0;
+    uint16_t i;
+
+    if (Mailbox->RxReady) control |= MAILBOX_BUSY;
+
+    if (Mailbox->TxBusy && Mailbox->Synced) {
+        // Cycle through the window, fragments not acknowledged meanwhile go out again
+        if (Mailbox->TxNext >= Mailbox->TxFragments || Mailbox->TxNext >= Mailbox->TxBase + MAILBOX_WINDOW) {
+            Mailbox->TxNext = Mailbox->TxBase;
+        }
+        uint16_t fragment = Mailbox->TxNext++;
+
+        if (Mailbox->TxSent == 0) {
+            // The message starts at the sequence number the peer expects
+            Mailbox->TxSeq = Mailbox->PeerExpected;
+        }
+        if (fragment < Mailbox->TxSent) {
+            Mailbox->Retransmits++;
+        } else {
+            Mailbox->TxSent = fragment + 1;
+        }
+
+        uint16_t first = fragment * MAILBOX_FRAGMENT_WORDS;
+        words = Mailbox->Tx.Length + 1 - first;
+        if (words > MAILBOX_FRAGMENT_WORDS) words = MAILBOX_FRAGMENT_WORDS;
+        for (i = 0; i < words; i++) {
+            Slot[1 + i] = messageWord(&Mailbox->Tx, first + i);
+        }
+
+        control |= MAILBOX_DATA | ((Mailbox->TxSeq + fragment) & MAILBOX_SEQ_M) | (words << MAILBOX_LENGTH_S);
+        if (fragment == 0) control |= MAILBOX_FIRST;
+        if (fragment == Mailbox->TxFragments - 1) control |= MAILBOX_LAST;
+    }
+
+    for (i = words; i < MAILBOX_FRAGMENT_WORDS; i++) {
+        Slot[1 + i] = 0;
+    }
+    Slot[0] = control;
+}
+
+void Mailbox_Receive(Mailbox_t *Mailbox, volatile const uint16_t *Slot)
+{
+    uint16_t control = Slot[0];
+    uint16_t i;
+
+    // Acknowledgement of what we sent
+    Mailbox->PeerExpected = (control & MAILBOX_ACK_M) >> MAILBOX_ACK_S;
+    Mailbox->Synced = 1;
+
+    if (Mailbox->TxBusy && Mailbox->TxSent) {
+        uint16_t acked = (Mailbox->PeerExpected - Mailbox->TxSeq - Mailbox->TxBase) & MAILBOX_SEQ_M;
+
+        if (acked != 0 && acked <= Mailbox->TxSent - Mailbox->TxBase) {
+            Mailbox->TxBase += acked;
+            Mailbox->TxStall = 0;
+            if (Mailbox->TxNext < Mailbox->TxBase) Mailbox->TxNext = Mailbox->TxBase;
+            if (Mailbox->TxBase == Mailbox->TxFragments) {
+                Mailbox->Sent++;
+                Mailbox->TxBusy = 0;
+            }
+        } else if (!(control & MAILBOX_BUSY) && ++Mailbox->TxStall >= MAILBOX_RESYNC_FRAMES) {
+            // The peer expects a sequence number outside the window, e.g. after a reset
+            Mailbox->TxBase = 0;
+            Mailbox->TxNext = 0;
+            Mailbox->TxSent = 0;
+            Mailbox->TxStall = 0;
+            Mailbox->Resyncs++;
+        }
+    }
+
+    // Fragment carried, accepted in sequence only: a repeated one was already acknowledged
+    if (!(control & MAILBOX_DATA)) return;
+    if (Mailbox->RxReady || (control & MAILBOX_SEQ_M) != Mailbox->RxExpected) return;
+
+    Mailbox->RxExpected = (Mailbox->RxExpected + 1) & MAILBOX_SEQ_M;
+
+    uint16_t words = control >> MAILBOX_LENGTH_S;
+    if (control & MAILBOX_FIRST) Mailbox->RxWords = 0;
+
+    // Acknowledged but dropped, so the sender moves on: start of the message missed, or message too long
+    if ((Mailbox->RxWords == 0 && !(control & MAILBOX_FIRST)) || words == 0 || words > MAILBOX_FRAGMENT_WORDS ||
+        Mailbox->RxWords + words > MAILBOX_MESSAGE_WORDS + 1) {
+        Mailbox->RxWords = 0;
+        Mailbox->Rejected++;
+        return;
+    }
+
+    for (i = 0; i < words; i++) {
+        uint16_t at = Mailbox->RxWords + i;
+        if (at == 0) {
+            Mailbox->Rx.Type = Slot[1 + i];
+        } else {
+            Mailbox->Rx.Data[at - 1] = Slot[1 + i];
+        }
+    }
+    Mailbox->RxWords += words;
+
+    if (control & MAILBOX_LAST) {
+        Mailbox->Rx.Length = Mailbox->RxWords - 1;
+        Mailbox->RxWords = 0;
+        Mailbox->Received++;
+        Mailbox->RxReady = 1;
+    }
+}
+
+/*** end of file ***/
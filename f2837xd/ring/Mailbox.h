@@ -0,0 +1,157 @@
+/**
+ ********************************************************************************
+ * @file    Mailbox.h
+ * @brief   Slow mailbox channel carried alongside the control payloads.
+ *
+ *          Each setpoint (Director to worker) and measurement (worker to Director) chunk
+ *          reserves MAILBOX_WORDS words for one fragment of a mailbox message, so parameter
+ *          accesses, log pulls or diagnostics never lengthen the control payloads. Both ends
+ *          of a link run a Mailbox_t that sends and receives at the same time.
+ *
+ *          A fragment is a control word followed by up to MAILBOX_FRAGMENT_WORDS words of
+ *          the message (type word first, then the data). Fragments are numbered modulo 16
+ *          and every fragment acknowledges, cumulatively, the next sequence number the
+ *          sender of the fragment expects. Up to MAILBOX_WINDOW fragments are in flight,
+ *          which covers the two frame round trip of the ring; unacknowledged fragments are
+ *          sent again in turn. Only fragments of chunks that passed their CRC are processed,
+ *          a lost or repeated chunk is recovered by the retransmission.
+ *
+ *          A message that makes no progress for MAILBOX_RESYNC_FRAMES frames is restarted
+ *          at the sequence number the peer expects, which also resynchronizes both ends
+ *          after either one was reset (the message in flight may then be lost). A receiver
+ *          holding a message that was not taken yet flags itself busy instead of accepting
+ *          the next one.
+ ********************************************************************************
+ */
+
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define MAILBOX_MESSAGE_WORDS   64U     /*!< Longest message data, in words */
+#define MAILBOX_WINDOW          2U      /*!< Fragments in flight, less than 8 */
+#define MAILBOX_RESYNC_FRAMES   32U     /*!< Frames without progress before a message is restarted */
+
+#define MAILBOX_FRAGMENT_WORDS  (MAILBOX_WORDS > 1 ? MAILBOX_WORDS - 1 : 1)   /*!< Message words per fragment */
+
+// Fragment control word
+#define MAILBOX_SEQ_M           0x000FU /*!< Sequence number of the fragment */
+#define MAILBOX_ACK_S           4U
+#define MAILBOX_ACK_M           0x00F0U /*!< Next sequence number expected from the peer */
+#define MAILBOX_DATA            0x0100U /*!< The fragment carries message words */
+#define MAILBOX_FIRST           0x0200U /*!< First fragment of a message */
+#define MAILBOX_LAST            0x0400U /*!< Last fragment of a message */
+#define MAILBOX_BUSY            0x0800U /*!< The sender still holds a received message */
+#define MAILBOX_LENGTH_S        12U     /*!< Message words in the fragment */
+
+// Message types, the first word of every message
+#define MAILBOX_TYPE_ECHO       0x0001U /*!< Sent back unchanged by the workers */
+#define MAILBOX_TYPE_LINK_STATS 0x0002U /*!< LinkStats_t of a worker, sent once per second */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief A mailbox message.
+ */
+typedef struct {
+    uint16_t Type;                          /*!< Message type, MAILBOX_TYPE_* */
+    uint16_t Length;                        /*!< Words of Data used */
+    uint16_t Data[MAILBOX_MESSAGE_WORDS];   /*!< Message data */
+} MailboxMessage_t;
+
+/**
+ * @brief One end of a mailbox link.
+ *
+ * Tx is owned by the ring interrupt while TxBusy is set, Rx by the caller while RxReady is set.
+ */
+typedef struct {
+    MailboxMessage_t Tx;            /*!< Message being sent */
+    MailboxMessage_t Rx;            /*!< Message being received, or received and not taken yet */
+    volatile uint16_t TxBusy;       /*!< Tx is being sent */
+    volatile uint16_t RxReady;      /*!< Rx holds a complete message */
+    uint16_t Synced;                /*!< The sequence number expected by the peer is known */
+    uint16_t TxSeq;                 /*!< Sequence number of the first fragment of Tx */
+    uint16_t TxFragments;           /*!< Fragments of Tx */
+    uint16_t TxBase;                /*!< Oldest fragment of Tx not acknowledged */
+    uint16_t TxNext;                /*!< Next fragment of Tx to send */
+    uint16_t TxSent;                /*!< Fragments of Tx sent at least once */
+    uint16_t TxStall;               /*!< Frames received without progress of Tx */
+    uint16_t PeerExpected;          /*!< Last acknowledgement of the peer */
+    uint16_t RxExpected;            /*!< Sequence number of the next fragment to accept */
+    uint16_t RxWords;               /*!< Message words received, type included, 0 outside a message */
+    uint32_t Sent;                  /*!< Messages sent and acknowledged */
+    uint32_t Received;              /*!< Messages received */
+    uint32_t Retransmits;           /*!< Fragments sent again, including while their acknowledgement is on its way */
+    uint32_t Resyncs;               /*!< Messages restarted */
+    uint32_t Rejected;              /*!< Fragments acknowledged but dropped: message start missed or message too long */
+} Mailbox_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Initializes one end of a link.
+ */
+void Mailbox_Init(Mailbox_t *Mailbox);
+
+/**
+ * @brief       Queues a message for sending.
+ *
+ * @param[in]   Type: Message type.
+ * @param[in]   Data: Message data, copied.
+ * @param[in]   Length: Words of Data, at most MAILBOX_MESSAGE_WORDS.
+ * @return      false if the previous message is still being sent or the message is too long.
+ */
+bool Mailbox_Send(Mailbox_t *Mailbox, uint16_t Type, const uint16_t *Data, uint16_t Length);
+
+/**
+ * @brief       Takes the message received, if any, and frees the receiver for the next one.
+ *
+ * @param[out]  Message: Copy of the message.
+ * @return      true if a message was taken.
+ */
+bool Mailbox_Take(Mailbox_t *Mailbox, MailboxMessage_t *Message);
+
+/**
+ * @brief       Writes the next fragment into an outgoing chunk, from the ring interrupt before
+ *              the CRC of the chunk is computed.
+ *
+ * @param[out]  Slot: MAILBOX_WORDS words at <class>_MAILBOX_OFFSET in the chunk data.
+ */
+void Mailbox_Transmit(Mailbox_t *Mailbox, volatile uint16_t *Slot);
+
+/**
+ * @brief       Processes the fragment of a received chunk that passed its CRC, from the ring
+ *              interrupt.
+ *
+ * @param[in]   Slot: MAILBOX_WORDS words at <class>_MAILBOX_OFFSET in the chunk data.
+ */
+void Mailbox_Receive(Mailbox_t *Mailbox, volatile const uint16_t *Slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAILBOX_H */
+
+/*** end of file ***/
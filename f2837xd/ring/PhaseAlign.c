@@ -0,0 +1,90 @@
+/**
+ ********************************************************************************
+ * @file    PhaseAlign.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "PhaseAlign.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#if PWM_INTERLEAVED
+#define WORKER_OFFSET(worker)   ((uint32_t)(worker) * PWM_CARRIER_TICKS / NUM_WORKERS)
+#else
+#define WORKER_OFFSET(worker)   0U
+#endif
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint32_t epoch;  /*!< Cluster time of a carrier zero, kept at most one period before the last reference time */
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void PhaseAlign_InitReference(uint32_t Now)
+{
+    epoch = Now;
+}
+
+uint16_t PhaseAlign_Reference(uint32_t RefTime, uint16_t Worker)
+{
+    // Advance the epoch by whole periods so differences never wrap
+    uint32_t elapsed = RefTime - epoch;
+    epoch += (elapsed / PWM_CARRIER_TICKS) * PWM_CARRIER_TICKS;
+    elapsed = RefTime - epoch;
+
+    return (uint16_t)((PWM_CARRIER_TICKS - elapsed + WORKER_OFFSET(Worker)) % PWM_CARRIER_TICKS);
+}
+
+int16_t PhaseAlign_Error(uint32_t RefTime, uint16_t Phase, uint32_t ClusterNow, uint16_t CarrierPos)
+{
+    // Time elapsed since the reference carrier zero, may be negative if the zero is still ahead
+    int32_t sinceZero = (int32_t)(ClusterNow - (RefTime + Phase));
+    int32_t expected = sinceZero % (int32_t)PWM_CARRIER_TICKS;
+
+    if (expected < 0) expected += PWM_CARRIER_TICKS;
+    expected /= PWM_TBCLK_DIV;
+
+    int32_t error = (int32_t)CarrierPos - expected;
+
+    if (error > (int32_t)(PWM_CARRIER_TBCLK / 2)) error -= PWM_CARRIER_TBCLK;
+    if (error <= -(int32_t)(PWM_CARRIER_TBCLK / 2)) error += PWM_CARRIER_TBCLK;
+
+    return (int16_t)error;
+}
+
+uint32_t PhaseAlign_Period(int32_t Rate, uint16_t RateShift)
+{
+    // A fast local clock counts more TBCLK in a cluster period
+    int32_t stretch = (int32_t)(((int64_t)PWM_TBPRD * Rate) >> (RateShift - PWM_TBPRD_HR_BITS));
+
+    return (uint32_t)(((int32_t)PWM_TBPRD << PWM_TBPRD_HR_BITS) + stretch);
+}
+
+/*** end of file ***/
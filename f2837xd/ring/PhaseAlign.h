@@ -0,0 +1,115 @@
+/**
+ ********************************************************************************
+ * @file    PhaseAlign.h
+ * @brief   Cross-board PWM carrier phase alignment.
+ *
+ *          The Director runs a virtual carrier in cluster time and writes, in each private
+ *          setpoint header, the offset from the header timestamp to the next carrier zero of
+ *          that worker (optionally interleaved by 1/NUM_WORKERS of a period). At the end of
+ *          each frame a locked worker compares its own EPWM time-base position against that
+ *          reference and trims the time-base phase by at most PHASE_MAX_STEP_TBCLK, so every
+ *          converter converges to the same (or interleaved) carrier without sync cables.
+ *
+ *          The carrier counts local TBCLK, so a crystal offset moves it by as much every frame:
+ *          20 ppm over a 100 ms frame is 200 TBCLK, more than a phase step. A locked worker
+ *          therefore also stretches its carrier period by the clock skew ClockSync estimates,
+ *          in 1/256 TBCLK with the high-resolution period, and the phase step only takes out
+ *          what is left.
+ ********************************************************************************
+ */
+
+#ifndef PHASEALIGN_H
+#define PHASEALIGN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define PWM_CARRIER_TICKS       10000U  /*!< Carrier period in timestamp ticks (20 kHz at 200 MHz SYSCLK) */
+#define PWM_TBCLK_DIV           2U      /*!< Timestamp ticks per TBCLK (EPWMCLK = SYSCLK / 2) */
+#define PWM_CARRIER_TBCLK       (PWM_CARRIER_TICKS / PWM_TBCLK_DIV)     /*!< Full up-down carrier period in TBCLK */
+#define PWM_TBPRD               (PWM_CARRIER_TBCLK / 2U)                /*!< TBPRD of the up-down counter */
+
+#define PWM_INTERLEAVED         1       /*!< 1: worker k carrier is delayed by k / NUM_WORKERS period, 0: aligned */
+#define PHASE_MAX_STEP_TBCLK    50      /*!< Largest phase trim applied in one frame, in TBCLK */
+#define PWM_TBPRD_HR_BITS       8U      /*!< Fraction bits of the high-resolution period (TBPRDHR) */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Starts the Director virtual carrier, with a carrier zero at Now.
+ *
+ * @param[in]   Now: Cluster time.
+ */
+void PhaseAlign_InitReference(uint32_t Now);
+
+/**
+ * @brief       Computes the phase reference of a worker (Director side).
+ *
+ *              Must be called with non-decreasing reference times, at least once every 2^31 ticks.
+ *
+ * @param[in]   RefTime: Cluster time the reference is relative to (the setpoint header time).
+ * @param[in]   Worker: Worker index, used for interleaving.
+ * @return      Offset from RefTime to the next carrier zero of that worker, in timestamp ticks.
+ */
+uint16_t PhaseAlign_Reference(uint32_t RefTime, uint16_t Worker);
+
+/**
+ * @brief       Computes the carrier phase error of a worker (worker side).
+ *
+ * @param[in]   RefTime: Cluster time carried by the setpoint header.
+ * @param[in]   Phase: Phase reference carried by the setpoint header.
+ * @param[in]   ClusterNow: Cluster time at which CarrierPos was sampled.
+ * @param[in]   CarrierPos: Position in the up-down carrier, 0 to PWM_CARRIER_TBCLK - 1 TBCLK.
+ * @return      Actual minus expected carrier position, wrapped to half a period, in TBCLK.
+ */
+int16_t PhaseAlign_Error(uint32_t RefTime, uint16_t Phase, uint32_t ClusterNow, uint16_t CarrierPos);
+
+/**
+ * @brief       Computes the carrier period that runs at the cluster rate (worker side).
+ *
+ * @param[in]   Rate: Local clock skew, in ticks per 2^RateShift ticks (ClockSync_t Rate).
+ * @param[in]   RateShift: Fraction bits of Rate, at least PWM_TBPRD_HR_BITS.
+ * @return      PWM_TBPRD stretched by the skew, TBPRD:TBPRDHR as HRPWM_setTimeBasePeriod() takes it.
+ */
+uint32_t PhaseAlign_Period(int32_t Rate, uint16_t RateShift);
+
+/**
+ * @brief       Limits a phase error to the trim allowed in one frame.
+ *
+ * @param[in]   Error: Phase error, in TBCLK.
+ * @return      Trim to subtract from the carrier position, in TBCLK.
+ */
+static inline int16_t PhaseAlign_Step(int16_t Error)
+{
+    if (Error > PHASE_MAX_STEP_TBCLK) return PHASE_MAX_STEP_TBCLK;
+    if (Error < -PHASE_MAX_STEP_TBCLK) return -PHASE_MAX_STEP_TBCLK;
+    return Error;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PHASEALIGN_H */
+
+/*** end of file ***/
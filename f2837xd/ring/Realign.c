@@ -0,0 +1,165 @@
+/**
+ ********************************************************************************
+ * @file    Realign.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stddef.h>
+#include "Realign.h"
+#include "crc.h"
+#include "Trace.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define SYNC_WORD (offsetof(FrameHeader, sync) / sizeof(uint16_t))
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+// Chunks found Slip words from their offset. The sync word rules out most positions before a CRC is computed.
+static uint16_t match(const Realign_t *Realign, int16_t Slip)
+{
+    uint16_t found = 0;
+    uint16_t i;
+
+    for (i = 0; i < Realign->NumChunks; i++) {
+        int16_t at = (int16_t)Realign->Chunks[i].Offset + Slip;
+        uint16_t words = Realign->Chunks[i].Words;
+
+        if (at < 0 || (uint16_t)at + words > Realign->BufferWords) continue;
+
+        volatile uint16_t *chunk = Realign->Buffer + at;
+        if (chunk[SYNC_WORD] != FRAME_SYNC) continue;
+        if ((crc_t)(FRAME_CRC(chunk, words) ^ Realign->Chunks[i].Key) == chunk[0]) found++;
+    }
+    return found;
+}
+
+// Whether the sync word of a chunk out of place is found a slip away. A dead slot or a hit on the sync word
+// itself shows none, the chunks around it are not suspected.
+static bool slipped(const Realign_t *Realign, uint16_t Offset)
+{
+    int16_t slip;
+
+    for (slip = -REALIGN_MAX_SLIP; slip <= REALIGN_MAX_SLIP; slip++) {
+        int16_t at = (int16_t)(Offset + SYNC_WORD) + slip;
+
+        if (slip == 0 || at < 0 || (uint16_t)at >= Realign->BufferWords) continue;
+        if (Realign->Buffer[at] == FRAME_SYNC) return true;
+    }
+    return false;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void Realign_Init(Realign_t *Realign, LinkStats_t *Stats, volatile uint16_t *Buffer, uint16_t BufferWords,
+                  const RealignChunk_t *Chunks, uint16_t NumChunks, int16_t MinShift, int16_t MaxShift)
+{
+    Realign->Stats = Stats;
+    Realign->Buffer = Buffer;
+    Realign->BufferWords = BufferWords;
+    Realign->Chunks = Chunks;
+    Realign->NumChunks = NumChunks;
+    Realign->MinShift = MinShift;
+    Realign->MaxShift = MaxShift;
+    Realign->Shift = 0;
+    Realign->Found = 0;
+    Realign->StepEnd = UINT16_MAX;
+}
+
+bool Realign_Search(Realign_t *Realign)
+{
+    int16_t best = 0;
+    uint16_t bestFound = 0;
+    int16_t distance;
+
+    // Smallest slips first, a larger one must match more chunks to be taken
+    for (distance = 1; distance <= REALIGN_MAX_SLIP; distance++) {
+        int16_t slip = -distance;
+        uint16_t side;
+
+        for (side = 0; side < 2; side++, slip = distance) {
+            int16_t shift = Realign->Shift - slip;
+            if (shift < Realign->MinShift || shift > Realign->MaxShift) continue;
+
+            uint16_t found = match(Realign, slip);
+            if (found > bestFound) {
+                bestFound = found;
+                best = slip;
+            }
+        }
+    }
+
+    if (bestFound == 0) return false;
+
+    Realign->Shift -= best;
+    Realign->Found = bestFound;
+    Realign->Stats->Realignments++;
+    Trace_Event(TRACE_EV_REALIGN, (uint16_t)Realign->Shift, bestFound);
+    return true;
+}
+
+void Realign_Check(Realign_t *Realign)
+{
+    uint16_t first = UINT16_MAX;
+    uint16_t end = 0;
+    uint16_t i;
+
+    // First chunk that slipped, the chunks are not listed in ring order
+    for (i = 0; i < Realign->NumChunks; i++) {
+        uint16_t offset = Realign->Chunks[i].Offset;
+
+        if (offset < first && Realign->Buffer[offset + SYNC_WORD] != FRAME_SYNC && slipped(Realign, offset)) {
+            first = offset;
+        }
+    }
+    if (first == UINT16_MAX) {
+        Realign->StepEnd = UINT16_MAX;
+        return;
+    }
+
+    // The slip came after the last sync word in place in front of it
+    for (i = 0; i < Realign->NumChunks; i++) {
+        uint16_t offset = Realign->Chunks[i].Offset;
+
+        if (offset < first && offset + SYNC_WORD > end && Realign->Buffer[offset + SYNC_WORD] == FRAME_SYNC) {
+            end = offset + SYNC_WORD;
+        }
+    }
+    Realign->StepEnd = end;
+    Realign->Stats->SlippedFrames++;
+}
+
+bool Realign_InStep(const Realign_t *Realign, volatile const uint16_t *Chunk, uint16_t Words)
+{
+    return (uint16_t)(Chunk - Realign->Buffer) + Words <= Realign->StepEnd;
+}
+
+/*** end of file ***/
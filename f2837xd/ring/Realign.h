@@ -0,0 +1,132 @@
+/**
+ ********************************************************************************
+ * @file    Realign.h
+ * @brief   Word slip detection and realignment of the received ring image.
+ *
+ *          The chunks of the ring image are read at fixed offsets. If a node upstream
+ *          inserts or drops words in front of the image, every chunk after the slip is
+ *          received shifted and fails its CRC until the image lines up again. The length
+ *          of the frame is unchanged, FrameIntegrity.h sees nothing wrong with it.
+ *
+ *          When every chunk of a frame fails its CRC, Realign_Search() looks for the slip:
+ *          each chunk is tried REALIGN_MAX_SLIP words either side of its offset, where its
+ *          FRAME_SYNC header word and then its CRC must match. The slip matching the most
+ *          chunks, the smallest one on a tie, is taken out of the RX DMA destination of
+ *          the following frames:
+ *
+ *            destination = aligned destination + Shift
+ *
+ *          so a slip costs the frame it is found in. A positive Shift (image early, words
+ *          missing in front) pushes the last words received past the image, into
+ *          REALIGN_MAX_SLIP words of slack after it. A negative Shift (image late) lands the
+ *          words in front over the end of what precedes the RX area; MinShift and MaxShift
+ *          bound it to what a node can afford.
+ *
+ *          A slip in the middle of a frame, such as words an upstream node lost to a full
+ *          RX FIFO and forwarded without, leaves the chunks in front of it in place. The
+ *          chunk it hits keeps its header and fails its CRC, but only 65535 times in 65536.
+ *          Realign_Check() finds the first chunk whose FRAME_SYNC word is REALIGN_MAX_SLIP
+ *          words or less off its offset: the slip lies between it and the last sync word in
+ *          place before it, and Realign_InStep() only passes the chunks in front of that one.
+ ********************************************************************************
+ */
+
+#ifndef REALIGN_H
+#define REALIGN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "crc.h"
+#include "LinkStats.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define REALIGN_MAX_SLIP        4       /*!< Largest slip searched, in words either way, also the slack after the image */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief A chunk of the received image.
+ */
+typedef struct {
+    uint16_t Offset;        /*!< Aligned offset in the buffer, in words */
+    uint16_t Words;         /*!< Chunk length, <class>_CHUNK */
+    crc_t Key;              /*!< XORed into its CRC, CHUNK_KEY() of its worker (system.h), 0 for the broadcast */
+} RealignChunk_t;
+
+/**
+ * @brief Alignment of the RX image of one node.
+ */
+typedef struct {
+    LinkStats_t *Stats;             /*!< Counts the realignments */
+    volatile uint16_t *Buffer;      /*!< Ring image, with its slack */
+    uint16_t BufferWords;           /*!< Words of Buffer that can be searched */
+    const RealignChunk_t *Chunks;   /*!< Received chunks */
+    uint16_t NumChunks;             /*!< Entries of Chunks */
+    int16_t MinShift;               /*!< Bounds of Shift */
+    int16_t MaxShift;
+    int16_t Shift;                  /*!< Words added to the aligned RX DMA destination */
+    uint16_t Found;                 /*!< Chunks matching at the last slip found */
+    uint16_t StepEnd;               /*!< Buffer offset the last frame checked is in step up to */
+} Realign_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Describes the received image, aligned (Shift 0).
+ *
+ * @param[in]   Stats: Link statistics to count into.
+ * @param[in]   Buffer: Ring image, the chunk offsets are relative to it.
+ * @param[in]   BufferWords: Words of Buffer, slack included.
+ * @param[in]   Chunks: Chunks received by this node, kept by reference.
+ * @param[in]   MinShift: Most negative Shift, no further back than REALIGN_MAX_SLIP words.
+ * @param[in]   MaxShift: Largest Shift, at most the REALIGN_MAX_SLIP words of slack.
+ */
+void Realign_Init(Realign_t *Realign, LinkStats_t *Stats, volatile uint16_t *Buffer, uint16_t BufferWords,
+                  const RealignChunk_t *Chunks, uint16_t NumChunks, int16_t MinShift, int16_t MaxShift);
+
+/**
+ * @brief       Looks for a word slip in a frame whose chunks all failed their CRC. Must run before
+ *              the RX channel is started for the next frame.
+ *
+ * @return      true if Shift changed, the RX DMA destination is then to be moved.
+ */
+bool Realign_Search(Realign_t *Realign);
+
+/**
+ * @brief       Looks for a word slip within the frame just received, before its chunks are checked.
+ */
+void Realign_Check(Realign_t *Realign);
+
+/**
+ * @brief       Whether a chunk of the frame lies before any slip Realign_Check() found in it. A chunk
+ *              passing its CRC is only to be taken if it is in step.
+ *
+ * @param[in]   Chunk: Chunk in the buffer.
+ * @param[in]   Words: Chunk length, <class>_CHUNK.
+ */
+bool Realign_InStep(const Realign_t *Realign, volatile const uint16_t *Chunk, uint16_t Words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REALIGN_H */
+
+/*** end of file ***/
@@ -0,0 +1,64 @@
+/**
+ ********************************************************************************
+ * @file    Snapshot.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "Snapshot.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+bool Snapshot_Copy(const SnapshotVersion_t *Version, volatile const uint16_t *Src, uint16_t *Dst, uint16_t Words)
+{
+    uint16_t attempt;
+    for (attempt = 0; attempt <= SNAPSHOT_RETRIES; attempt++) {
+        uint32_t start = Snapshot_ReadBegin(Version);
+
+        // A write in progress lasts a whole frame, don't wait for it
+        if (start & 1U) return false;
+
+        uint16_t i;
+        for (i = 0; i < Words; i++) {
+            Dst[i] = Src[i];
+        }
+
+        if (!Snapshot_ReadRetry(Version, start)) return true;
+    }
+
+    return false;
+}
+
+/*** end of file ***/
@@ -0,0 +1,123 @@
+/**
+ ********************************************************************************
+ * @file    Snapshot.h
+ * @brief   Seqlock-style versioned snapshots of the ring image.
+ *
+ *          The single writer (CPU2) makes the version odd before the ring image can
+ *          change (DMA start, or CS falling on a worker) and even again once the frame
+ *          is received and checked. A reader samples the version, reads the frames in
+ *          place and checks the version again: if it was odd or has moved, the read
+ *          overlapped a write and must be retried or dropped. Readers never block the
+ *          writer and never spin on it, a read overlapping a write fails at once.
+ *
+ *          C28x keeps volatile accesses in program order and has no data cache, so no
+ *          fence is needed on target; SNAPSHOT_FENCE() can be defined for hosts.
+ ********************************************************************************
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#ifndef SNAPSHOT_FENCE
+#define SNAPSHOT_FENCE()
+#endif
+
+#define SNAPSHOT_RETRIES        2U      /*!< Extra attempts of Snapshot_Copy() when a write moved the version */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+typedef volatile uint32_t SnapshotVersion_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Marks the start of a write (writer side). Idempotent, a write that is started
+ *              again without having ended stays a single odd version.
+ */
+static inline void Snapshot_WriteBegin(SnapshotVersion_t *Version)
+{
+    if (!(*Version & 1U)) (*Version)++;
+    SNAPSHOT_FENCE();
+}
+
+/**
+ * @brief       Marks the end of a write (writer side). Idempotent.
+ */
+static inline void Snapshot_WriteEnd(SnapshotVersion_t *Version)
+{
+    SNAPSHOT_FENCE();
+    if (*Version & 1U) (*Version)++;
+}
+
+/**
+ * @brief       Samples the version before reading (reader side).
+ *
+ * @return      Version to pass to Snapshot_ReadRetry(). Odd if a write is in progress.
+ */
+static inline uint32_t Snapshot_ReadBegin(const SnapshotVersion_t *Version)
+{
+    uint32_t start = *Version;
+    SNAPSHOT_FENCE();
+    return start;
+}
+
+/**
+ * @brief       Checks a read done since Snapshot_ReadBegin() (reader side).
+ *
+ * @return      true if the read overlapped a write and what was read must be discarded.
+ */
+static inline bool Snapshot_ReadRetry(const SnapshotVersion_t *Version, uint32_t Start)
+{
+    SNAPSHOT_FENCE();
+    return (Start & 1U) || (*Version != Start);
+}
+
+/**
+ * @brief       Copies a block of the ring image with a tear-free guarantee. Gives up at once
+ *              while a write is in progress, and after SNAPSHOT_RETRIES attempts if writes
+ *              keep overlapping.
+ *
+ * @param[in]   Version: Version guarding the block.
+ * @param[in]   Src: Block in the ring image.
+ * @param[out]  Dst: Destination, left partially written on failure.
+ * @param[in]   Words: Block length in 16-bit words.
+ * @return      true if Dst holds a consistent copy.
+ */
+bool Snapshot_Copy(const SnapshotVersion_t *Version, volatile const uint16_t *Src, uint16_t *Dst, uint16_t Words);
+
+/**
+ * @brief       Snapshot_Copy() of a whole frame.
+ */
+static inline bool Snapshot_ReadFrame(const SnapshotVersion_t *Version, volatile const Frame *Src, Frame *Dst)
+{
+    return Snapshot_Copy(Version, (volatile const uint16_t *)Src, (uint16_t *)Dst, WORDS(Frame));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAPSHOT_H */
+
+/*** end of file ***/
@@ -0,0 +1,111 @@
+/**
+ ********************************************************************************
+ * @file    Trace.c
+ * @brief
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdbool.h>
+#include "Trace.h"
+#include "Timestamp.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define SLOT(seq)       ((seq) & (TRACE_RECORDS - 1U))
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// Slots are taken modulo the ring size, which must divide the 16 bit sequence numbers
+typedef char traceRecordsCheck[((TRACE_RECORDS & (TRACE_RECORDS - 1U)) == 0 && TRACE_RECORDS <= 0x8000U) ? 1 : -1];
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+Trace_t trace;
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+static void writeRecord(uint16_t Seq, uint16_t Event, uint32_t Time, uint16_t Arg0, uint16_t Arg1)
+{
+    volatile TraceRecord_t *record = &trace.Record[SLOT(Seq)];
+
+    record->Seq = 0;
+    record->Event = Event;
+    record->Time = Time;
+    record->Arg0 = Arg0;
+    record->Arg1 = Arg1;
+    record->Seq = Seq + 1;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void Trace_Init(uint16_t Node, uint16_t Core)
+{
+    uint16_t i;
+
+    trace.Magic = 0;
+    trace.Node = Node;
+    trace.Core = Core;
+    trace.Records = TRACE_RECORDS;
+    trace.Head = 0;
+    trace.Reserved = 0;
+    trace.High = (uint32_t)(Timestamp_now64() >> 32);
+    for (i = 0; i < TRACE_RECORDS; i++) {
+        trace.Record[i].Seq = 0;
+    }
+    trace.Magic = TRACE_MAGIC;
+}
+
+void Trace_SetNode(uint16_t Node)
+{
+    trace.Node = Node;
+}
+
+void Trace_Event(uint16_t Event, uint16_t Arg0, uint16_t Arg1)
+{
+    uint16_t seq;
+    uint16_t highSeq = 0;
+    uint32_t previous = 0;
+    bool newHigh = false;
+
+    // Time is read along with the reservation, records are in time order
+    uint16_t status = __disable_interrupts();
+    uint64_t now = Timestamp_now64();
+    uint32_t high = (uint32_t)(now >> 32);
+    if (high != trace.High) {
+        previous = trace.High;
+        trace.High = high;
+        highSeq = trace.Head++;
+        newHigh = true;
+    }
+    seq = trace.Head++;
+    __restore_interrupts(status);
+
+    if (newHigh) {
+        writeRecord(highSeq, TRACE_EV_TIME_HIGH, high, (uint16_t)previous, (uint16_t)(previous >> 16));
+    }
+    writeRecord(seq, Event, (uint32_t)now, Arg0, Arg1);
+}
+
+/*** end of file ***/
@@ -0,0 +1,125 @@
+/**
+ ********************************************************************************
+ * @file    Trace.h
+ * @brief   Binary event trace of a core, merged across cores and nodes on the host.
+ *
+ *          Every core keeps a ring of TRACE_RECORDS fixed size records in its own RAM:
+ *          an event id, two argument words and the low 32 bits of the IPC counter. The
+ *          ring is overwritten continuously and only read back by the debugger (save the
+ *          `trace` symbol, TRACE_WORDS words), so it can stay enabled in production.
+ *
+ *          Writers only mask interrupts to read the time and reserve their slot, then
+ *          fill it and stamp its sequence number last; a record caught half written in
+ *          a dump is recognized and dropped. A TRACE_EV_TIME_HIGH record is inserted
+ *          whenever the high word of the IPC counter changes, so the host recovers the
+ *          64-bit time of every record. Workers log their cluster time offset with
+ *          TRACE_EV_CLOCK, which lets tools/trace.py put every node on the Director
+ *          timeline. Both cores of a node share the IPC counter.
+ ********************************************************************************
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define TRACE_RECORDS           256U    /*!< Records kept, power of 2 */
+#define TRACE_MAGIC             0x7ACEU
+#define TRACE_NODE_DIRECTOR     0x00FFU /*!< Node of the Director, workers use their id */
+#define TRACE_NODE_UNKNOWN      0xFFFFU
+#define TRACE_CLOCK_FRAMES      64U     /*!< Frames between the TRACE_EV_CLOCK records of a worker, power of 2 */
+
+#define TRACE_WORDS             (sizeof(Trace_t) / sizeof(uint16_t))   /*!< Words to dump */
+
+// Events, decoded by name by tools/trace.py. Arguments are listed when used.
+#define TRACE_EV_TIME_HIGH      0x0001U /*!< Time: IPC counter high word from here on. Arg0, Arg1: previous one (low, high) */
+#define TRACE_EV_CLOCK          0x0002U /*!< Cluster minus local time, Arg0: low, Arg1: high (workers) */
+#define TRACE_EV_LAUNCH         0x0010U /*!< Frame launched, Arg0: cycle token, Arg1: 1 for a firmware bulk frame (Director) */
+#define TRACE_EV_TX_DONE        0x0011U /*!< TX DMA complete */
+#define TRACE_EV_RX_DONE        0x0012U /*!< RX DMA complete, Arg0: valid setpoints (workers) or measurements (Director),
+                                             Arg1: valid measurements (workers) */
+#define TRACE_EV_CS_FALL        0x0013U /*!< CS falling, Arg0: ticks since the captured edge (workers) */
+#define TRACE_EV_CS_RISE        0x0014U /*!< CS rising, end of a valid frame (workers) */
+#define TRACE_EV_BULK           0x0015U /*!< Firmware bulk frame received (workers) */
+#define TRACE_EV_WATCHDOG       0x0016U /*!< Comms watchdog state entered, Arg0: COMMS_WD_*, Arg1: reaction in ticks,
+                                             saturated, when the fail-safe path is entered (workers) */
+#define TRACE_EV_FRAME_ERROR    0x0017U /*!< Bad frame (FrameIntegrity.h), Arg0: FRAME_*, Arg1: words missing or left over */
+#define TRACE_EV_REALIGN        0x0018U /*!< Word slip found (Realign.h), Arg0: new RX shift (int16_t), Arg1: chunks found */
+#define TRACE_EV_ACQUIRE        0x0020U /*!< Ring image taken by the algorithm core, Arg0: token, Arg1: fresh (workers)
+                                             or valid measurements (Director) */
+#define TRACE_EV_PUBLISH        0x0021U /*!< Results published, Arg0: token (CPU1) */
+#define TRACE_EV_USER           0x0100U /*!< First application specific event */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief A trace record.
+ */
+typedef struct {
+    uint16_t Seq;                           /*!< Sequence number + 1, written last, 0 if never written */
+    uint16_t Event;                         /*!< TRACE_EV_* */
+    uint32_t Time;                          /*!< IPC counter low word */
+    uint16_t Arg0;                          /*!< Event argument */
+    uint16_t Arg1;                          /*!< Event argument */
+} TraceRecord_t;
+
+/**
+ * @brief Trace ring of a core, dumped as is.
+ */
+typedef struct {
+    uint16_t Magic;                         /*!< TRACE_MAGIC once initialized */
+    uint16_t Node;                          /*!< Worker id or TRACE_NODE_DIRECTOR */
+    uint16_t Core;                          /*!< 1 or 2 */
+    uint16_t Records;                       /*!< TRACE_RECORDS */
+    volatile uint16_t Head;                 /*!< Sequence number of the next record */
+    uint16_t Reserved;
+    volatile uint32_t High;                 /*!< IPC counter high word of the last record */
+    volatile TraceRecord_t Record[TRACE_RECORDS];   /*!< Record n is at Record[n % TRACE_RECORDS] */
+} Trace_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+extern Trace_t trace;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Clears the ring of this core.
+ *
+ * @param[in]   Node: Worker id, TRACE_NODE_DIRECTOR or TRACE_NODE_UNKNOWN until Trace_SetNode.
+ * @param[in]   Core: 1 or 2.
+ */
+void Trace_Init(uint16_t Node, uint16_t Core);
+
+/**
+ * @brief       Sets the node, for cores that learn it late.
+ */
+void Trace_SetNode(uint16_t Node);
+
+/**
+ * @brief       Records an event, from any context.
+ */
+void Trace_Event(uint16_t Event, uint16_t Arg0, uint16_t Arg1);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
+
+/*** end of file ***/
@@ -0,0 +1,325 @@
+/**
+ ********************************************************************************
+ * @file    Faults.c
+ * @brief   Fault injection between the nodes of the host ring simulator, see
+ *          Faults.h.
+ *
+ *          Scripted faults are sorted by frame and word and taken in order.
+ *          Drawn faults take one draw per word, node and kind with a non-zero
+ *          rate, so a run only depends on the seed, the rates and the script.
+ *          A scripted fault past the last word of a shorter frame is dropped.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Faults.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define MAX_NODES               64U
+#define ARG_DRAWN               UINT32_MAX  /*!< Scripted without an argument, drawn when taken */
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Shift register of a node: bits shifted in that do not make a word yet.
+ */
+typedef struct {
+    uint64_t Bits;
+    uint16_t Count;
+} Link_t;
+
+typedef struct {
+    Fault_t Fault;
+    uint32_t Line;              /*!< Keeps the order of the script for faults at the same word */
+} Scripted_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static const char *const names[FAULT_KINDS] = {
+    "flip", "garble", "drop", "dup", "glitch", "overrun", "dropout"
+};
+
+static uint64_t rng;
+static uint16_t numNodes;
+static double rates[FAULT_KINDS];
+static Scripted_t *script;
+static uint32_t scriptLength, scriptNext;
+static Link_t links[MAX_NODES];
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+uint64_t FaultsInjected[FAULT_KINDS];
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint64_t random64(void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform in [0, 1)
+static double uniform(void)
+{
+    return (double)(random64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int kindOf(const char *Name, size_t Length)
+{
+    int k;
+
+    for (k = 0; k < FAULT_KINDS; k++) {
+        if (strlen(names[k]) == Length && !strncmp(names[k], Name, Length)) return k;
+    }
+    return -1;
+}
+
+static uint32_t drawArg(FaultKind_t Kind)
+{
+    switch (Kind) {
+    case FAULT_FLIP:
+    case FAULT_DROP:
+    case FAULT_DUP:
+        return (uint32_t)(random64() % 16U);
+    case FAULT_GARBLE:
+        return 1U + (uint32_t)(random64() % 0xFFFFU);
+    case FAULT_GLITCH:
+        return FAULT_GLITCH_BITS;
+    case FAULT_OVERRUN:
+        return FAULT_OVERRUN_WORDS;
+    default:
+        return FAULT_DROPOUT_FRAMES;
+    }
+}
+
+static int scriptOrder(const void *A, const void *B)
+{
+    const Scripted_t *a = A, *b = B;
+
+    if (a->Fault.Frame != b->Fault.Frame) return a->Fault.Frame < b->Fault.Frame ? -1 : 1;
+    if (a->Fault.Word != b->Fault.Word) return a->Fault.Word < b->Fault.Word ? -1 : 1;
+    return a->Line < b->Line ? -1 : (a->Line > b->Line);
+}
+
+static bool parseNode(const char *Name, uint16_t *Node)
+{
+    char *end;
+    unsigned long k;
+
+    if (!strcmp(Name, "director")) {
+        *Node = 0;
+        return true;
+    }
+    if (strncmp(Name, "worker", 6) != 0) return false;
+    k = strtoul(Name + 6, &end, 10);
+    if (end == Name + 6 || *end != '\0' || k + 1U >= numNodes) return false;
+    *Node = (uint16_t)(k + 1U);
+    return true;
+}
+
+static bool parseLine(char *Line, Fault_t *Fault)
+{
+    char frame[32], kind[16], node[16], word[16] = "-", arg[16] = "-";
+    char *end;
+    int k;
+
+    if (sscanf(Line, "%31s %15s %15s %15s %15s", frame, kind, node, word, arg) < 3) return false;
+    Fault->Frame = strtoull(frame, &end, 0);
+    if (*end != '\0') return false;
+    k = kindOf(kind, strlen(kind));
+    if (k < 0 || !parseNode(node, &Fault->Node)) return false;
+    Fault->Kind = (FaultKind_t)k;
+    if ((Fault->Kind == FAULT_GLITCH || Fault->Kind == FAULT_DROPOUT) && Fault->Node == 0) return false;
+
+    if (Fault->Kind == FAULT_DROPOUT) {
+        Fault->Word = FAULT_FRAME_START;
+    } else if (!strcmp(word, "-")) {
+        Fault->Word = 0;
+    } else {
+        Fault->Word = (int32_t)strtol(word, &end, 0);
+        if (*end != '\0' || Fault->Word < 0) return false;
+    }
+
+    if (!strcmp(arg, "-")) {
+        Fault->Arg = ARG_DRAWN;
+    } else {
+        Fault->Arg = (uint32_t)strtoul(arg, &end, 0);
+        if (*end != '\0') return false;
+    }
+    return true;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void Faults_Init(uint16_t Nodes, uint64_t Seed)
+{
+    numNodes = Nodes < MAX_NODES ? Nodes : MAX_NODES;
+    rng = 0xD1B54A32D192ED03ULL ^ (Seed * 0x9E3779B97F4A7C15ULL);
+    if (rng == 0) rng = 1;
+    memset(links, 0, sizeof(links));
+    memset(FaultsInjected, 0, sizeof(FaultsInjected));
+}
+
+bool Faults_SetRate(const char *Spec)
+{
+    const char *eq = strchr(Spec, '=');
+    char *end;
+    double rate;
+    int k;
+
+    if (eq == NULL) return false;
+    k = kindOf(Spec, (size_t)(eq - Spec));
+    rate = strtod(eq + 1, &end);
+    if (k < 0 || *end != '\0' || rate < 0.0 || rate > 1.0) return false;
+    rates[k] = rate;
+    return true;
+}
+
+bool Faults_LoadScript(const char *Path)
+{
+    FILE *f = fopen(Path, "r");
+    char line[256];
+    uint32_t number = 0;
+    bool ok = true;
+
+    if (f == NULL) {
+        fprintf(stderr, "ringsim: cannot read %s\n", Path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char *hash = strchr(line, '#');
+        Fault_t fault;
+
+        number++;
+        if (hash != NULL) *hash = '\0';
+        if (strspn(line, " \t\r\n") == strlen(line)) continue;
+        if (!parseLine(line, &fault)) {
+            fprintf(stderr, "ringsim: %s:%u: expected FRAME KIND NODE [WORD [ARG]]\n", Path, number);
+            ok = false;
+            continue;
+        }
+        script = realloc(script, (scriptLength + 1U) * sizeof(Scripted_t));
+        script[scriptLength].Fault = fault;
+        script[scriptLength++].Line = number;
+    }
+    fclose(f);
+    qsort(script, scriptLength, sizeof(Scripted_t), scriptOrder);
+    return ok;
+}
+
+bool Faults_Enabled(void)
+{
+    int k;
+
+    for (k = 0; k < FAULT_KINDS; k++) {
+        if (rates[k] > 0.0) return true;
+    }
+    return scriptLength > 0;
+}
+
+uint16_t Faults_Due(uint64_t Frame, int32_t Word, Fault_t *Due)
+{
+    uint16_t n = 0;
+    uint16_t node;
+    int k;
+
+    while (scriptNext < scriptLength) {
+        Fault_t *s = &script[scriptNext].Fault;
+        if (s->Frame > Frame || (s->Frame == Frame && s->Word > Word)) break;
+        scriptNext++;
+        // Past the end of its frame
+        if (Word == FAULT_FRAME_START && s->Word != FAULT_FRAME_START) continue;
+        if (n == FAULTS_MAX_DUE) continue;
+        Due[n] = *s;
+        if (Due[n].Arg == ARG_DRAWN) Due[n].Arg = drawArg(s->Kind);
+        FaultsInjected[s->Kind]++;
+        n++;
+    }
+
+    for (k = 0; k < FAULT_KINDS; k++) {
+        if (rates[k] <= 0.0 || ((k == FAULT_DROPOUT) != (Word == FAULT_FRAME_START))) continue;
+        for (node = (k == FAULT_GLITCH || k == FAULT_DROPOUT) ? 1U : 0U; node < numNodes; node++) {
+            if (uniform() >= rates[k] || n == FAULTS_MAX_DUE) continue;
+            Due[n].Frame = Frame;
+            Due[n].Word = Word;
+            Due[n].Kind = (FaultKind_t)k;
+            Due[n].Node = node;
+            Due[n].Arg = drawArg((FaultKind_t)k);
+            FaultsInjected[k]++;
+            n++;
+        }
+    }
+    return n;
+}
+
+uint16_t Faults_Shift(uint16_t Node, uint16_t Word, const Fault_t *Slip, uint16_t Out[2])
+{
+    Link_t *link = &links[Node];
+    uint32_t bits = Word;
+    uint16_t count = 16;
+    uint16_t n = 0;
+
+    if (link->Count == 0U && Slip == NULL) {
+        Out[0] = Word;
+        return 1;
+    }
+
+    if (Slip != NULL) {
+        // Arg counts from the first bit shifted, the MSB
+        uint16_t at = 15U - (uint16_t)(Slip->Arg % 16U);
+        uint32_t low = bits & ((1UL << at) - 1U);
+
+        if (Slip->Kind == FAULT_DROP) {
+            bits = ((bits >> (at + 1U)) << at) | low;
+            count = 15;
+        } else {
+            bits = ((bits >> at) << (at + 1U)) | (((bits >> at) & 1U) << at) | low;
+            count = 17;
+        }
+    }
+
+    link->Bits = (link->Bits << count) | bits;
+    link->Count += count;
+    while (link->Count >= 16U) {
+        link->Count -= 16U;
+        Out[n++] = (uint16_t)(link->Bits >> link->Count);
+    }
+    link->Bits &= (1ULL << link->Count) - 1U;
+    return n;
+}
+
+void Faults_Resync(uint16_t Node)
+{
+    links[Node].Bits = 0;
+    links[Node].Count = 0;
+}
+
+const char *Faults_Name(FaultKind_t Kind)
+{
+    return names[Kind];
+}
+
+/*** end of file ***/
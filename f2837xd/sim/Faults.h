@@ -0,0 +1,135 @@
+/**
+ ********************************************************************************
+ * @file    Faults.h
+ * @brief   Fault injection between the nodes of the host ring simulator.
+ *
+ *          Decides which faults hit the ring and where, from per word rates
+ *          and from a script, with its own seeded generator: a run is repeated
+ *          exactly with the same seed, rates and script. ringsim.c applies them:
+ *
+ *          - flip, garble: a word is corrupted on the link into a node;
+ *          - drop, dup: the node misses an SCLK edge, or sees one twice. It
+ *            shifts in one bit less, or more, for the rest of the frame, so its
+ *            words straddle those of the wire (Faults_Shift());
+ *          - glitch: CS goes high for a few bits at a worker during a frame;
+ *          - overrun: the DMA of a node is held off the bus for a number of
+ *            words, its RX FIFO overflows;
+ *          - dropout: a worker is off the ring for a number of frames, it sees
+ *            neither CS nor SCLK and its output stays high.
+ *
+ *          Frames are counted from the end of the warm-up, nothing is injected
+ *          before.
+ ********************************************************************************
+ */
+
+#ifndef FAULTS_H
+#define FAULTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define FAULT_FRAME_START       (-1)        /*!< Fault_t.Word of the faults taken before CS falls */
+#define FAULTS_MAX_DUE          32          /*!< Faults taken at once */
+
+#define FAULT_GLITCH_BITS       1U          /*!< Default Arg: CS high for one SCLK period */
+#define FAULT_OVERRUN_WORDS     17U         /*!< Default Arg: more than a full RX FIFO */
+#define FAULT_DROPOUT_FRAMES    10U         /*!< Default Arg */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+typedef enum {
+    FAULT_FLIP,                 /*!< Bit Arg of the word flipped */
+    FAULT_GARBLE,               /*!< Word XORed with the non-zero pattern Arg */
+    FAULT_DROP,                 /*!< SCLK edge of bit Arg missed */
+    FAULT_DUP,                  /*!< SCLK edge of bit Arg seen twice */
+    FAULT_GLITCH,               /*!< CS high at a worker for Arg bits */
+    FAULT_OVERRUN,              /*!< DMA of the node stalled for Arg words */
+    FAULT_DROPOUT,              /*!< Worker off the ring for Arg frames */
+    FAULT_KINDS
+} FaultKind_t;
+
+/**
+ * @brief A fault, scripted or drawn.
+ */
+typedef struct {
+    uint64_t Frame;             /*!< Frame after the warm-up */
+    int32_t Word;               /*!< Word at the end of which it hits, FAULT_FRAME_START for a dropout */
+    FaultKind_t Kind;
+    uint16_t Node;              /*!< 0 the Director, k + 1 worker k. For a link fault, the receiving node */
+    uint32_t Arg;
+} Fault_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+extern uint64_t FaultsInjected[FAULT_KINDS];    /*!< Faults taken, per kind */
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/**
+ * @brief       Sets up the generator and the link state of a ring of Nodes nodes (the Director and the workers).
+ */
+void Faults_Init(uint16_t Nodes, uint64_t Seed);
+
+/**
+ * @brief       Sets the rate of a kind of fault from "kind=rate": per word and per node for every kind but
+ *              dropout, per frame and per worker for dropout.
+ * @return      false if Spec is not understood.
+ */
+bool Faults_SetRate(const char *Spec);
+
+/**
+ * @brief       Reads scripted faults, one per line: FRAME KIND NODE [WORD [ARG]], NODE "director" or "worker<k>",
+ *              '#' starting a comment. A word or argument of "-" takes the default.
+ * @return      false if the file cannot be read or a line is wrong, reported on stderr.
+ */
+bool Faults_LoadScript(const char *Path);
+
+/**
+ * @brief       true if any fault can be injected.
+ */
+bool Faults_Enabled(void);
+
+/**
+ * @brief       Faults hitting at the end of word Word of frame Frame, or before CS falls (FAULT_FRAME_START):
+ *              scripted ones due by then, then drawn ones.
+ * @return      Faults written to Due, at most FAULTS_MAX_DUE.
+ */
+uint16_t Faults_Due(uint64_t Frame, int32_t Word, Fault_t *Due);
+
+/**
+ * @brief       Word of the wire as shifted in by Node, after the SCLK edge fault Slip if not NULL.
+ * @return      Words complete in the node shift register, 0 to 2, written to Out.
+ */
+uint16_t Faults_Shift(uint16_t Node, uint16_t Word, const Fault_t *Slip, uint16_t Out[2]);
+
+/**
+ * @brief       CS of Node went high: the bits of a word not complete are lost.
+ */
+void Faults_Resync(uint16_t Node);
+
+/**
+ * @brief       Name of a kind of fault, as in rates and scripts.
+ */
+const char *Faults_Name(FaultKind_t Kind);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAULTS_H */
+
+/*** end of file ***/
@@ -0,0 +1,177 @@
+/**
+ ********************************************************************************
+ * @file    SimCpu1.c
+ * @brief   CPU1 of a simulated node: boot handshake and CoreLink exchange.
+ *
+ *          Plays the CPU1 side of CoreLink.h on the IPC registers of the node,
+ *          the way it looks from CPU2: flags CPU2 raises show in IPC_O_FLG, flags
+ *          CPU1 raises in IPC_O_STS. Runs whenever the node returns to idle, so an
+ *          image is taken as soon as it is ready and released at once.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "system.h"
+#include "CoreLink.h"
+#include "SimNode.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define IPC_REG(offset)         HWREG(IPC_BASE + (offset))
+
+#define PAYLOAD_BROADCAST       1U
+#define PAYLOAD_SETPOINT        2U
+#define PAYLOAD_MEASUREMENT     3U
+
+#define BROADCAST_NODE          0xFFU
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+SimCpu1_t SimCpu1;
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+// Word j of a payload after its sequence number
+static uint16_t payloadWord(uint16_t Class, uint16_t Node, uint16_t Sequence, uint16_t Word)
+{
+    uint32_t x = ((uint32_t)Class << 24) ^ ((uint32_t)Node << 16) ^ Sequence ^ ((uint32_t)Word << 20);
+
+    x ^= x >> 15;
+    x *= 0x2C1B3C6DUL;
+    x ^= x >> 12;
+    x *= 0x297A2D39UL;
+    x ^= x >> 15;
+    return (uint16_t)x;
+}
+
+static void payloadFill(uint16_t *Payload, uint16_t Words, uint16_t Class, uint16_t Node, uint16_t Sequence)
+{
+    uint16_t j;
+
+    Payload[0] = Sequence;
+    for (j = 1; j < Words; j++) {
+        Payload[j] = payloadWord(Class, Node, Sequence, j);
+    }
+}
+
+// A payload is consistent with its own sequence number, whichever frame it was published for
+static void payloadCheck(volatile const uint16_t *Payload, uint16_t Words, uint16_t Class, uint16_t Node)
+{
+    uint16_t j;
+
+    SimCpu1.Checked++;
+    for (j = 1; j < Words; j++) {
+        if (Payload[j] != payloadWord(Class, Node, Payload[0], j)) {
+            SimCpu1.Mismatches++;
+            SimCpu1.LastMismatch = SimNode_Now();
+            return;
+        }
+    }
+}
+
+// Delta encoded measurements are not checked: every word of these payloads changes every frame, more than the
+// delta slots carry, so the decoded view of the Director only catches up with a keyframe. The workers see the
+// measurements of the others encoded.
+static void checkImage(void)
+{
+    uint16_t self = coreLinkDown.Self;
+    uint16_t w;
+
+    if (self == CORELINK_NO_WORKER) {
+        for (w = 0; w < NUM_WORKERS && !MEASUREMENT_DELTA; w++) {
+            if (coreLinkDown.MeasurementsValid & (1U << w)) {
+                payloadCheck(coreLinkDown.Measurements[w]->data, MEASUREMENT_WORDS - MEASUREMENT_ADC_WORDS,
+                             PAYLOAD_MEASUREMENT, w);
+            }
+        }
+        return;
+    }
+
+    if (coreLinkDown.Broadcast != NULL && coreLinkDown.BroadcastValid) {
+        payloadCheck(coreLinkDown.Broadcast->data, BROADCAST_DATA_LEN, PAYLOAD_BROADCAST, BROADCAST_NODE);
+    }
+    for (w = 0; w < NUM_WORKERS; w++) {
+        if (coreLinkDown.SetpointsValid & (1U << w)) {
+            payloadCheck(coreLinkDown.Setpoints[w]->data, SETPOINT_WORDS, PAYLOAD_SETPOINT, w);
+        }
+        if (w != self && !MEASUREMENT_DELTA && (coreLinkDown.MeasurementsValid & (1U << w))) {
+            payloadCheck(coreLinkDown.Measurements[w]->data, MEASUREMENT_WORDS - MEASUREMENT_ADC_WORDS,
+                         PAYLOAD_MEASUREMENT, w);
+        }
+    }
+}
+
+// Fills the free slot and commits it, as CoreLink_Publish() does from CPU1
+static void publish(void)
+{
+    uint16_t *slot = CoreLink_PublishBuffer();
+    uint16_t sequence = ++SimCpu1.Sequence;
+    uint16_t w;
+
+    if (coreLinkDown.Self == CORELINK_NO_WORKER) {
+#if BROADCAST_CHUNK > 0
+        payloadFill(CORELINK_PUBLISH_BROADCAST(slot), BROADCAST_DATA_LEN, PAYLOAD_BROADCAST, BROADCAST_NODE,
+                    sequence);
+#endif
+        for (w = 0; w < NUM_WORKERS; w++) {
+            payloadFill(CORELINK_PUBLISH_SETPOINT(slot, w), SETPOINT_WORDS, PAYLOAD_SETPOINT, w, sequence);
+        }
+    } else {
+        payloadFill(CORELINK_PUBLISH_MEASUREMENT(slot), MEASUREMENT_WORDS - MEASUREMENT_ADC_WORDS,
+                    PAYLOAD_MEASUREMENT, coreLinkDown.Self, sequence);
+    }
+
+    coreLinkUp.Slot = (coreLinkUp.Slot + 1) % CORELINK_PUBLISH_SLOTS;
+    coreLinkUp.Token = coreLinkDown.Token;
+    IPC_REG(IPC_O_STS) |= CORELINK_PUBLISH_FLAG;
+    SimCpu1.Published++;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+void SimCpu1_Boot(void)
+{
+    CoreLink_InitConsumer();
+    IPC_REG(IPC_O_STS) |= IPC_STS_IPC31;
+}
+
+void SimCpu1_Service(void)
+{
+    // CoreLink_Init() has not run yet, the descriptor is not set up
+    if (coreLinkDown.Version == 0U) return;
+
+    if (IPC_REG(IPC_O_FLG) & CORELINK_READY_FLAG) {
+        SimCpu1.Images++;
+        if (SimCpu1.Check) checkImage();
+        coreLinkUp.Consumed++;
+        IPC_REG(IPC_O_FLG) &= ~(uint32_t)CORELINK_READY_FLAG;
+    }
+
+    if (!(IPC_REG(IPC_O_STS) & CORELINK_PUBLISH_FLAG)) publish();
+}
+
+/*** end of file ***/
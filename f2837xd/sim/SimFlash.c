@@ -0,0 +1,87 @@
+/**
+ ********************************************************************************
+ * @file    SimFlash.c
+ * @brief   Flash writer of a simulated worker: the staging area of FwUpdate.h.
+ *
+ *          Stands in for the F021 flash writer of the target, FwFlash.c of the
+ *          worker. Operations complete at once, ringsim.c reads the staging area
+ *          back (SimFlash) to check the image written.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "FwUpdate.h"
+#include "SimNode.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+// The longest image fits the staging area
+typedef char simFlashCheck[((uint32_t)FW_MAX_SEGMENTS * FW_SEGMENT_WORDS <= SIM_FLASH_WORDS) ? 1 : -1];
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+static bool simFlashErase(uint32_t Words);
+static bool simFlashProgram(uint32_t Offset, const uint16_t *Data, uint16_t Words);
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+SimFlash_t SimFlash;
+const FwFlash_t fwFlash = { simFlashErase, simFlashProgram };    /*!< Flash writer of the worker code */
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static bool simFlashErase(uint32_t Words)
+{
+    uint32_t i;
+
+    SimFlash.Erases++;
+    if (Words > SIM_FLASH_WORDS) return false;
+    for (i = 0; i < Words; i++) {
+        SimFlash.Data[i] = 0xFFFFU;
+    }
+    SimFlash.Erased = Words;
+    return true;
+}
+
+static bool simFlashProgram(uint32_t Offset, const uint16_t *Data, uint16_t Words)
+{
+    bool ok = true;
+    uint16_t i;
+
+    SimFlash.Programs++;
+    if (Offset + Words > SimFlash.Erased) {
+        SimFlash.Failed++;
+        return false;
+    }
+    for (i = 0; i < Words; i++) {
+        SimFlash.Data[Offset + i] &= Data[i];
+        if (SimFlash.Data[Offset + i] != Data[i]) ok = false;
+    }
+    if (!ok) SimFlash.Failed++;
+    return ok;
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+
+/*** end of file ***/
@@ -0,0 +1,192 @@
+/**
+ ********************************************************************************
+ * @file    SimNode.c
+ * @brief   Entry points of a simulated node, see SimNode.h.
+ *
+ *          main() of the node code is built as node_main() and returns once it
+ *          reaches the events engine (EventsEngine is wrapped at link time).
+ *          From then on every stimulus of the kernel ends with the node run to
+ *          idle: pending interrupts in the order they were raised, then the
+ *          events they posted, with the IPC registers brought up to date and
+ *          CPU1 served in between.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+#include "system.h"
+#include "EventsEngine.h"
+#include "SimNode.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define IPC_REG(offset)         HWREG(IPC_BASE + (offset))
+
+#ifdef WORKER_ID
+#define SIM_NODE                WORKER_ID
+#else
+#define SIM_NODE                SIM_NODE_DIRECTOR
+#endif
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+static void boot(uint64_t Now);
+static uint64_t nextEvent(void);
+static void advance(uint64_t Now);
+static void chipSelect(bool Low, uint64_t Now);
+static bool spiTxReady(uint32_t Base);
+static uint16_t spiWordOut(uint32_t Base, uint64_t Now);
+static void spiWordIn(uint32_t Base, uint16_t Word, uint64_t Now);
+static void stallDma(uint64_t Until, uint64_t Now);
+
+void node_main(void);
+
+crc_t __real_crcFast(uint16_t const message[], int nBytes);
+void __real_EventPost(Event_t * const Ev);
+void __real_EventPostIsr(Event_t * const Ev);
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+const SimNodeApi_t SimNodeApi = {
+    SIM_NODE, NUM_WORKERS, RING_CLOCKED_WORDS,
+    boot, nextEvent, advance, chipSelect, spiTxReady, spiWordOut, spiWordIn, SimNode_SpiRate, stallDma,
+    SimNode_FindVector,
+    &SimCounters, &SimCpu1
+};
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+// Flags written by CPU2 take effect: IPC_O_SET raises its flags to CPU1, IPC_O_CLR withdraws them, IPC_O_ACK
+// clears the flags CPU1 raised
+static void ipcSync(void)
+{
+    uint32_t set = IPC_REG(IPC_O_SET);
+    uint32_t clr = IPC_REG(IPC_O_CLR);
+    uint32_t ack = IPC_REG(IPC_O_ACK);
+
+    IPC_REG(IPC_O_FLG) = (IPC_REG(IPC_O_FLG) | set) & ~clr;
+    IPC_REG(IPC_O_STS) &= ~ack;
+    IPC_REG(IPC_O_SET) = 0;
+    IPC_REG(IPC_O_CLR) = 0;
+    IPC_REG(IPC_O_ACK) = 0;
+
+    SimCpu1_Service();
+}
+
+static void runToIdle(void)
+{
+    for (;;) {
+        ipcSync();
+        if (SimNode_TakeInterrupt()) continue;
+        if (EventsEngineRun()) continue;
+        break;
+    }
+}
+
+static void boot(uint64_t Now)
+{
+    SimNode_ModelInit();
+    SimNode_SetTime(Now);
+    SimCpu1_Boot();
+    node_main();
+    runToIdle();
+}
+
+static uint64_t nextEvent(void)
+{
+    return SimNode_NextTimed();
+}
+
+static void advance(uint64_t Now)
+{
+    SimNode_SetTime(Now);
+    SimNode_RunTimed();
+    runToIdle();
+}
+
+static void chipSelect(bool Low, uint64_t Now)
+{
+    SimNode_SetTime(Now);
+    SimNode_CsEdge(Low);
+    runToIdle();
+}
+
+static bool spiTxReady(uint32_t Base)
+{
+    return SimNode_SpiReady(Base);
+}
+
+static uint16_t spiWordOut(uint32_t Base, uint64_t Now)
+{
+    uint16_t word;
+
+    SimNode_SetTime(Now);
+    word = SimNode_SpiShiftOut(Base);
+    runToIdle();
+    return word;
+}
+
+static void spiWordIn(uint32_t Base, uint16_t Word, uint64_t Now)
+{
+    SimNode_SetTime(Now);
+    SimNode_SpiShiftIn(Base, Word);
+    runToIdle();
+}
+
+static void stallDma(uint64_t Until, uint64_t Now)
+{
+    SimNode_SetTime(Now);
+    SimNode_DmaStall(Until);
+    runToIdle();
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+
+/* Link-time wraps (-Wl,--wrap=...) */
+
+// The node returns to the kernel instead of looping forever
+void __wrap_EventsEngine(void)
+{
+}
+
+crc_t __wrap_crcFast(uint16_t const message[], int nBytes)
+{
+    SimCounters.CrcCalls++;
+    SimCounters.CrcWords += (uint64_t)nBytes;
+    return __real_crcFast(message, nBytes);
+}
+
+void __wrap_EventPost(Event_t * const Ev)
+{
+    SimCounters.Events++;
+    __real_EventPost(Ev);
+}
+
+void __wrap_EventPostIsr(Event_t * const Ev)
+{
+    SimCounters.Events++;
+    __real_EventPostIsr(Ev);
+}
+
+/*** end of file ***/
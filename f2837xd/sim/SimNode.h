@@ -0,0 +1,266 @@
+/**
+ ********************************************************************************
+ * @file    SimNode.h
+ * @brief   Peripheral model of one CPU2 node of the host ring simulator.
+ *
+ *          Each node (the Director, or worker WORKER_ID) is the unmodified CPU2
+ *          code built into its own shared object along with this model, the fake
+ *          driverlib (driverlib/) and the CPU1 stub (SimCpu1.c). Every object has
+ *          its own globals, ringsim.c loads one per node and drives it through
+ *          SimNodeApi, reading the globals of the node code (linkStats, ...) by
+ *          name.
+ *
+ *          The model is event driven, nothing runs on its own: the kernel sets
+ *          the local time of the node, applies a stimulus (a word shifted in or
+ *          out, a CS edge, a timer due) and the node then runs to idle. DMA
+ *          bursts complete as soon as they are triggered, interrupts are taken
+ *          one at a time once the code that raised them returns, then the events
+ *          engine runs. No CPU time is modelled: an ISR or an event handler takes
+ *          no simulated time.
+ *
+ *          Registers the code reads directly (HWREG, HWREGH) live in a register
+ *          file indexed by the C28x word address, see driverlib/inc/hw_types.h.
+ *          The model keeps them current: the IPC counter is the local time, the
+ *          DMA CONTROL and TRANSFER_COUNT registers and the SPI CCR follow the
+ *          channel and module state. IPC flags written by CPU2 are applied when
+ *          the node returns to the kernel.
+ ********************************************************************************
+ */
+
+#ifndef SIMNODE_H
+#define SIMNODE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define SIM_REGS_WORDS          0x80000UL   /*!< Peripheral address space of the register file, in words */
+#define SIM_SYSCLK_FREQ         200000000UL /*!< Local time ticks per second */
+#define SIM_TIME_NEVER          UINT64_MAX
+
+#define SIM_NODE_DIRECTOR       (-1)        /*!< SimNodeApi_t.Worker of the Director */
+
+#define SIM_MAX_INTERRUPTS      16          /*!< Interrupt vectors registered by a node */
+#define SIM_DMA_CHANNELS        6
+
+#define SIM_FLASH_WORDS         0x40000UL   /*!< Firmware staging area of a worker, in words */
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+
+/**
+ * @brief Activity of a node, for the cycle budget: counted from boot, never cleared.
+ */
+typedef struct {
+    uint64_t Interrupts;            /*!< ISRs taken */
+    uint64_t Events;                /*!< Events engine callbacks */
+    uint64_t DmaBursts;             /*!< Bursts of every channel */
+    uint64_t DmaWords;              /*!< Words moved by DMA */
+    uint64_t CrcCalls;              /*!< crcFast() calls */
+    uint64_t CrcWords;              /*!< Words through crcFast() */
+    uint64_t WordsIn;               /*!< Words shifted into an enabled SPI */
+    uint64_t RxOverflows;           /*!< Words lost to a full SPI RX FIFO */
+} SimCounters_t;
+
+/**
+ * @brief Interrupt vector of a node, with its statistics.
+ */
+typedef struct {
+    uint32_t Id;                    /*!< INT_* */
+    void (*Handler)(void);
+    bool Enabled;
+    bool Pending;
+    uint64_t Taken;                 /*!< Times the ISR ran */
+    uint64_t LastTaken;             /*!< Local time of the last one */
+} SimVector_t;
+
+/**
+ * @brief CPU1 of the node, played by SimCpu1.c. The algorithm core is reduced to its exchange with CPU2:
+ *        every ring image handed over is checked, and a fresh payload is published in return. Payloads carry
+ *        their sequence number in their first word and words derived from it and from the node in the
+ *        others, so a chunk that passed its CRC with a wrong payload is found here.
+ */
+typedef struct {
+    bool Check;                     /*!< Payloads are checked, set by the kernel once the first published
+                                         ones have gone round */
+    uint16_t Sequence;              /*!< Last payload published */
+    uint64_t Images;                /*!< Ring images handed over */
+    uint64_t Published;             /*!< Payloads published */
+    uint64_t Checked;               /*!< Payloads found valid by CPU2 and checked */
+    uint64_t Mismatches;            /*!< Of those, payloads that differ from what was published */
+    uint64_t LastMismatch;          /*!< Local time of the last mismatch */
+} SimCpu1_t;
+
+/**
+ * @brief Firmware staging area of a worker, played by SimFlash.c behind the FwFlash_t of the worker code.
+ *        Like the F021 flash, an erase sets words to 0xFFFF and programming only clears bits: a word written
+ *        twice, or outside what was erased, fails its verify.
+ */
+typedef struct {
+    uint16_t Data[SIM_FLASH_WORDS];
+    uint32_t Erased;                /*!< Words erased by the last erase */
+    uint64_t Erases;
+    uint64_t Programs;
+    uint64_t Failed;                /*!< Programs that failed their verify */
+} SimFlash_t;
+
+/**
+ * @brief Entry points of a node, exported as SimNodeApi. Every call takes the local time of the node, in
+ *        SYSCLK ticks, which never goes back, and returns once the node is idle.
+ */
+typedef struct {
+    int16_t Worker;                 /*!< WORKER_ID, SIM_NODE_DIRECTOR */
+    uint16_t NumWorkers;            /*!< NUM_WORKERS it was built with */
+    uint16_t ClockedWords;          /*!< RING_CLOCKED_WORDS it was built with */
+
+    /** Runs main() up to the events engine. */
+    void (*Boot)(uint64_t Now);
+
+    /** Local time of the next timer, carrier, conversion or bus release event, SIM_TIME_NEVER if none. */
+    uint64_t (*NextEvent)(void);
+
+    /** Runs the timed events due at Now. */
+    void (*Advance)(uint64_t Now);
+
+    /** Level of the CS input (XINT1, ECAP1) changed. */
+    void (*ChipSelect)(bool Low, uint64_t Now);
+
+    /** Master SPI: true if it has a word to shift out. */
+    bool (*SpiTxReady)(uint32_t Base);
+
+    /** Start of a word: the word the SPI shifts out. */
+    uint16_t (*SpiWordOut)(uint32_t Base, uint64_t Now);
+
+    /** End of a word: the word shifted in. */
+    void (*SpiWordIn)(uint32_t Base, uint16_t Word, uint64_t Now);
+
+    /** SPI clock set up by the code, in bit/s, 0 if never configured. */
+    uint32_t (*SpiBitRate)(uint32_t Base);
+
+    /** DMA held off the bus until Until, see SimNode_DmaStall(). */
+    void (*StallDma)(uint64_t Until, uint64_t Now);
+
+    /** ISR statistics of an interrupt, NULL if never registered. */
+    const SimVector_t *(*Vector)(uint32_t Id);
+
+    SimCounters_t *Counters;
+    SimCpu1_t *Cpu1;
+} SimNodeApi_t;
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+extern volatile uint16_t SimRegs[SIM_REGS_WORDS];      /*!< Register file, see driverlib/inc/hw_types.h */
+extern SimCounters_t SimCounters;
+extern SimCpu1_t SimCpu1;
+extern SimFlash_t SimFlash;                             /*!< Workers only */
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/* Model side of the fake driverlib (driverlib/driverlib.c) */
+
+/**
+ * @brief       Local time of the node.
+ */
+uint64_t SimNode_Now(void);
+
+/**
+ * @brief       Moves the local time forward, never back, and the IPC counter with it.
+ */
+void SimNode_SetTime(uint64_t Now);
+
+/**
+ * @brief       Sets up the peripherals in their reset state, before main().
+ */
+void SimNode_ModelInit(void);
+
+/**
+ * @brief       Raises an interrupt, taken once the running code returns to the node.
+ */
+void SimNode_Raise(uint32_t Id);
+
+/**
+ * @brief       Runs the ISR of the oldest interrupt raised, registered and enabled.
+ * @return      false if there was none.
+ */
+bool SimNode_TakeInterrupt(void);
+
+/**
+ * @brief       Interrupt vector of an interrupt, NULL if the code never touched it.
+ */
+const SimVector_t *SimNode_FindVector(uint32_t Id);
+
+/**
+ * @brief       Local time of the next CPU timer expiry, SOCA, end of conversion or bus release, SIM_TIME_NEVER
+ *              if none.
+ */
+uint64_t SimNode_NextTimed(void);
+
+/**
+ * @brief       Runs the CPU timers, SOCAs, conversions and bus release due at the local time.
+ */
+void SimNode_RunTimed(void);
+
+/**
+ * @brief       Edge on the CS input: ECAP1 capture and XINT1.
+ */
+void SimNode_CsEdge(bool Low);
+
+/**
+ * @brief       SPI side of the wire: a word to shift out, the word shifted out at the start of a word, the word
+ *              shifted in at its end and the bit rate set up.
+ */
+bool SimNode_SpiReady(uint32_t Base);
+uint16_t SimNode_SpiShiftOut(uint32_t Base);
+void SimNode_SpiShiftIn(uint32_t Base, uint16_t Word);
+uint32_t SimNode_SpiRate(uint32_t Base);
+
+/**
+ * @brief       Reads or writes a word at a peripheral address for the DMA: data registers with side effects
+ *              (SPI RXBUF, TXBUF), the register file otherwise.
+ */
+uint16_t SimNode_PeripheralRead(uint32_t Address);
+void SimNode_PeripheralWrite(uint32_t Address, uint16_t Word);
+
+/**
+ * @brief       A DMA trigger source fired (DMA_TRIGGER_*). Latched by the channels it is selected on.
+ */
+void SimNode_Trigger(uint16_t Source);
+
+/**
+ * @brief       Another master holds the bus until the local time Until: no DMA burst runs, triggers are latched.
+ */
+void SimNode_DmaStall(uint64_t Until);
+
+/* CPU1 stub (SimCpu1.c), called by the model */
+
+/**
+ * @brief       Prepares the first payloads and the IPC handshake, before main().
+ */
+void SimCpu1_Boot(void);
+
+/**
+ * @brief       Answers the IPC flags set by CPU2: checks a ring image handed over, releases it and publishes
+ *              the next payloads.
+ */
+void SimCpu1_Service(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMNODE_H */
+
+/*** end of file ***/
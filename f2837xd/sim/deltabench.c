@@ -0,0 +1,238 @@
+/**
+ ********************************************************************************
+ * @file    deltabench.c
+ * @brief   Host benchmark of the measurement delta encoding (ring/DeltaCodec.c).
+ *
+ *          Built against the configuration with its measurement encoding
+ *          switched to delta (Makefile), it feeds the encoder synthetic
+ *          payloads for a few workloads and decodes what it sends, dropping
+ *          frames at --loss. Per workload it reports:
+ *
+ *          - the words on the ring against a raw payload, i.e. the compression
+ *            ratio. The encoding is sized at build time, so this is the same
+ *            for every workload; what the workloads change is how late the
+ *            Director sees a change;
+ *          - the age of the changes when the decoded view catches up with them,
+ *            in frames, and the changed words deferred per frame;
+ *          - the host encode and decode cost, in ns per frame.
+ *
+ *          Without loss, the decoded view must equal what the encoder believes
+ *          it sent after every frame; with loss, the view must have caught up
+ *          with an unchanged payload once a keyframe period of frames got
+ *          through in a row. Either failing is counted as an error and the exit
+ *          status is 1.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "DeltaCodec.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define DEFAULT_FRAMES      200000U
+
+// Frames after which the refresh slice has rewritten every word of the view
+#define KEYFRAME_FRAMES     ((DELTA_WORDS + MEASUREMENT_REFRESH_WORDS - 1) / MEASUREMENT_REFRESH_WORDS)
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+    const char *Name;
+    uint16_t Changes;           /*!< Words changed per frame, DELTA_WORDS for all */
+} Workload_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint64_t rng = 0x9E3779B97F4A7C15ULL;
+static double timerNs;          /*!< Cost of the clock reads around each call, taken off the figures */
+
+static const Workload_t workloads[] = {
+    { "idle",  0 },
+    { "one",   1 },
+    { "slots", MEASUREMENT_DELTA_SLOTS },
+    { "half",  (DELTA_WORDS + 1) / 2 },
+    { "all",   DELTA_WORDS },
+};
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint64_t random64(void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1DULL;
+}
+
+static double uniform(void)
+{
+    return (double)(random64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint64_t nanoseconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+// Changes Count consecutive words from a random one, by a nonzero step so each really changes
+static void mutate(uint16_t *Payload, uint16_t Count)
+{
+    uint16_t i = (uint16_t)(random64() % DELTA_WORDS);
+    uint16_t n;
+
+    for (n = 0; n < Count && n < DELTA_WORDS; n++) {
+        Payload[i] += 1U + (uint16_t)(random64() % 0xFFFFU);
+        if (++i == DELTA_WORDS) i = 0;
+    }
+}
+
+static void timerCalibrate(void)
+{
+    uint64_t total = 0, t;
+    uint32_t n;
+
+    for (n = 0; n < 100000U; n++) {
+        t = nanoseconds();
+        total += nanoseconds() - t;
+    }
+    timerNs = (double)total / 100000.0;
+}
+
+static bool run(const Workload_t *Load, uint64_t Frames, double Loss)
+{
+    static DeltaEncoder_t encoder;
+    static uint16_t payload[DELTA_WORDS], view[DELTA_WORDS], encoded[DELTA_ENCODED_WORDS];
+    static uint64_t staleSince[DELTA_WORDS];
+    uint64_t encodeNs = 0, decodeNs = 0, t;
+    uint64_t ages = 0, caught = 0, ageMax = 0, deferred = 0, deferredMax = 0, lost = 0, errors = 0;
+    uint64_t f;
+    uint16_t i;
+
+    DeltaCodec_InitEncoder(&encoder);
+    memset(payload, 0, sizeof(payload));
+    memset(view, 0, sizeof(view));
+    memset(staleSince, 0, sizeof(staleSince));
+
+    for (f = 1; f <= Frames; f++) {
+        mutate(payload, Load->Changes);
+
+        t = nanoseconds();
+        uint16_t left = DeltaCodec_Encode(&encoder, payload, encoded);
+        encodeNs += nanoseconds() - t;
+        deferred += left;
+        if (left > deferredMax) deferredMax = left;
+
+        if (Loss > 0 && uniform() < Loss) {
+            lost++;
+        } else {
+            t = nanoseconds();
+            if (!DeltaCodec_Decode(encoded, view)) errors++;
+            decodeNs += nanoseconds() - t;
+            if (Loss == 0 && memcmp(view, encoder.Sent, sizeof(view))) errors++;
+        }
+
+        // Age of a change: frames from the first frame the view differs to the one it matches again
+        for (i = 0; i < DELTA_WORDS; i++) {
+            if (view[i] != payload[i]) {
+                if (!staleSince[i]) staleSince[i] = f;
+            } else if (staleSince[i]) {
+                uint64_t age = f - staleSince[i];
+                ages += age;
+                caught++;
+                if (age > ageMax) ageMax = age;
+                staleSince[i] = 0;
+            }
+        }
+    }
+
+    // Stop changing: after a keyframe period delivered in a row the view must have caught up
+    uint64_t inRow = 0;
+    for (f = 0; inRow < KEYFRAME_FRAMES && f < 1000000U; f++) {
+        DeltaCodec_Encode(&encoder, payload, encoded);
+        if (Loss > 0 && uniform() < Loss) {
+            inRow = 0;
+            continue;
+        }
+        if (!DeltaCodec_Decode(encoded, view)) errors++;
+        inRow++;
+    }
+    if (memcmp(view, payload, sizeof(view))) errors++;
+
+    uint64_t decoded = Frames - lost;
+    double encode = (double)encodeNs / (double)Frames - timerNs;
+    double decode = decoded ? (double)decodeNs / (double)decoded - timerNs : 0.0;
+    printf("%-6s %7u %7.2f %5llu %7.2f %6llu %8.1f %8.1f %6llu\n",
+           Load->Name, (unsigned)(Load->Changes < DELTA_WORDS ? Load->Changes : DELTA_WORDS),
+           caught ? (double)ages / (double)caught : 0.0, (unsigned long long)ageMax,
+           (double)deferred / (double)Frames, (unsigned long long)deferredMax,
+           encode > 0 ? encode : 0.0, decode > 0 ? decode : 0.0, (unsigned long long)errors);
+    return errors == 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: deltabench [--frames N] [--seed N] [--loss RATE]\n"
+            "  --frames  frames per workload (%u)\n"
+            "  --seed    seed of the payload changes and losses\n"
+            "  --loss    rate of frames the decoder does not get (0)\n", DEFAULT_FRAMES);
+    exit(2);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main(int argc, char **argv)
+{
+    uint64_t frames = DEFAULT_FRAMES;
+    uint64_t seed = 1;
+    double loss = 0;
+    bool ok = true;
+    size_t w;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        const char *arg = argv[a];
+        const char *val = (a + 1 < argc) ? argv[a + 1] : NULL;
+        if (val == NULL) usage();
+        if (!strcmp(arg, "--frames")) frames = strtoull(val, NULL, 0);
+        else if (!strcmp(arg, "--seed")) seed = strtoull(val, NULL, 0);
+        else if (!strcmp(arg, "--loss")) loss = atof(val);
+        else usage();
+        a++;
+    }
+    if (frames == 0 || loss < 0 || loss >= 1) usage();
+    rng ^= seed * 0xBF58476D1CE4E5B9ULL;
+
+    // Unpadded data words: pre_build.py may pad the measurement chunk either way
+    uint16_t raw = MEASUREMENT_WORDS + MAILBOX_WORDS;
+    uint16_t delta = DELTA_ENCODED_WORDS + MAILBOX_WORDS;
+    printf("payload %u words, %u slots, refresh %u words (keyframe every %u frames)\n",
+           (unsigned)MEASUREMENT_WORDS, (unsigned)MEASUREMENT_DELTA_SLOTS, (unsigned)MEASUREMENT_REFRESH_WORDS,
+           (unsigned)KEYFRAME_FRAMES);
+    printf("measurement data %u words raw, %u delta encoded: ratio %.2f (chunk %u words)\n",
+           raw, delta, (double)delta / (double)raw, (unsigned)MEASUREMENT_CHUNK);
+    printf("%.1f %% of the frames lost; ages in frames, deferred in words per frame, host ns per frame\n\n",
+           loss * 100.0);
+    timerCalibrate();
+    printf("%-6s %7s %7s %5s %7s %6s %8s %8s %6s\n", "load", "changes", "age", "max", "defer", "max",
+           "enc ns", "dec ns", "errors");
+    for (w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+        ok &= run(&workloads[w], frames, loss);
+    }
+    return ok ? 0 : 1;
+}
+
+/*** end of file ***/
@@ -0,0 +1,32 @@
+/**
+ ********************************************************************************
+ * @file    cpu.h
+ * @brief   Host stand-in for driverlib/cpu.h, for the ring simulator.
+ *
+ *          The simulator never interrupts running code, interrupts are only taken
+ *          between ISRs and events (SimNode.h): the global interrupt mask and the
+ *          protected register access have nothing to do.
+ ********************************************************************************
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define EINT
+#define DINT
+#define ERTM
+#define DRTM
+#define EALLOW
+#define EDIS
+#define ESTOP0
+
+// Compiler intrinsics
+#define __disable_interrupts()      0U
+#define __restore_interrupts(x)     ((void)(x))
+
+#endif /* CPU_H */
+
+/*** end of file ***/
@@ -0,0 +1,43 @@
+/**
+ ********************************************************************************
+ * @file    device.h
+ * @brief   Host stand-in for device/device.h, for the ring simulator.
+ ********************************************************************************
+ */
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include "driverlib.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define DEVICE_GPIO_PIN_LED1        31U
+#define DEVICE_GPIO_PIN_LED2        34U
+
+#define DEVICE_SYSCLK_FREQ          200000000UL
+#define DEVICE_LSPCLK_FREQ          (DEVICE_SYSCLK_FREQ)
+
+// Delays take no simulated time
+#define DEVICE_DELAY_US(x)          SysCtl_delay(0U)
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+void Device_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEVICE_H */
+
+/*** end of file ***/
@@ -0,0 +1,1542 @@
+/**
+ ********************************************************************************
+ * @file    driverlib.c
+ * @brief   Peripheral model behind the host stand-in of the driverlib.
+ *
+ *          One instance per node (SimNode.h). SPI A to C with their 16 word
+ *          FIFOs, the six DMA channels, the CPU timers, ECAP1, XINT1, EPWM1 with
+ *          the SOCA of ADC A to D, and just enough of the SCI and the PIE for
+ *          the CPU2 code to run. The high-resolution period of EPWM1 (TBPRDHR)
+ *          stretches its up-down period by 2 * TBPRDHR / 256 TBCLK, with an
+ *          exact MEP step.
+ *
+ *          DMA triggers follow the FIFO levels: a SPI TX trigger when the TX FIFO
+ *          falls to TXFFIL or below, a RX trigger when the RX FIFO reaches RXFFIL.
+ *          A trigger is latched in PERINTFLG until the channel runs a burst, and
+ *          is raised again after the burst while its condition holds, so a TX
+ *          channel started on an empty FIFO fills it in two bursts. A trigger
+ *          latched while the previous one is still pending sets OVRFLG. While
+ *          the bus is held (SimNode_DmaStall()), triggers are only latched.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <string.h>
+#include "driverlib.h"
+#include "device.h"
+#include "SimNode.h"
+
+/************************************
+ * EXTERN VARIABLES
+ ************************************/
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define SPI_FIFO_WORDS          16U
+#define SPI_MODULES             3U
+
+#define CPU_TIMERS              3U
+
+#define EPWM_TBCLK_DIV          2U          /*!< SYSCLK ticks per TBCLK, EPWMCLK = SYSCLK / 2 */
+
+#define ADC_MODULES             4U
+#define ADC_SOCS                16U
+#define ADC_CONVERSION_TICKS    100U        /*!< SOCA to the end of the last conversion, 500 ns */
+
+#define SCI_INT_TX              0x0100U     /*!< TX FIFO interrupt enabled, in Sci_t.IntEnabled */
+
+#define PERIPHERAL(a)           ((a) < SIM_REGS_WORDS)  /*!< DMA address in the register file, else a host pointer */
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+    uint32_t Base;
+    uint16_t TxSource;              /*!< DMA_TRIGGER_* of the FIFO levels */
+    uint16_t RxSource;
+    bool Master;
+    uint32_t BitRate;
+    bool Fifo;
+    uint16_t Tx[SPI_FIFO_WORDS];
+    uint16_t TxHead, TxLevel;
+    uint16_t Rx[SPI_FIFO_WORDS];
+    uint16_t RxHead, RxLevel;
+    uint16_t TxLevelInt, RxLevelInt;
+    bool TxCond, RxCond;            /*!< Trigger conditions, for the edges */
+    uint32_t Status;                /*!< SPI_INT_* latched */
+    uint16_t Dat;                   /*!< Shift register: last word received */
+} Spi_t;
+
+typedef struct {
+    uintptr_t Shadow, Active, Begin;
+    int16_t BurstStep, TransferStep, WrapStep;
+    uint16_t WrapSize, WrapCount;
+} DmaPort_t;
+
+typedef struct {
+    uint32_t Base;
+    uint32_t Int;
+    uint16_t Source;                /*!< DMA_TRIGGER_* selected */
+    bool OneShot, Continuous;
+    bool TriggerEnabled, IntEnabled, IntAtEnd;
+    uint16_t BurstSize;             /*!< Words per burst */
+    uint16_t TransferSize;          /*!< Bursts per transfer */
+    uint16_t TransferCount;         /*!< TRANSFER_COUNT: bursts left after the current one */
+    bool Run, Transfer, Pending, Overflow;
+    DmaPort_t Src, Dst;
+} DmaChannel_t;
+
+typedef struct {
+    uint32_t Base;
+    uint32_t Int;
+    uint32_t Period;                /*!< PRD */
+    bool Running, IntEnabled, Overflow;
+    uint64_t Expiry;                /*!< Local time of the next interrupt, while running */
+} CpuTimer_t;
+
+typedef struct {
+    bool Falling[4];                /*!< Polarity of each capture event */
+    uint16_t Wrap;                  /*!< Events before the pointer wraps */
+    uint16_t Pointer;
+    uint32_t Cap[4];
+    uint16_t Flags, IntEnabled;
+    bool Int;                       /*!< Global interrupt flag, cleared by ECAP_clearGlobalInterrupt() */
+    bool Running;
+} Ecap_t;
+
+typedef struct {
+    uint16_t Period;                /*!< TBPRD */
+    uint16_t PeriodHr;              /*!< TBPRDHR, 1/256 TBCLK, counted with HighResPeriod */
+    bool HighResPeriod;
+    int64_t Offset;                 /*!< Up-down position at TBCLK 0, in 1/256 TBCLK */
+    uint16_t Phase;
+    bool PhaseLoad;
+    bool UpAfterSync;
+    uint16_t Compare[4];
+    bool Tripped;
+    bool Soc;                       /*!< SOCA at every counter zero */
+    uint64_t NextSoc;               /*!< Local time of the next SOCA, SIM_TIME_NEVER if disabled */
+} Epwm_t;
+
+typedef struct {
+    uint32_t Base, ResultBase;
+    uint16_t Source;                /*!< DMA_TRIGGER_* of ADCINT1 */
+    bool SocOnPwm[ADC_SOCS];
+    uint16_t Channel[ADC_SOCS];
+    uint16_t IntSoc;
+    bool IntEnabled, Continuous, Flag, Overflow;
+    uint64_t Done;                  /*!< Local time the conversions in progress complete, SIM_TIME_NEVER if none */
+    uint32_t Conversions;
+} Adc_t;
+
+typedef struct {
+    uint16_t IntEnabled;
+} Sci_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint64_t now;
+static Spi_t spi[SPI_MODULES];
+static DmaChannel_t dma[SIM_DMA_CHANNELS];
+static bool dmaBusy;                /*!< Bursts in progress, triggers are only latched meanwhile */
+static uint64_t dmaStall;           /*!< Local time the bus is released, 0 if it is not held */
+static CpuTimer_t timers[CPU_TIMERS];
+static Ecap_t ecap;
+static bool xintEnabled, xintFalling = true;
+static Epwm_t epwm;
+static Adc_t adc[ADC_MODULES];
+static Sci_t sci;
+static SimVector_t vectors[SIM_MAX_INTERRUPTS];
+static uint16_t numVectors;
+static uint32_t pending[SIM_MAX_INTERRUPTS];    /*!< Raised, in order */
+static uint16_t numPending;
+
+static const uint32_t dmaInts[SIM_DMA_CHANNELS] = {
+    INT_DMA_CH1, INT_DMA_CH2, INT_DMA_CH3, INT_DMA_CH4, INT_DMA_CH5, INT_DMA_CH6
+};
+
+/************************************
+ * GLOBAL VARIABLES
+ ************************************/
+volatile uint16_t SimRegs[SIM_REGS_WORDS] __attribute__((aligned(8)));
+SimCounters_t SimCounters;
+
+/************************************
+ * STATIC FUNCTION PROTOTYPES
+ ************************************/
+static void dmaService(void);
+static bool sourceActive(uint16_t Source);
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static SimVector_t *vector(uint32_t Id, bool Create)
+{
+    uint16_t i;
+
+    for (i = 0; i < numVectors; i++) {
+        if (vectors[i].Id == Id) return &vectors[i];
+    }
+    if (!Create || numVectors == SIM_MAX_INTERRUPTS) return NULL;
+    memset(&vectors[numVectors], 0, sizeof(SimVector_t));
+    vectors[numVectors].Id = Id;
+    return &vectors[numVectors++];
+}
+
+static Spi_t *spiOf(uint32_t Base)
+{
+    uint16_t i = (uint16_t)((Base - SPIA_BASE) / (SPIB_BASE - SPIA_BASE));
+
+    return (Base >= SPIA_BASE && i < SPI_MODULES) ? &spi[i] : NULL;
+}
+
+static DmaChannel_t *dmaOf(uint32_t Base)
+{
+    return &dma[(Base - DMA_CH1_BASE) / (DMA_CH2_BASE - DMA_CH1_BASE)];
+}
+
+static CpuTimer_t *timerOf(uint32_t Base)
+{
+    return &timers[(Base - CPUTIMER0_BASE) / (CPUTIMER1_BASE - CPUTIMER0_BASE)];
+}
+
+static Adc_t *adcOf(uint32_t Base)
+{
+    uint16_t i;
+
+    for (i = 0; i < ADC_MODULES; i++) {
+        if (adc[i].Base == Base) return &adc[i];
+    }
+    return &adc[0];
+}
+
+// Registers the code reads directly: SPICCR.SPISWRESET, DMA CONTROL and TRANSFER_COUNT
+static void spiRegs(const Spi_t *Spi, bool Enabled)
+{
+    if (Enabled) {
+        SimRegs[Spi->Base + SPI_O_CCR] |= SPI_CCR_SPISWRESET;
+    } else {
+        SimRegs[Spi->Base + SPI_O_CCR] &= (uint16_t)~SPI_CCR_SPISWRESET;
+    }
+}
+
+static bool spiEnabled(const Spi_t *Spi)
+{
+    return (SimRegs[Spi->Base + SPI_O_CCR] & SPI_CCR_SPISWRESET) != 0U;
+}
+
+static void dmaRegs(const DmaChannel_t *Ch)
+{
+    uint16_t control = 0;
+
+    if (Ch->Run) control |= DMA_CONTROL_RUNSTS;
+    if (Ch->Transfer) control |= DMA_CONTROL_TRANSFERSTS;
+    if (Ch->Overflow) control |= DMA_CONTROL_OVRFLG;
+    if (Ch->Pending) control |= DMA_CONTROL_PERINTFLG;
+    SimRegs[Ch->Base + DMA_O_CONTROL] = control;
+    SimRegs[Ch->Base + DMA_O_TRANSFER_COUNT] = Ch->TransferCount;
+}
+
+// Raises the DMA triggers of a SPI on the edges of its FIFO level conditions. A FIFO reset is an edge.
+static void spiTriggers(Spi_t *Spi, bool TxReset)
+{
+    bool tx = Spi->Fifo && Spi->TxLevel <= Spi->TxLevelInt;
+    bool rx = Spi->Fifo && Spi->RxLevel >= Spi->RxLevelInt && Spi->RxLevelInt > 0U;
+
+    if (tx && (!Spi->TxCond || TxReset)) {
+        Spi->Status |= SPI_INT_TXFF;
+        SimNode_Trigger(Spi->TxSource);
+    }
+    if (rx && !Spi->RxCond) {
+        Spi->Status |= SPI_INT_RXFF;
+        SimNode_Trigger(Spi->RxSource);
+    }
+    Spi->TxCond = tx;
+    Spi->RxCond = rx;
+}
+
+static void spiPushTx(Spi_t *Spi, uint16_t Word)
+{
+    if (Spi->TxLevel == SPI_FIFO_WORDS) return;
+    Spi->Tx[(Spi->TxHead + Spi->TxLevel) % SPI_FIFO_WORDS] = Word;
+    Spi->TxLevel++;
+    spiTriggers(Spi, false);
+}
+
+static uint16_t spiPopRx(Spi_t *Spi)
+{
+    uint16_t word;
+
+    if (Spi->RxLevel == 0U) return Spi->Dat;
+    word = Spi->Rx[Spi->RxHead];
+    Spi->RxHead = (Spi->RxHead + 1U) % SPI_FIFO_WORDS;
+    Spi->RxLevel--;
+    spiTriggers(Spi, false);
+    return word;
+}
+
+static uint16_t portRead(uintptr_t Address)
+{
+    return PERIPHERAL(Address) ? SimNode_PeripheralRead((uint32_t)Address) : *(volatile uint16_t *)Address;
+}
+
+static void portWrite(uintptr_t Address, uint16_t Word)
+{
+    if (PERIPHERAL(Address)) {
+        SimNode_PeripheralWrite((uint32_t)Address, Word);
+    } else {
+        *(volatile uint16_t *)Address = Word;
+    }
+}
+
+// Address steps are in words, host pointers in bytes
+static uintptr_t portStep(uintptr_t Address, int16_t Step)
+{
+    return PERIPHERAL(Address) ? Address + Step : Address + 2 * (intptr_t)Step;
+}
+
+static void portStart(DmaPort_t *Port)
+{
+    Port->Active = Port->Shadow;
+    Port->Begin = Port->Shadow;
+    Port->WrapCount = Port->WrapSize;
+}
+
+// End of a burst: wrap or step to the next one
+static void portNextBurst(DmaPort_t *Port)
+{
+    if (Port->WrapCount == 0U) {
+        Port->WrapCount = Port->WrapSize;
+        Port->Begin = portStep(Port->Begin, Port->WrapStep);
+        Port->Active = Port->Begin;
+    } else {
+        Port->WrapCount--;
+        Port->Active = portStep(Port->Active, Port->TransferStep);
+    }
+}
+
+// One burst, the channel is running and triggered. Returns true at the end of the transfer.
+static bool dmaBurst(DmaChannel_t *Ch)
+{
+    uint16_t i;
+
+    if (!Ch->Transfer) {
+        portStart(&Ch->Src);
+        portStart(&Ch->Dst);
+        Ch->TransferCount = Ch->TransferSize - 1U;
+        Ch->Transfer = true;
+        if (Ch->IntEnabled && !Ch->IntAtEnd) SimNode_Raise(Ch->Int);
+    }
+    for (i = 0; i < Ch->BurstSize; i++) {
+        portWrite(Ch->Dst.Active, portRead(Ch->Src.Active));
+        if (i + 1U < Ch->BurstSize) {
+            Ch->Src.Active = portStep(Ch->Src.Active, Ch->Src.BurstStep);
+            Ch->Dst.Active = portStep(Ch->Dst.Active, Ch->Dst.BurstStep);
+        }
+    }
+    SimCounters.DmaBursts++;
+    SimCounters.DmaWords += Ch->BurstSize;
+    portNextBurst(&Ch->Src);
+    portNextBurst(&Ch->Dst);
+
+    if (Ch->TransferCount != 0U) {
+        Ch->TransferCount--;
+        return false;
+    }
+    Ch->Transfer = false;
+    if (!Ch->Continuous) Ch->Run = false;
+    if (Ch->IntEnabled && Ch->IntAtEnd) SimNode_Raise(Ch->Int);
+    return true;
+}
+
+// Runs the bursts of every triggered channel, highest priority (lowest channel) first
+static void dmaService(void)
+{
+    bool again = true;
+    uint16_t i;
+
+    if (dmaBusy || dmaStall != 0U) return;
+    dmaBusy = true;
+    while (again) {
+        again = false;
+        for (i = 0; i < SIM_DMA_CHANNELS; i++) {
+            DmaChannel_t *ch = &dma[i];
+            if (!ch->Run || !ch->Pending) continue;
+            ch->Pending = false;
+            if (ch->OneShot) {
+                while (ch->Run && !dmaBurst(ch)) { }
+            } else {
+                dmaBurst(ch);
+            }
+            if (ch->TriggerEnabled && sourceActive(ch->Source)) ch->Pending = true;
+            dmaRegs(ch);
+            again = true;
+            break;
+        }
+    }
+    dmaBusy = false;
+}
+
+static void dmaLatch(DmaChannel_t *Ch)
+{
+    if (Ch->Pending) Ch->Overflow = true;
+    Ch->Pending = true;
+    dmaRegs(Ch);
+}
+
+// Trigger condition still true after a burst of the channel
+static bool sourceActive(uint16_t Source)
+{
+    uint16_t i;
+
+    for (i = 0; i < SPI_MODULES; i++) {
+        if (spi[i].TxSource == Source) return spi[i].TxCond;
+        if (spi[i].RxSource == Source) return spi[i].RxCond;
+    }
+    return false;
+}
+
+// Up-down period, in 1/256 TBCLK
+static int64_t pwmSpan(void)
+{
+    return 2 * (((int64_t)epwm.Period << 8) + (epwm.HighResPeriod ? epwm.PeriodHr : 0));
+}
+
+// Time in 1/256 TBCLK
+static int64_t pwmTime(uint64_t Time)
+{
+    return (int64_t)(Time / EPWM_TBCLK_DIV) << 8;
+}
+
+// Carrier position in the up-down period at a local time, in 1/256 TBCLK
+static int64_t pwmFinePosition(uint64_t Time)
+{
+    int64_t span = pwmSpan();
+    int64_t position;
+
+    if (span == 0) return 0;
+    position = (pwmTime(Time) + epwm.Offset) % span;
+    return position < 0 ? position + span : position;
+}
+
+// Carrier position in the up-down period at a local time
+static uint32_t pwmPosition(uint64_t Time)
+{
+    return (uint32_t)(pwmFinePosition(Time) >> 8);
+}
+
+// First local time after Time at which the carrier is at zero
+static uint64_t pwmNextZero(uint64_t Time)
+{
+    int64_t span = pwmSpan();
+    int64_t position = pwmFinePosition(Time);
+    int64_t zero;
+
+    if (span == 0) return SIM_TIME_NEVER;
+    zero = pwmTime(Time) + ((position == 0) ? span : span - position);
+    return (uint64_t)((zero + 255) >> 8) * EPWM_TBCLK_DIV;
+}
+
+// The counter goes on from where it is when the period changes
+static void pwmSetPeriod(uint16_t Period, uint16_t PeriodHr, bool HighRes)
+{
+    int64_t position = pwmFinePosition(now);
+    int64_t span;
+
+    epwm.Period = Period;
+    epwm.PeriodHr = PeriodHr;
+    epwm.HighResPeriod = HighRes;
+    span = pwmSpan();
+    if (span != 0) position %= span;
+    epwm.Offset = position - pwmTime(now);
+}
+
+// The carrier moved: the next SOCA is at its next zero
+static void pwmSchedule(void)
+{
+    epwm.NextSoc = epwm.Soc ? pwmNextZero(now) : SIM_TIME_NEVER;
+}
+
+static void adcStart(Adc_t *Adc, uint64_t Time)
+{
+    if (Adc->Done != SIM_TIME_NEVER) return;
+    Adc->Done = Time + ADC_CONVERSION_TICKS;
+}
+
+static void adcComplete(Adc_t *Adc)
+{
+    uint16_t soc;
+
+    Adc->Done = SIM_TIME_NEVER;
+    Adc->Conversions++;
+    for (soc = 0; soc < ADC_SOCS; soc++) {
+        if (!Adc->SocOnPwm[soc]) continue;
+        SimRegs[Adc->ResultBase + ADC_O_RESULT0 + soc] =
+            (uint16_t)((Adc->Channel[soc] * 256U + Adc->Conversions) & 0x0FFFU);
+    }
+    if (!Adc->IntEnabled) return;
+    if (Adc->Flag && !Adc->Continuous) {
+        Adc->Overflow = true;
+        return;
+    }
+    Adc->Flag = true;
+    SimNode_Trigger(Adc->Source);
+}
+
+static void timerExpired(CpuTimer_t *Timer)
+{
+    Timer->Overflow = true;
+    Timer->Expiry += (uint64_t)Timer->Period + 1U;
+    if (Timer->IntEnabled) SimNode_Raise(Timer->Int);
+}
+
+static void ecapEvent(bool Falling)
+{
+    uint16_t event = ecap.Pointer;
+
+    if (!ecap.Running || ecap.Falling[event] != Falling) return;
+    ecap.Cap[event] = (uint32_t)now;
+    ecap.Flags |= (uint16_t)(ECAP_ISR_SOURCE_CAPTURE_EVENT_1 << event);
+    ecap.Pointer = (uint16_t)((event + 1U) % ecap.Wrap);
+    if ((ecap.Flags & ecap.IntEnabled) && !ecap.Int) {
+        ecap.Int = true;
+        SimNode_Raise(INT_ECAP1);
+    }
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+
+/* Model side */
+
+uint64_t SimNode_Now(void)
+{
+    return now;
+}
+
+void SimNode_SetTime(uint64_t Now)
+{
+    if (Now > now) now = Now;
+    HWREG(IPC_BASE + IPC_O_COUNTERL) = (uint32_t)now;
+    HWREG(IPC_BASE + IPC_O_COUNTERH) = (uint32_t)(now >> 32);
+}
+
+void SimNode_Raise(uint32_t Id)
+{
+    SimVector_t *v = vector(Id, true);
+
+    if (v == NULL || v->Pending) return;
+    v->Pending = true;
+    pending[numPending++] = Id;
+}
+
+bool SimNode_TakeInterrupt(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < numPending; i++) {
+        SimVector_t *v = vector(pending[i], false);
+        if (!v->Enabled || v->Handler == NULL) continue;
+        memmove(&pending[i], &pending[i + 1], (numPending - i - 1U) * sizeof(pending[0]));
+        numPending--;
+        v->Pending = false;
+        v->Taken++;
+        v->LastTaken = now;
+        SimCounters.Interrupts++;
+        v->Handler();
+        return true;
+    }
+    return false;
+}
+
+const SimVector_t *SimNode_FindVector(uint32_t Id)
+{
+    return vector(Id, false);
+}
+
+uint16_t SimNode_PeripheralRead(uint32_t Address)
+{
+    Spi_t *s = spiOf(Address - SPI_O_RXBUF);
+
+    if (s != NULL && Address == s->Base + SPI_O_RXBUF) return spiPopRx(s);
+    return SimRegs[Address];
+}
+
+void SimNode_PeripheralWrite(uint32_t Address, uint16_t Word)
+{
+    Spi_t *s = spiOf(Address - SPI_O_TXBUF);
+
+    if (s != NULL && Address == s->Base + SPI_O_TXBUF) {
+        spiPushTx(s, Word);
+        return;
+    }
+    SimRegs[Address] = Word;
+}
+
+void SimNode_Trigger(uint16_t Source)
+{
+    uint16_t i;
+
+    for (i = 0; i < SIM_DMA_CHANNELS; i++) {
+        if (dma[i].TriggerEnabled && dma[i].Source == Source && Source != DMA_TRIGGER_SOFTWARE) dmaLatch(&dma[i]);
+    }
+    dmaService();
+}
+
+uint64_t SimNode_NextTimed(void)
+{
+    uint64_t next = SIM_TIME_NEVER;
+    uint16_t i;
+
+    for (i = 0; i < CPU_TIMERS; i++) {
+        if (timers[i].Running && timers[i].Expiry < next) next = timers[i].Expiry;
+    }
+    for (i = 0; i < ADC_MODULES; i++) {
+        if (adc[i].Done < next) next = adc[i].Done;
+    }
+    if (epwm.NextSoc < next) next = epwm.NextSoc;
+    if (dmaStall != 0U && dmaStall < next) next = dmaStall;
+    return next;
+}
+
+void SimNode_RunTimed(void)
+{
+    bool again = true;
+    uint16_t i;
+
+    while (again) {
+        again = false;
+        for (i = 0; i < CPU_TIMERS; i++) {
+            if (timers[i].Running && timers[i].Expiry <= now) {
+                timerExpired(&timers[i]);
+                again = true;
+            }
+        }
+        for (i = 0; i < ADC_MODULES; i++) {
+            if (adc[i].Done <= now) {
+                adcComplete(&adc[i]);
+                again = true;
+            }
+        }
+        if (epwm.NextSoc <= now) {
+            for (i = 0; i < ADC_MODULES; i++) {
+                uint16_t soc;
+                for (soc = 0; soc < ADC_SOCS && !adc[i].SocOnPwm[soc]; soc++) { }
+                if (soc < ADC_SOCS) adcStart(&adc[i], epwm.NextSoc);
+            }
+            epwm.NextSoc = pwmNextZero(epwm.NextSoc);
+            again = true;
+        }
+        if (dmaStall != 0U && dmaStall <= now) {
+            dmaStall = 0;
+            dmaService();
+            again = true;
+        }
+    }
+}
+
+void SimNode_DmaStall(uint64_t Until)
+{
+    if (Until > now && Until > dmaStall) dmaStall = Until;
+}
+
+void SimNode_CsEdge(bool Low)
+{
+    ecapEvent(Low);
+    if (xintEnabled && Low == xintFalling) SimNode_Raise(INT_XINT1);
+}
+
+bool SimNode_SpiReady(uint32_t Base)
+{
+    Spi_t *s = spiOf(Base);
+
+    return spiEnabled(s) && s->TxLevel > 0U;
+}
+
+uint16_t SimNode_SpiShiftOut(uint32_t Base)
+{
+    Spi_t *s = spiOf(Base);
+    uint16_t word;
+
+    if (!spiEnabled(s)) return 0xFFFFU;
+    if (s->TxLevel == 0U) return s->Dat;
+    word = s->Tx[s->TxHead];
+    s->TxHead = (s->TxHead + 1U) % SPI_FIFO_WORDS;
+    s->TxLevel--;
+    spiTriggers(s, false);
+    return word;
+}
+
+void SimNode_SpiShiftIn(uint32_t Base, uint16_t Word)
+{
+    Spi_t *s = spiOf(Base);
+
+    if (!spiEnabled(s)) return;
+    s->Dat = Word;
+    SimCounters.WordsIn++;
+    if (s->RxLevel == SPI_FIFO_WORDS) {
+        s->Status |= SPI_INT_RXFF_OVERFLOW;
+        SimCounters.RxOverflows++;
+        return;
+    }
+    s->Rx[(s->RxHead + s->RxLevel) % SPI_FIFO_WORDS] = Word;
+    s->RxLevel++;
+    spiTriggers(s, false);
+}
+
+uint32_t SimNode_SpiRate(uint32_t Base)
+{
+    return spiOf(Base)->BitRate;
+}
+
+void SimNode_ModelInit(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < SPI_MODULES; i++) {
+        spi[i].Base = SPIA_BASE + i * (SPIB_BASE - SPIA_BASE);
+        spi[i].TxSource = DMA_TRIGGER_SPIATX + 2U * i;
+        spi[i].RxSource = DMA_TRIGGER_SPIARX + 2U * i;
+    }
+    for (i = 0; i < SIM_DMA_CHANNELS; i++) {
+        dma[i].Base = DMA_CH1_BASE + i * (DMA_CH2_BASE - DMA_CH1_BASE);
+        dma[i].Int = dmaInts[i];
+        dma[i].BurstSize = 1;
+        dma[i].TransferSize = 1;
+        dma[i].Src.WrapSize = dma[i].Dst.WrapSize = 0xFFFFU;
+    }
+    for (i = 0; i < CPU_TIMERS; i++) {
+        timers[i].Base = CPUTIMER0_BASE + i * (CPUTIMER1_BASE - CPUTIMER0_BASE);
+        timers[i].Period = 0xFFFFFFFFUL;
+    }
+    timers[0].Int = INT_TIMER0;
+    timers[1].Int = INT_TIMER1;
+    timers[2].Int = INT_TIMER2;
+    ecap.Wrap = 4;
+    epwm.NextSoc = SIM_TIME_NEVER;
+    adc[0].Base = ADCA_BASE;
+    adc[0].ResultBase = ADCARESULT_BASE;
+    adc[0].Source = DMA_TRIGGER_ADCA1;
+    adc[1].Base = ADCB_BASE;
+    adc[1].ResultBase = ADCBRESULT_BASE;
+    adc[1].Source = DMA_TRIGGER_ADCB1;
+    adc[2].Base = ADCC_BASE;
+    adc[2].ResultBase = ADCCRESULT_BASE;
+    adc[2].Source = DMA_TRIGGER_ADCC1;
+    adc[3].Base = ADCD_BASE;
+    adc[3].ResultBase = ADCDRESULT_BASE;
+    adc[3].Source = DMA_TRIGGER_ADCD1;
+    for (i = 0; i < ADC_MODULES; i++) {
+        adc[i].Done = SIM_TIME_NEVER;
+    }
+}
+
+/* device.h */
+
+void Device_init(void)
+{
+}
+
+/* interrupt.h */
+
+void Interrupt_initModule(void)
+{
+}
+
+void Interrupt_initVectorTable(void)
+{
+}
+
+void Interrupt_register(uint32_t interruptNumber, void (*handler)(void))
+{
+    SimVector_t *v = vector(interruptNumber, true);
+
+    if (v != NULL) v->Handler = handler;
+}
+
+void Interrupt_enable(uint32_t interruptNumber)
+{
+    SimVector_t *v = vector(interruptNumber, true);
+
+    if (v != NULL) v->Enabled = true;
+}
+
+void Interrupt_disable(uint32_t interruptNumber)
+{
+    SimVector_t *v = vector(interruptNumber, true);
+
+    if (v != NULL) v->Enabled = false;
+}
+
+void Interrupt_clearACKGroup(uint16_t group)
+{
+}
+
+/* sysctl.h, gpio.h */
+
+void SysCtl_enablePeripheral(uint16_t peripheral)
+{
+}
+
+void SysCtl_disablePeripheral(uint16_t peripheral)
+{
+}
+
+void SysCtl_selectSecMaster(uint16_t periFrame1Config, uint16_t periFrame2Config)
+{
+}
+
+void SysCtl_delay(uint32_t count)
+{
+}
+
+void GPIO_togglePin(uint32_t pin)
+{
+}
+
+void GPIO_writePin(uint32_t pin, uint32_t outVal)
+{
+}
+
+void GPIO_setInterruptType(uint16_t extIntNum, uint16_t intType)
+{
+    xintFalling = (intType == GPIO_INT_TYPE_FALLING_EDGE);
+}
+
+void GPIO_enableInterrupt(uint16_t extIntNum)
+{
+    xintEnabled = true;
+}
+
+void GPIO_disableInterrupt(uint16_t extIntNum)
+{
+    xintEnabled = false;
+}
+
+/* dma.h */
+
+void DMA_initController(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < SIM_DMA_CHANNELS; i++) {
+        dma[i].Run = dma[i].Transfer = dma[i].Pending = dma[i].Overflow = false;
+        dmaRegs(&dma[i]);
+    }
+}
+
+void DMA_configAddresses(uint32_t base, const void *destAddr, const void *srcAddr)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Dst.Shadow = (uintptr_t)destAddr;
+    ch->Src.Shadow = (uintptr_t)srcAddr;
+}
+
+void DMA_configBurst(uint32_t base, uint16_t size, int16_t srcStep, int16_t destStep)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->BurstSize = size;
+    ch->Src.BurstStep = srcStep;
+    ch->Dst.BurstStep = destStep;
+}
+
+void DMA_configTransfer(uint32_t base, uint32_t transferSize, int16_t srcStep, int16_t destStep)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->TransferSize = (uint16_t)transferSize;
+    ch->Src.TransferStep = srcStep;
+    ch->Dst.TransferStep = destStep;
+}
+
+void DMA_configWrap(uint32_t base, uint32_t srcWrapSize, int16_t srcStep, uint32_t destWrapSize, int16_t destStep)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Src.WrapSize = (uint16_t)(srcWrapSize - 1U);
+    ch->Src.WrapStep = srcStep;
+    ch->Dst.WrapSize = (uint16_t)(destWrapSize - 1U);
+    ch->Dst.WrapStep = destStep;
+}
+
+void DMA_configMode(uint32_t base, DMA_Trigger trigger, uint32_t config)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Source = (uint16_t)trigger;
+    ch->OneShot = (config & DMA_CFG_ONESHOT_ENABLE) != 0U;
+    ch->Continuous = (config & DMA_CFG_CONTINUOUS_ENABLE) != 0U;
+}
+
+void DMA_setInterruptMode(uint32_t base, DMA_InterruptMode mode)
+{
+    dmaOf(base)->IntAtEnd = (mode == DMA_INT_AT_END);
+}
+
+void DMA_enableTrigger(uint32_t base)
+{
+    dmaOf(base)->TriggerEnabled = true;
+}
+
+void DMA_disableTrigger(uint32_t base)
+{
+    dmaOf(base)->TriggerEnabled = false;
+}
+
+void DMA_enableInterrupt(uint32_t base)
+{
+    dmaOf(base)->IntEnabled = true;
+}
+
+void DMA_disableInterrupt(uint32_t base)
+{
+    dmaOf(base)->IntEnabled = false;
+}
+
+void DMA_enableOverrunInterrupt(uint32_t base)
+{
+}
+
+void DMA_disableOverrunInterrupt(uint32_t base)
+{
+}
+
+void DMA_startChannel(uint32_t base)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Run = true;
+    dmaRegs(ch);
+    dmaService();
+}
+
+void DMA_stopChannel(uint32_t base)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Run = false;
+    dmaRegs(ch);
+}
+
+void DMA_forceTrigger(uint32_t base)
+{
+    dmaLatch(dmaOf(base));
+    dmaService();
+}
+
+void DMA_clearTriggerFlag(uint32_t base)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Pending = false;
+    dmaRegs(ch);
+}
+
+void DMA_clearErrorFlag(uint32_t base)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Overflow = false;
+    dmaRegs(ch);
+}
+
+void DMA_triggerSoftReset(uint32_t base)
+{
+    DmaChannel_t *ch = dmaOf(base);
+
+    ch->Run = false;
+    ch->Transfer = false;
+    dmaRegs(ch);
+}
+
+bool DMA_getTransferStatusFlag(uint32_t base)
+{
+    return dmaOf(base)->Transfer;
+}
+
+bool DMA_getBurstStatusFlag(uint32_t base)
+{
+    return false;
+}
+
+bool DMA_getRunStatusFlag(uint32_t base)
+{
+    return dmaOf(base)->Run;
+}
+
+bool DMA_getOverflowFlag(uint32_t base)
+{
+    return dmaOf(base)->Overflow;
+}
+
+bool DMA_getTriggerFlagStatus(uint32_t base)
+{
+    return dmaOf(base)->Pending;
+}
+
+/* spi.h */
+
+void SPI_setConfig(uint32_t base, uint32_t lspclkHz, SPI_TransferProtocol protocol, SPI_Mode mode,
+                   uint32_t bitRate, uint16_t dataWidth)
+{
+    Spi_t *s = spiOf(base);
+
+    s->Master = (mode == SPI_MODE_MASTER || mode == SPI_MODE_MASTER_OD);
+    s->BitRate = bitRate;
+}
+
+void SPI_enableModule(uint32_t base)
+{
+    spiRegs(spiOf(base), true);
+}
+
+void SPI_disableModule(uint32_t base)
+{
+    Spi_t *s = spiOf(base);
+
+    spiRegs(s, false);
+    s->Status &= ~(uint32_t)SPI_INT_RXFF_OVERFLOW;
+}
+
+void SPI_enableHighSpeedMode(uint32_t base)
+{
+}
+
+void SPI_disableLoopback(uint32_t base)
+{
+}
+
+void SPI_setEmulationMode(uint32_t base, SPI_EmulationMode mode)
+{
+}
+
+void SPI_enableFIFO(uint32_t base)
+{
+    Spi_t *s = spiOf(base);
+
+    s->Fifo = true;
+    spiTriggers(s, false);
+}
+
+void SPI_disableFIFO(uint32_t base)
+{
+    spiOf(base)->Fifo = false;
+}
+
+void SPI_resetTxFIFO(uint32_t base)
+{
+    Spi_t *s = spiOf(base);
+
+    s->TxLevel = 0;
+    spiTriggers(s, true);
+}
+
+void SPI_resetRxFIFO(uint32_t base)
+{
+    Spi_t *s = spiOf(base);
+
+    s->RxLevel = 0;
+    spiTriggers(s, false);
+}
+
+void SPI_setFIFOInterruptLevel(uint32_t base, SPI_TxFIFOLevel txLevel, SPI_RxFIFOLevel rxLevel)
+{
+    Spi_t *s = spiOf(base);
+
+    s->TxLevelInt = (uint16_t)txLevel;
+    s->RxLevelInt = (uint16_t)rxLevel;
+    spiTriggers(s, false);
+}
+
+void SPI_enableInterrupt(uint32_t base, uint32_t intFlags)
+{
+}
+
+void SPI_disableInterrupt(uint32_t base, uint32_t intFlags)
+{
+}
+
+uint32_t SPI_getInterruptStatus(uint32_t base)
+{
+    return spiOf(base)->Status;
+}
+
+void SPI_clearInterruptStatus(uint32_t base, uint32_t intFlags)
+{
+    spiOf(base)->Status &= ~intFlags;
+}
+
+SPI_TxFIFOLevel SPI_getTxFIFOStatus(uint32_t base)
+{
+    return (SPI_TxFIFOLevel)spiOf(base)->TxLevel;
+}
+
+SPI_RxFIFOLevel SPI_getRxFIFOStatus(uint32_t base)
+{
+    return (SPI_RxFIFOLevel)spiOf(base)->RxLevel;
+}
+
+/* cputimer.h */
+
+void CPUTimer_setPeriod(uint32_t base, uint32_t periodCount)
+{
+    timerOf(base)->Period = periodCount;
+}
+
+void CPUTimer_setPreScaler(uint32_t base, uint16_t prescaler)
+{
+}
+
+void CPUTimer_stopTimer(uint32_t base)
+{
+    timerOf(base)->Running = false;
+}
+
+// Starting a timer reloads it, as the driverlib does
+void CPUTimer_startTimer(uint32_t base)
+{
+    CpuTimer_t *t = timerOf(base);
+
+    t->Running = true;
+    t->Expiry = now + (uint64_t)t->Period + 1U;
+}
+
+void CPUTimer_reloadTimerCounter(uint32_t base)
+{
+    CpuTimer_t *t = timerOf(base);
+
+    t->Expiry = now + (uint64_t)t->Period + 1U;
+}
+
+void CPUTimer_setEmulationMode(uint32_t base, uint16_t mode)
+{
+}
+
+void CPUTimer_enableInterrupt(uint32_t base)
+{
+    timerOf(base)->IntEnabled = true;
+}
+
+void CPUTimer_disableInterrupt(uint32_t base)
+{
+    timerOf(base)->IntEnabled = false;
+}
+
+void CPUTimer_clearOverflowFlag(uint32_t base)
+{
+    timerOf(base)->Overflow = false;
+}
+
+bool CPUTimer_getTimerOverflowStatus(uint32_t base)
+{
+    return timerOf(base)->Overflow;
+}
+
+/* ecap.h */
+
+void ECAP_enableInterrupt(uint32_t base, uint16_t intFlags)
+{
+    ecap.IntEnabled |= intFlags;
+}
+
+void ECAP_disableInterrupt(uint32_t base, uint16_t intFlags)
+{
+    ecap.IntEnabled &= (uint16_t)~intFlags;
+}
+
+void ECAP_clearInterrupt(uint32_t base, uint16_t intFlags)
+{
+    ecap.Flags &= (uint16_t)~intFlags;
+}
+
+// Flags still set raise the interrupt again
+void ECAP_clearGlobalInterrupt(uint32_t base)
+{
+    ecap.Int = false;
+    if (ecap.Flags & ecap.IntEnabled) {
+        ecap.Int = true;
+        SimNode_Raise(INT_ECAP1);
+    }
+}
+
+uint16_t ECAP_getInterruptSource(uint32_t base)
+{
+    return ecap.Flags;
+}
+
+void ECAP_enableTimeStampCapture(uint32_t base)
+{
+}
+
+void ECAP_disableTimeStampCapture(uint32_t base)
+{
+}
+
+void ECAP_startCounter(uint32_t base)
+{
+    ecap.Running = true;
+}
+
+void ECAP_stopCounter(uint32_t base)
+{
+    ecap.Running = false;
+}
+
+void ECAP_enableCaptureMode(uint32_t base)
+{
+}
+
+void ECAP_setCaptureMode(uint32_t base, ECAP_CaptureMode mode, ECAP_Events event)
+{
+    ecap.Wrap = (uint16_t)event + 1U;
+}
+
+void ECAP_setEventPrescaler(uint32_t base, uint16_t preScalerValue)
+{
+}
+
+void ECAP_setEventPolarity(uint32_t base, ECAP_Events event, ECAP_EventPolarity polarity)
+{
+    ecap.Falling[event] = (polarity == ECAP_EVNT_FALLING_EDGE);
+}
+
+void ECAP_enableCounterResetOnEvent(uint32_t base, ECAP_Events event)
+{
+}
+
+void ECAP_disableCounterResetOnEvent(uint32_t base, ECAP_Events event)
+{
+}
+
+void ECAP_disableLoadCounter(uint32_t base)
+{
+}
+
+void ECAP_setSyncOutMode(uint32_t base, ECAP_SyncOutMode mode)
+{
+}
+
+void ECAP_setEmulationMode(uint32_t base, ECAP_EmulationMode mode)
+{
+}
+
+void ECAP_reArm(uint32_t base)
+{
+    ecap.Pointer = 0;
+}
+
+uint32_t ECAP_getEventTimeStamp(uint32_t base, ECAP_Events event)
+{
+    return ecap.Cap[event];
+}
+
+// The counter is free running from reset, never loaded: the low 32 bits of the local time
+uint32_t ECAP_getTimeBaseCounter(uint32_t base)
+{
+    return (uint32_t)now;
+}
+
+/* epwm.h */
+
+void EPWM_setClockPrescaler(uint32_t base, EPWM_ClockDivider prescaler, EPWM_HSClockDivider highSpeedPrescaler)
+{
+}
+
+void EPWM_setTimeBasePeriod(uint32_t base, uint16_t periodCount)
+{
+    pwmSetPeriod(periodCount, epwm.PeriodHr, epwm.HighResPeriod);
+    pwmSchedule();
+}
+
+void EPWM_setTimeBaseCounter(uint32_t base, uint16_t count)
+{
+    epwm.Offset = ((int64_t)count << 8) - pwmTime(now);
+    pwmSchedule();
+}
+
+void EPWM_setTimeBaseCounterMode(uint32_t base, EPWM_TimeBaseCountMode counterMode)
+{
+}
+
+void EPWM_setPhaseShift(uint32_t base, uint16_t phaseCount)
+{
+    epwm.Phase = phaseCount;
+}
+
+void EPWM_enablePhaseShiftLoad(uint32_t base)
+{
+    epwm.PhaseLoad = true;
+}
+
+void EPWM_disablePhaseShiftLoad(uint32_t base)
+{
+    epwm.PhaseLoad = false;
+}
+
+void EPWM_setCountModeAfterSync(uint32_t base, EPWM_SyncCountMode mode)
+{
+    epwm.UpAfterSync = (mode == EPWM_COUNT_MODE_UP_AFTER_SYNC);
+}
+
+// The counter is loaded with the phase, and counts in the direction selected from there
+void EPWM_forceSyncPulse(uint32_t base)
+{
+    int64_t position;
+
+    if (!epwm.PhaseLoad) return;
+    position = epwm.UpAfterSync ? ((int64_t)epwm.Phase << 8) : pwmSpan() - ((int64_t)epwm.Phase << 8);
+    epwm.Offset = position - pwmTime(now);
+    pwmSchedule();
+}
+
+void EPWM_setSyncOutPulseMode(uint32_t base, EPWM_SyncOutPulseMode mode)
+{
+}
+
+void EPWM_setEmulationMode(uint32_t base, EPWM_EmulationMode emulationMode)
+{
+}
+
+uint16_t EPWM_getTimeBaseCounterValue(uint32_t base)
+{
+    uint32_t position = pwmPosition(now);
+
+    return (uint16_t)(position < epwm.Period ? position : 2U * epwm.Period - position);
+}
+
+uint16_t EPWM_getTimeBaseCounterDirection(uint32_t base)
+{
+    return pwmPosition(now) < epwm.Period ? EPWM_TIME_BASE_STATUS_COUNT_UP : EPWM_TIME_BASE_STATUS_COUNT_DOWN;
+}
+
+void EPWM_setCounterCompareValue(uint32_t base, EPWM_CounterCompareModule compModule, uint16_t compCount)
+{
+    epwm.Compare[compModule] = compCount;
+}
+
+uint16_t EPWM_getCounterCompareValue(uint32_t base, EPWM_CounterCompareModule compModule)
+{
+    return epwm.Compare[compModule];
+}
+
+void EPWM_setActionQualifierAction(uint32_t base, EPWM_ActionQualifierOutputModule epwmOutput,
+                                   EPWM_ActionQualifierOutput output, EPWM_ActionQualifierOutputEvent event)
+{
+}
+
+/* hrpwm.h */
+
+void HRPWM_setTimeBasePeriod(uint32_t base, uint32_t periodCount)
+{
+    pwmSetPeriod((uint16_t)(periodCount >> 8), (uint16_t)(periodCount & 0xFFU), epwm.HighResPeriod);
+    pwmSchedule();
+}
+
+void HRPWM_enablePeriodControl(uint32_t base)
+{
+    pwmSetPeriod(epwm.Period, epwm.PeriodHr, true);
+    pwmSchedule();
+}
+
+void HRPWM_setMEPEdgeSelect(uint32_t base, HRPWM_Channel channel, HRPWM_MEPEdgeMode mepEdgeMode)
+{
+}
+
+void HRPWM_setMEPControlMode(uint32_t base, HRPWM_Channel channel, HRPWM_MEPCtrlMode mepCtrlMode)
+{
+}
+
+void HRPWM_enableAutoConversion(uint32_t base)
+{
+}
+
+void HRPWM_setMEPStep(uint32_t base, uint16_t mepCount)
+{
+}
+
+void EPWM_setTripZoneAction(uint32_t base, EPWM_TripZoneEvent tzEvent, EPWM_TripZoneAction tzAction)
+{
+}
+
+void EPWM_clearTripZoneFlag(uint32_t base, uint16_t tzFlags)
+{
+    if (tzFlags & EPWM_TZ_FLAG_OST) epwm.Tripped = false;
+}
+
+void EPWM_forceTripZoneEvent(uint32_t base, uint16_t tzForceEvent)
+{
+    if (tzForceEvent & EPWM_TZ_FORCE_EVENT_OST) epwm.Tripped = true;
+}
+
+void EPWM_enableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType)
+{
+    epwm.Soc = true;
+    pwmSchedule();
+}
+
+void EPWM_disableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType)
+{
+    epwm.Soc = false;
+    pwmSchedule();
+}
+
+void EPWM_setADCTriggerSource(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                              EPWM_ADCStartOfConversionSource socSource)
+{
+}
+
+void EPWM_setADCTriggerEventPrescale(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                                     uint16_t preScaleCount)
+{
+}
+
+/* adc.h */
+
+void ADC_setPrescaler(uint32_t base, ADC_ClkPrescale clkPrescale)
+{
+}
+
+void ADC_setMode(uint32_t base, ADC_Resolution resolution, ADC_SignalMode signalMode)
+{
+}
+
+void ADC_setInterruptPulseMode(uint32_t base, ADC_PulseMode pulseMode)
+{
+}
+
+void ADC_enableConverter(uint32_t base)
+{
+}
+
+void ADC_setupSOC(uint32_t base, ADC_SOCNumber socNumber, ADC_Trigger trigger, ADC_Channel channel,
+                  uint32_t sampleWindow)
+{
+    Adc_t *a = adcOf(base);
+
+    a->SocOnPwm[socNumber] = (trigger == ADC_TRIGGER_EPWM1_SOCA);
+    a->Channel[socNumber] = (uint16_t)channel;
+}
+
+void ADC_setInterruptSource(uint32_t base, ADC_IntNumber adcIntNum, ADC_SOCNumber socNumber)
+{
+    adcOf(base)->IntSoc = (uint16_t)socNumber;
+}
+
+void ADC_enableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum)
+{
+    adcOf(base)->Continuous = true;
+}
+
+void ADC_disableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum)
+{
+    adcOf(base)->Continuous = false;
+}
+
+void ADC_enableInterrupt(uint32_t base, ADC_IntNumber adcIntNum)
+{
+    adcOf(base)->IntEnabled = true;
+}
+
+void ADC_clearInterruptStatus(uint32_t base, ADC_IntNumber adcIntNum)
+{
+    adcOf(base)->Flag = false;
+}
+
+void ADC_clearInterruptOverflowStatus(uint32_t base, ADC_IntNumber adcIntNum)
+{
+    adcOf(base)->Overflow = false;
+}
+
+/* sci.h: the TX FIFO drains at once, nothing is ever received */
+
+void SCI_setConfig(uint32_t base, uint32_t lspclkHz, uint32_t baud, uint32_t config)
+{
+}
+
+void SCI_performSoftwareReset(uint32_t base)
+{
+}
+
+void SCI_resetChannels(uint32_t base)
+{
+}
+
+void SCI_enableFIFO(uint32_t base)
+{
+}
+
+void SCI_resetTxFIFO(uint32_t base)
+{
+}
+
+void SCI_resetRxFIFO(uint32_t base)
+{
+}
+
+void SCI_setFIFOInterruptLevel(uint32_t base, SCI_TxFIFOLevel txLevel, SCI_RxFIFOLevel rxLevel)
+{
+}
+
+void SCI_enableInterrupt(uint32_t base, uint32_t intFlags)
+{
+    if ((intFlags & SCI_INT_TXFF) && !(sci.IntEnabled & SCI_INT_TX)) {
+        sci.IntEnabled |= SCI_INT_TX;
+        SimNode_Raise(INT_SCIA_TX);
+    }
+}
+
+void SCI_disableInterrupt(uint32_t base, uint32_t intFlags)
+{
+    if (intFlags & SCI_INT_TXFF) sci.IntEnabled &= (uint16_t)~SCI_INT_TX;
+}
+
+void SCI_clearInterruptStatus(uint32_t base, uint32_t intFlags)
+{
+    if ((intFlags & SCI_INT_TXFF) && (sci.IntEnabled & SCI_INT_TX)) SimNode_Raise(INT_SCIA_TX);
+}
+
+void SCI_enableModule(uint32_t base)
+{
+}
+
+SCI_TxFIFOLevel SCI_getTxFIFOStatus(uint32_t base)
+{
+    return SCI_FIFO_TX0;
+}
+
+SCI_RxFIFOLevel SCI_getRxFIFOStatus(uint32_t base)
+{
+    return SCI_FIFO_RX0;
+}
+
+void SCI_writeCharNonBlocking(uint32_t base, uint16_t data)
+{
+}
+
+uint16_t SCI_readCharNonBlocking(uint32_t base)
+{
+    return 0;
+}
+
+uint16_t SCI_getRxStatus(uint32_t base)
+{
+    return 0;
+}
+
+bool SCI_getOverflowStatus(uint32_t base)
+{
+    return false;
+}
+
+void SCI_clearOverflowStatus(uint32_t base)
+{
+}
+
+/*** end of file ***/
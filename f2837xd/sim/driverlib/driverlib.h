@@ -0,0 +1,465 @@
+/**
+ ********************************************************************************
+ * @file    driverlib.h
+ * @brief   Host stand-in for the C2000 driverlib, for the ring simulator.
+ *
+ *          Declares the part of the driverlib API the CPU2 code uses, with the
+ *          same names and argument order, on top of the peripheral model of
+ *          SimNode.h. Register offsets, base addresses and interrupt numbers are
+ *          the device ones (device/driverlib/inc). Constants the code only passes
+ *          through keep their driverlib meaning but not always their value.
+ ********************************************************************************
+ */
+
+#ifndef DRIVERLIB_H
+#define DRIVERLIB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_ipc.h"
+#include "inc/hw_dma.h"
+#include "inc/hw_spi.h"
+#include "inc/hw_adc.h"
+#include "cpu.h"
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+
+/* interrupt.h */
+#define INTERRUPT_ACK_GROUP1    0x1U
+#define INTERRUPT_ACK_GROUP4    0x8U
+#define INTERRUPT_ACK_GROUP7    0x40U
+#define INTERRUPT_ACK_GROUP9    0x100U
+
+/* dma.h */
+#define DMA_CFG_ONESHOT_DISABLE     0x0U
+#define DMA_CFG_ONESHOT_ENABLE      0x400U
+#define DMA_CFG_CONTINUOUS_DISABLE  0x0U
+#define DMA_CFG_CONTINUOUS_ENABLE   0x800U
+#define DMA_CFG_SIZE_16BIT          0x0U
+#define DMA_CFG_SIZE_32BIT          0x4000U
+
+/* spi.h */
+#define SPI_INT_RXFF            0x0020U
+#define SPI_INT_TXFF            0x0040U
+#define SPI_INT_RXFF_OVERFLOW   0x0080U
+#define SPI_CCR_SPISWRESET      0x80U
+
+/* cputimer.h */
+#define CPUTIMER_EMULATIONMODE_STOPAFTERNEXTDECREMENT   0x0000U
+#define CPUTIMER_EMULATIONMODE_STOPATZERO               0x0400U
+#define CPUTIMER_EMULATIONMODE_RUNFREE                  0x0800U
+
+/* ecap.h */
+#define ECAP_ISR_SOURCE_CAPTURE_EVENT_1     0x2U
+#define ECAP_ISR_SOURCE_CAPTURE_EVENT_2     0x4U
+#define ECAP_ISR_SOURCE_CAPTURE_EVENT_3     0x8U
+#define ECAP_ISR_SOURCE_CAPTURE_EVENT_4     0x10U
+#define ECAP_ISR_SOURCE_COUNTER_OVERFLOW    0x20U
+#define ECAP_ISR_SOURCE_COUNTER_PERIOD      0x40U
+#define ECAP_ISR_SOURCE_COUNTER_COMPARE     0x80U
+
+/* epwm.h */
+#define EPWM_TZ_INTERRUPT           0x1U
+#define EPWM_TZ_FLAG_OST            0x4U
+#define EPWM_TZ_FORCE_EVENT_OST     0x4U
+#define EPWM_TIME_BASE_STATUS_COUNT_DOWN    0U
+#define EPWM_TIME_BASE_STATUS_COUNT_UP      1U
+
+/* sci.h */
+#define SCI_CONFIG_WLEN_8           0x0007U
+#define SCI_CONFIG_STOP_ONE         0x0000U
+#define SCI_CONFIG_PAR_NONE         0x0000U
+#define SCI_INT_RXERR               0x01U
+#define SCI_INT_RXRDY_BRKDT         0x02U
+#define SCI_INT_TXRDY               0x04U
+#define SCI_INT_TXFF                0x08U
+#define SCI_INT_RXFF                0x10U
+#define SCI_RXSTATUS_ERROR          0x0080U
+
+/* gpio.h, sysctl.h */
+#define GPIO_INT_XINT1              0U
+#define GPIO_INT_TYPE_FALLING_EDGE  0x00U
+#define GPIO_INT_TYPE_RISING_EDGE   0x04U
+#define SYSCTL_SEC_MASTER_DMA       1U
+#define SYSCTL_PERIPH_CLK_TBCLKSYNC 0x0012U
+
+/************************************
+ * TYPEDEFS
+ ************************************/
+typedef enum {
+    DMA_TRIGGER_SOFTWARE    = 0,
+    DMA_TRIGGER_ADCA1       = 1,
+    DMA_TRIGGER_ADCB1       = 6,
+    DMA_TRIGGER_ADCC1       = 11,
+    DMA_TRIGGER_ADCD1       = 16,
+    DMA_TRIGGER_SPIATX      = 109,
+    DMA_TRIGGER_SPIARX      = 110,
+    DMA_TRIGGER_SPIBTX      = 111,
+    DMA_TRIGGER_SPIBRX      = 112
+} DMA_Trigger;
+
+typedef enum {
+    DMA_INT_AT_BEGINNING,
+    DMA_INT_AT_END
+} DMA_InterruptMode;
+
+typedef enum {
+    SPI_PROT_POL0PHA0, SPI_PROT_POL0PHA1, SPI_PROT_POL1PHA0, SPI_PROT_POL1PHA1
+} SPI_TransferProtocol;
+
+typedef enum {
+    SPI_MODE_SLAVE, SPI_MODE_MASTER, SPI_MODE_SLAVE_OD, SPI_MODE_MASTER_OD
+} SPI_Mode;
+
+typedef enum {
+    SPI_FIFO_TX0, SPI_FIFO_TX1, SPI_FIFO_TX2, SPI_FIFO_TX3, SPI_FIFO_TX4, SPI_FIFO_TX5, SPI_FIFO_TX6,
+    SPI_FIFO_TX7, SPI_FIFO_TX8, SPI_FIFO_TX9, SPI_FIFO_TX10, SPI_FIFO_TX11, SPI_FIFO_TX12, SPI_FIFO_TX13,
+    SPI_FIFO_TX14, SPI_FIFO_TX15, SPI_FIFO_TX16, SPI_FIFO_TXEMPTY = SPI_FIFO_TX0, SPI_FIFO_TXFULL = SPI_FIFO_TX16
+} SPI_TxFIFOLevel;
+
+typedef enum {
+    SPI_FIFO_RX0, SPI_FIFO_RX1, SPI_FIFO_RX2, SPI_FIFO_RX3, SPI_FIFO_RX4, SPI_FIFO_RX5, SPI_FIFO_RX6,
+    SPI_FIFO_RX7, SPI_FIFO_RX8, SPI_FIFO_RX9, SPI_FIFO_RX10, SPI_FIFO_RX11, SPI_FIFO_RX12, SPI_FIFO_RX13,
+    SPI_FIFO_RX14, SPI_FIFO_RX15, SPI_FIFO_RX16, SPI_FIFO_RXEMPTY = SPI_FIFO_RX0, SPI_FIFO_RXFULL = SPI_FIFO_RX16
+} SPI_RxFIFOLevel;
+
+typedef enum {
+    SPI_EMULATION_STOP_MIDWAY, SPI_EMULATION_FREE_RUN, SPI_EMULATION_STOP_AFTER_TRANSMIT
+} SPI_EmulationMode;
+
+typedef enum {
+    SCI_FIFO_TX0, SCI_FIFO_TX1, SCI_FIFO_TX2, SCI_FIFO_TX3, SCI_FIFO_TX4, SCI_FIFO_TX5, SCI_FIFO_TX6,
+    SCI_FIFO_TX7, SCI_FIFO_TX8, SCI_FIFO_TX9, SCI_FIFO_TX10, SCI_FIFO_TX11, SCI_FIFO_TX12, SCI_FIFO_TX13,
+    SCI_FIFO_TX14, SCI_FIFO_TX15, SCI_FIFO_TX16
+} SCI_TxFIFOLevel;
+
+typedef enum {
+    SCI_FIFO_RX0, SCI_FIFO_RX1, SCI_FIFO_RX2, SCI_FIFO_RX3, SCI_FIFO_RX4, SCI_FIFO_RX5, SCI_FIFO_RX6,
+    SCI_FIFO_RX7, SCI_FIFO_RX8, SCI_FIFO_RX9, SCI_FIFO_RX10, SCI_FIFO_RX11, SCI_FIFO_RX12, SCI_FIFO_RX13,
+    SCI_FIFO_RX14, SCI_FIFO_RX15, SCI_FIFO_RX16
+} SCI_RxFIFOLevel;
+
+typedef enum {
+    ECAP_EVENT_1, ECAP_EVENT_2, ECAP_EVENT_3, ECAP_EVENT_4
+} ECAP_Events;
+
+typedef enum {
+    ECAP_EVNT_RISING_EDGE, ECAP_EVNT_FALLING_EDGE
+} ECAP_EventPolarity;
+
+typedef enum {
+    ECAP_CONTINUOUS_CAPTURE_MODE, ECAP_ONE_SHOT_CAPTURE_MODE
+} ECAP_CaptureMode;
+
+typedef enum {
+    ECAP_SYNC_OUT_SYNCI, ECAP_SYNC_OUT_COUNTER_PRD, ECAP_SYNC_OUT_DISABLED
+} ECAP_SyncOutMode;
+
+typedef enum {
+    ECAP_EMULATION_STOP, ECAP_EMULATION_RUN_TO_ZERO, ECAP_EMULATION_FREE_RUN
+} ECAP_EmulationMode;
+
+typedef enum {
+    EPWM_CLOCK_DIVIDER_1, EPWM_CLOCK_DIVIDER_2, EPWM_CLOCK_DIVIDER_4, EPWM_CLOCK_DIVIDER_8,
+    EPWM_CLOCK_DIVIDER_16, EPWM_CLOCK_DIVIDER_32, EPWM_CLOCK_DIVIDER_64, EPWM_CLOCK_DIVIDER_128
+} EPWM_ClockDivider;
+
+typedef enum {
+    EPWM_HSCLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_2, EPWM_HSCLOCK_DIVIDER_4, EPWM_HSCLOCK_DIVIDER_6,
+    EPWM_HSCLOCK_DIVIDER_8, EPWM_HSCLOCK_DIVIDER_10, EPWM_HSCLOCK_DIVIDER_12, EPWM_HSCLOCK_DIVIDER_14
+} EPWM_HSClockDivider;
+
+typedef enum {
+    EPWM_COUNTER_MODE_UP, EPWM_COUNTER_MODE_DOWN, EPWM_COUNTER_MODE_UP_DOWN, EPWM_COUNTER_MODE_STOP_FREEZE
+} EPWM_TimeBaseCountMode;
+
+typedef enum {
+    EPWM_COUNT_MODE_DOWN_AFTER_SYNC, EPWM_COUNT_MODE_UP_AFTER_SYNC
+} EPWM_SyncCountMode;
+
+typedef enum {
+    EPWM_SYNC_OUT_PULSE_ON_SOFTWARE, EPWM_SYNC_OUT_PULSE_ON_COUNTER_ZERO,
+    EPWM_SYNC_OUT_PULSE_ON_COUNTER_COMPARE_B, EPWM_SYNC_OUT_PULSE_DISABLED
+} EPWM_SyncOutPulseMode;
+
+typedef enum {
+    EPWM_EMULATION_STOP_AFTER_NEXT_TB, EPWM_EMULATION_STOP_AFTER_FULL_CYCLE, EPWM_EMULATION_FREE_RUN
+} EPWM_EmulationMode;
+
+typedef enum {
+    EPWM_COUNTER_COMPARE_A, EPWM_COUNTER_COMPARE_B, EPWM_COUNTER_COMPARE_C, EPWM_COUNTER_COMPARE_D
+} EPWM_CounterCompareModule;
+
+typedef enum {
+    EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_B
+} EPWM_ActionQualifierOutputModule;
+
+typedef enum {
+    EPWM_AQ_OUTPUT_NO_CHANGE, EPWM_AQ_OUTPUT_LOW, EPWM_AQ_OUTPUT_HIGH, EPWM_AQ_OUTPUT_TOGGLE
+} EPWM_ActionQualifierOutput;
+
+typedef enum {
+    EPWM_AQ_OUTPUT_ON_TIMEBASE_ZERO, EPWM_AQ_OUTPUT_ON_TIMEBASE_PERIOD,
+    EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA, EPWM_AQ_OUTPUT_ON_TIMEBASE_DOWN_CMPA,
+    EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPB, EPWM_AQ_OUTPUT_ON_TIMEBASE_DOWN_CMPB
+} EPWM_ActionQualifierOutputEvent;
+
+typedef enum {
+    EPWM_TZ_ACTION_EVENT_TZA, EPWM_TZ_ACTION_EVENT_TZB
+} EPWM_TripZoneEvent;
+
+typedef enum {
+    EPWM_TZ_ACTION_HIGH_Z, EPWM_TZ_ACTION_HIGH, EPWM_TZ_ACTION_LOW, EPWM_TZ_ACTION_DISABLE
+} EPWM_TripZoneAction;
+
+typedef enum {
+    EPWM_SOC_A, EPWM_SOC_B
+} EPWM_ADCStartOfConversionType;
+
+typedef enum {
+    EPWM_SOC_DCxEVT1, EPWM_SOC_TBCTR_ZERO, EPWM_SOC_TBCTR_PERIOD, EPWM_SOC_TBCTR_ZERO_OR_PERIOD
+} EPWM_ADCStartOfConversionSource;
+
+typedef enum {
+    HRPWM_CHANNEL_A = 0, HRPWM_CHANNEL_B = 8
+} HRPWM_Channel;
+
+typedef enum {
+    HRPWM_MEP_CTRL_DISABLE = 0, HRPWM_MEP_CTRL_RISING_EDGE = 1, HRPWM_MEP_CTRL_FALLING_EDGE = 2,
+    HRPWM_MEP_CTRL_RISING_AND_FALLING_EDGE = 3
+} HRPWM_MEPEdgeMode;
+
+typedef enum {
+    HRPWM_MEP_DUTY_PERIOD_CTRL = 0, HRPWM_MEP_PHASE_CTRL = 1
+} HRPWM_MEPCtrlMode;
+
+typedef enum {
+    ADC_CLK_DIV_1_0 = 0, ADC_CLK_DIV_2_0 = 2, ADC_CLK_DIV_4_0 = 6, ADC_CLK_DIV_8_0 = 14
+} ADC_ClkPrescale;
+
+typedef enum {
+    ADC_RESOLUTION_12BIT, ADC_RESOLUTION_16BIT
+} ADC_Resolution;
+
+typedef enum {
+    ADC_MODE_SINGLE_ENDED, ADC_MODE_DIFFERENTIAL
+} ADC_SignalMode;
+
+typedef enum {
+    ADC_PULSE_END_OF_ACQ_WIN, ADC_PULSE_END_OF_CONV
+} ADC_PulseMode;
+
+typedef enum {
+    ADC_SOC_NUMBER0, ADC_SOC_NUMBER1, ADC_SOC_NUMBER2, ADC_SOC_NUMBER3, ADC_SOC_NUMBER4, ADC_SOC_NUMBER5,
+    ADC_SOC_NUMBER6, ADC_SOC_NUMBER7, ADC_SOC_NUMBER8, ADC_SOC_NUMBER9, ADC_SOC_NUMBER10, ADC_SOC_NUMBER11,
+    ADC_SOC_NUMBER12, ADC_SOC_NUMBER13, ADC_SOC_NUMBER14, ADC_SOC_NUMBER15
+} ADC_SOCNumber;
+
+typedef enum {
+    ADC_CH_ADCIN0, ADC_CH_ADCIN1, ADC_CH_ADCIN2, ADC_CH_ADCIN3, ADC_CH_ADCIN4, ADC_CH_ADCIN5, ADC_CH_ADCIN6,
+    ADC_CH_ADCIN7, ADC_CH_ADCIN8, ADC_CH_ADCIN9, ADC_CH_ADCIN10, ADC_CH_ADCIN11, ADC_CH_ADCIN12,
+    ADC_CH_ADCIN13, ADC_CH_ADCIN14, ADC_CH_ADCIN15
+} ADC_Channel;
+
+typedef enum {
+    ADC_TRIGGER_SW_ONLY = 0, ADC_TRIGGER_EPWM1_SOCA = 5
+} ADC_Trigger;
+
+typedef enum {
+    ADC_INT_NUMBER1, ADC_INT_NUMBER2, ADC_INT_NUMBER3, ADC_INT_NUMBER4
+} ADC_IntNumber;
+
+/************************************
+ * GLOBAL FUNCTION PROTOTYPES
+ ************************************/
+
+/* interrupt.h */
+void Interrupt_initModule(void);
+void Interrupt_initVectorTable(void);
+void Interrupt_register(uint32_t interruptNumber, void (*handler)(void));
+void Interrupt_enable(uint32_t interruptNumber);
+void Interrupt_disable(uint32_t interruptNumber);
+void Interrupt_clearACKGroup(uint16_t group);
+
+/* sysctl.h, gpio.h */
+void SysCtl_enablePeripheral(uint16_t peripheral);
+void SysCtl_disablePeripheral(uint16_t peripheral);
+void SysCtl_selectSecMaster(uint16_t periFrame1Config, uint16_t periFrame2Config);
+void SysCtl_delay(uint32_t count);
+void GPIO_togglePin(uint32_t pin);
+void GPIO_writePin(uint32_t pin, uint32_t outVal);
+void GPIO_setInterruptType(uint16_t extIntNum, uint16_t intType);
+void GPIO_enableInterrupt(uint16_t extIntNum);
+void GPIO_disableInterrupt(uint16_t extIntNum);
+
+/* dma.h */
+void DMA_initController(void);
+void DMA_configAddresses(uint32_t base, const void *destAddr, const void *srcAddr);
+void DMA_configBurst(uint32_t base, uint16_t size, int16_t srcStep, int16_t destStep);
+void DMA_configTransfer(uint32_t base, uint32_t transferSize, int16_t srcStep, int16_t destStep);
+void DMA_configWrap(uint32_t base, uint32_t srcWrapSize, int16_t srcStep, uint32_t destWrapSize, int16_t destStep);
+void DMA_configMode(uint32_t base, DMA_Trigger trigger, uint32_t config);
+void DMA_setInterruptMode(uint32_t base, DMA_InterruptMode mode);
+void DMA_enableTrigger(uint32_t base);
+void DMA_disableTrigger(uint32_t base);
+void DMA_enableInterrupt(uint32_t base);
+void DMA_disableInterrupt(uint32_t base);
+void DMA_enableOverrunInterrupt(uint32_t base);
+void DMA_disableOverrunInterrupt(uint32_t base);
+void DMA_startChannel(uint32_t base);
+void DMA_stopChannel(uint32_t base);
+void DMA_forceTrigger(uint32_t base);
+void DMA_clearTriggerFlag(uint32_t base);
+void DMA_clearErrorFlag(uint32_t base);
+void DMA_triggerSoftReset(uint32_t base);
+bool DMA_getTransferStatusFlag(uint32_t base);
+bool DMA_getBurstStatusFlag(uint32_t base);
+bool DMA_getRunStatusFlag(uint32_t base);
+bool DMA_getOverflowFlag(uint32_t base);
+bool DMA_getTriggerFlagStatus(uint32_t base);
+
+/* spi.h */
+void SPI_setConfig(uint32_t base, uint32_t lspclkHz, SPI_TransferProtocol protocol, SPI_Mode mode,
+                   uint32_t bitRate, uint16_t dataWidth);
+void SPI_enableModule(uint32_t base);
+void SPI_disableModule(uint32_t base);
+void SPI_enableHighSpeedMode(uint32_t base);
+void SPI_disableLoopback(uint32_t base);
+void SPI_setEmulationMode(uint32_t base, SPI_EmulationMode mode);
+void SPI_enableFIFO(uint32_t base);
+void SPI_disableFIFO(uint32_t base);
+void SPI_resetTxFIFO(uint32_t base);
+void SPI_resetRxFIFO(uint32_t base);
+void SPI_setFIFOInterruptLevel(uint32_t base, SPI_TxFIFOLevel txLevel, SPI_RxFIFOLevel rxLevel);
+void SPI_enableInterrupt(uint32_t base, uint32_t intFlags);
+void SPI_disableInterrupt(uint32_t base, uint32_t intFlags);
+uint32_t SPI_getInterruptStatus(uint32_t base);
+void SPI_clearInterruptStatus(uint32_t base, uint32_t intFlags);
+SPI_TxFIFOLevel SPI_getTxFIFOStatus(uint32_t base);
+SPI_RxFIFOLevel SPI_getRxFIFOStatus(uint32_t base);
+
+/* cputimer.h */
+void CPUTimer_setPeriod(uint32_t base, uint32_t periodCount);
+void CPUTimer_setPreScaler(uint32_t base, uint16_t prescaler);
+void CPUTimer_stopTimer(uint32_t base);
+void CPUTimer_startTimer(uint32_t base);
+void CPUTimer_reloadTimerCounter(uint32_t base);
+void CPUTimer_setEmulationMode(uint32_t base, uint16_t mode);
+void CPUTimer_enableInterrupt(uint32_t base);
+void CPUTimer_disableInterrupt(uint32_t base);
+void CPUTimer_clearOverflowFlag(uint32_t base);
+bool CPUTimer_getTimerOverflowStatus(uint32_t base);
+
+/* ecap.h */
+void ECAP_enableInterrupt(uint32_t base, uint16_t intFlags);
+void ECAP_disableInterrupt(uint32_t base, uint16_t intFlags);
+void ECAP_clearInterrupt(uint32_t base, uint16_t intFlags);
+void ECAP_clearGlobalInterrupt(uint32_t base);
+uint16_t ECAP_getInterruptSource(uint32_t base);
+void ECAP_enableTimeStampCapture(uint32_t base);
+void ECAP_disableTimeStampCapture(uint32_t base);
+void ECAP_startCounter(uint32_t base);
+void ECAP_stopCounter(uint32_t base);
+void ECAP_enableCaptureMode(uint32_t base);
+void ECAP_setCaptureMode(uint32_t base, ECAP_CaptureMode mode, ECAP_Events event);
+void ECAP_setEventPrescaler(uint32_t base, uint16_t preScalerValue);
+void ECAP_setEventPolarity(uint32_t base, ECAP_Events event, ECAP_EventPolarity polarity);
+void ECAP_enableCounterResetOnEvent(uint32_t base, ECAP_Events event);
+void ECAP_disableCounterResetOnEvent(uint32_t base, ECAP_Events event);
+void ECAP_disableLoadCounter(uint32_t base);
+void ECAP_setSyncOutMode(uint32_t base, ECAP_SyncOutMode mode);
+void ECAP_setEmulationMode(uint32_t base, ECAP_EmulationMode mode);
+void ECAP_reArm(uint32_t base);
+uint32_t ECAP_getEventTimeStamp(uint32_t base, ECAP_Events event);
+uint32_t ECAP_getTimeBaseCounter(uint32_t base);
+
+/* epwm.h */
+void EPWM_setClockPrescaler(uint32_t base, EPWM_ClockDivider prescaler, EPWM_HSClockDivider highSpeedPrescaler);
+void EPWM_setTimeBasePeriod(uint32_t base, uint16_t periodCount);
+void EPWM_setTimeBaseCounter(uint32_t base, uint16_t count);
+void EPWM_setTimeBaseCounterMode(uint32_t base, EPWM_TimeBaseCountMode counterMode);
+void EPWM_setPhaseShift(uint32_t base, uint16_t phaseCount);
+void EPWM_enablePhaseShiftLoad(uint32_t base);
+void EPWM_disablePhaseShiftLoad(uint32_t base);
+void EPWM_setCountModeAfterSync(uint32_t base, EPWM_SyncCountMode mode);
+void EPWM_forceSyncPulse(uint32_t base);
+void EPWM_setSyncOutPulseMode(uint32_t base, EPWM_SyncOutPulseMode mode);
+void EPWM_setEmulationMode(uint32_t base, EPWM_EmulationMode emulationMode);
+uint16_t EPWM_getTimeBaseCounterValue(uint32_t base);
+uint16_t EPWM_getTimeBaseCounterDirection(uint32_t base);
+void EPWM_setCounterCompareValue(uint32_t base, EPWM_CounterCompareModule compModule, uint16_t compCount);
+uint16_t EPWM_getCounterCompareValue(uint32_t base, EPWM_CounterCompareModule compModule);
+void EPWM_setActionQualifierAction(uint32_t base, EPWM_ActionQualifierOutputModule epwmOutput,
+                                   EPWM_ActionQualifierOutput output, EPWM_ActionQualifierOutputEvent event);
+void EPWM_setTripZoneAction(uint32_t base, EPWM_TripZoneEvent tzEvent, EPWM_TripZoneAction tzAction);
+void EPWM_clearTripZoneFlag(uint32_t base, uint16_t tzFlags);
+void EPWM_forceTripZoneEvent(uint32_t base, uint16_t tzForceEvent);
+void EPWM_enableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType);
+void EPWM_disableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType);
+void EPWM_setADCTriggerSource(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                              EPWM_ADCStartOfConversionSource socSource);
+
+/* hrpwm.h */
+void HRPWM_setTimeBasePeriod(uint32_t base, uint32_t periodCount);
+void HRPWM_enablePeriodControl(uint32_t base);
+void HRPWM_setMEPEdgeSelect(uint32_t base, HRPWM_Channel channel, HRPWM_MEPEdgeMode mepEdgeMode);
+void HRPWM_setMEPControlMode(uint32_t base, HRPWM_Channel channel, HRPWM_MEPCtrlMode mepCtrlMode);
+void HRPWM_enableAutoConversion(uint32_t base);
+void HRPWM_setMEPStep(uint32_t base, uint16_t mepCount);
+void EPWM_setADCTriggerEventPrescale(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                                     uint16_t preScaleCount);
+
+/* adc.h */
+void ADC_setPrescaler(uint32_t base, ADC_ClkPrescale clkPrescale);
+void ADC_setMode(uint32_t base, ADC_Resolution resolution, ADC_SignalMode signalMode);
+void ADC_setInterruptPulseMode(uint32_t base, ADC_PulseMode pulseMode);
+void ADC_enableConverter(uint32_t base);
+void ADC_setupSOC(uint32_t base, ADC_SOCNumber socNumber, ADC_Trigger trigger, ADC_Channel channel,
+                  uint32_t sampleWindow);
+void ADC_setInterruptSource(uint32_t base, ADC_IntNumber adcIntNum, ADC_SOCNumber socNumber);
+void ADC_enableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_disableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_enableInterrupt(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_clearInterruptStatus(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_clearInterruptOverflowStatus(uint32_t base, ADC_IntNumber adcIntNum);
+
+/* sci.h */
+void SCI_setConfig(uint32_t base, uint32_t lspclkHz, uint32_t baud, uint32_t config);
+void SCI_performSoftwareReset(uint32_t base);
+void SCI_resetChannels(uint32_t base);
+void SCI_enableFIFO(uint32_t base);
+void SCI_resetTxFIFO(uint32_t base);
+void SCI_resetRxFIFO(uint32_t base);
+void SCI_setFIFOInterruptLevel(uint32_t base, SCI_TxFIFOLevel txLevel, SCI_RxFIFOLevel rxLevel);
+void SCI_enableInterrupt(uint32_t base, uint32_t intFlags);
+void SCI_disableInterrupt(uint32_t base, uint32_t intFlags);
+void SCI_clearInterruptStatus(uint32_t base, uint32_t intFlags);
+void SCI_enableModule(uint32_t base);
+SCI_TxFIFOLevel SCI_getTxFIFOStatus(uint32_t base);
+SCI_RxFIFOLevel SCI_getRxFIFOStatus(uint32_t base);
+void SCI_writeCharNonBlocking(uint32_t base, uint16_t data);
+uint16_t SCI_readCharNonBlocking(uint32_t base);
+uint16_t SCI_getRxStatus(uint32_t base);
+bool SCI_getOverflowStatus(uint32_t base);
+void SCI_clearOverflowStatus(uint32_t base);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVERLIB_H */
+
+/*** end of file ***/
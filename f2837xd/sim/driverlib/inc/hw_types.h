@@ -0,0 +1,35 @@
+/**
+ ********************************************************************************
+ * @file    hw_types.h
+ * @brief   Host stand-in for driverlib/inc/hw_types.h, for the ring simulator.
+ *
+ *          Register accesses land in the register file of the node (SimNode.h),
+ *          indexed by the C28x word address. 32-bit registers are at even
+ *          addresses, low word first, as on the device.
+ ********************************************************************************
+ */
+
+#ifndef HW_TYPES_H
+#define HW_TYPES_H
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>             // NULL, which the TI headers bring along
+
+/************************************
+ * MACROS AND DEFINES
+ ************************************/
+#define HWREG(x)        (*((volatile uint32_t *)(void *)&SimRegs[(uintptr_t)(x)]))
+#define HWREGH(x)       (SimRegs[(uintptr_t)(x)])
+
+/************************************
+ * EXPORTED VARIABLES
+ ************************************/
+extern volatile uint16_t SimRegs[];
+
+#endif /* HW_TYPES_H */
+
+/*** end of file ***/
@@ -0,0 +1,1474 @@
+/**
+ ********************************************************************************
+ * @file    ringsim.c
+ * @brief   Host ring simulator: clocks the Director and N workers as one ring.
+ *
+ *          Loads director.so and worker<k>.so (Makefile), each with its own
+ *          local clock (offset, drift), and plays the wires between them:
+ *
+ *          - CS falls CS_DELAY_TICKS after the Director has words in its SPI A
+ *            TX FIFO, and reaches worker k CS_HOP_TICKS * (k + 1) later;
+ *          - once every worker has seen it, and CS_SETUP_TICKS more, the
+ *            Director clocks 16-bit words back to back at the bit rate its code
+ *            set up. Each worker is a shift register in the data path: the word
+ *            it shifts out during a word is the one it got in the word before;
+ *          - CS rises half a bit after the last word, once the Director SPI A
+ *            TX FIFO is empty.
+ *
+ *          Faults (Faults.h) are injected after the warm-up, on the links at the
+ *          end of each word, on CS and the DMA of the nodes. The report then
+ *          tells, for the frames they hit, whether a node found something wrong
+ *          or a payload passed its CRC wrong, and how long the ring took to be
+ *          clean again.
+ *
+ *          Run to idle after every stimulus, the nodes never overlap with the
+ *          wire, see SimNode.h. The report covers the frames after the warm-up:
+ *          link statistics of every node, frame timing, what the nodes did per
+ *          frame, and the payloads CPU1 found wrong after they passed their CRC.
+ *
+ *          With --update, the Director distributes a random firmware image from
+ *          the end of the warm-up, to the simulated staging area of the workers
+ *          (SimFlash.c); faults hit its bulk frames like any other. The report
+ *          tells when each worker had it written and the CRC of what it holds.
+ *
+ *          With --halt-director, the Director stops dead between two frames and
+ *          the run goes on until every worker watchdog (CommsWatchdog.h) has put
+ *          its output in the safe state. The report tells how long after the
+ *          last frame each worker entered its fail-safe path and reached the
+ *          safe state, against the bound its watchdog settings give.
+ *
+ *          With --check the run is also a test: the exit status is 1 if CPU1
+ *          found a payload wrong after it passed its CRC, faults or not, if a
+ *          worker cluster time or carrier was further off than --max-sync or
+ *          --max-phase, if the update did
+ *          not end with the image in the staging area of every worker, or if a
+ *          worker did not reach its safe state within the bound. With the
+ *          mailbox channel it is also 1 if a worker did not answer the echo
+ *          requests of the Director, or the link statistics the Director got
+ *          from a worker were not its own of the last REPORT_LAG_FRAMES frames.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+#include <dlfcn.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "system.h"
+#include "crc.h"
+#include "LinkStats.h"
+#include "Mailbox.h"
+#include "FwUpdate.h"
+#include "CommsWatchdog.h"
+#include "SimNode.h"
+#include "Faults.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define MAX_NODES               (NUM_WORKERS + 1)
+
+#define CS_DELAY_TICKS          200U    /*!< Director launch to CS falling, CS_DETECT_DELAY_TICKS of the workers */
+#define CS_HOP_TICKS            4U      /*!< CS propagation per ring position, CS_HOP_DELAY_TICKS of the workers */
+#define CS_SETUP_TICKS          64U     /*!< Last CS falling edge to the first SCLK edge */
+
+#define RUNAWAY_FRAMES          4U      /*!< A frame this many times RING_CLOCKED_WORDS long never ends */
+
+#define DEFAULT_FRAMES          1000U
+#define DEFAULT_WARMUP          50U
+
+#define UPDATE_IMAGE_ID         0x51U   /*!< Image id of --update */
+
+#define HALT_TIMEOUT_PERIODS    64U     /*!< Frame periods after a halt the workers have to reach their safe state */
+#define HALT_MARGIN_DIV         100U    /*!< Bound of the safe state: the watchdog settings, plus a period / DIV */
+
+// Frames the link statistics the Director holds of a worker may lag the worker: it reports them once a second,
+// 10 frames at the default period, over a frame per message fragment, and a report faults hit is restarted after
+// MAILBOX_RESYNC_FRAMES. The checks lag 16 frames clean, up to 116 with faults or an update.
+#define REPORT_LAG_FRAMES       160U
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef enum {
+    STAT_COUNT,
+    STAT_ERROR,                 /*!< Counts something wrong the node found */
+    STAT_CRC,                   /*!< Counts chunks failing their CRC */
+    STAT_MAX,                   /*!< Largest value seen rather than a counter */
+} StatClass_t;
+
+typedef struct {
+    const char *Name;
+    size_t Offset;
+    StatClass_t Class;
+} StatField_t;
+
+typedef struct {
+    char Name[16];
+    void *Handle;
+    const SimNodeApi_t *Api;
+    int64_t Offset;             /*!< Local time at global 0 */
+    int64_t Ppb;                /*!< Clock error, parts per billion */
+    LinkStats_t *Stats;         /*!< linkStats of the node code */
+    LinkStats_t Last;           /*!< At the last frame boundary */
+    uint64_t Totals[LINK_STATS_WORDS];
+    SimCounters_t Base;         /*!< Counters at the end of the warm-up */
+    SimCpu1_t Cpu1Base;
+    uint64_t LastMismatches;    /*!< CPU1 mismatches at the last frame boundary */
+
+    bool WireCsLow;             /*!< CS level the wire drives at the node */
+    bool CsLow;                 /*!< CS level the node sees */
+    bool Glitch;                /*!< CS held high by a glitch until GlitchEnd */
+    uint64_t GlitchEnd;
+    uint64_t Dropout;           /*!< Frames the worker is still off the ring */
+
+    FwReceiver_t *Receiver;     /*!< fwReceiver of a worker */
+    SimFlash_t *Flash;          /*!< Staging area of a worker */
+    uint64_t UpdateDone;        /*!< Frame after the warm-up the worker had the image written, 0 if not yet */
+
+    CommsWatchdog_t *Watchdog;  /*!< watchdog of a worker */
+    uint64_t FailSafeAt;        /*!< Global time it entered its fail-safe path after a halt, 0 if not yet */
+    uint64_t SafeAt;            /*!< Global time its output tripped after a halt, 0 if not yet */
+
+    LinkStats_t History[REPORT_LAG_FRAMES + 1];     /*!< linkStats of a worker at the last frame boundaries */
+    uint16_t HistoryHead;       /*!< Newest entry */
+    uint16_t HistoryLen;
+    uint32_t EchoBase;          /*!< Echo requests to the worker acknowledged by the end of the warm-up */
+    bool EchoSeen;
+    uint16_t LastEcho;          /*!< Last echo reply in the Director inbox */
+    uint64_t EchoReplies;
+    LinkStats_t Reported;       /*!< Last report of its link statistics the Director received */
+    uint64_t Reports;           /*!< Reports received after the warm-up */
+    uint16_t ReportAgeMax;      /*!< Frames the reported statistics lagged the worker, at most */
+    uint64_t StaleFrames;       /*!< Frames the report lagged more than REPORT_LAG_FRAMES */
+    uint64_t AheadFrames;       /*!< Frames the report was ahead of the worker in some counter */
+} Node_t;
+
+typedef enum {
+    WIRE_IDLE,
+    WIRE_LAUNCH,                /*!< Director has words to send, CS about to fall */
+    WIRE_CS_FALL,               /*!< CS falling edge reaching worker Index */
+    WIRE_WORD_START,
+    WIRE_WORD_END,
+    WIRE_CS_RISE,               /*!< CS rising edge reaching worker Index */
+} WireState_t;
+
+typedef struct {
+    WireState_t State;
+    uint64_t Next;              /*!< Global time of the next step */
+    uint16_t Index;
+    uint64_t Fall, Rise;        /*!< Global time CS left the Director */
+    uint64_t Launch;            /*!< Local Director time of the launch */
+    uint16_t Out[MAX_NODES];    /*!< Words being shifted out: Director, workers 0 to N-1 */
+    uint32_t Words;             /*!< Words clocked in the frame */
+    uint32_t WordTicks, BitTicks;
+} Wire_t;
+
+typedef struct {
+    uint64_t Count;
+    uint64_t Sum;
+    uint64_t Min, Max;
+} Spread_t;
+
+/**
+ * @brief Outcome of the faults, frame by frame. A frame runs from a CS falling edge to the next.
+ */
+typedef struct {
+    uint64_t Faulted;           /*!< Frames hit by a fault, or with a worker off the ring */
+    uint64_t Detected;          /*!< Of those, frames in which a node found something wrong */
+    uint64_t Undetected;        /*!< Frames in which none did, but a payload passed its CRC wrong */
+    uint64_t Masked;            /*!< Frames with neither */
+    uint64_t Spurious;          /*!< Frames with errors and no fault since the ring was last clean */
+    uint64_t CrcErrors;         /*!< Chunks failing their CRC */
+    uint64_t Errors;            /*!< Other errors found by the nodes */
+    uint64_t Mismatches;        /*!< Payloads CPU1 found wrong after their CRC passed */
+    uint64_t Checked;           /*!< Payloads CPU1 checked */
+    Spread_t Recovery;          /*!< Last fault to the first clean frame, ticks */
+    Spread_t RecoveryFrames;
+    uint64_t Unrecovered;       /*!< Disturbed at the end of the run */
+} FaultStats_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static Node_t nodes[MAX_NODES];     /*!< Director first, then the workers */
+static uint16_t numNodes;
+static Wire_t wire;
+static uint64_t now;                /*!< Global time, Director SYSCLK ticks */
+
+static uint64_t frames;             /*!< Frames with CS risen */
+static uint64_t warmup = DEFAULT_WARMUP;
+static bool measuring;
+static uint64_t measureStart;
+
+static Spread_t csLow;              /*!< CS falling to rising, ticks */
+static Spread_t wordsPerFrame;
+static Spread_t rxLatency;          /*!< Launch to the Director RX DMA interrupt, ticks */
+static Spread_t period;             /*!< CS falling to CS falling */
+static uint64_t lastFall;
+static uint64_t rxTaken;
+static int32_t *syncError;
+static int16_t *phaseError;
+static int32_t syncErrorMax;
+static int16_t phaseErrorMax;
+static int32_t maxPhase = -1;       /*!< --max-phase, TBCLK, -1 for none */
+static int32_t maxSync = -1;        /*!< --max-sync, ticks, -1 for none */
+
+static uint32_t updateWords;        /*!< --update, image words, 0 for none */
+static uint16_t *updateImage;
+static FwSender_t *fwSender;        /*!< of the Director */
+static volatile uint16_t *fwStart;
+static uint64_t updateEnd;          /*!< Frame after the warm-up the Director ended the update, 0 if not yet */
+
+static uint64_t haltAfter;          /*!< --halt-director, frames after the warm-up, 0 for none */
+static bool halted;
+static uint64_t haltFall;           /*!< CS falling edge of the last frame before the halt */
+
+#if MAILBOX_WORDS > 0
+static Mailbox_t *mailboxes;        /*!< of the Director */
+static MailboxMessage_t *mailboxInbox;
+static LinkStats_t *workerLinkStats;
+#endif
+
+static uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+static bool faults;                 /*!< Fault injection enabled */
+static uint64_t faultSeed;
+static uint64_t frameFaults;        /*!< Faults taken in the frame */
+static uint64_t lastFault;          /*!< Global time of the last fault, or of the end of a dropout */
+static uint64_t lastFaultFrame;
+static bool disturbed;              /*!< A fault was taken since the ring was last clean */
+static bool disturbedErrors;        /*!< and errors were found since */
+static FaultStats_t faultStats;
+
+static StatField_t statFields[4 + 2 * NUM_WORKERS + 12];
+static uint16_t numStatFields;
+
+static const struct {
+    const char *Name;
+    uint32_t Id;
+} vectorNames[] = {
+    { "TIMER0", INT_TIMER0 }, { "XINT1", INT_XINT1 }, { "ECAP1", INT_ECAP1 }, { "DMA_CH3", INT_DMA_CH3 },
+    { "DMA_CH5", INT_DMA_CH5 }, { "DMA_CH6", INT_DMA_CH6 }, { "TIMER1", INT_TIMER1 }, { "TIMER2", INT_TIMER2 },
+    { "SCIA_TX", INT_SCIA_TX },
+};
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint64_t random64(void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1DULL;
+}
+
+static void spreadAdd(Spread_t *Spread, uint64_t Value)
+{
+    if (Spread->Count == 0 || Value < Spread->Min) Spread->Min = Value;
+    if (Spread->Count == 0 || Value > Spread->Max) Spread->Max = Value;
+    Spread->Count++;
+    Spread->Sum += Value;
+}
+
+static double spreadAvg(const Spread_t *Spread)
+{
+    return Spread->Count ? (double)Spread->Sum / Spread->Count : 0.0;
+}
+
+static void statField(const char *Name, size_t Offset, StatClass_t Class)
+{
+    statFields[numStatFields].Name = Name;
+    statFields[numStatFields].Offset = Offset;
+    statFields[numStatFields++].Class = Class;
+}
+
+static void statFieldsInit(void)
+{
+    static char names[2 * NUM_WORKERS][32];
+    uint16_t w;
+
+    statField("FramesSent", offsetof(LinkStats_t, FramesSent), STAT_COUNT);
+    statField("FramesReceived", offsetof(LinkStats_t, FramesReceived), STAT_COUNT);
+    statField("BroadcastCrcErrors", offsetof(LinkStats_t, BroadcastCrcErrors), STAT_CRC);
+    for (w = 0; w < NUM_WORKERS; w++) {
+        snprintf(names[w], sizeof(names[w]), "SetpointCrcErrors%u", w);
+        statField(names[w], offsetof(LinkStats_t, SetpointCrcErrors) + w * sizeof(uint16_t), STAT_CRC);
+    }
+    for (w = 0; w < NUM_WORKERS; w++) {
+        snprintf(names[NUM_WORKERS + w], sizeof(names[0]), "MeasurementCrcErrors%u", w);
+        statField(names[NUM_WORKERS + w], offsetof(LinkStats_t, MeasurementCrcErrors) + w * sizeof(uint16_t),
+                  STAT_CRC);
+    }
+    statField("DecodeErrors", offsetof(LinkStats_t, DecodeErrors), STAT_ERROR);
+    statField("LateChunks", offsetof(LinkStats_t, LateChunks), STAT_COUNT);
+    statField("CsOverruns", offsetof(LinkStats_t, CsOverruns), STAT_ERROR);
+    statField("DmaOverruns", offsetof(LinkStats_t, DmaOverruns), STAT_ERROR);
+    statField("LengthErrors", offsetof(LinkStats_t, LengthErrors), STAT_ERROR);
+    statField("ShortFrames", offsetof(LinkStats_t, ShortFrames), STAT_ERROR);
+    statField("Recoveries", offsetof(LinkStats_t, Recoveries), STAT_ERROR);
+    statField("Realignments", offsetof(LinkStats_t, Realignments), STAT_ERROR);
+    statField("SlippedFrames", offsetof(LinkStats_t, SlippedFrames), STAT_ERROR);
+    statField("BulkFrames", offsetof(LinkStats_t, BulkFrames), STAT_COUNT);
+    statField("IsrLatencyMax", offsetof(LinkStats_t, IsrLatencyMax), STAT_MAX);
+    statField("RxIsrMax", offsetof(LinkStats_t, RxIsrMax), STAT_MAX);
+}
+
+static uint16_t statWord(const LinkStats_t *Stats, const StatField_t *Field)
+{
+    return *(const uint16_t *)((const uint8_t *)Stats + Field->Offset);
+}
+
+// Counters are 16 bits on the nodes, they are added up frame by frame. Adds to Crc and Errors what the
+// node found wrong since the last call.
+static void statsAccumulate(Node_t *Node, uint64_t *Crc, uint64_t *Errors)
+{
+    uint16_t i;
+
+    for (i = 0; i < numStatFields; i++) {
+        uint16_t value = statWord(Node->Stats, &statFields[i]);
+        uint16_t delta = (uint16_t)(value - statWord(&Node->Last, &statFields[i]));
+        if (statFields[i].Class == STAT_MAX) {
+            Node->Totals[i] = value;
+            continue;
+        }
+        if (measuring) Node->Totals[i] += delta;
+        if (statFields[i].Class == STAT_CRC) *Crc += delta;
+        if (statFields[i].Class == STAT_ERROR) *Errors += delta;
+    }
+    Node->Last = *Node->Stats;
+}
+
+/* Clocks */
+
+static uint64_t toLocal(const Node_t *Node, uint64_t Global)
+{
+    return (uint64_t)(Node->Offset + (int64_t)Global + (int64_t)((__int128)Global * Node->Ppb / 1000000000));
+}
+
+// First global time at which the local clock reaches Local
+static uint64_t toGlobal(const Node_t *Node, uint64_t Local)
+{
+    double g;
+    uint64_t global;
+
+    if (Local == SIM_TIME_NEVER) return SIM_TIME_NEVER;
+    if ((int64_t)Local <= Node->Offset) return 0;
+    g = (double)((int64_t)Local - Node->Offset) * 1e9 / (1e9 + (double)Node->Ppb);
+    global = (uint64_t)g;
+    while (toLocal(Node, global) < Local) global++;
+    while (global > 0 && toLocal(Node, global - 1) >= Local) global--;
+    return global;
+}
+
+/* Nodes */
+
+static void nodeLoad(Node_t *Node, const char *Dir, const char *File, const char *Name)
+{
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/%s", Dir, File);
+    Node->Handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (Node->Handle == NULL) {
+        fprintf(stderr, "ringsim: %s\n", dlerror());
+        exit(1);
+    }
+    Node->Api = dlsym(Node->Handle, "SimNodeApi");
+    Node->Stats = dlsym(Node->Handle, "linkStats");
+    if (Node->Api == NULL || Node->Stats == NULL) {
+        fprintf(stderr, "ringsim: %s is not a node\n", path);
+        exit(1);
+    }
+    if (Node->Api->NumWorkers != NUM_WORKERS || Node->Api->ClockedWords != RING_CLOCKED_WORDS) {
+        fprintf(stderr, "ringsim: %s was built for another ring configuration\n", path);
+        exit(1);
+    }
+    snprintf(Node->Name, sizeof(Node->Name), "%s", Name);
+}
+
+static Node_t *director(void)
+{
+    return &nodes[0];
+}
+
+static Node_t *worker(uint16_t Index)
+{
+    return &nodes[1 + Index];
+}
+
+/* Firmware update */
+
+static void *directorSymbol(const char *Name)
+{
+    void *symbol = dlsym(director()->Handle, Name);
+
+    if (symbol == NULL) {
+        fprintf(stderr, "ringsim: the Director has no %s\n", Name);
+        exit(1);
+    }
+    return symbol;
+}
+
+// Hands a random image to the Director, as from the debugger
+static void updateStart(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < updateWords; i++) {
+        updateImage[i] = (uint16_t)random64();
+    }
+    *(const uint16_t **)directorSymbol("fwImage") = updateImage;
+    *(uint32_t *)directorSymbol("fwImageWords") = updateWords;
+    *(uint16_t *)directorSymbol("fwImageId") = UPDATE_IMAGE_ID;
+    *fwStart = 1;
+}
+
+static void updateFrame(void)
+{
+    const FwReceiver_t *r;
+    uint16_t k;
+
+    for (k = 0; k < NUM_WORKERS; k++) {
+        r = worker(k)->Receiver;
+        if (worker(k)->UpdateDone == 0 && r->ImageId == UPDATE_IMAGE_ID && r->ErasedId == UPDATE_IMAGE_ID &&
+            r->Missing == 0) {
+            worker(k)->UpdateDone = frames - warmup;
+        }
+    }
+    // fwStart is taken at the next launch
+    if (updateEnd == 0 && !*fwStart && !fwSender->Active) updateEnd = frames - warmup;
+}
+
+static uint16_t updateCrc(uint16_t Index)
+{
+    return crcFast(worker(Index)->Flash->Data, (int)updateWords);
+}
+
+/* Director halt */
+
+static const char *policyName(uint16_t Policy)
+{
+    return Policy == COMMS_WD_POLICY_HOLD ? "hold" : Policy == COMMS_WD_POLICY_RAMP ? "ramp" : "trip";
+}
+
+// Latest safe state of a worker after the last valid frame its watchdog allows: the deadline, then the
+// periods of HOLD, or the steps of RAMP after its first one
+static uint64_t haltBound(uint16_t Index)
+{
+    const CommsWatchdog_t *wd = worker(Index)->Watchdog;
+    double p = spreadAvg(&period);
+    uint16_t steps = wd->Policy == COMMS_WD_POLICY_TRIP || wd->PolicyFrames == 0 ? 0 :
+                     wd->Policy == COMMS_WD_POLICY_RAMP ? wd->PolicyFrames - 1U : wd->PolicyFrames;
+
+    return (uint64_t)(p * (wd->Frames + 0.5 + steps) + p / HALT_MARGIN_DIV);
+}
+
+// Follows the workers once the Director stopped. true when they are all safe, or out of time.
+static bool haltFollow(void)
+{
+    bool safe = true;
+    uint16_t k;
+
+    for (k = 0; k < NUM_WORKERS; k++) {
+        Node_t *w = worker(k);
+        uint16_t state = w->Watchdog->State;
+
+        if (w->FailSafeAt == 0 && state != COMMS_WD_LEARNING && state != COMMS_WD_RUNNING) w->FailSafeAt = now;
+        if (w->SafeAt == 0 && state == COMMS_WD_TRIPPED) w->SafeAt = now;
+        if (w->SafeAt == 0) safe = false;
+    }
+    return safe || now - haltFall > (uint64_t)(spreadAvg(&period) * HALT_TIMEOUT_PERIODS);
+}
+
+static bool haltSafe(uint16_t Index)
+{
+    return worker(Index)->SafeAt != 0 && worker(Index)->SafeAt - haltFall <= haltBound(Index);
+}
+
+/* Mailbox */
+
+#if MAILBOX_WORDS > 0
+static const LinkStats_t *historyAt(const Node_t *Node, uint16_t Age)
+{
+    return &Node->History[(Node->HistoryHead + REPORT_LAG_FRAMES + 1U - Age) % (REPORT_LAG_FRAMES + 1U)];
+}
+
+// Every counter of A at or past the one of B. The counters wrap, they are compared within half their range.
+static bool statsReached(const LinkStats_t *A, const LinkStats_t *B)
+{
+    const uint16_t *a = (const uint16_t *)A, *b = (const uint16_t *)B;
+    uint16_t i;
+
+    for (i = 0; i < LINK_STATS_WORDS; i++) {
+        if ((int16_t)(a[i] - b[i]) < 0) return false;
+    }
+    return true;
+}
+
+// Follows the echo replies and link statistics reports the Director receives. A report is the statistics of
+// the worker at some point of the last REPORT_LAG_FRAMES frames: at or past its statistics at a frame boundary
+// of that window, and not past them now.
+static void mailboxFrame(void)
+{
+    uint16_t k, age;
+
+    for (k = 0; k < NUM_WORKERS; k++) {
+        Node_t *w = worker(k);
+        const MailboxMessage_t *inbox = &mailboxInbox[k];
+        const LinkStats_t *report = &workerLinkStats[k];
+
+        w->HistoryHead = (w->HistoryHead + 1U) % (REPORT_LAG_FRAMES + 1U);
+        w->History[w->HistoryHead] = *w->Stats;
+        if (w->HistoryLen <= REPORT_LAG_FRAMES) w->HistoryLen++;
+
+        // Echo replies all differ, the Director numbers its requests
+        if (inbox->Type == MAILBOX_TYPE_ECHO && inbox->Length == 1 && (!w->EchoSeen || inbox->Data[0] != w->LastEcho)) {
+            if (measuring) w->EchoReplies++;
+            w->EchoSeen = true;
+            w->LastEcho = inbox->Data[0];
+        }
+        if (memcmp(report, &w->Reported, sizeof(*report)) != 0) {
+            if (measuring) w->Reports++;
+            w->Reported = *report;
+        }
+        if (!measuring || halted) continue;
+
+        if (!statsReached(w->Stats, report)) w->AheadFrames++;
+        for (age = 0; age < w->HistoryLen && !statsReached(report, historyAt(w, age)); age++) {
+        }
+        if (age == w->HistoryLen) {
+            if (w->HistoryLen > REPORT_LAG_FRAMES) w->StaleFrames++;
+        } else if (age > w->ReportAgeMax) {
+            w->ReportAgeMax = age;
+        }
+    }
+}
+#endif
+
+/* Faults */
+
+static bool dropouts(void)
+{
+    uint16_t k;
+
+    for (k = 0; k < NUM_WORKERS; k++) {
+        if (worker(k)->Dropout) return true;
+    }
+    return false;
+}
+
+static void faultTaken(void)
+{
+    frameFaults++;
+    lastFault = now;
+    lastFaultFrame = frames - warmup;
+}
+
+// CS level seen by worker Index: the one of the wire unless a glitch holds it high, no edge while it is off
+// the ring
+static void csApply(uint16_t Index)
+{
+    Node_t *w = worker(Index);
+    bool low = w->WireCsLow && !w->Glitch;
+
+    if (w->Dropout || low == w->CsLow) return;
+    w->CsLow = low;
+    if (!low) Faults_Resync(1 + Index);
+    w->Api->ChipSelect(low, toLocal(w, now));
+}
+
+// Dropouts, before CS falls. A worker back on the ring counts as a fault of the frame.
+static void faultFrameStart(void)
+{
+    Fault_t due[FAULTS_MAX_DUE];
+    uint16_t n, i, k;
+
+    for (k = 0; k < NUM_WORKERS; k++) {
+        if (worker(k)->Dropout && --worker(k)->Dropout == 0) faultTaken();
+    }
+    n = Faults_Due(frames - warmup, FAULT_FRAME_START, due);
+    for (i = 0; i < n; i++) {
+        Node_t *w = &nodes[due[i].Node];
+        if (due[i].Arg > w->Dropout) w->Dropout = due[i].Arg;
+        faultTaken();
+    }
+}
+
+// Outcome of the frame that ended: Crc, Errors found by the nodes, Mismatches found by CPU1
+static void faultFrameEnd(uint64_t Crc, uint64_t Errors, uint64_t Mismatches)
+{
+    bool hit = frameFaults > 0 || dropouts();
+    bool bad = Crc + Errors + Mismatches > 0;
+
+    faultStats.CrcErrors += Crc;
+    faultStats.Errors += Errors;
+    faultStats.Mismatches += Mismatches;
+    if (hit) {
+        faultStats.Faulted++;
+        if (Crc + Errors > 0) {
+            faultStats.Detected++;
+        } else if (Mismatches > 0) {
+            faultStats.Undetected++;
+        } else {
+            faultStats.Masked++;
+        }
+        disturbed = true;
+    } else if (bad && !disturbed) {
+        faultStats.Spurious++;
+    }
+    if (bad && disturbed) disturbedErrors = true;
+
+    // First clean frame since the last fault: recovered, if the fault did any harm
+    if (disturbed && !hit && !bad) {
+        if (disturbedErrors) {
+            spreadAdd(&faultStats.Recovery, lastFall - lastFault);
+            spreadAdd(&faultStats.RecoveryFrames, frames - 1U - warmup - lastFaultFrame);
+        }
+        disturbed = disturbedErrors = false;
+    }
+    frameFaults = 0;
+}
+
+/* Wire */
+
+static void wireLaunchCheck(void);
+
+static void wireAfterDirector(void)
+{
+    const SimVector_t *rx = director()->Api->Vector(INT_DMA_CH6);
+    uint16_t w;
+
+    if (rx != NULL && rx->Taken != rxTaken) {
+        rxTaken = rx->Taken;
+        if (measuring) {
+            spreadAdd(&rxLatency, rx->LastTaken - wire.Launch);
+            for (w = 0; w < NUM_WORKERS; w++) {
+                int32_t s = abs(syncError[w]);
+                int16_t p = (int16_t)abs(phaseError[w]);
+                if (s > syncErrorMax) syncErrorMax = s;
+                if (p > phaseErrorMax) phaseErrorMax = p;
+            }
+        }
+    }
+    wireLaunchCheck();
+}
+
+static void wireLaunchCheck(void)
+{
+    if (wire.State != WIRE_IDLE || !director()->Api->SpiTxReady(SPIA_BASE)) return;
+    wire.State = WIRE_LAUNCH;
+    wire.Launch = toLocal(director(), now);
+    wire.Next = now + CS_DELAY_TICKS;
+}
+
+// Closes the frame clocked since the last CS falling edge
+static void frameEnd(void)
+{
+    uint64_t crc = 0, errors = 0, mismatches = 0;
+    uint16_t i;
+
+    for (i = 0; i < numNodes; i++) {
+        statsAccumulate(&nodes[i], &crc, &errors);
+        mismatches += nodes[i].Api->Cpu1->Mismatches - nodes[i].LastMismatches;
+        nodes[i].LastMismatches = nodes[i].Api->Cpu1->Mismatches;
+    }
+    if (measuring && faults) faultFrameEnd(crc, errors, mismatches);
+}
+
+static void frameStart(void)
+{
+    uint16_t i;
+
+    frameEnd();
+    if (frames >= warmup && !measuring) {
+        measuring = true;
+        measureStart = now;
+        for (i = 0; i < numNodes; i++) {
+            nodes[i].Base = *nodes[i].Api->Counters;
+            nodes[i].Cpu1Base = *nodes[i].Api->Cpu1;
+            nodes[i].Last = *nodes[i].Stats;
+            nodes[i].Api->Cpu1->Check = true;
+        }
+        if (updateWords) updateStart();
+#if MAILBOX_WORDS > 0
+        for (i = 0; i < NUM_WORKERS; i++) {
+            worker(i)->EchoBase = mailboxes[i].Sent;
+        }
+#endif
+    }
+#if MAILBOX_WORDS > 0
+    mailboxFrame();
+#endif
+    if (measuring && updateWords) updateFrame();
+    if (measuring && lastFall != 0) spreadAdd(&period, now - lastFall);
+    lastFall = now;
+    if (measuring && faults) faultFrameStart();
+}
+
+// Word shifted in by a node from its link, after a slip of its SCLK
+static void linkDeliver(uint16_t Node, uint32_t Base, uint16_t Word, const Fault_t *Slip)
+{
+    uint16_t out[2];
+    uint16_t n = Faults_Shift(Node, Word, Slip, out);
+    uint16_t i;
+
+    for (i = 0; i < n; i++) {
+        nodes[Node].Api->SpiWordIn(Base, out[i], toLocal(&nodes[Node], now));
+    }
+}
+
+// Faults on the link into a node: wire.Out[k] goes to worker k, wire.Out[N] to the Director
+static void faultLink(const Fault_t *Fault, const Fault_t **Slip)
+{
+    uint16_t *word = &wire.Out[Fault->Node ? Fault->Node - 1U : NUM_WORKERS];
+
+    switch (Fault->Kind) {
+    case FAULT_FLIP:
+        *word ^= (uint16_t)(1U << (Fault->Arg % 16U));
+        break;
+    case FAULT_GARBLE:
+        *word ^= (uint16_t)Fault->Arg;
+        break;
+    case FAULT_DROP:
+    case FAULT_DUP:
+        if (Slip[Fault->Node] == NULL) Slip[Fault->Node] = Fault;
+        break;
+    default:
+        break;
+    }
+}
+
+// Faults on a node, once the word is shifted in
+static void faultNode(const Fault_t *Fault)
+{
+    Node_t *node = &nodes[Fault->Node];
+
+    if (Fault->Kind == FAULT_GLITCH) {
+        node->Glitch = true;
+        node->GlitchEnd = now + (uint64_t)Fault->Arg * wire.BitTicks;
+        csApply(Fault->Node - 1U);
+    } else if (Fault->Kind == FAULT_OVERRUN) {
+        node->Api->StallDma(toLocal(node, now + (uint64_t)Fault->Arg * wire.WordTicks), toLocal(node, now));
+        if (Fault->Node == 0) wireAfterDirector();
+    }
+}
+
+static void wordStart(void)
+{
+    uint16_t k;
+
+    wire.Out[0] = director()->Api->SpiWordOut(SPIA_BASE, toLocal(director(), now));
+    for (k = 0; k < NUM_WORKERS; k++) {
+        // Off the ring, the line stays high
+        wire.Out[1 + k] = worker(k)->Dropout ? 0xFFFFU
+                                             : worker(k)->Api->SpiWordOut(SPIA_BASE, toLocal(worker(k), now));
+    }
+    wire.Words++;
+    wire.State = WIRE_WORD_END;
+    wire.Next = now + wire.WordTicks;
+}
+
+static void wordEnd(void)
+{
+    Fault_t due[FAULTS_MAX_DUE];
+    const Fault_t *slip[MAX_NODES] = { NULL };
+    uint16_t n = 0;
+    uint16_t i, k;
+
+    if (measuring && faults) {
+        n = Faults_Due(frames - warmup, (int32_t)wire.Words - 1, due);
+        for (i = 0; i < n; i++) {
+            faultLink(&due[i], slip);
+            faultTaken();
+        }
+    }
+    for (k = 0; k < NUM_WORKERS; k++) {
+        if (!worker(k)->Dropout) linkDeliver(1 + k, SPIA_BASE, wire.Out[k], slip[1 + k]);
+    }
+    linkDeliver(0, SPIB_BASE, wire.Out[NUM_WORKERS], slip[0]);
+    wireAfterDirector();
+    for (i = 0; i < n; i++) {
+        faultNode(&due[i]);
+    }
+
+    if (director()->Api->SpiTxReady(SPIA_BASE)) {
+        // The Director relaunched before the end of the frame: its frame period is shorter than the frame
+        if (wire.Words >= RUNAWAY_FRAMES * RING_CLOCKED_WORDS) {
+            fprintf(stderr, "ringsim: frame %llu still clocked after %u words, the Director frame period is "
+                    "shorter than the frame\n", (unsigned long long)frames, wire.Words);
+            exit(1);
+        }
+        wordStart();
+        return;
+    }
+    wire.Rise = now + wire.BitTicks / 2;
+    wire.State = WIRE_CS_RISE;
+    wire.Index = 0;
+    wire.Next = wire.Rise + CS_HOP_TICKS;
+}
+
+static void wireStep(void)
+{
+    switch (wire.State) {
+    case WIRE_LAUNCH:
+        frameStart();
+        wire.Fall = now;
+        wire.Words = 0;
+        wire.State = WIRE_CS_FALL;
+        wire.Index = 0;
+        wire.Next = now + CS_HOP_TICKS;
+        break;
+
+    case WIRE_CS_FALL:
+        worker(wire.Index)->WireCsLow = true;
+        csApply(wire.Index);
+        if (++wire.Index < NUM_WORKERS) {
+            wire.Next = wire.Fall + CS_HOP_TICKS * (wire.Index + 1U);
+        } else {
+            wire.State = WIRE_WORD_START;
+            wire.Next = now + CS_SETUP_TICKS;
+        }
+        break;
+
+    case WIRE_WORD_START:
+        wordStart();
+        break;
+
+    case WIRE_WORD_END:
+        wordEnd();
+        break;
+
+    case WIRE_CS_RISE:
+        worker(wire.Index)->WireCsLow = false;
+        csApply(wire.Index);
+        if (++wire.Index < NUM_WORKERS) {
+            wire.Next = wire.Rise + CS_HOP_TICKS * (wire.Index + 1U);
+            break;
+        }
+        if (measuring) {
+            spreadAdd(&csLow, wire.Rise - wire.Fall);
+            spreadAdd(&wordsPerFrame, wire.Words);
+        }
+        Faults_Resync(0);
+        frames++;
+        wire.State = WIRE_IDLE;
+        wireLaunchCheck();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* Report */
+
+static uint64_t cpu1Checked(void)
+{
+    uint64_t checked = 0;
+    uint16_t i;
+
+    for (i = 0; i < numNodes; i++) {
+        checked += nodes[i].Api->Cpu1->Checked - nodes[i].Cpu1Base.Checked;
+    }
+    return checked;
+}
+
+static uint64_t cpu1Mismatches(void)
+{
+    uint64_t mismatches = 0;
+    uint16_t i;
+
+    for (i = 0; i < numNodes; i++) {
+        mismatches += nodes[i].Api->Cpu1->Mismatches - nodes[i].Cpu1Base.Mismatches;
+    }
+    return mismatches;
+}
+
+// Chunks found bad out of those that were
+static double detectionRate(void)
+{
+    uint64_t bad = faultStats.CrcErrors + faultStats.Mismatches;
+
+    return bad ? (double)faultStats.CrcErrors / bad : 1.0;
+}
+
+static void reportFaultsText(void)
+{
+    const FaultStats_t *f = &faultStats;
+    uint64_t checked = cpu1Checked();
+    int k;
+
+    printf("\nfaults (seed %llu):", (unsigned long long)faultSeed);
+    for (k = 0; k < FAULT_KINDS; k++) {
+        printf(" %s %llu", Faults_Name((FaultKind_t)k), (unsigned long long)FaultsInjected[k]);
+    }
+    printf("\nframes hit:     %llu, detected %llu, undetected %llu, masked %llu\n", (unsigned long long)f->Faulted,
+           (unsigned long long)f->Detected, (unsigned long long)f->Undetected, (unsigned long long)f->Masked);
+    printf("found:          %llu chunks failing their CRC, %llu other errors, %llu frames with errors and no fault\n",
+           (unsigned long long)f->CrcErrors, (unsigned long long)f->Errors, (unsigned long long)f->Spurious);
+    printf("undetected:     %llu payloads wrong after their CRC passed, of %llu checked (%.3g per payload)\n",
+           (unsigned long long)f->Mismatches, (unsigned long long)checked,
+           checked ? (double)f->Mismatches / checked : 0.0);
+    printf("detection rate: %.6f of the bad chunks failed their CRC\n", detectionRate());
+    printf("recovery:       %llu times, avg %.1f us (%.2f frames), max %.1f us (%llu frames), %llu not recovered\n",
+           (unsigned long long)f->Recovery.Count, spreadAvg(&f->Recovery) / 200.0, spreadAvg(&f->RecoveryFrames),
+           f->Recovery.Max / 200.0, (unsigned long long)f->RecoveryFrames.Max, (unsigned long long)f->Unrecovered);
+}
+
+static void reportFaultsJson(void)
+{
+    const FaultStats_t *f = &faultStats;
+    uint64_t checked = cpu1Checked();
+    int k;
+
+    printf(" \"faults\": {\"seed\": %llu, \"injected\": {", (unsigned long long)faultSeed);
+    for (k = 0; k < FAULT_KINDS; k++) {
+        printf("%s\"%s\": %llu", k ? ", " : "", Faults_Name((FaultKind_t)k), (unsigned long long)FaultsInjected[k]);
+    }
+    printf("},\n  \"frames_hit\": %llu, \"detected\": %llu, \"undetected\": %llu, \"masked\": %llu, "
+           "\"spurious\": %llu,\n", (unsigned long long)f->Faulted, (unsigned long long)f->Detected,
+           (unsigned long long)f->Undetected, (unsigned long long)f->Masked, (unsigned long long)f->Spurious);
+    printf("  \"crc_errors\": %llu, \"errors\": %llu, \"mismatches\": %llu, \"checked\": %llu, "
+           "\"detection_rate\": %.6f, \"undetected_rate\": %.6g,\n", (unsigned long long)f->CrcErrors,
+           (unsigned long long)f->Errors, (unsigned long long)f->Mismatches, (unsigned long long)checked,
+           detectionRate(), checked ? (double)f->Mismatches / checked : 0.0);
+    printf("  \"recovery_ticks\": {\"count\": %llu, \"avg\": %.1f, \"max\": %llu}, "
+           "\"recovery_frames\": {\"avg\": %.2f, \"max\": %llu}, \"unrecovered\": %llu},\n",
+           (unsigned long long)f->Recovery.Count, spreadAvg(&f->Recovery), (unsigned long long)f->Recovery.Max,
+           spreadAvg(&f->RecoveryFrames), (unsigned long long)f->RecoveryFrames.Max,
+           (unsigned long long)f->Unrecovered);
+}
+
+static void reportUpdateText(void)
+{
+    uint16_t i;
+
+    printf("\nupdate: %lu words, image CRC 0x%04X, ", (unsigned long)updateWords, crcFast(updateImage, (int)updateWords));
+    if (updateEnd) {
+        printf("ended at frame %llu", (unsigned long long)updateEnd);
+    } else {
+        printf("not ended");
+    }
+    printf(", %lu bulk frames, %lu segments sent for %u\n", (unsigned long)fwSender->BulkFrames,
+           (unsigned long)fwSender->SegmentsSent, fwSender->Segments);
+
+    printf("%-22s", "staging area");
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12s", worker(i)->Name);
+    printf("\n%-22s", "Written at frame");
+    for (i = 0; i < NUM_WORKERS; i++) {
+        if (worker(i)->UpdateDone) {
+            printf("%12llu", (unsigned long long)worker(i)->UpdateDone);
+        } else {
+            printf("%12s", "-");
+        }
+    }
+    printf("\n%-22s", "CRC");
+    for (i = 0; i < NUM_WORKERS; i++) printf("      0x%04X", updateCrc(i));
+#define RECEIVER(field)                                                                                     \
+    printf("\n%-22s", #field);                                                                              \
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12lu", (unsigned long)worker(i)->Receiver->field);
+    RECEIVER(Blocks)
+    RECEIVER(Evicted)
+    RECEIVER(CrcErrors)
+    RECEIVER(FlashErrors)
+#undef RECEIVER
+    printf("\n");
+}
+
+static void reportHaltText(void)
+{
+    const CommsWatchdog_t *wd = worker(0)->Watchdog;
+    double p = spreadAvg(&period);
+    uint16_t i;
+
+    printf("\nhalt: Director stopped after frame %llu, watchdog %u frames then %s for %u periods, "
+           "times from the last CS falling edge, ms\n", (unsigned long long)haltAfter, wd->Frames,
+           policyName(wd->Policy), wd->PolicyFrames);
+    printf("%-22s", "watchdog");
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12s", worker(i)->Name);
+#define HALT_TIME(name, field)                                                                              \
+    printf("\n%-22s", name);                                                                                \
+    for (i = 0; i < NUM_WORKERS; i++) {                                                                     \
+        if (worker(i)->field) {                                                                             \
+            printf("%12.3f", (worker(i)->field - haltFall) / 200000.0);                                     \
+        } else {                                                                                            \
+            printf("%12s", "-");                                                                            \
+        }                                                                                                   \
+    }
+    HALT_TIME("Fail-safe path", FailSafeAt)
+    HALT_TIME("Safe state", SafeAt)
+#undef HALT_TIME
+    printf("\n%-22s", "Bound");
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12.3f", haltBound(i) / 200000.0);
+    printf("\n%-22s", "Safe state, periods");
+    for (i = 0; i < NUM_WORKERS; i++) {
+        printf("%12.2f", worker(i)->SafeAt && p > 0 ? (worker(i)->SafeAt - haltFall) / p : 0.0);
+    }
+    printf("\n%-22s", "Reaction (us)");
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12.1f", worker(i)->Watchdog->Reaction / 200.0);
+    printf("\n");
+}
+
+#if MAILBOX_WORDS > 0
+static void reportMailboxText(void)
+{
+    uint16_t i;
+
+    printf("\n%-22s", "mailbox");
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12s", worker(i)->Name);
+    printf("\n%-22s", "Echo requests");
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12lu", (unsigned long)(mailboxes[i].Sent - worker(i)->EchoBase));
+#define MAILBOX_FIELD(name, field)                                                                          \
+    printf("\n%-22s", name);                                                                                \
+    for (i = 0; i < NUM_WORKERS; i++) printf("%12llu", (unsigned long long)worker(i)->field);
+    MAILBOX_FIELD("Echo replies", EchoReplies)
+    MAILBOX_FIELD("Stats reports", Reports)
+    MAILBOX_FIELD("Report lag max", ReportAgeMax)
+    MAILBOX_FIELD("Report stale", StaleFrames)
+    MAILBOX_FIELD("Report ahead", AheadFrames)
+#undef MAILBOX_FIELD
+    printf("\n");
+}
+#endif
+
+static void reportText(double Wall)
+{
+    double seconds = (double)(now - measureStart) / SIM_SYSCLK_FREQ;
+    uint64_t n = frames > warmup ? frames - warmup : 0;
+    uint16_t i, f, v;
+
+    printf("ring: %u workers, %u words clocked per frame, %u ticks per word\n", NUM_WORKERS, RING_CLOCKED_WORDS,
+           wire.WordTicks);
+    printf("frames: %llu measured after %llu warm-up, %.3f s simulated, %.3f s wall, %.0f frames/s wall\n",
+           (unsigned long long)n, (unsigned long long)warmup, seconds, Wall, Wall > 0 ? frames / Wall : 0.0);
+    printf("frame period:  avg %.1f us  min %.1f  max %.1f\n", spreadAvg(&period) / 200.0, period.Min / 200.0,
+           period.Max / 200.0);
+    printf("CS low:        avg %.1f us  min %.1f  max %.1f  (%.1f words avg)\n", spreadAvg(&csLow) / 200.0,
+           csLow.Min / 200.0, csLow.Max / 200.0, spreadAvg(&wordsPerFrame));
+    printf("launch to RX:  avg %.1f us  min %.1f  max %.1f  (%llu Director RX interrupts)\n",
+           spreadAvg(&rxLatency) / 200.0, rxLatency.Min / 200.0, rxLatency.Max / 200.0,
+           (unsigned long long)rxLatency.Count);
+    printf("sync error max %d ticks, phase error max %d TBCLK\n", syncErrorMax, phaseErrorMax);
+
+    printf("\n%-22s", "link stats");
+    for (i = 0; i < numNodes; i++) printf("%12s", nodes[i].Name);
+    printf("\n");
+    for (f = 0; f < numStatFields; f++) {
+        printf("%-22s", statFields[f].Name);
+        for (i = 0; i < numNodes; i++) printf("%12llu", (unsigned long long)nodes[i].Totals[f]);
+        printf("\n");
+    }
+
+    printf("\n%-22s", "per frame");
+    for (i = 0; i < numNodes; i++) printf("%12s", nodes[i].Name);
+    printf("\n");
+#define COUNTER(field)                                                                                      \
+    printf("%-22s", #field);                                                                                \
+    for (i = 0; i < numNodes; i++) {                                                                        \
+        printf("%12.2f", n ? (double)(nodes[i].Api->Counters->field - nodes[i].Base.field) / n : 0.0);      \
+    }                                                                                                       \
+    printf("\n");
+    COUNTER(Interrupts)
+    COUNTER(Events)
+    COUNTER(DmaBursts)
+    COUNTER(DmaWords)
+    COUNTER(CrcCalls)
+    COUNTER(CrcWords)
+    COUNTER(WordsIn)
+    COUNTER(RxOverflows)
+#undef COUNTER
+    for (v = 0; v < sizeof(vectorNames) / sizeof(vectorNames[0]); v++) {
+        printf("ISR %-18s", vectorNames[v].Name);
+        for (i = 0; i < numNodes; i++) {
+            const SimVector_t *vec = nodes[i].Api->Vector(vectorNames[v].Id);
+            if (vec == NULL) {
+                printf("%12s", "-");
+            } else {
+                printf("%12.2f", n ? (double)vec->Taken / frames : 0.0);
+            }
+        }
+        printf("\n");
+    }
+
+    printf("\n%-22s", "CPU1");
+    for (i = 0; i < numNodes; i++) printf("%12s", nodes[i].Name);
+    printf("\n%-22s", "Images");
+    for (i = 0; i < numNodes; i++) {
+        printf("%12llu", (unsigned long long)(nodes[i].Api->Cpu1->Images - nodes[i].Cpu1Base.Images));
+    }
+    printf("\n%-22s", "Checked");
+    for (i = 0; i < numNodes; i++) {
+        printf("%12llu", (unsigned long long)(nodes[i].Api->Cpu1->Checked - nodes[i].Cpu1Base.Checked));
+    }
+    printf("\n%-22s", "Mismatches");
+    for (i = 0; i < numNodes; i++) {
+        printf("%12llu", (unsigned long long)(nodes[i].Api->Cpu1->Mismatches - nodes[i].Cpu1Base.Mismatches));
+    }
+    printf("\n");
+#if MAILBOX_WORDS > 0
+    reportMailboxText();
+#endif
+    if (updateWords) reportUpdateText();
+    if (halted) reportHaltText();
+    if (faults) reportFaultsText();
+}
+
+static void reportJson(double Wall)
+{
+    uint64_t n = frames > warmup ? frames - warmup : 0;
+    uint16_t i, f, v;
+
+    printf("{\"workers\": %u, \"clocked_words\": %u, \"word_ticks\": %u, \"frames\": %llu, \"warmup\": %llu, "
+           "\"sim_seconds\": %.6f, \"wall_seconds\": %.6f,\n", NUM_WORKERS, RING_CLOCKED_WORDS, wire.WordTicks,
+           (unsigned long long)n, (unsigned long long)warmup, (double)(now - measureStart) / SIM_SYSCLK_FREQ, Wall);
+#define SPREAD(name, s)                                                                                     \
+    printf(" \"%s\": {\"avg\": %.1f, \"min\": %llu, \"max\": %llu},\n", name, spreadAvg(&s),                \
+           (unsigned long long)s.Min, (unsigned long long)s.Max);
+    SPREAD("period_ticks", period)
+    SPREAD("cs_low_ticks", csLow)
+    SPREAD("words_per_frame", wordsPerFrame)
+    SPREAD("rx_latency_ticks", rxLatency)
+#undef SPREAD
+    printf(" \"sync_error_max\": %d, \"phase_error_max\": %d,\n", syncErrorMax, phaseErrorMax);
+    if (faults) reportFaultsJson();
+    if (updateWords) {
+        printf(" \"update\": {\"words\": %lu, \"crc\": %u, \"end\": %llu, \"bulk_frames\": %lu, "
+               "\"segments_sent\": %lu, \"workers\": [", (unsigned long)updateWords,
+               crcFast(updateImage, (int)updateWords), (unsigned long long)updateEnd,
+               (unsigned long)fwSender->BulkFrames, (unsigned long)fwSender->SegmentsSent);
+        for (i = 0; i < NUM_WORKERS; i++) {
+            const FwReceiver_t *r = worker(i)->Receiver;
+            printf("%s{\"done\": %llu, \"crc\": %u, \"blocks\": %lu, \"evicted\": %lu, \"crc_errors\": %lu, "
+                   "\"flash_errors\": %lu}", i ? ", " : "", (unsigned long long)worker(i)->UpdateDone, updateCrc(i),
+                   (unsigned long)r->Blocks, (unsigned long)r->Evicted, (unsigned long)r->CrcErrors,
+                   (unsigned long)r->FlashErrors);
+        }
+        printf("]},\n");
+    }
+#if MAILBOX_WORDS > 0
+    printf(" \"mailbox\": [");
+    for (i = 0; i < NUM_WORKERS; i++) {
+        const Node_t *w = worker(i);
+        printf("%s{\"echo_requests\": %lu, \"echo_replies\": %llu, \"reports\": %llu, \"report_lag_max\": %u, "
+               "\"report_stale\": %llu, \"report_ahead\": %llu}", i ? ", " : "",
+               (unsigned long)(mailboxes[i].Sent - w->EchoBase), (unsigned long long)w->EchoReplies,
+               (unsigned long long)w->Reports, w->ReportAgeMax, (unsigned long long)w->StaleFrames,
+               (unsigned long long)w->AheadFrames);
+    }
+    printf("],\n");
+#endif
+    if (halted) {
+        printf(" \"halt\": {\"after\": %llu, \"workers\": [", (unsigned long long)haltAfter);
+        for (i = 0; i < NUM_WORKERS; i++) {
+            const Node_t *w = worker(i);
+            printf("%s{\"fail_safe_ticks\": %llu, \"safe_ticks\": %llu, \"bound_ticks\": %llu, \"reaction_ticks\": %lu}",
+                   i ? ", " : "", (unsigned long long)(w->FailSafeAt ? w->FailSafeAt - haltFall : 0),
+                   (unsigned long long)(w->SafeAt ? w->SafeAt - haltFall : 0), (unsigned long long)haltBound(i),
+                   (unsigned long)w->Watchdog->Reaction);
+        }
+        printf("]},\n");
+    }
+    printf(" \"nodes\": [\n");
+    for (i = 0; i < numNodes; i++) {
+        const SimCounters_t *c = nodes[i].Api->Counters;
+        const SimCpu1_t *cpu1 = nodes[i].Api->Cpu1;
+
+        printf("  {\"name\": \"%s\", \"link_stats\": {", nodes[i].Name);
+        for (f = 0; f < numStatFields; f++) {
+            printf("%s\"%s\": %llu", f ? ", " : "", statFields[f].Name, (unsigned long long)nodes[i].Totals[f]);
+        }
+        printf("},\n   \"counters\": {\"Interrupts\": %llu, \"Events\": %llu, \"DmaBursts\": %llu, \"DmaWords\": %llu, "
+               "\"CrcCalls\": %llu, \"CrcWords\": %llu, \"WordsIn\": %llu, \"RxOverflows\": %llu},\n",
+               (unsigned long long)(c->Interrupts - nodes[i].Base.Interrupts),
+               (unsigned long long)(c->Events - nodes[i].Base.Events),
+               (unsigned long long)(c->DmaBursts - nodes[i].Base.DmaBursts),
+               (unsigned long long)(c->DmaWords - nodes[i].Base.DmaWords),
+               (unsigned long long)(c->CrcCalls - nodes[i].Base.CrcCalls),
+               (unsigned long long)(c->CrcWords - nodes[i].Base.CrcWords),
+               (unsigned long long)(c->WordsIn - nodes[i].Base.WordsIn),
+               (unsigned long long)(c->RxOverflows - nodes[i].Base.RxOverflows));
+        printf("   \"isr\": {");
+        for (v = 0, f = 0; v < sizeof(vectorNames) / sizeof(vectorNames[0]); v++) {
+            const SimVector_t *vec = nodes[i].Api->Vector(vectorNames[v].Id);
+            if (vec == NULL) continue;
+            printf("%s\"%s\": %llu", f++ ? ", " : "", vectorNames[v].Name, (unsigned long long)vec->Taken);
+        }
+        printf("},\n   \"cpu1\": {\"Images\": %llu, \"Checked\": %llu, \"Mismatches\": %llu}}%s\n",
+               (unsigned long long)(cpu1->Images - nodes[i].Cpu1Base.Images),
+               (unsigned long long)(cpu1->Checked - nodes[i].Cpu1Base.Checked),
+               (unsigned long long)(cpu1->Mismatches - nodes[i].Cpu1Base.Mismatches), i + 1 < numNodes ? "," : "");
+    }
+    printf(" ]\n}\n");
+}
+
+// What --check asserts on the run, failures are reported on stderr
+static bool check(void)
+{
+    bool ok = true;
+    uint16_t i;
+    uint64_t wrong = cpu1Mismatches();
+
+    if (wrong > 0) {
+        fprintf(stderr, "ringsim: check: %llu payloads passed their CRC wrong\n", (unsigned long long)wrong);
+        ok = false;
+    }
+    if (maxSync >= 0 && syncErrorMax > maxSync) {
+        fprintf(stderr, "ringsim: check: cluster time error %d ticks, over %d\n", syncErrorMax, (int)maxSync);
+        ok = false;
+    }
+    if (maxPhase >= 0 && phaseErrorMax > maxPhase) {
+        fprintf(stderr, "ringsim: check: carrier phase error %d TBCLK, over %d\n", phaseErrorMax, (int)maxPhase);
+        ok = false;
+    }
+    if (updateWords && updateEnd == 0) {
+        fprintf(stderr, "ringsim: check: the update did not end\n");
+        ok = false;
+    }
+    if (haltAfter && !halted) {
+        fprintf(stderr, "ringsim: check: the Director was not halted, --frames ends first\n");
+        ok = false;
+    }
+    for (i = 0; halted && i < NUM_WORKERS; i++) {
+        if (!haltSafe(i)) {
+            fprintf(stderr, "ringsim: check: %s not in its safe state %.1f ms after the last frame\n",
+                    worker(i)->Name, haltBound(i) / 200000.0);
+            ok = false;
+        }
+    }
+#if MAILBOX_WORDS > 0
+    for (i = 0; i < NUM_WORKERS; i++) {
+        const Node_t *w = worker(i);
+        uint32_t requests = mailboxes[i].Sent - w->EchoBase;
+
+        // A request acknowledged in the warm-up may be answered after it
+        if (requests == 0 || w->EchoReplies + 1U < requests) {
+            fprintf(stderr, "ringsim: check: %s answered %llu of %lu echo requests\n", w->Name,
+                    (unsigned long long)w->EchoReplies, (unsigned long)requests);
+            ok = false;
+        }
+        if (w->Reports == 0 || w->StaleFrames > 0 || w->AheadFrames > 0) {
+            fprintf(stderr, "ringsim: check: %s link statistics: %llu reports, %llu frames over %u frames old, "
+                    "%llu frames ahead of the worker\n", w->Name, (unsigned long long)w->Reports,
+                    (unsigned long long)w->StaleFrames, REPORT_LAG_FRAMES, (unsigned long long)w->AheadFrames);
+            ok = false;
+        }
+    }
+#endif
+    for (i = 0; updateWords && i < NUM_WORKERS; i++) {
+        if (updateCrc(i) != crcFast(updateImage, (int)updateWords)) {
+            fprintf(stderr, "ringsim: check: %s staging area CRC 0x%04X, image 0x%04X\n", worker(i)->Name,
+                    updateCrc(i), crcFast(updateImage, (int)updateWords));
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ringsim [--dir DIR] [--frames N] [--warmup N] [--time SECONDS] [--seed N] [--drift PPM | --skew PPM]\n"
+            "               [--json] [--check] [--max-sync TICKS] [--max-phase TBCLK]\n"
+            "               [--update WORDS] [--halt-director N]\n"
+            "               [--fault KIND=RATE]... [--faults SCRIPT] [--fault-seed N]\n"
+            "  --dir         directory of director.so and worker<k>.so (.)\n"
+            "  --frames      frames to run after the warm-up (%u)\n"
+            "  --warmup      frames run before the statistics start, and CPU1 checks its payloads (%u)\n"
+            "  --time        simulated time limit, in seconds\n"
+            "  --seed        seed of the clock offsets and errors of the workers\n"
+            "  --drift       largest worker clock error, in ppm (0)\n"
+            "  --skew        worker clocks this many ppm fast and slow in turn, the worst case of --drift\n"
+            "  --json        report as JSON\n"
+            "  --check       exit status 1 if a payload passed its CRC wrong, a bound below is exceeded, the\n"
+            "                update did not end with every worker holding the image, a worker was not safe in\n"
+            "                time after the halt, or a worker mailbox fell behind (echo, link statistics)\n"
+            "  --max-sync    largest cluster time error of a worker after the warm-up, in ticks\n"
+            "  --max-phase   largest carrier phase error of a worker after the warm-up, in TBCLK\n"
+            "  --update      firmware image of this many random words distributed from the end of the warm-up\n"
+            "  --halt-director\n"
+            "                stop the Director N frames after the warm-up, run until the workers are safe\n"
+            "  --fault       rate of a fault after the warm-up, per word and node, per frame and worker for dropout:\n"
+            "                flip, garble, drop, dup (SCLK edges), glitch (CS), overrun (DMA), dropout\n"
+            "  --faults      scripted faults, lines of FRAME KIND NODE [WORD [ARG]], see Faults.h\n"
+            "  --fault-seed  seed of the faults (--seed)\n", DEFAULT_FRAMES, DEFAULT_WARMUP);
+    exit(2);
+}
+
+static void faultRate(const char *Spec)
+{
+    if (!Faults_SetRate(Spec)) usage();
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main(int argc, char **argv)
+{
+    const char *dir = ".";
+    uint64_t target = DEFAULT_FRAMES;
+    double limit = 0;
+    uint64_t seed = 1;
+    const char *script = NULL;
+    const char *faultSeedArg = NULL;
+    double drift = 0;
+    double skew = 0;
+    bool json = false;
+    bool checking = false;
+    struct timespec t0, t1;
+    uint64_t end = SIM_TIME_NEVER;
+    uint16_t i;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        const char *arg = argv[a];
+        const char *val = (a + 1 < argc) ? argv[a + 1] : NULL;
+        if (!strcmp(arg, "--json")) {
+            json = true;
+            continue;
+        }
+        if (!strcmp(arg, "--check")) {
+            checking = true;
+            continue;
+        }
+        if (val == NULL) usage();
+        if (!strcmp(arg, "--dir")) dir = val;
+        else if (!strcmp(arg, "--frames")) target = strtoull(val, NULL, 0);
+        else if (!strcmp(arg, "--warmup")) warmup = strtoull(val, NULL, 0);
+        else if (!strcmp(arg, "--time")) limit = atof(val);
+        else if (!strcmp(arg, "--seed")) seed = strtoull(val, NULL, 0);
+        else if (!strcmp(arg, "--drift")) drift = atof(val);
+        else if (!strcmp(arg, "--skew")) skew = atof(val);
+        else if (!strcmp(arg, "--max-phase")) maxPhase = atoi(val);
+        else if (!strcmp(arg, "--max-sync")) maxSync = atoi(val);
+        else if (!strcmp(arg, "--update")) updateWords = (uint32_t)strtoul(val, NULL, 0);
+        else if (!strcmp(arg, "--halt-director")) haltAfter = strtoull(val, NULL, 0);
+        else if (!strcmp(arg, "--fault")) faultRate(val);
+        else if (!strcmp(arg, "--faults")) script = val;
+        else if (!strcmp(arg, "--fault-seed")) faultSeedArg = val;
+        else usage();
+        a++;
+    }
+    rng ^= seed * 0xBF58476D1CE4E5B9ULL;
+    faultSeed = faultSeedArg ? strtoull(faultSeedArg, NULL, 0) : seed;
+    Faults_Init(NUM_WORKERS + 1, faultSeed);
+    if (script != NULL && !Faults_LoadScript(script)) return 2;
+    faults = Faults_Enabled();
+    if (limit > 0) end = (uint64_t)(limit * SIM_SYSCLK_FREQ);
+    if (updateWords > (uint32_t)FW_MAX_SEGMENTS * FW_SEGMENT_WORDS) usage();
+    updateImage = calloc(updateWords + 1U, sizeof(uint16_t));
+    crcInit();
+
+    statFieldsInit();
+    nodeLoad(&nodes[numNodes++], dir, "director.so", "director");
+    for (i = 0; i < NUM_WORKERS; i++) {
+        char file[32], name[16];
+        snprintf(file, sizeof(file), "worker%u.so", i);
+        snprintf(name, sizeof(name), "worker%u", i);
+        nodeLoad(&nodes[numNodes], dir, file, name);
+        nodes[numNodes].Offset = (int64_t)(random64() % 1000000000ULL);
+        nodes[numNodes].Ppb = (int64_t)(((double)(random64() % 2001U) - 1000.0) * drift);
+        if (skew != 0) nodes[numNodes].Ppb = (int64_t)((i & 1U ? -1000.0 : 1000.0) * skew);
+        nodes[numNodes].Receiver = dlsym(nodes[numNodes].Handle, "fwReceiver");
+        nodes[numNodes].Flash = dlsym(nodes[numNodes].Handle, "SimFlash");
+        if (updateWords && (nodes[numNodes].Receiver == NULL || nodes[numNodes].Flash == NULL)) {
+            fprintf(stderr, "ringsim: %s has no firmware update receiver\n", file);
+            return 1;
+        }
+        nodes[numNodes].Watchdog = dlsym(nodes[numNodes].Handle, "watchdog");
+        if (haltAfter && nodes[numNodes].Watchdog == NULL) {
+            fprintf(stderr, "ringsim: %s has no watchdog\n", file);
+            return 1;
+        }
+        numNodes++;
+    }
+    syncError = dlsym(director()->Handle, "syncError");
+    phaseError = dlsym(director()->Handle, "phaseError");
+    if (updateWords) {
+        fwSender = directorSymbol("fwSender");
+        fwStart = directorSymbol("fwStart");
+    }
+#if MAILBOX_WORDS > 0
+    mailboxes = directorSymbol("mailboxes");
+    mailboxInbox = directorSymbol("mailboxInbox");
+    workerLinkStats = directorSymbol("workerLinkStats");
+#endif
+
+    // Workers first, they wait for the Director clocking
+    for (i = 1; i < numNodes; i++) {
+        nodes[i].Api->Boot(toLocal(&nodes[i], 0));
+    }
+    director()->Api->Boot(0);
+    if (director()->Api->SpiBitRate(SPIA_BASE) == 0) {
+        fprintf(stderr, "ringsim: the Director did not set up its SPI clock\n");
+        return 1;
+    }
+    wire.BitTicks = (uint32_t)(SIM_SYSCLK_FREQ / director()->Api->SpiBitRate(SPIA_BASE));
+    wire.WordTicks = 16U * wire.BitTicks;
+    wireAfterDirector();
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    while (frames < warmup + target) {
+        uint64_t next = (wire.State != WIRE_IDLE) ? wire.Next : SIM_TIME_NEVER;
+        int16_t who = -1;
+        int16_t glitch = -1;
+
+        for (i = halted ? 1 : 0; i < numNodes; i++) {
+            uint64_t t = toGlobal(&nodes[i], nodes[i].Api->NextEvent());
+            // A node goes before the wire at the same time
+            if (t < next || (t == next && who < 0)) {
+                next = t;
+                who = (int16_t)i;
+            }
+        }
+        // The end of a CS glitch goes first
+        for (i = 0; i < NUM_WORKERS; i++) {
+            if (worker(i)->Glitch && worker(i)->GlitchEnd <= next) {
+                next = worker(i)->GlitchEnd;
+                glitch = (int16_t)i;
+            }
+        }
+        if (next == SIM_TIME_NEVER) {
+            fprintf(stderr, "ringsim: nothing left to run\n");
+            break;
+        }
+        if (next > end) break;
+        if (next > now) now = next;
+
+        if (glitch >= 0) {
+            worker(glitch)->Glitch = false;
+            csApply(glitch);
+        } else if (who < 0) {
+            wireStep();
+        } else {
+            nodes[who].Api->Advance(toLocal(&nodes[who], now));
+            if (who == 0) wireAfterDirector();
+        }
+
+        // The Director stops between two frames, before it launches the next one
+        if (!halted && haltAfter && frames >= warmup + haltAfter && wire.State == WIRE_IDLE) {
+            halted = true;
+            haltFall = lastFall;
+        }
+        if (halted && haltFollow()) break;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    frameEnd();
+    if (faults && disturbed) faultStats.Unrecovered++;
+    if (json) {
+        reportJson((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    } else {
+        reportText((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    }
+    if (checking && !check()) return 1;
+    return 0;
+}
+
+/*** end of file ***/
@@ -0,0 +1,228 @@
+/**
+ ********************************************************************************
+ * @file    snapstress.c
+ * @brief   Host stress test of the ring image snapshots (ring/Snapshot.c).
+ *
+ *          One writer thread plays CPU2: it rewrites a block of the size of the
+ *          ring image between Snapshot_WriteBegin() and Snapshot_WriteEnd(),
+ *          then holds it for --hold loops, as the image stays between frames,
+ *          over and over. Without the hold a reader on a single CPU would only
+ *          ever find a write in progress. Reader threads play CPU1 and copy it with
+ *          Snapshot_Copy(). Every write fills the block from one sequence
+ *          number, kept in its first two words, so a copy that mixes two writes
+ *          is found: a torn read. A reader also checks that the sequence numbers
+ *          it gets never go back.
+ *
+ *          Snapshot.h is built with SNAPSHOT_FENCE() a full fence (Makefile),
+ *          as on any host. The readers also copy the block without the version
+ *          now and then: what they find torn that way shows the test sees the
+ *          writes overlap, it is reported but is no error.
+ *
+ *          The exit status is 1 if a snapshot copy was torn or went back, or if
+ *          no copy ever succeeded.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "Snapshot.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define BLOCK_WORDS         RING_CLOCKED_WORDS
+#define MAX_READERS         8U
+#define DEFAULT_SECONDS     2.0
+#define DEFAULT_READERS     2U
+#define DEFAULT_HOLD        2000U
+#define UNGUARDED_EVERY     64U     /*!< Copies without the version, one in this many */
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+    pthread_t Thread;
+    uint64_t Attempts;          /*!< Snapshot_Copy() calls */
+    uint64_t Copies;            /*!< that succeeded */
+    uint64_t Torn;              /*!< of those, mixing two writes */
+    uint64_t Back;              /*!< of those, older than the one before */
+    uint64_t Unguarded;         /*!< Copies without the version */
+    uint64_t UnguardedTorn;
+} Reader_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static SnapshotVersion_t version;
+static volatile uint16_t block[BLOCK_WORDS];
+static volatile int running = 1;
+static uint32_t hold = DEFAULT_HOLD;
+static uint64_t writes;
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+
+// Word i of the block written with sequence number Sequence
+static uint16_t blockWord(uint32_t Sequence, uint16_t i)
+{
+    uint32_t x = Sequence * 0x9E3779B1UL ^ ((uint32_t)i << 16) ^ i;
+
+    x ^= x >> 15;
+    x *= 0x2C1B3C6DUL;
+    x ^= x >> 12;
+    return (uint16_t)x;
+}
+
+// Sequence number of a copy, or false if its words come from more than one write
+static bool blockCheck(const uint16_t *Copy, uint32_t *Sequence)
+{
+    uint16_t i;
+
+    *Sequence = Copy[0] | ((uint32_t)Copy[1] << 16);
+    for (i = 2; i < BLOCK_WORDS; i++) {
+        if (Copy[i] != blockWord(*Sequence, i)) return false;
+    }
+    return true;
+}
+
+static void *writer(void *Arg)
+{
+    uint32_t sequence = 0;
+    volatile uint32_t n;
+    uint16_t i;
+
+    while (running) {
+        sequence++;
+        Snapshot_WriteBegin(&version);
+        block[0] = (uint16_t)sequence;
+        block[1] = (uint16_t)(sequence >> 16);
+        for (i = 2; i < BLOCK_WORDS; i++) {
+            block[i] = blockWord(sequence, i);
+        }
+        Snapshot_WriteEnd(&version);
+        for (n = 0; n < hold; n++) {
+        }
+    }
+    writes = sequence;
+    return NULL;
+}
+
+static void *reader(void *Arg)
+{
+    Reader_t *r = Arg;
+    uint16_t copy[BLOCK_WORDS];
+    uint32_t sequence, last = 0;
+    uint16_t i;
+
+    while (running) {
+        if (++r->Attempts % UNGUARDED_EVERY == 0) {
+            for (i = 0; i < BLOCK_WORDS; i++) {
+                copy[i] = block[i];
+            }
+            r->Unguarded++;
+            if (!blockCheck(copy, &sequence)) r->UnguardedTorn++;
+            continue;
+        }
+        if (!Snapshot_Copy(&version, block, copy, BLOCK_WORDS)) continue;
+
+        r->Copies++;
+        if (!blockCheck(copy, &sequence)) {
+            r->Torn++;
+        } else {
+            if (sequence < last) r->Back++;
+            last = sequence;
+        }
+    }
+    return NULL;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: snapstress [--seconds S] [--readers N] [--hold N]\n"
+            "  --seconds  run time (%.1f)\n"
+            "  --readers  reader threads, 1 to %u (%u)\n"
+            "  --hold     loops the writer leaves the block alone after each write (%u)\n",
+            DEFAULT_SECONDS, MAX_READERS, DEFAULT_READERS, DEFAULT_HOLD);
+    exit(2);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main(int argc, char **argv)
+{
+    static Reader_t readers[MAX_READERS];
+    double seconds = DEFAULT_SECONDS;
+    unsigned numReaders = DEFAULT_READERS;
+    uint64_t attempts = 0, copies = 0, torn = 0, back = 0, unguarded = 0, unguardedTorn = 0;
+    pthread_t writerThread;
+    struct timespec run;
+    unsigned k;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        const char *arg = argv[a];
+        const char *val = (a + 1 < argc) ? argv[a + 1] : NULL;
+        if (val == NULL) usage();
+        if (!strcmp(arg, "--seconds")) seconds = atof(val);
+        else if (!strcmp(arg, "--readers")) numReaders = (unsigned)atoi(val);
+        else if (!strcmp(arg, "--hold")) hold = (uint32_t)strtoul(val, NULL, 0);
+        else usage();
+        a++;
+    }
+    if (seconds <= 0 || numReaders < 1 || numReaders > MAX_READERS) usage();
+
+    // A consistent block before the readers start
+    Snapshot_WriteBegin(&version);
+    block[0] = 0;
+    block[1] = 0;
+    for (k = 2; k < BLOCK_WORDS; k++) {
+        block[k] = blockWord(0, (uint16_t)k);
+    }
+    Snapshot_WriteEnd(&version);
+
+    pthread_create(&writerThread, NULL, writer, NULL);
+    for (k = 0; k < numReaders; k++) {
+        pthread_create(&readers[k].Thread, NULL, reader, &readers[k]);
+    }
+    run.tv_sec = (time_t)seconds;
+    run.tv_nsec = (long)((seconds - (double)run.tv_sec) * 1e9);
+    nanosleep(&run, NULL);
+    running = 0;
+    pthread_join(writerThread, NULL);
+    for (k = 0; k < numReaders; k++) {
+        pthread_join(readers[k].Thread, NULL);
+        attempts += readers[k].Attempts - readers[k].Unguarded;
+        copies += readers[k].Copies;
+        torn += readers[k].Torn;
+        back += readers[k].Back;
+        unguarded += readers[k].Unguarded;
+        unguardedTorn += readers[k].UnguardedTorn;
+    }
+
+    printf("block %u words, %u readers, hold %lu, %.1f s: %llu writes\n", (unsigned)BLOCK_WORDS, numReaders,
+           (unsigned long)hold, seconds, (unsigned long long)writes);
+    printf("snapshot copies:   %llu of %llu attempts, %llu torn, %llu went back\n", (unsigned long long)copies,
+           (unsigned long long)attempts, (unsigned long long)torn, (unsigned long long)back);
+    printf("unguarded copies:  %llu, %llu torn\n", (unsigned long long)unguarded, (unsigned long long)unguardedTorn);
+
+    if (torn || back) {
+        fprintf(stderr, "snapstress: snapshot copies torn or out of order\n");
+        return 1;
+    }
+    if (copies == 0) {
+        fprintf(stderr, "snapstress: no snapshot copy succeeded\n");
+        return 1;
+    }
+    return 0;
+}
+
+/*** end of file ***/
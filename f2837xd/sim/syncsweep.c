@@ -0,0 +1,236 @@
+/**
+ ********************************************************************************
+ * @file    syncsweep.c
+ * @brief   Convergence of the cluster time servo (ring/ClockSync.c) on a host.
+ *
+ *          Built once per servo setting (CLOCKSYNC_KP_SHIFT, CLOCKSYNC_KI_SHIFT,
+ *          CLOCKSYNC_LOCK_THRESHOLD, see make syncsweep), it feeds ClockSync
+ *          the timestamp pairs a worker gets: the Director launch time of frame
+ *          n and the local time of its CS falling edge, PathDelay later, read
+ *          on a clock with an offset, a skew and --jitter ticks of noise. As on
+ *          the worker, frame n is fed once frame n + 1 has arrived, then the CS
+ *          falling edge of n + 1 is converted to cluster time: the error of that
+ *          conversion is what the Director sees as the sync error.
+ *
+ *          The first two samples give the skew almost exactly, so from a steady
+ *          clock every setting locks alike. What tells them apart is a change of
+ *          the skew: halfway through each run it steps by --step ppm, as when a
+ *          crystal warms up.
+ *
+ *          Each setting runs every skew of skewsPpm from --runs random offsets
+ *          and prints one line, the worst run of each:
+ *
+ *          - lock: samples until ClockSync_IsLocked();
+ *          - step: largest error after the step, in ticks, and samples until it
+ *            is back within --settle ticks;
+ *          - locked: largest error while locked, what the lock threshold lets
+ *            through to the carrier alignment;
+ *          - unlocks: times the lock was lost again, the carrier is not trimmed
+ *            meanwhile;
+ *          - rate: skew estimate error at the end, in ppb.
+ ********************************************************************************
+ */
+
+/************************************
+ * INCLUDES
+ ************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ClockSync.h"
+
+/************************************
+ * PRIVATE MACROS AND DEFINES
+ ************************************/
+#define TICKS_PER_US        200U
+#define PATH_DELAY_TICKS    204U        /*!< Worker 0: CS_DETECT_DELAY_TICKS + CS_HOP_DELAY_TICKS */
+
+#define DEFAULT_SAMPLES     300U
+#define DEFAULT_PERIOD_US   100000U
+#define DEFAULT_JITTER      2U
+#define DEFAULT_SETTLE      20U
+#define DEFAULT_RUNS        4U
+#define DEFAULT_STEP_PPM    10
+
+/************************************
+ * PRIVATE TYPEDEFS
+ ************************************/
+typedef struct {
+    int32_t Lock;               /*!< Samples to lock, -1 if never */
+    int32_t StepError;          /*!< Largest |error| after the skew step, ticks */
+    int32_t Recovered;          /*!< Samples after the step until the error stays within the bound, -1 if never */
+    int32_t Locked;             /*!< Largest |error| while locked, ticks */
+    uint32_t Unlocks;
+    int32_t Rate;               /*!< |skew estimate error| at the end, ppb */
+} Result_t;
+
+/**
+ * @brief Local clock of the worker: Ppb off from global time since BaseGlobal, when it read BaseLocal.
+ */
+typedef struct {
+    uint64_t BaseGlobal;
+    uint64_t BaseLocal;
+    int64_t Ppb;
+} Clock_t;
+
+/************************************
+ * STATIC VARIABLES
+ ************************************/
+static uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+static const int32_t skewsPpm[] = { -200, -100, -50, -20, 0, 20, 50, 100, 200 };
+
+/************************************
+ * STATIC FUNCTIONS
+ ************************************/
+static uint64_t random64(void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return rng * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t localTime(const Clock_t *Clock, uint64_t Global)
+{
+    int64_t elapsed = (int64_t)(Global - Clock->BaseGlobal);
+    return Clock->BaseLocal + (uint64_t)(elapsed + elapsed * Clock->Ppb / 1000000000LL);
+}
+
+// Changes the skew at global time Global, the local clock goes on from where it is
+static void clockStep(Clock_t *Clock, uint64_t Global, int64_t Ppb)
+{
+    Clock->BaseLocal = localTime(Clock, Global);
+    Clock->BaseGlobal = Global;
+    Clock->Ppb = Ppb;
+}
+
+static Result_t run(int64_t Ppb, int64_t StepPpb, uint32_t Samples, uint64_t Period, uint32_t Jitter, uint32_t Settle)
+{
+    Result_t r = { -1, 0, -1, 0, 0, 0 };
+    Clock_t clock = { 0, random64() & 0xFFFFFFFFU, Ppb };
+    uint64_t launch = random64() % Period;
+    uint32_t prevMaster = 0, prevLocal = 0;
+    uint32_t step = Samples / 2U;
+    bool locked = false;
+    uint32_t n;
+
+    ClockSync_Init(PATH_DELAY_TICKS);
+    for (n = 0; n < Samples; n++, launch += Period) {
+        if (n == step) clockStep(&clock, launch, Ppb + StepPpb);
+
+        int32_t noise = Jitter ? (int32_t)(random64() % (2U * Jitter + 1U)) - (int32_t)Jitter : 0;
+        uint32_t local = (uint32_t)localTime(&clock, launch + PATH_DELAY_TICKS) + (uint32_t)noise;
+
+        if (n > 0) {
+            ClockSync_Update(prevMaster, prevLocal);
+
+            int32_t error = (int32_t)(ClockSync_ToCluster(local) - (uint32_t)(launch + PATH_DELAY_TICKS));
+            if (error < 0) error = -error;
+            if (ClockSync_IsLocked()) {
+                if (r.Lock < 0) r.Lock = (int32_t)n;
+                if (error > r.Locked) r.Locked = error;
+                locked = true;
+            } else if (locked) {
+                r.Unlocks++;
+                locked = false;
+            }
+            if (n >= step) {
+                if (error > r.StepError) r.StepError = error;
+                if ((uint32_t)error > Settle) r.Recovered = -1;
+                else if (r.Recovered < 0) r.Recovered = (int32_t)(n - step);
+            }
+        }
+        prevMaster = (uint32_t)launch;
+        prevLocal = local;
+    }
+
+    // Local minus cluster ticks per local tick, against what the servo estimates
+    double truth = (double)clock.Ppb / (1.0 + (double)clock.Ppb * 1e-9);
+    double estimate = (double)ClockSync_Rate() * 1e9 / (double)(1UL << CLOCKSYNC_RATE_SHIFT);
+    double rate = estimate - truth;
+    r.Rate = (int32_t)(rate < 0 ? -rate : rate);
+    return r;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: syncsweep [--samples N] [--period-us US] [--jitter TICKS] [--step PPM] [--settle TICKS] [--runs N]\n"
+            "                 [--seed N]\n"
+            "  --samples    frames per run, the skew steps halfway (%u)\n"
+            "  --period-us  frame period (%u)\n"
+            "  --jitter     CS timestamp noise, uniform within +/- this many ticks (%u)\n"
+            "  --step       skew step, in ppm (%d)\n"
+            "  --settle     error bound of the recovery from the step, in ticks (%u)\n"
+            "  --runs       random clock offsets per skew (%u)\n"
+            "  --seed       seed of the offsets and of the noise\n",
+            DEFAULT_SAMPLES, DEFAULT_PERIOD_US, DEFAULT_JITTER, DEFAULT_STEP_PPM, DEFAULT_SETTLE, DEFAULT_RUNS);
+    exit(2);
+}
+
+/************************************
+ * GLOBAL FUNCTIONS
+ ************************************/
+int main(int argc, char **argv)
+{
+    uint32_t samples = DEFAULT_SAMPLES;
+    uint32_t periodUs = DEFAULT_PERIOD_US;
+    uint32_t jitter = DEFAULT_JITTER;
+    int32_t stepPpm = DEFAULT_STEP_PPM;
+    uint32_t settle = DEFAULT_SETTLE;
+    uint32_t runs = DEFAULT_RUNS;
+    uint64_t seed = 1;
+    Result_t worst = { 0, 0, 0, 0, 0, 0 };
+    size_t s;
+    uint32_t k;
+    int a;
+
+    for (a = 1; a < argc; a++) {
+        const char *arg = argv[a];
+        const char *val = (a + 1 < argc) ? argv[a + 1] : NULL;
+        if (val == NULL) usage();
+        if (!strcmp(arg, "--samples")) samples = (uint32_t)strtoul(val, NULL, 0);
+        else if (!strcmp(arg, "--period-us")) periodUs = (uint32_t)strtoul(val, NULL, 0);
+        else if (!strcmp(arg, "--jitter")) jitter = (uint32_t)strtoul(val, NULL, 0);
+        else if (!strcmp(arg, "--step")) stepPpm = atoi(val);
+        else if (!strcmp(arg, "--settle")) settle = (uint32_t)strtoul(val, NULL, 0);
+        else if (!strcmp(arg, "--runs")) runs = (uint32_t)strtoul(val, NULL, 0);
+        else if (!strcmp(arg, "--seed")) seed = strtoull(val, NULL, 0);
+        else usage();
+        a++;
+    }
+    // The servo works on int32 tick differences over one period
+    if (samples < 4 || periodUs == 0 || periodUs > 10000000U || runs == 0) usage();
+    rng ^= seed * 0xBF58476D1CE4E5B9ULL;
+
+    for (s = 0; s < sizeof(skewsPpm) / sizeof(skewsPpm[0]); s++) {
+        for (k = 0; k < runs; k++) {
+            Result_t r = run((int64_t)skewsPpm[s] * 1000, (int64_t)stepPpm * 1000, samples,
+                             (uint64_t)periodUs * TICKS_PER_US, jitter, settle);
+
+            // Never counts as the longest
+            if (worst.Lock >= 0 && (r.Lock < 0 || r.Lock > worst.Lock)) worst.Lock = r.Lock;
+            if (worst.Recovered >= 0 && (r.Recovered < 0 || r.Recovered > worst.Recovered)) {
+                worst.Recovered = r.Recovered;
+            }
+            if (r.StepError > worst.StepError) worst.StepError = r.StepError;
+            if (r.Locked > worst.Locked) worst.Locked = r.Locked;
+            if (r.Rate > worst.Rate) worst.Rate = r.Rate;
+            worst.Unlocks += r.Unlocks;
+        }
+    }
+
+    printf("kp %u ki %u lock %4u:", (unsigned)CLOCKSYNC_KP_SHIFT, (unsigned)CLOCKSYNC_KI_SHIFT,
+           (unsigned)CLOCKSYNC_LOCK_THRESHOLD);
+    if (worst.Lock >= 0) printf("  lock %4d", (int)worst.Lock);
+    else printf("  lock never");
+    printf("  step %6ld ticks", (long)worst.StepError);
+    if (worst.Recovered >= 0) printf(" recovered %4d", (int)worst.Recovered);
+    else printf(" recovered never");
+    printf("  locked %6ld ticks  unlocks %3lu  rate %5ld ppb\n", (long)worst.Locked, (unsigned long)worst.Unlocks,
+           (long)worst.Rate);
+    return 0;
+}
+
+/*** end of file ***/
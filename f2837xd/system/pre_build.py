@@ -1,3 +1,637 @@
+"""
+Pre-build code generator.
+
+Reads system.json and generates, next to this script:
+  system_config.h   ring geometry (NUM_WORKERS, FIFO_LVL, chunk sizes per frame class)
+  signals.h         packed payload structs, word/bit offsets and accessor inlines
+  signals.c         static signal tables (name, type, offset, scaling)
+  signals.py        matching host-side frame decoder
+
+Signals belong to one of three frame classes: "broadcast" (one chunk read by
+every worker in transit), "setpoint" (one private chunk per worker) and
+"measurement" (one chunk per worker). Without broadcast signals there is no
+broadcast chunk.
+
+Payloads are packed into the minimum number of 16-bit words: 32-bit signals
+first (so they stay on even words), then 16-bit signals, then booleans, 16 per
+word. Chunks are a header plus their payload; a few padding words are added
+(to the measurement chunk, then to the broadcast or setpoint chunks) so the
+DMA bursts divide what the ring clocks per frame, see system.h, and so every
+node relays words it has already received, see geometry().
+
+With "measurement_encoding" of type "delta", workers send their measurement
+payload encoded by ring/DeltaCodec.c: a presence bitmap with up to delta_slots
+changed words, plus a slice of the payload so the whole payload is refreshed
+every keyframe_period cycles. The measurement chunk is then sized for the
+encoding instead of the payload.
+
+"mailbox_words" reserves words after the setpoint and measurement
+payloads for the slow mailbox channel of ring/Mailbox.c (0 for none).
+
+Measurement signals with an "adc" source ("A2": ADC A, channel ADCIN2) are
+converted on the worker and moved from the ADC result registers into the
+payload by DMA (AdcCapture.h). They are uint16 counts, packed last as one
+block, one SOC each in declaration order, and all on the same ADC module.
+
+The "timing" section is not used here, it holds the costs tools/budget.py
+plans the frame rate with.
+
+Files are only rewritten when their content changes, so running this on every
+build does not trigger a full rebuild. --config and --out generate another
+configuration elsewhere, as the host ring simulator (sim/) does.
+"""
+import argparse
+import json
+import math
 import os
-print("prebuild")
-os.system("echo 2 >> \"..\\..\\..\\system\\test.txt\"")
\ No newline at end of file
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+CONFIG = os.path.join(HERE, "system.json")
+
+# Must match WORDS(FrameHeader) in system.h (crc, token, time, phase, sync, sample)
+FRAME_HEADER_WORDS = 8
+
+# FRAME_SYNC in system.h, header word 5
+FRAME_SYNC = 0x5A3C
+
+# Words of the SPI TX and RX FIFOs
+SPI_FIFO_DEPTH = 16
+
+DIRECTIONS = ("broadcast", "setpoint", "measurement")
+
+# type: (C type, words)
+TYPES = {
+    "bool":    ("bool", 0),
+    "uint16":  ("uint16_t", 1),
+    "int16":   ("int16_t", 1),
+    "uint32":  ("uint32_t", 2),
+    "int32":   ("int32_t", 2),
+    "float32": ("float", 2),
+}
+
+INT_TYPES = ("uint16", "int16", "uint32", "int32")
+
+ADC_MODULES = "ABCD"
+ADC_SOCS = 16
+
+BANNER = "Generated by pre_build.py from system.json, do not edit."
+
+
+class ConfigError(Exception):
+    pass
+
+
+def load_config(path):
+    with open(path) as f:
+        config = json.load(f)
+
+    num_workers = config.get("num_workers")
+    fifo_level = config.get("fifo_level", 8)
+    if not isinstance(num_workers, int) or not 1 <= num_workers <= 16:
+        raise ConfigError("num_workers must be an integer between 1 and 16")
+    if not isinstance(fifo_level, int) or not 1 <= fifo_level <= 15:
+        raise ConfigError("fifo_level must be an integer between 1 and 15")
+
+    signals = {d: [] for d in DIRECTIONS}
+    names = set()
+    for s in config.get("signals", []):
+        name = s.get("name", "")
+        if not re.match(r"^[a-z][a-z0-9_]*$", name):
+            raise ConfigError("invalid signal name '%s'" % name)
+        if (s.get("direction"), name) in names:
+            raise ConfigError("duplicate signal '%s'" % name)
+        if s.get("type") not in TYPES:
+            raise ConfigError("signal '%s': unknown type '%s'" % (name, s.get("type")))
+        if s.get("direction") not in DIRECTIONS:
+            raise ConfigError("signal '%s': direction must be one of %s" % (name, ", ".join(DIRECTIONS)))
+        q = s.get("q", 0)
+        if (q or "scale" in s) and s["type"] not in INT_TYPES:
+            raise ConfigError("signal '%s': Q format and scale only apply to integer types" % name)
+        if not isinstance(q, int) or not 0 <= q <= 31:
+            raise ConfigError("signal '%s': q must be between 0 and 31" % name)
+        adc = s.get("adc")
+        if adc is not None:
+            m = re.match(r"^([A-D])([0-9]|1[0-5])$", str(adc))
+            if not m:
+                raise ConfigError("signal '%s': adc must be a module and channel, A0 to D15" % name)
+            if s["direction"] != "measurement" or s["type"] != "uint16":
+                raise ConfigError("signal '%s': ADC signals must be uint16 measurements" % name)
+            adc = (ADC_MODULES.index(m.group(1)), int(m.group(2)))
+
+        names.add((s["direction"], name))
+        signals[s["direction"]].append({
+            "name": name,
+            "type": s["type"],
+            "q": q,
+            "scale": float(s.get("scale", 1.0)),
+            "scaled": "q" in s or "scale" in s,
+            "unit": s.get("unit", ""),
+            "doc": s.get("doc", ""),
+            "adc": adc,
+        })
+
+    adc = [s["adc"] for s in signals["measurement"] if s["adc"]]
+    if len(set(module for module, _ in adc)) > 1:
+        raise ConfigError("ADC signals must all be on the same ADC module")
+    if len(adc) > ADC_SOCS:
+        raise ConfigError("at most %d ADC signals" % ADC_SOCS)
+
+    encoding = config.get("measurement_encoding", {"type": "raw"})
+    if encoding.get("type") not in ("raw", "delta"):
+        raise ConfigError("measurement_encoding type must be 'raw' or 'delta'")
+    for key in ("delta_slots", "keyframe_period"):
+        value = encoding.get(key, 1)
+        if not isinstance(value, int) or not 1 <= value <= 255:
+            raise ConfigError("measurement_encoding %s must be an integer between 1 and 255" % key)
+
+    mailbox = config.get("mailbox_words", 0)
+    if not isinstance(mailbox, int) or not (mailbox == 0 or 2 <= mailbox <= 16):
+        raise ConfigError("mailbox_words must be 0 or an integer between 2 and 16")
+
+    return num_workers, fifo_level, signals, encoding, mailbox
+
+
+def delta_layout(encoding, payload):
+    """Encoded measurement length, see DeltaCodec.h: refresh cursor, presence bitmap, changed words and
+    refresh slice. Returns (delta slots, refresh words, encoded words), or None for raw measurements."""
+    if encoding["type"] != "delta":
+        return None
+    slots = min(encoding.get("delta_slots", 1), payload)
+    refresh = -(-payload // encoding.get("keyframe_period", 1))
+    return slots, refresh, 1 + (payload + 15) // 16 + slots + refresh
+
+
+def pack(signals):
+    """Assigns word/bit offsets, returns the payload length in words. ADC signals come last, in SOC order."""
+    word = 0
+    for size in (2, 1):
+        for s in signals:
+            if TYPES[s["type"]][1] == size and not s.get("adc"):
+                s["word"], s["bit"] = word, 0
+                word += size
+
+    bools = [s for s in signals if s["type"] == "bool"]
+    for i, s in enumerate(bools):
+        s["word"], s["bit"] = word + i // 16, i % 16
+    word += (len(bools) + 15) // 16
+
+    for s in adc_signals(signals):
+        s["word"], s["bit"] = word, 0
+        word += 1
+
+    return word
+
+
+def adc_signals(signals):
+    return [s for s in signals if s.get("adc")]
+
+
+def prefix(direction):
+    return direction.capitalize()
+
+
+def lsb(s):
+    return s["scale"] / (1 << s["q"])
+
+
+def c_float(value):
+    return repr(float(value)) + "f"
+
+
+def measurement_mailbox(words, delta):
+    """Offset of the mailbox in the measurement payload, after the payload or its encoding."""
+    return delta[2] if delta else words["measurement"]
+
+
+def geometry(num_workers, fifo_level, words, delta, mailbox):
+    """Chunk sizes per frame class, padded so that with N workers and chunk sizes B, P and M:
+    the Director RX burst (FIFO_LVL) divides N * M, and both burst lengths divide the
+    B + N * P + (N - 1) * M words clocked per frame. Returns the smallest such image.
+
+    A node relaying the ring sends a word a fixed delay after it received it: M on a
+    worker, B + N * P on the Director. Its TX FIFO takes words up to 16 ahead of the
+    wire, its RX channel stores them up to one burst after they were received, so
+    the delay must cover both or the relayed words go out from the previous frame."""
+    step = fifo_level * (16 - fifo_level) // math.gcd(fifo_level, 16 - fifo_level)
+    relay = SPI_FIFO_DEPTH + fifo_level
+    n = num_workers
+    b0 = FRAME_HEADER_WORDS + words["broadcast"] if words["broadcast"] else 0
+    p0 = FRAME_HEADER_WORDS + words["setpoint"] + mailbox
+    m0 = FRAME_HEADER_WORDS + measurement_mailbox(words, delta) + mailbox
+    if n > 1:
+        m0 = max(m0, relay)
+
+    best = None
+    for m in range(m0, m0 + 2 * step):
+        if (n * m) % fifo_level:
+            continue
+        for pad in range(step + relay):
+            b, p = (b0 + pad, p0) if b0 else (0, p0 + pad)
+            clocked = b + n * p + (n - 1) * m
+            if n > 1 and b + n * p < relay:
+                continue
+            if clocked % step == 0 and (best is None or clocked + m < best[0]):
+                best = (clocked + m, {"broadcast": b, "setpoint": p, "measurement": m})
+                break
+    if best is None:
+        raise ConfigError("no ring geometry fits fifo_level %d with %d workers" % (fifo_level, n))
+    return best[1]
+
+
+def gen_config(num_workers, fifo_level, signals, words, chunks, delta, mailbox):
+    adc = adc_signals(signals["measurement"])
+    return "\n".join([
+        "/* %s */" % BANNER,
+        "",
+        "#ifndef SYSTEM_CONFIG_H",
+        "#define SYSTEM_CONFIG_H",
+        "",
+        "#define NUM_WORKERS %d" % num_workers,
+        "#define FIFO_LVL %d                     // SPI FIFO interrupt level, also the DMA burst length" % fifo_level,
+        "",
+        "#define FRAME_HEADER_WORDS %d           // WORDS(FrameHeader)" % FRAME_HEADER_WORDS,
+        "#define BROADCAST_WORDS %d              // Packed broadcast payload" % words["broadcast"],
+        "#define SETPOINT_WORDS %d               // Packed setpoint payload" % words["setpoint"],
+        "#define MEASUREMENT_WORDS %d            // Packed measurement payload" % words["measurement"],
+        "",
+        "// Chunk of each frame class: header, payload and padding. No broadcast chunk if 0.",
+        "#define BROADCAST_CHUNK %d" % chunks["broadcast"],
+        "#define SETPOINT_CHUNK %d" % chunks["setpoint"],
+        "#define MEASUREMENT_CHUNK %d" % chunks["measurement"],
+        "",
+        "// Delta encoded measurements (DeltaCodec.h): changed words per frame, payload words refreshed per frame",
+        "#define MEASUREMENT_DELTA %d" % (1 if delta else 0),
+        "#define MEASUREMENT_DELTA_SLOTS %d" % (delta[0] if delta else 0),
+        "#define MEASUREMENT_REFRESH_WORDS %d" % (delta[1] if delta else 0),
+        "",
+        "// Slow mailbox channel (Mailbox.h): words per setpoint and measurement, and their offset in the data",
+        "#define MAILBOX_WORDS %d" % mailbox,
+        "#define SETPOINT_MAILBOX_OFFSET %d" % words["setpoint"],
+        "#define MEASUREMENT_MAILBOX_OFFSET %d" % measurement_mailbox(words, delta),
+        "",
+        "// ADC sampled measurement words (AdcCapture.h), the last of the payload: their offset, the ADC module (0 to",
+        "// 3: A to D) and the channel of each SOC. Moved in by the worker comms core, not published by the algorithm core.",
+        "#define MEASUREMENT_ADC_WORDS %d" % len(adc),
+        "#define MEASUREMENT_ADC_OFFSET %d" % (words["measurement"] - len(adc)),
+        "#define MEASUREMENT_ADC_MODULE %d" % (adc[0]["adc"][0] if adc else 0),
+        ("#define MEASUREMENT_ADC_CHANNELS %s" % ", ".join(str(s["adc"][1]) for s in adc)).rstrip(),
+        "",
+        "// Largest chunk or decoded measurement, size of the generic Frame view",
+        "#define CHUNK_SIZE %d" % max(list(chunks.values()) + [FRAME_HEADER_WORDS + words["measurement"]]),
+        "",
+        "#endif //SYSTEM_CONFIG_H",
+        "",
+    ])
+
+
+def gen_header(signals, words):
+    out = [
+        "/* %s */" % BANNER,
+        "",
+        "#ifndef SIGNALS_H",
+        "#define SIGNALS_H",
+        "",
+        "#include <stdint.h>",
+        "#include <stdbool.h>",
+        "#include \"system.h\"",
+        "",
+        "typedef enum {",
+        "    SIGNAL_BOOL,",
+        "    SIGNAL_UINT16,",
+        "    SIGNAL_INT16,",
+        "    SIGNAL_UINT32,",
+        "    SIGNAL_INT32,",
+        "    SIGNAL_FLOAT32",
+        "} SignalType_t;",
+        "",
+        "typedef struct {",
+        "    const char   *Name;",
+        "    SignalType_t  Type;",
+        "    uint16_t      Word;     // Offset in the payload, in words",
+        "    uint16_t      Bit;      // Bit in the word, booleans only",
+        "    uint16_t      Q;        // Fractional bits",
+        "    float         Scale;    // Engineering units of 1.0 in Q format",
+        "} SignalInfo_t;",
+        "",
+    ]
+
+    for d in DIRECTIONS:
+        P = prefix(d)
+        U = d.upper()
+        sig = signals[d]
+
+        out.append("// %s payload, %d words" % (P, words[d]))
+        out.append("")
+        for s in sig:
+            N = "%s_%s" % (U, s["name"].upper())
+            out.append("#define %s_WORD %d" % (N, s["word"]))
+            if s["type"] == "bool":
+                out.append("#define %s_BIT %d" % (N, s["bit"]))
+            if s["adc"]:
+                out.append("#define %s_ADC_SOC %d" % (N, s["word"] - (words[d] - len(adc_signals(sig)))))
+            if s["scaled"]:
+                out.append(("#define %s_LSB %s" % (N, c_float(lsb(s)))).ljust(48) + "// %s per count" % (s["unit"] or "units"))
+        out.append("#define %s_NUM_SIGNALS %d" % (U, len(sig)))
+        out.append("")
+        if not sig:
+            continue
+
+        # Packed struct, for the debugger and for sizing. Accessors below only use word accesses, so they don't
+        # depend on the alignment of the payload.
+        out.append("typedef struct {")
+        flag_words = {}
+        for s in sorted(sig, key=lambda s: (s["word"], s["bit"])):
+            if s["type"] == "bool":
+                flag_words.setdefault(s["word"], []).append(s["name"])
+                continue
+            out.append(("    %-9s %s;" % (TYPES[s["type"]][0], s["name"])).ljust(32) + "// %s" % s["doc"])
+        for w, names in sorted(flag_words.items()):
+            out.append(("    uint16_t  flags%d;" % w).ljust(32) + "// %s" % ", ".join(names))
+        out.append("} %sPayload_t;" % P)
+        out.append("")
+        out.append("extern const SignalInfo_t %sSignals[%s_NUM_SIGNALS];" % (d, U))
+        out.append("")
+
+        for s in sig:
+            N = "%s_%s" % (U, s["name"].upper())
+            ctype = TYPES[s["type"]][0]
+            name = s["name"]
+            t = s["type"]
+            comment = "// %s%s" % (s["doc"], " [%s]" % s["unit"] if s["unit"] else "")
+            out.append(comment)
+            if t == "bool":
+                out += [
+                    "static inline bool %s_Get_%s(volatile const uint16_t *Payload) {" % (P, name),
+                    "    return (Payload[%s_WORD] >> %s_BIT) & 1U;" % (N, N),
+                    "}",
+                    "static inline void %s_Set_%s(volatile uint16_t *Payload, bool Value) {" % (P, name),
+                    "    if (Value) Payload[%s_WORD] |= (1U << %s_BIT);" % (N, N),
+                    "    else Payload[%s_WORD] &= ~(1U << %s_BIT);" % (N, N),
+                    "}",
+                ]
+            elif TYPES[t][1] == 1:
+                out += [
+                    "static inline %s %s_Get_%s(volatile const uint16_t *Payload) {" % (ctype, P, name),
+                    "    return (%s)Payload[%s_WORD];" % (ctype, N),
+                    "}",
+                    "static inline void %s_Set_%s(volatile uint16_t *Payload, %s Value) {" % (P, name, ctype),
+                    "    Payload[%s_WORD] = (uint16_t)Value;" % N,
+                    "}",
+                ]
+            elif t == "float32":
+                out += [
+                    "static inline float %s_Get_%s(volatile const uint16_t *Payload) {" % (P, name),
+                    "    union { uint32_t u; float f; } v;",
+                    "    v.u = ((uint32_t)Payload[%s_WORD + 1] << 16) | Payload[%s_WORD];" % (N, N),
+                    "    return v.f;",
+                    "}",
+                    "static inline void %s_Set_%s(volatile uint16_t *Payload, float Value) {" % (P, name),
+                    "    union { uint32_t u; float f; } v;",
+                    "    v.f = Value;",
+                    "    Payload[%s_WORD] = (uint16_t)v.u;" % N,
+                    "    Payload[%s_WORD + 1] = (uint16_t)(v.u >> 16);" % N,
+                    "}",
+                ]
+            else:
+                out += [
+                    "static inline %s %s_Get_%s(volatile const uint16_t *Payload) {" % (ctype, P, name),
+                    "    return (%s)(((uint32_t)Payload[%s_WORD + 1] << 16) | Payload[%s_WORD]);" % (ctype, N, N),
+                    "}",
+                    "static inline void %s_Set_%s(volatile uint16_t *Payload, %s Value) {" % (P, name, ctype),
+                    "    Payload[%s_WORD] = (uint16_t)((uint32_t)Value);" % N,
+                    "    Payload[%s_WORD + 1] = (uint16_t)((uint32_t)Value >> 16);" % N,
+                    "}",
+                ]
+
+            if s["scaled"]:
+                hi_c = "%s_MAX" % ctype[:-2].upper()
+                lo_c = "%s_MIN" % ctype[:-2].upper() if t.startswith("int") else "0"
+                out += [
+                    "static inline float %s_Read_%s(volatile const uint16_t *Payload) {" % (P, name),
+                    "    return (float)%s_Get_%s(Payload) * %s_LSB;" % (P, name, N),
+                    "}",
+                    "static inline void %s_Write_%s(volatile uint16_t *Payload, float Value) {" % (P, name),
+                    "    float counts = Value / %s_LSB;" % N,
+                    "    if (counts >= (float)%s) %s_Set_%s(Payload, %s);" % (hi_c, P, name, hi_c),
+                    "    else if (counts <= (float)%s) %s_Set_%s(Payload, %s);" % (lo_c, P, name, lo_c),
+                    "    else %s_Set_%s(Payload, (%s)(counts + (counts < 0.0f ? -0.5f : 0.5f)));" % (P, name, ctype),
+                    "}",
+                ]
+            out.append("")
+
+    out += ["#endif //SIGNALS_H", ""]
+    return "\n".join(out)
+
+
+def gen_tables(signals):
+    out = [
+        "/* %s */" % BANNER,
+        "",
+        "#include \"signals.h\"",
+        "",
+    ]
+    for d in DIRECTIONS:
+        U = d.upper()
+        if not signals[d]:
+            continue
+        out.append("const SignalInfo_t %sSignals[%s_NUM_SIGNALS] = {" % (d, U))
+        for s in signals[d]:
+            out.append("    { \"%s\", SIGNAL_%s, %d, %d, %d, %s }," % (
+                s["name"], s["type"].upper(), s["word"], s["bit"], s["q"], c_float(s["scale"])))
+        out.append("};")
+        out.append("")
+    return "\n".join(out)
+
+
+def gen_decoder(num_workers, fifo_level, signals, words, chunks, delta, mailbox):
+    out = [
+        '"""',
+        BANNER,
+        "",
+        "Host-side decoder for ring frames. A frame is a list of 16-bit words as stored on",
+        "the C28x (32-bit values low word first), one chunk of its frame class long.",
+        '"""',
+        "import struct",
+        "",
+        "NUM_WORKERS = %d" % num_workers,
+        "FIFO_LVL = %d" % fifo_level,
+        "FRAME_HEADER_WORDS = %d" % FRAME_HEADER_WORDS,
+        "FRAME_SYNC = 0x%04X" % FRAME_SYNC,
+        "",
+        "# Chunk length of each frame class, in words (no broadcast chunk if 0)",
+        "CHUNKS = {'broadcast': %d, 'setpoint': %d, 'measurement': %d}" % (
+            chunks["broadcast"], chunks["setpoint"], chunks["measurement"]),
+        "",
+        "# Delta encoded measurements (ring/DeltaCodec.h), None if raw: (delta slots, refresh words)",
+        "MEASUREMENT_DELTA = %r" % (delta[:2] if delta else None,),
+        "",
+        "# Mailbox fragment (ring/Mailbox.h) in the payload, None if there is none: {class: (offset, words)}",
+        "MAILBOX = %s" % ("{'setpoint': (%d, %d), 'measurement': (%d, %d)}" % (
+            words["setpoint"], mailbox, measurement_mailbox(words, delta), mailbox) if mailbox else "None"),
+        "",
+        "# name: (type, word, bit, lsb or None, unit)",
+    ]
+    for d in DIRECTIONS:
+        out.append("%s_SIGNALS = {" % d.upper())
+        for s in signals[d]:
+            out.append("    %r: (%r, %d, %d, %r, %r)," % (
+                s["name"], s["type"], s["word"], s["bit"], lsb(s) if s["scaled"] else None, s["unit"]))
+        out.append("}")
+    out += [
+        "",
+        "SIGNALS = {'broadcast': BROADCAST_SIGNALS, 'setpoint': SETPOINT_SIGNALS, 'measurement': MEASUREMENT_SIGNALS}",
+        "",
+        "_FORMATS = {'uint16': 'H', 'int16': 'h', 'uint32': 'I', 'int32': 'i', 'float32': 'f'}",
+        "",
+        "",
+        "def crc16(words):",
+        "    \"\"\"CRC-16/CCITT-FALSE over 16-bit words, high byte first (crc.c crcFast).\"\"\"",
+        "    crc = 0xFFFF",
+        "    for w in words:",
+        "        for byte in ((w >> 8) & 0xFF, w & 0xFF):",
+        "            crc ^= byte << 8",
+        "            for _ in range(8):",
+        "                crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)",
+        "                crc &= 0xFFFF",
+        "    return crc",
+        "",
+        "",
+        "def decode_payload(words, direction):",
+        "    \"\"\"Decodes a payload into {name: value}, scaled signals in engineering units.\"\"\"",
+        "    values = {}",
+        "    for name, (kind, word, bit, lsb, unit) in SIGNALS[direction].items():",
+        "        if kind == 'bool':",
+        "            values[name] = bool((words[word] >> bit) & 1)",
+        "            continue",
+        "        if kind in ('uint16', 'int16'):",
+        "            raw = struct.pack('<H', words[word] & 0xFFFF)",
+        "        else:",
+        "            raw = struct.pack('<HH', words[word] & 0xFFFF, words[word + 1] & 0xFFFF)",
+        "        value = struct.unpack('<' + _FORMATS[kind], raw)[0]",
+        "        values[name] = value * lsb if lsb is not None else value",
+        "    return values",
+        "",
+        "",
+        "def decode_frame(words, direction, worker=None):",
+        "    \"\"\"Decodes one chunk: header fields, CRC check and payload. The CRC of the setpoint and measurement",
+        "    of a worker is XORed with its id (CHUNK_KEY in system.h). Delta encoded measurements are returned as",
+        "    words, see delta_decode().\"\"\"",
+        "    if len(words) != CHUNKS[direction]:",
+        "        raise ValueError('%s frame must be %d words' % (direction, CHUNKS[direction]))",
+        "    return {",
+        "        'crc_ok': crc16(words[1:]) ^ (worker or 0) == words[0],",
+        "        'token': words[1],",
+        "        'time': words[2] | (words[3] << 16),",
+        "        'phase': words[4],",
+        "        'sync_ok': words[5] == FRAME_SYNC,",
+        "        'sample': words[6] | (words[7] << 16),",
+        "        'data': (list(words[FRAME_HEADER_WORDS:]) if direction == 'measurement' and MEASUREMENT_DELTA",
+        "                 else decode_payload(words[FRAME_HEADER_WORDS:], direction)),",
+        "        'mailbox': (decode_fragment(words[FRAME_HEADER_WORDS + MAILBOX[direction][0]:][:MAILBOX[direction][1]])",
+        "                    if MAILBOX and direction in MAILBOX else None),",
+        "    }",
+        "",
+        "",
+        "def decode_fragment(words):",
+        "    \"\"\"Decodes a mailbox fragment: control word fields and the words it carries.\"\"\"",
+        "    control = words[0]",
+        "    length = control >> 12",
+        "    return {",
+        "        'seq': control & 0xF,",
+        "        'ack': (control >> 4) & 0xF,",
+        "        'data': bool(control & 0x100),",
+        "        'first': bool(control & 0x200),",
+        "        'last': bool(control & 0x400),",
+        "        'busy': bool(control & 0x800),",
+        "        'words': list(words[1:1 + length]) if control & 0x100 else [],",
+        "    }",
+        "",
+        "",
+        "def delta_decode(encoded, view):",
+        "    \"\"\"Applies a delta encoded measurement payload to view (list of the decoded payload words, kept",
+        "    between frames, zeros initially). Returns False if the encoding is malformed.\"\"\"",
+        "    slots, refresh = MEASUREMENT_DELTA",
+        "    n = len(view)",
+        "    bitmap_words = (n + 15) // 16",
+        "    cursor = encoded[0]",
+        "    if cursor >= n:",
+        "        return False",
+        "    present = [i for i in range(n) if (encoded[1 + i // 16] >> (i % 16)) & 1]",
+        "    if len(present) > slots or any(encoded[1 + w] >> (n - 16 * w) for w in range(bitmap_words) if n - 16 * w < 16):",
+        "        return False",
+        "    for slot, i in enumerate(present):",
+        "        view[i] = encoded[1 + bitmap_words + slot]",
+        "    for j in range(refresh):",
+        "        view[(cursor + j) % n] = encoded[1 + bitmap_words + slots + j]",
+        "    return True",
+        "",
+        "",
+        "def director_offsets():",
+        "    \"\"\"Offsets of the chunks in the Director ring image (system.h), {(class, worker): offset}.\"\"\"",
+        "    offsets = {}",
+        "    if CHUNKS['broadcast']:",
+        "        offsets[('broadcast', None)] = 0",
+        "    for w in range(NUM_WORKERS):",
+        "        offsets[('setpoint', w)] = CHUNKS['broadcast'] + (NUM_WORKERS - 1 - w) * CHUNKS['setpoint']",
+        "        offsets[('measurement', w)] = (CHUNKS['broadcast'] + NUM_WORKERS * CHUNKS['setpoint']",
+        "                                       + (NUM_WORKERS - 1 - w) * CHUNKS['measurement'])",
+        "    return offsets",
+        "",
+        "",
+        "def decode_director_image(words):",
+        "    \"\"\"Decodes every chunk of a Director ring image, {(class, worker): frame}.\"\"\"",
+        "    return {key: decode_frame(words[offset:offset + CHUNKS[key[0]]], key[0], key[1])",
+        "            for key, offset in director_offsets().items()}",
+        "",
+    ]
+    return "\n".join(out)
+
+
+def write_if_changed(out, name, content):
+    path = os.path.join(out, name)
+    try:
+        with open(path, newline="") as f:
+            if f.read() == content:
+                return
+    except OSError:
+        pass
+    with open(path, "w", newline="\n") as f:
+        f.write(content)
+    print("pre_build: generated %s" % name)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generates the ring configuration from system.json.")
+    parser.add_argument("--config", default=CONFIG, help="system description (default: system.json)")
+    parser.add_argument("--out", default=HERE, help="output directory (default: next to this script)")
+    args = parser.parse_args()
+
+    try:
+        num_workers, fifo_level, signals, encoding, mailbox = load_config(args.config)
+    except (ConfigError, ValueError) as e:
+        print("pre_build: %s: %s" % (args.config, e), file=sys.stderr)
+        return 1
+
+    words = {d: pack(signals[d]) for d in DIRECTIONS}
+    delta = delta_layout(encoding, words["measurement"])
+    try:
+        if delta and not words["measurement"]:
+            raise ConfigError("delta measurement encoding needs measurement signals")
+        chunks = geometry(num_workers, fifo_level, words, delta, mailbox)
+    except ConfigError as e:
+        print("pre_build: %s: %s" % (args.config, e), file=sys.stderr)
+        return 1
+
+    os.makedirs(args.out, exist_ok=True)
+    write_if_changed(args.out, "system_config.h",
+                     gen_config(num_workers, fifo_level, signals, words, chunks, delta, mailbox))
+    write_if_changed(args.out, "signals.h", gen_header(signals, words))
+    write_if_changed(args.out, "signals.c", gen_tables(signals))
+    write_if_changed(args.out, "signals.py", gen_decoder(num_workers, fifo_level, signals, words, chunks, delta, mailbox))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,28 @@
+/* Generated by pre_build.py from system.json, do not edit. */
+
+#include "signals.h"
+
+const SignalInfo_t broadcastSignals[BROADCAST_NUM_SIGNALS] = {
+    { "enable", SIGNAL_BOOL, 2, 0, 0, 1.0f },
+    { "mode", SIGNAL_UINT16, 0, 0, 0, 1.0f },
+    { "v_dc_ref", SIGNAL_INT16, 1, 0, 15, 1000.0f },
+};
+
+const SignalInfo_t setpointSignals[SETPOINT_NUM_SIGNALS] = {
+    { "reset_faults", SIGNAL_BOOL, 4, 0, 0, 1.0f },
+    { "i_d_ref", SIGNAL_INT16, 2, 0, 15, 100.0f },
+    { "i_q_ref", SIGNAL_INT16, 3, 0, 15, 100.0f },
+    { "p_ref", SIGNAL_INT32, 0, 0, 8, 1.0f },
+};
+
+const SignalInfo_t measurementSignals[MEASUREMENT_NUM_SIGNALS] = {
+    { "running", SIGNAL_BOOL, 5, 0, 0, 1.0f },
+    { "ready", SIGNAL_BOOL, 5, 1, 0, 1.0f },
+    { "fault", SIGNAL_BOOL, 5, 2, 0, 1.0f },
+    { "fault_code", SIGNAL_UINT16, 2, 0, 0, 1.0f },
+    { "v_dc", SIGNAL_UINT16, 6, 0, 12, 1000.0f },
+    { "i_d", SIGNAL_INT16, 3, 0, 15, 100.0f },
+    { "i_q", SIGNAL_INT16, 4, 0, 15, 100.0f },
+    { "temperature", SIGNAL_UINT16, 7, 0, 12, 200.0f },
+    { "energy", SIGNAL_UINT32, 0, 0, 0, 1.0f },
+};
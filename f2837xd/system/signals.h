@@ -0,0 +1,307 @@
+/* Generated by pre_build.py from system.json, do not edit. */
+
+#ifndef SIGNALS_H
+#define SIGNALS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+
+typedef enum {
+    SIGNAL_BOOL,
+    SIGNAL_UINT16,
+    SIGNAL_INT16,
+    SIGNAL_UINT32,
+    SIGNAL_INT32,
+    SIGNAL_FLOAT32
+} SignalType_t;
+
+typedef struct {
+    const char   *Name;
+    SignalType_t  Type;
+    uint16_t      Word;     // Offset in the payload, in words
+    uint16_t      Bit;      // Bit in the word, booleans only
+    uint16_t      Q;        // Fractional bits
+    float         Scale;    // Engineering units of 1.0 in Q format
+} SignalInfo_t;
+
+// Broadcast payload, 3 words
+
+#define BROADCAST_ENABLE_WORD 2
+#define BROADCAST_ENABLE_BIT 0
+#define BROADCAST_MODE_WORD 0
+#define BROADCAST_V_DC_REF_WORD 1
+#define BROADCAST_V_DC_REF_LSB 0.030517578125f  // V per count
+#define BROADCAST_NUM_SIGNALS 3
+
+typedef struct {
+    uint16_t  mode;             // Operating mode
+    int16_t   v_dc_ref;         // DC link voltage reference
+    uint16_t  flags2;           // enable
+} BroadcastPayload_t;
+
+extern const SignalInfo_t broadcastSignals[BROADCAST_NUM_SIGNALS];
+
+// Converter enable
+static inline bool Broadcast_Get_enable(volatile const uint16_t *Payload) {
+    return (Payload[BROADCAST_ENABLE_WORD] >> BROADCAST_ENABLE_BIT) & 1U;
+}
+static inline void Broadcast_Set_enable(volatile uint16_t *Payload, bool Value) {
+    if (Value) Payload[BROADCAST_ENABLE_WORD] |= (1U << BROADCAST_ENABLE_BIT);
+    else Payload[BROADCAST_ENABLE_WORD] &= ~(1U << BROADCAST_ENABLE_BIT);
+}
+
+// Operating mode
+static inline uint16_t Broadcast_Get_mode(volatile const uint16_t *Payload) {
+    return (uint16_t)Payload[BROADCAST_MODE_WORD];
+}
+static inline void Broadcast_Set_mode(volatile uint16_t *Payload, uint16_t Value) {
+    Payload[BROADCAST_MODE_WORD] = (uint16_t)Value;
+}
+
+// DC link voltage reference [V]
+static inline int16_t Broadcast_Get_v_dc_ref(volatile const uint16_t *Payload) {
+    return (int16_t)Payload[BROADCAST_V_DC_REF_WORD];
+}
+static inline void Broadcast_Set_v_dc_ref(volatile uint16_t *Payload, int16_t Value) {
+    Payload[BROADCAST_V_DC_REF_WORD] = (uint16_t)Value;
+}
+static inline float Broadcast_Read_v_dc_ref(volatile const uint16_t *Payload) {
+    return (float)Broadcast_Get_v_dc_ref(Payload) * BROADCAST_V_DC_REF_LSB;
+}
+static inline void Broadcast_Write_v_dc_ref(volatile uint16_t *Payload, float Value) {
+    float counts = Value / BROADCAST_V_DC_REF_LSB;
+    if (counts >= (float)INT16_MAX) Broadcast_Set_v_dc_ref(Payload, INT16_MAX);
+    else if (counts <= (float)INT16_MIN) Broadcast_Set_v_dc_ref(Payload, INT16_MIN);
+    else Broadcast_Set_v_dc_ref(Payload, (int16_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Setpoint payload, 5 words
+
+#define SETPOINT_RESET_FAULTS_WORD 4
+#define SETPOINT_RESET_FAULTS_BIT 0
+#define SETPOINT_I_D_REF_WORD 2
+#define SETPOINT_I_D_REF_LSB 0.0030517578125f   // A per count
+#define SETPOINT_I_Q_REF_WORD 3
+#define SETPOINT_I_Q_REF_LSB 0.0030517578125f   // A per count
+#define SETPOINT_P_REF_WORD 0
+#define SETPOINT_P_REF_LSB 0.00390625f          // W per count
+#define SETPOINT_NUM_SIGNALS 4
+
+typedef struct {
+    int32_t   p_ref;            // Active power reference
+    int16_t   i_d_ref;          // Direct axis current reference
+    int16_t   i_q_ref;          // Quadrature axis current reference
+    uint16_t  flags4;           // reset_faults
+} SetpointPayload_t;
+
+extern const SignalInfo_t setpointSignals[SETPOINT_NUM_SIGNALS];
+
+// Clear latched faults
+static inline bool Setpoint_Get_reset_faults(volatile const uint16_t *Payload) {
+    return (Payload[SETPOINT_RESET_FAULTS_WORD] >> SETPOINT_RESET_FAULTS_BIT) & 1U;
+}
+static inline void Setpoint_Set_reset_faults(volatile uint16_t *Payload, bool Value) {
+    if (Value) Payload[SETPOINT_RESET_FAULTS_WORD] |= (1U << SETPOINT_RESET_FAULTS_BIT);
+    else Payload[SETPOINT_RESET_FAULTS_WORD] &= ~(1U << SETPOINT_RESET_FAULTS_BIT);
+}
+
+// Direct axis current reference [A]
+static inline int16_t Setpoint_Get_i_d_ref(volatile const uint16_t *Payload) {
+    return (int16_t)Payload[SETPOINT_I_D_REF_WORD];
+}
+static inline void Setpoint_Set_i_d_ref(volatile uint16_t *Payload, int16_t Value) {
+    Payload[SETPOINT_I_D_REF_WORD] = (uint16_t)Value;
+}
+static inline float Setpoint_Read_i_d_ref(volatile const uint16_t *Payload) {
+    return (float)Setpoint_Get_i_d_ref(Payload) * SETPOINT_I_D_REF_LSB;
+}
+static inline void Setpoint_Write_i_d_ref(volatile uint16_t *Payload, float Value) {
+    float counts = Value / SETPOINT_I_D_REF_LSB;
+    if (counts >= (float)INT16_MAX) Setpoint_Set_i_d_ref(Payload, INT16_MAX);
+    else if (counts <= (float)INT16_MIN) Setpoint_Set_i_d_ref(Payload, INT16_MIN);
+    else Setpoint_Set_i_d_ref(Payload, (int16_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Quadrature axis current reference [A]
+static inline int16_t Setpoint_Get_i_q_ref(volatile const uint16_t *Payload) {
+    return (int16_t)Payload[SETPOINT_I_Q_REF_WORD];
+}
+static inline void Setpoint_Set_i_q_ref(volatile uint16_t *Payload, int16_t Value) {
+    Payload[SETPOINT_I_Q_REF_WORD] = (uint16_t)Value;
+}
+static inline float Setpoint_Read_i_q_ref(volatile const uint16_t *Payload) {
+    return (float)Setpoint_Get_i_q_ref(Payload) * SETPOINT_I_Q_REF_LSB;
+}
+static inline void Setpoint_Write_i_q_ref(volatile uint16_t *Payload, float Value) {
+    float counts = Value / SETPOINT_I_Q_REF_LSB;
+    if (counts >= (float)INT16_MAX) Setpoint_Set_i_q_ref(Payload, INT16_MAX);
+    else if (counts <= (float)INT16_MIN) Setpoint_Set_i_q_ref(Payload, INT16_MIN);
+    else Setpoint_Set_i_q_ref(Payload, (int16_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Active power reference [W]
+static inline int32_t Setpoint_Get_p_ref(volatile const uint16_t *Payload) {
+    return (int32_t)(((uint32_t)Payload[SETPOINT_P_REF_WORD + 1] << 16) | Payload[SETPOINT_P_REF_WORD]);
+}
+static inline void Setpoint_Set_p_ref(volatile uint16_t *Payload, int32_t Value) {
+    Payload[SETPOINT_P_REF_WORD] = (uint16_t)((uint32_t)Value);
+    Payload[SETPOINT_P_REF_WORD + 1] = (uint16_t)((uint32_t)Value >> 16);
+}
+static inline float Setpoint_Read_p_ref(volatile const uint16_t *Payload) {
+    return (float)Setpoint_Get_p_ref(Payload) * SETPOINT_P_REF_LSB;
+}
+static inline void Setpoint_Write_p_ref(volatile uint16_t *Payload, float Value) {
+    float counts = Value / SETPOINT_P_REF_LSB;
+    if (counts >= (float)INT32_MAX) Setpoint_Set_p_ref(Payload, INT32_MAX);
+    else if (counts <= (float)INT32_MIN) Setpoint_Set_p_ref(Payload, INT32_MIN);
+    else Setpoint_Set_p_ref(Payload, (int32_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Measurement payload, 8 words
+
+#define MEASUREMENT_RUNNING_WORD 5
+#define MEASUREMENT_RUNNING_BIT 0
+#define MEASUREMENT_READY_WORD 5
+#define MEASUREMENT_READY_BIT 1
+#define MEASUREMENT_FAULT_WORD 5
+#define MEASUREMENT_FAULT_BIT 2
+#define MEASUREMENT_FAULT_CODE_WORD 2
+#define MEASUREMENT_V_DC_WORD 6
+#define MEASUREMENT_V_DC_ADC_SOC 0
+#define MEASUREMENT_V_DC_LSB 0.244140625f       // V per count
+#define MEASUREMENT_I_D_WORD 3
+#define MEASUREMENT_I_D_LSB 0.0030517578125f    // A per count
+#define MEASUREMENT_I_Q_WORD 4
+#define MEASUREMENT_I_Q_LSB 0.0030517578125f    // A per count
+#define MEASUREMENT_TEMPERATURE_WORD 7
+#define MEASUREMENT_TEMPERATURE_ADC_SOC 1
+#define MEASUREMENT_TEMPERATURE_LSB 0.048828125f// degC per count
+#define MEASUREMENT_ENERGY_WORD 0
+#define MEASUREMENT_NUM_SIGNALS 9
+
+typedef struct {
+    uint32_t  energy;           // Energy delivered
+    uint16_t  fault_code;       // First latched fault
+    int16_t   i_d;              // Direct axis current
+    int16_t   i_q;              // Quadrature axis current
+    uint16_t  v_dc;             // DC link voltage
+    uint16_t  temperature;      // Heatsink temperature
+    uint16_t  flags5;           // running, ready, fault
+} MeasurementPayload_t;
+
+extern const SignalInfo_t measurementSignals[MEASUREMENT_NUM_SIGNALS];
+
+// Converter switching
+static inline bool Measurement_Get_running(volatile const uint16_t *Payload) {
+    return (Payload[MEASUREMENT_RUNNING_WORD] >> MEASUREMENT_RUNNING_BIT) & 1U;
+}
+static inline void Measurement_Set_running(volatile uint16_t *Payload, bool Value) {
+    if (Value) Payload[MEASUREMENT_RUNNING_WORD] |= (1U << MEASUREMENT_RUNNING_BIT);
+    else Payload[MEASUREMENT_RUNNING_WORD] &= ~(1U << MEASUREMENT_RUNNING_BIT);
+}
+
+// Ready to be enabled
+static inline bool Measurement_Get_ready(volatile const uint16_t *Payload) {
+    return (Payload[MEASUREMENT_READY_WORD] >> MEASUREMENT_READY_BIT) & 1U;
+}
+static inline void Measurement_Set_ready(volatile uint16_t *Payload, bool Value) {
+    if (Value) Payload[MEASUREMENT_READY_WORD] |= (1U << MEASUREMENT_READY_BIT);
+    else Payload[MEASUREMENT_READY_WORD] &= ~(1U << MEASUREMENT_READY_BIT);
+}
+
+// Fault latched
+static inline bool Measurement_Get_fault(volatile const uint16_t *Payload) {
+    return (Payload[MEASUREMENT_FAULT_WORD] >> MEASUREMENT_FAULT_BIT) & 1U;
+}
+static inline void Measurement_Set_fault(volatile uint16_t *Payload, bool Value) {
+    if (Value) Payload[MEASUREMENT_FAULT_WORD] |= (1U << MEASUREMENT_FAULT_BIT);
+    else Payload[MEASUREMENT_FAULT_WORD] &= ~(1U << MEASUREMENT_FAULT_BIT);
+}
+
+// First latched fault
+static inline uint16_t Measurement_Get_fault_code(volatile const uint16_t *Payload) {
+    return (uint16_t)Payload[MEASUREMENT_FAULT_CODE_WORD];
+}
+static inline void Measurement_Set_fault_code(volatile uint16_t *Payload, uint16_t Value) {
+    Payload[MEASUREMENT_FAULT_CODE_WORD] = (uint16_t)Value;
+}
+
+// DC link voltage [V]
+static inline uint16_t Measurement_Get_v_dc(volatile const uint16_t *Payload) {
+    return (uint16_t)Payload[MEASUREMENT_V_DC_WORD];
+}
+static inline void Measurement_Set_v_dc(volatile uint16_t *Payload, uint16_t Value) {
+    Payload[MEASUREMENT_V_DC_WORD] = (uint16_t)Value;
+}
+static inline float Measurement_Read_v_dc(volatile const uint16_t *Payload) {
+    return (float)Measurement_Get_v_dc(Payload) * MEASUREMENT_V_DC_LSB;
+}
+static inline void Measurement_Write_v_dc(volatile uint16_t *Payload, float Value) {
+    float counts = Value / MEASUREMENT_V_DC_LSB;
+    if (counts >= (float)UINT16_MAX) Measurement_Set_v_dc(Payload, UINT16_MAX);
+    else if (counts <= (float)0) Measurement_Set_v_dc(Payload, 0);
+    else Measurement_Set_v_dc(Payload, (uint16_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Direct axis current [A]
+static inline int16_t Measurement_Get_i_d(volatile const uint16_t *Payload) {
+    return (int16_t)Payload[MEASUREMENT_I_D_WORD];
+}
+static inline void Measurement_Set_i_d(volatile uint16_t *Payload, int16_t Value) {
+    Payload[MEASUREMENT_I_D_WORD] = (uint16_t)Value;
+}
+static inline float Measurement_Read_i_d(volatile const uint16_t *Payload) {
+    return (float)Measurement_Get_i_d(Payload) * MEASUREMENT_I_D_LSB;
+}
+static inline void Measurement_Write_i_d(volatile uint16_t *Payload, float Value) {
+    float counts = Value / MEASUREMENT_I_D_LSB;
+    if (counts >= (float)INT16_MAX) Measurement_Set_i_d(Payload, INT16_MAX);
+    else if (counts <= (float)INT16_MIN) Measurement_Set_i_d(Payload, INT16_MIN);
+    else Measurement_Set_i_d(Payload, (int16_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Quadrature axis current [A]
+static inline int16_t Measurement_Get_i_q(volatile const uint16_t *Payload) {
+    return (int16_t)Payload[MEASUREMENT_I_Q_WORD];
+}
+static inline void Measurement_Set_i_q(volatile uint16_t *Payload, int16_t Value) {
+    Payload[MEASUREMENT_I_Q_WORD] = (uint16_t)Value;
+}
+static inline float Measurement_Read_i_q(volatile const uint16_t *Payload) {
+    return (float)Measurement_Get_i_q(Payload) * MEASUREMENT_I_Q_LSB;
+}
+static inline void Measurement_Write_i_q(volatile uint16_t *Payload, float Value) {
+    float counts = Value / MEASUREMENT_I_Q_LSB;
+    if (counts >= (float)INT16_MAX) Measurement_Set_i_q(Payload, INT16_MAX);
+    else if (counts <= (float)INT16_MIN) Measurement_Set_i_q(Payload, INT16_MIN);
+    else Measurement_Set_i_q(Payload, (int16_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Heatsink temperature [degC]
+static inline uint16_t Measurement_Get_temperature(volatile const uint16_t *Payload) {
+    return (uint16_t)Payload[MEASUREMENT_TEMPERATURE_WORD];
+}
+static inline void Measurement_Set_temperature(volatile uint16_t *Payload, uint16_t Value) {
+    Payload[MEASUREMENT_TEMPERATURE_WORD] = (uint16_t)Value;
+}
+static inline float Measurement_Read_temperature(volatile const uint16_t *Payload) {
+    return (float)Measurement_Get_temperature(Payload) * MEASUREMENT_TEMPERATURE_LSB;
+}
+static inline void Measurement_Write_temperature(volatile uint16_t *Payload, float Value) {
+    float counts = Value / MEASUREMENT_TEMPERATURE_LSB;
+    if (counts >= (float)UINT16_MAX) Measurement_Set_temperature(Payload, UINT16_MAX);
+    else if (counts <= (float)0) Measurement_Set_temperature(Payload, 0);
+    else Measurement_Set_temperature(Payload, (uint16_t)(counts + (counts < 0.0f ? -0.5f : 0.5f)));
+}
+
+// Energy delivered [Wh]
+static inline uint32_t Measurement_Get_energy(volatile const uint16_t *Payload) {
+    return (uint32_t)(((uint32_t)Payload[MEASUREMENT_ENERGY_WORD + 1] << 16) | Payload[MEASUREMENT_ENERGY_WORD]);
+}
+static inline void Measurement_Set_energy(volatile uint16_t *Payload, uint32_t Value) {
+    Payload[MEASUREMENT_ENERGY_WORD] = (uint16_t)((uint32_t)Value);
+    Payload[MEASUREMENT_ENERGY_WORD + 1] = (uint16_t)((uint32_t)Value >> 16);
+}
+
+#endif //SIGNALS_H
@@ -0,0 +1,149 @@
+"""
+Generated by pre_build.py from system.json, do not edit.
+
+Host-side decoder for ring frames. A frame is a list of 16-bit words as stored on
+the C28x (32-bit values low word first), one chunk of its frame class long.
+"""
+import struct
+
+NUM_WORKERS = 2
+FIFO_LVL = 8
+FRAME_HEADER_WORDS = 8
+FRAME_SYNC = 0x5A3C
+
+# Chunk length of each frame class, in words (no broadcast chunk if 0)
+CHUNKS = {'broadcast': 14, 'setpoint': 17, 'measurement': 24}
+
+# Delta encoded measurements (ring/DeltaCodec.h), None if raw: (delta slots, refresh words)
+MEASUREMENT_DELTA = None
+
+# Mailbox fragment (ring/Mailbox.h) in the payload, None if there is none: {class: (offset, words)}
+MAILBOX = {'setpoint': (5, 4), 'measurement': (8, 4)}
+
+# name: (type, word, bit, lsb or None, unit)
+BROADCAST_SIGNALS = {
+    'enable': ('bool', 2, 0, None, ''),
+    'mode': ('uint16', 0, 0, None, ''),
+    'v_dc_ref': ('int16', 1, 0, 0.030517578125, 'V'),
+}
+SETPOINT_SIGNALS = {
+    'reset_faults': ('bool', 4, 0, None, ''),
+    'i_d_ref': ('int16', 2, 0, 0.0030517578125, 'A'),
+    'i_q_ref': ('int16', 3, 0, 0.0030517578125, 'A'),
+    'p_ref': ('int32', 0, 0, 0.00390625, 'W'),
+}
+MEASUREMENT_SIGNALS = {
+    'running': ('bool', 5, 0, None, ''),
+    'ready': ('bool', 5, 1, None, ''),
+    'fault': ('bool', 5, 2, None, ''),
+    'fault_code': ('uint16', 2, 0, None, ''),
+    'v_dc': ('uint16', 6, 0, 0.244140625, 'V'),
+    'i_d': ('int16', 3, 0, 0.0030517578125, 'A'),
+    'i_q': ('int16', 4, 0, 0.0030517578125, 'A'),
+    'temperature': ('uint16', 7, 0, 0.048828125, 'degC'),
+    'energy': ('uint32', 0, 0, None, 'Wh'),
+}
+
+SIGNALS = {'broadcast': BROADCAST_SIGNALS, 'setpoint': SETPOINT_SIGNALS, 'measurement': MEASUREMENT_SIGNALS}
+
+_FORMATS = {'uint16': 'H', 'int16': 'h', 'uint32': 'I', 'int32': 'i', 'float32': 'f'}
+
+
+def crc16(words):
+    """CRC-16/CCITT-FALSE over 16-bit words, high byte first (crc.c crcFast)."""
+    crc = 0xFFFF
+    for w in words:
+        for byte in ((w >> 8) & 0xFF, w & 0xFF):
+            crc ^= byte << 8
+            for _ in range(8):
+                crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+                crc &= 0xFFFF
+    return crc
+
+
+def decode_payload(words, direction):
+    """Decodes a payload into {name: value}, scaled signals in engineering units."""
+    values = {}
+    for name, (kind, word, bit, lsb, unit) in SIGNALS[direction].items():
+        if kind == 'bool':
+            values[name] = bool((words[word] >> bit) & 1)
+            continue
+        if kind in ('uint16', 'int16'):
+            raw = struct.pack('<H', words[word] & 0xFFFF)
+        else:
+            raw = struct.pack('<HH', words[word] & 0xFFFF, words[word + 1] & 0xFFFF)
+        value = struct.unpack('<' + _FORMATS[kind], raw)[0]
+        values[name] = value * lsb if lsb is not None else value
+    return values
+
+
+def decode_frame(words, direction, worker=None):
+    """Decodes one chunk: header fields, CRC check and payload. The CRC of the setpoint and measurement
+    of a worker is XORed with its id (CHUNK_KEY in system.h). Delta encoded measurements are returned as
+    words, see delta_decode()."""
+    if len(words) != CHUNKS[direction]:
+        raise ValueError('%s frame must be %d words' % (direction, CHUNKS[direction]))
+    return {
+        'crc_ok': crc16(words[1:]) ^ (worker or 0) == words[0],
+        'token': words[1],
+        'time': words[2] | (words[3] << 16),
+        'phase': words[4],
+        'sync_ok': words[5] == FRAME_SYNC,
+        'sample': words[6] | (words[7] << 16),
+        'data': (list(words[FRAME_HEADER_WORDS:]) if direction == 'measurement' and MEASUREMENT_DELTA
+                 else decode_payload(words[FRAME_HEADER_WORDS:], direction)),
+        'mailbox': (decode_fragment(words[FRAME_HEADER_WORDS + MAILBOX[direction][0]:][:MAILBOX[direction][1]])
+                    if MAILBOX and direction in MAILBOX else None),
+    }
+
+
+def decode_fragment(words):
+    """Decodes a mailbox fragment: control word fields and the words it carries."""
+    control = words[0]
+    length = control >> 12
+    return {
+        'seq': control & 0xF,
+        'ack': (control >> 4) & 0xF,
+        'data': bool(control & 0x100),
+        'first': bool(control & 0x200),
+        'last': bool(control & 0x400),
+        'busy': bool(control & 0x800),
+        'words': list(words[1:1 + length]) if control & 0x100 else [],
+    }
+
+
+def delta_decode(encoded, view):
+    """Applies a delta encoded measurement payload to view (list of the decoded payload words, kept
+    between frames, zeros initially). Returns False if the encoding is malformed."""
+    slots, refresh = MEASUREMENT_DELTA
+    n = len(view)
+    bitmap_words = (n + 15) // 16
+    cursor = encoded[0]
+    if cursor >= n:
+        return False
+    present = [i for i in range(n) if (encoded[1 + i // 16] >> (i % 16)) & 1]
+    if len(present) > slots or any(encoded[1 + w] >> (n - 16 * w) for w in range(bitmap_words) if n - 16 * w < 16):
+        return False
+    for slot, i in enumerate(present):
+        view[i] = encoded[1 + bitmap_words + slot]
+    for j in range(refresh):
+        view[(cursor + j) % n] = encoded[1 + bitmap_words + slots + j]
+    return True
+
+
+def director_offsets():
+    """Offsets of the chunks in the Director ring image (system.h), {(class, worker): offset}."""
+    offsets = {}
+    if CHUNKS['broadcast']:
+        offsets[('broadcast', None)] = 0
+    for w in range(NUM_WORKERS):
+        offsets[('setpoint', w)] = CHUNKS['broadcast'] + (NUM_WORKERS - 1 - w) * CHUNKS['setpoint']
+        offsets[('measurement', w)] = (CHUNKS['broadcast'] + NUM_WORKERS * CHUNKS['setpoint']
+                                       + (NUM_WORKERS - 1 - w) * CHUNKS['measurement'])
+    return offsets
+
+
+def decode_director_image(words):
+    """Decodes every chunk of a Director ring image, {(class, worker): frame}."""
+    return {key: decode_frame(words[offset:offset + CHUNKS[key[0]]], key[0], key[1])
+            for key, offset in director_offsets().items()}
@@ -5,27 +5,107 @@
 
 #include <string.h>
 #include "crc.h"
+#include "system_config.h"  // NUM_WORKERS, FIFO_LVL, chunk sizes: generated from system.json by pre_build.py
 
-#define NUM_WORKERS 2
-#define CHUNK_SIZE 32
+// Ring image, in the order the Director shifts it out:
+//   [broadcast][setpoint N-1] .. [setpoint 0][measurement N-1] .. [measurement 0]
+// The broadcast chunk (references common to all workers) is read by every worker in transit, setpoint w only
+// by worker w. Each worker shifts its own measurement out first and delays the rest of the ring by one
+// measurement chunk, so the Director receives the measurements back at the start of the frame.
+#define MEM_BUFFER_SIZE (BROADCAST_CHUNK + NUM_WORKERS * (SETPOINT_CHUNK + MEASUREMENT_CHUNK))
 
-#define MEM_BUFFER_SIZE (2 * CHUNK_SIZE * NUM_WORKERS)
+// Words clocked per frame. The last worker has then received the last setpoint, and each worker k the
+// measurements of the workers after it, relayed by the Director as soon as they are received.
+#define RING_CLOCKED_WORDS (MEM_BUFFER_SIZE - MEASUREMENT_CHUNK)
 
-#define DATA_LEN (CHUNK_SIZE - sizeof(FrameHeader))
+// Chunk offsets in the Director image
+#define DIRECTOR_BROADCAST_OFFSET           0
+#define DIRECTOR_SETPOINT_OFFSET(w)         (BROADCAST_CHUNK + (NUM_WORKERS - 1 - (w)) * SETPOINT_CHUNK)
+#define DIRECTOR_MEASUREMENT_OFFSET(w)      (BROADCAST_CHUNK + NUM_WORKERS * SETPOINT_CHUNK + (NUM_WORKERS - 1 - (w)) * MEASUREMENT_CHUNK)
+
+// Chunk offsets in the image of worker k. Director offset x reaches worker k after k + 1 measurement chunks,
+// measurements of the workers up to k come from upstream in the same frame.
+#define WORKER_IMAGE_OFFSET(k, x)           (((k) + 1) * MEASUREMENT_CHUNK + (x))
+#define WORKER_BROADCAST_OFFSET(k)          WORKER_IMAGE_OFFSET(k, DIRECTOR_BROADCAST_OFFSET)
+#define WORKER_SETPOINT_OFFSET(k, w)        WORKER_IMAGE_OFFSET(k, DIRECTOR_SETPOINT_OFFSET(w))
+#define WORKER_MEASUREMENT_OFFSET(k, w)     ((w) <= (k) ? ((k) - (w)) * MEASUREMENT_CHUNK \
+                                                        : WORKER_IMAGE_OFFSET(k, DIRECTOR_MEASUREMENT_OFFSET(w)))
+
+// CPU1 divides LSPCLK by SYSTEM_LSPCLK_DIV after Device_init(), device.h assumes it undivided (DEVICE_LSPCLK_FREQ).
+// The SPI and SCI modules of both cores run from it.
+#define SYSTEM_LSPCLK_DIV   14U
+#define SYSTEM_LSPCLK_FREQ  (DEVICE_SYSCLK_FREQ / SYSTEM_LSPCLK_DIV)
+
+// Ring SPI clock, the slowest the SPI divides LSPCLK by: 14.29 MHz / 128 = 111.6 kbit/s, 143.4 us a word
+#define RING_SPI_BIT_RATE   (SYSTEM_LSPCLK_FREQ / 128U)
+
+// Size of a type in 16-bit words
+#define WORDS(x) (sizeof(x) / sizeof(uint16_t))
+
+#define DATA_LEN (CHUNK_SIZE - WORDS(FrameHeader))
+
+// Payload words of each frame class, including padding
+#define BROADCAST_DATA_LEN (BROADCAST_CHUNK ? BROADCAST_CHUNK - FRAME_HEADER_WORDS : 0)
+#define SETPOINT_DATA_LEN (SETPOINT_CHUNK - FRAME_HEADER_WORDS)
+#define MEASUREMENT_DATA_LEN (MEASUREMENT_CHUNK - FRAME_HEADER_WORDS)
+
+// The setpoint and measurement data end with MAILBOX_WORDS words of the mailbox channel (Mailbox.h), at
+// <class>_MAILBOX_OFFSET. With MEASUREMENT_DELTA the measurement payload is delta encoded (DeltaCodec.h), the
+// worker encodes from a raw copy and the Director decodes into a view of MEASUREMENT_WORDS words.
+
+// Marker in the header of every chunk, covered by its CRC
+#define FRAME_SYNC 0x5A3CU
+
+// Time in the broadcast and setpoint headers of a Director that has not launched a frame before, no launch is
+// stamped with it
+#define FRAME_TIME_NONE 0UL
 
 #define AFTER_CRC(frame) (((uint16_t *)frame) + 1)
 
+// CRC of a chunk, over everything after the CRC word
+#define FRAME_CRC(frame, chunk) crcFast(AFTER_CRC(frame), (chunk) - 1)
+
+// The CRC of the setpoint and measurement chunks of worker w is XORed with its key, so an intact chunk read in
+// the slot of another worker (a DMA stall, a slip) fails its CRC. Keys only differ in their low byte, no two of
+// them XOR to FW_CRC_XOR (FwUpdate.h).
+#define CHUNK_KEY(w) ((crc_t)(w))
+
+#define BROADCAST_CRC(frame) FRAME_CRC(frame, BROADCAST_CHUNK)
+#define SETPOINT_CRC(frame, w) ((crc_t)(FRAME_CRC(frame, SETPOINT_CHUNK) ^ CHUNK_KEY(w)))
+#define MEASUREMENT_CRC(frame, w) ((crc_t)(FRAME_CRC(frame, MEASUREMENT_CHUNK) ^ CHUNK_KEY(w)))
+
+// A chunk read a word or two off its place (a DMA stall, a slip) passes its CRC once in 65536, the broadcast as
+// well as a keyed one. Its sync word out of place fails it first.
+#define CHUNK_IN_PLACE(frame) ((frame)->hdr.sync == FRAME_SYNC)
+
 
 typedef struct _frameHeader  {
   crc_t crc; // MUST BE FIRST ELEMENT IN STRUCT
+  uint16_t token; // Cycle token. Set by the Director on broadcast and setpoints, echoed by the worker on its measurement
+  uint32_t time;  // Broadcast, setpoints: Director launch timestamp of the previous frame.
+                  // Measurements: worker's cluster time of the launch of the echoed frame, from its CS
+                  // falling edge less its path delay
+  uint16_t phase; // Broadcast: unused.
+                  // Setpoints: ticks from time to the next PWM carrier zero of the worker.
+                  // Measurements: residual carrier phase error of the worker, in TBCLK (int16_t)
+  uint16_t sync;  // FRAME_SYNC, marks the chunk start in a ring image that slipped (Realign.h)
+  uint32_t sample; // Broadcast, setpoints: unused.
+                   // Measurements: worker's cluster time of the ADC sampling instant of the payload (AdcCapture.h),
+                   // or of its hand-over by the algorithm core without ADC signals
 } FrameHeader;
 
 
+// Any chunk, only the first <class>_DATA_LEN words of data belong to it
 typedef struct _frame {
   FrameHeader hdr;
   uint16_t data[DATA_LEN];
 } Frame;
 
+// pre_build.py sizes the chunks from FRAME_HEADER_WORDS, and pads them so the DMA bursts divide the ring
+typedef char frameHeaderWordsCheck[(WORDS(FrameHeader) == FRAME_HEADER_WORDS) ? 1 : -1];
+typedef char ringRxBurstCheck[(RING_CLOCKED_WORDS % FIFO_LVL == 0 && (NUM_WORKERS * MEASUREMENT_CHUNK) % FIFO_LVL == 0) ? 1 : -1];
+typedef char ringTxBurstCheck[(RING_CLOCKED_WORDS % (16 - FIFO_LVL) == 0) ? 1 : -1];
+
 
 // DEBUG
 
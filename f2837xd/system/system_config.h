@@ -0,0 +1,39 @@
+/* Generated by pre_build.py from system.json, do not edit. */
+
+#ifndef SYSTEM_CONFIG_H
+#define SYSTEM_CONFIG_H
+
+#define NUM_WORKERS 2
+#define FIFO_LVL 8                     // SPI FIFO interrupt level, also the DMA burst length
+
+#define FRAME_HEADER_WORDS 8           // WORDS(FrameHeader)
+#define BROADCAST_WORDS 3              // Packed broadcast payload
+#define SETPOINT_WORDS 5               // Packed setpoint payload
+#define MEASUREMENT_WORDS 8            // Packed measurement payload
+
+// Chunk of each frame class: header, payload and padding. No broadcast chunk if 0.
+#define BROADCAST_CHUNK 14
+#define SETPOINT_CHUNK 17
+#define MEASUREMENT_CHUNK 24
+
+// Delta encoded measurements (DeltaCodec.h): changed words per frame, payload words refreshed per frame
+#define MEASUREMENT_DELTA 0
+#define MEASUREMENT_DELTA_SLOTS 0
+#define MEASUREMENT_REFRESH_WORDS 0
+
+// Slow mailbox channel (Mailbox.h): words per setpoint and measurement, and their offset in the data
+#define MAILBOX_WORDS 4
+#define SETPOINT_MAILBOX_OFFSET 5
+#define MEASUREMENT_MAILBOX_OFFSET 8
+
+// ADC sampled measurement words (AdcCapture.h), the last of the payload: their offset, the ADC module (0 to
+// 3: A to D) and the channel of each SOC. Moved in by the worker comms core, not published by the algorithm core.
+#define MEASUREMENT_ADC_WORDS 2
+#define MEASUREMENT_ADC_OFFSET 6
+#define MEASUREMENT_ADC_MODULE 0
+#define MEASUREMENT_ADC_CHANNELS 2, 3
+
+// Largest chunk or decoded measurement, size of the generic Frame view
+#define CHUNK_SIZE 24
+
+#endif //SYSTEM_CONFIG_H
@@ -0,0 +1,430 @@
+"""
+Cycle budget planner: wire time, CPU time per node and the highest frame rate
+of a ring configuration, from system.json.
+
+  budget.py plan [--config system.json] [--rate HZ | --period-us US] [--prearm]
+  budget.py check [--config system.json] [--frames N]
+
+plan takes the ring geometry pre_build.py generates from the configuration
+(workers, FIFO level, chunk sizes) and the costs of the "timing" section of
+system.json, and works out the frame as the Director and the workers run it:
+
+  wire      CS setup, the words clocked per frame, and the CS high gap
+  director  setpoints stamped while the frame is shifted out, each before the
+            TX DMA reads it; the RX DMA interrupt checks the measurements
+            before the next launch
+  worker    the RX DMA interrupt checks the frame after CS rises, then the
+            own measurement is prepared WORKER_PREPARE_LEAD_US (plus a carrier
+            period with ADC signals) before the next CS falling edge. Without
+            pre-armed DMA (--prearm), its CS interrupt starts the DMA before
+            the Director clocks
+  load      CPU and DMA time per frame plus the timer tick and the services,
+            at most max_load of the comms core
+
+The shortest period meeting all of them, rounded up to the soft timer
+granularity the Director frame timer runs at, gives the highest frame rate.
+A target rate or period that does not fit is rejected, exit status 1.
+
+"timing" in system.json, every key optional, costs in SYSCLK cycles:
+  spi_bit_rate      SPI clock of the ring in bit/s (firmware: RING_SPI_BIT_RATE,
+                    SYSCLK / 14 / 128 = 111607)
+  crc_call_cycles   crcFast() call and return
+  crc_word_cycles   crcFast() per word
+  isr_cycles        interrupt entry, exit and PIE acknowledge
+  rx_isr_cycles     RX DMA interrupt besides its CRCs: clock sync, phase
+                    trim, hand-over to CPU1 (workers report the whole of it as
+                    RxIsrMax in their link statistics)
+  tick_cycles       soft timer tick, timeBaseHandler() in Timers.c
+  event_cycles      dispatch of an event and its handler besides its CRCs
+  stamp_cycles      Director setpoint header besides its CRC
+  dma_burst_cycles  DMA burst overhead
+  dma_word_cycles   DMA word moved
+  cs_setup_us       CS falling to the first SCLK edge, left by the Director
+  cs_gap_us         shortest CS high time between frames
+  max_load          share of the comms core a node may be busy
+
+check validates the plan against the host ring simulator (sim/): it builds it
+at the planned period and compares the words and CS low time of a frame and
+what every node does per frame (interrupts, events, DMA bursts and words, CRC
+calls and words) with the plan, then runs it a timer step below the wire limit
+and expects the frames to run into each other. The simulated nodes take no
+time, so the cycle costs themselves are for on-target measurement: RxIsrMax
+and IsrLatencyMax in the link statistics, and the trace (trace.py).
+"""
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SIM = os.path.join(HERE, "..", "sim")
+sys.path.insert(0, os.path.join(HERE, "..", "system"))
+import pre_build
+
+# Must match the firmware, system.h: CPU1 sets the LSPCLK prescaler, the ring SPI divides LSPCLK by 128
+SYSCLK_HZ = 200000000
+LSPCLK_HZ = SYSCLK_HZ // 14
+RING_SPI_BIT_RATE = LSPCLK_HZ // 128
+
+TIMING = {
+    "spi_bit_rate": RING_SPI_BIT_RATE,
+    "crc_call_cycles": 24,
+    "crc_word_cycles": 9,
+    "isr_cycles": 110,          # cpuTimer0ISR() takes 540 to 560 ns
+    "rx_isr_cycles": 1500,
+    "tick_cycles": 560,         # timeBaseHandler() takes 2.8 us
+    "event_cycles": 200,
+    "stamp_cycles": 150,
+    "dma_burst_cycles": 2,
+    "dma_word_cycles": 4,
+    "cs_setup_us": 2.0,
+    "cs_gap_us": 2.0,
+    "max_load": 0.8,
+}
+
+# Must match the firmware
+TIMER_GRANULARITY_US = 100                      # Timers.h
+TX_PREFILL_WORDS = 16                           # director_main_cpu2.c
+WORKER_PREPARE_LEAD_US = 20                     # worker_main_cpu2.c
+PWM_CARRIER_US = 10000 * 1e6 / SYSCLK_HZ        # PWM_CARRIER_TICKS in PhaseAlign.h
+DIRECTOR_SERVICES_HZ = 1 + 100 + 200            # Latency export, mailbox and telemetry timers
+WORKER_SERVICES_HZ = 2 + 100 + 1000             # Inner loop, mailbox and firmware update timers
+TICK_HZ = 1000000 // TIMER_GRANULARITY_US
+
+# Must match the simulator, ringsim.c takes the SPI clock the firmware sets up
+SIM_SPI_BIT_RATE = RING_SPI_BIT_RATE
+SIM_CS_SETUP_US = 64 * 1e6 / SYSCLK_HZ         # CS_SETUP_TICKS, the CS hops aside
+
+
+class ConfigError(Exception):
+    pass
+
+
+def us(cycles):
+    return cycles * 1e6 / SYSCLK_HZ
+
+
+def load_timing(path):
+    with open(path) as f:
+        timing = json.load(f).get("timing", {})
+    unknown = sorted(set(timing) - set(TIMING))
+    if unknown:
+        raise ConfigError("unknown timing key '%s'" % unknown[0])
+    timing = dict(TIMING, **timing)
+    for key, value in timing.items():
+        if not isinstance(value, (int, float)) or value < 0 or (value == 0 and not key.startswith("cs_")):
+            raise ConfigError("timing %s must be a positive number" % key)
+    if timing["max_load"] > 1:
+        raise ConfigError("timing max_load must be at most 1")
+    return timing
+
+
+def load_ring(path):
+    """Ring geometry as pre_build.py generates it."""
+    try:
+        num_workers, fifo_level, signals, encoding, mailbox = pre_build.load_config(path)
+        words = {d: pre_build.pack(signals[d]) for d in pre_build.DIRECTIONS}
+        delta = pre_build.delta_layout(encoding, words["measurement"])
+        chunks = pre_build.geometry(num_workers, fifo_level, words, delta, mailbox)
+    except pre_build.ConfigError as e:
+        raise ConfigError(str(e))
+    n, b, p, m = num_workers, chunks["broadcast"], chunks["setpoint"], chunks["measurement"]
+    return {
+        "workers": n, "fifo_level": fifo_level, "broadcast": b, "setpoint": p, "measurement": m,
+        "clocked": b + n * p + (n - 1) * m,
+        "adc": len(pre_build.adc_signals(signals["measurement"])),
+        "setpoint_words": words["setpoint"],
+        "measurement_words": words["measurement"],
+    }
+
+
+def frame_counts(ring):
+    """What each node does per control frame, as the simulator counts it (SimCounters_t): interrupts, events
+    posted, DMA bursts and words, crcFast() calls and words. Chunk CRCs cover the chunk but its CRC word."""
+    n, level, b, p, m, clocked = (ring[k] for k in ("workers", "fifo_level", "broadcast", "setpoint", "measurement",
+                                                     "clocked"))
+    tx = 16 - level
+    crc_calls = (1 if b else 0) + n + n
+    crc_words = (b - 1 if b else 0) + n * (p - 1) + n * (m - 1)
+
+    # CoreLink moves the published payloads one word per burst
+    director_mover = (b - pre_build.FRAME_HEADER_WORDS if b else 0) + n * ring["setpoint_words"]
+    worker_mover = ring["measurement_words"] - ring["adc"]
+
+    director = {
+        "Interrupts": 2,                        # TX and RX DMA
+        "Events": 1,                            # Frame timer
+        "DmaBursts": clocked // tx + n * m // level + director_mover,
+        "DmaWords": clocked + n * m + director_mover,
+        "CrcCalls": crc_calls,
+        "CrcWords": crc_words,
+        "Mover": director_mover,
+    }
+    worker = {
+        "Interrupts": 5 + (1 if ring["adc"] else 0),   # CS falling and rising, TX and RX DMA, prepare timer, ADC DMA
+        "Events": 0,
+        "DmaBursts": clocked // tx + clocked // level + (1 if ring["adc"] else 0) + worker_mover,
+        "DmaWords": 2 * clocked + ring["adc"] + worker_mover,
+        "CrcCalls": crc_calls,
+        "CrcWords": crc_words,
+        "Mover": worker_mover,
+    }
+    return director, worker
+
+
+def second_counts(services):
+    """Interrupts and events per second besides the frames: the soft timer tick and the service timers."""
+    return {"Interrupts": TICK_HZ, "Events": TICK_HZ + services}
+
+
+def plan(ring, t, prearm=False):
+    n, level, b, p, m = (ring[k] for k in ("workers", "fifo_level", "broadcast", "setpoint", "measurement"))
+    director, worker = frame_counts(ring)
+
+    def crc(words):
+        return t["crc_call_cycles"] + words * t["crc_word_cycles"]
+
+    def mover(words):
+        return words * (t["dma_burst_cycles"] + t["dma_word_cycles"])
+
+    def dma(counts):
+        bursts = counts["DmaBursts"] - counts["Mover"]
+        return bursts * t["dma_burst_cycles"] + (counts["DmaWords"] - counts["Mover"]) * t["dma_word_cycles"]
+
+    word_us = 16e6 / t["spi_bit_rate"]
+    cs_low = t["cs_setup_us"] + (ring["clocked"] + 0.5 / 16) * word_us
+
+    # Director: the RX DMA interrupt ends a frame once the last measurement is in
+    stamp = t["stamp_cycles"] + crc(p - 1)
+    director_rx = t["isr_cycles"] + t["rx_isr_cycles"] + n * crc(m - 1)
+    director_cpu = (director["Interrupts"] * t["isr_cycles"] + t["rx_isr_cycles"] + t["event_cycles"] +
+                    director["CrcCalls"] * t["crc_call_cycles"] + director["CrcWords"] * t["crc_word_cycles"] +
+                    n * t["stamp_cycles"] + mover(director["Mover"]))
+
+    # Setpoints are stamped from worker N - 1 down to 0 in ring order, those beyond the TX prefill after the launch.
+    # The TX DMA reads a burst once the FIFO is down to FIFO_LVL words.
+    stamping = None
+    done = 0.0
+    for w in range(n - 1, -1, -1):
+        offset = b + (n - 1 - w) * p
+        if offset < TX_PREFILL_WORDS:
+            continue
+        done += us(stamp)
+        start = offset // (16 - level) * (16 - level)
+        deadline = max(start - level, 0) * word_us
+        if stamping is None or deadline - done < stamping[1] - stamping[0]:
+            stamping = (done, deadline)
+
+    # Worker: the RX DMA interrupt runs after the CS rising edge, the prepare hook a lead before the next frame
+    worker_rx = 2 * t["isr_cycles"] + t["rx_isr_cycles"] + (crc(b - 1) if b else 0) + n * crc(p - 1) + \
+        (n - 1) * crc(m - 1)
+    prepare = t["isr_cycles"] * (2 if ring["adc"] else 1) + mover(worker["Mover"]) + crc(m - 1)
+    lead = WORKER_PREPARE_LEAD_US + (PWM_CARRIER_US if ring["adc"] else 0)
+    worker_cpu = (worker["Interrupts"] * t["isr_cycles"] + t["rx_isr_cycles"] +
+                  worker["CrcCalls"] * t["crc_call_cycles"] + worker["CrcWords"] * t["crc_word_cycles"] +
+                  mover(worker["Mover"]))
+    # The CS falling interrupt may wait for the longest short one (the tick), then fills the TX FIFO
+    setup = 2 * t["isr_cycles"] + t["dma_burst_cycles"] + (16 - level) * t["dma_word_cycles"]
+
+    nodes = []
+    for name, counts, cpu, services in (("director", director, director_cpu, DIRECTOR_SERVICES_HZ),
+                                        ("worker", worker, worker_cpu, WORKER_SERVICES_HZ)):
+        background = TICK_HZ * (t["isr_cycles"] + t["tick_cycles"]) + services * t["event_cycles"]
+        nodes.append({"name": name, "counts": counts, "cpu_us": us(cpu), "dma_us": us(dma(counts)),
+                      "background": background / SYSCLK_HZ})
+
+    limits = [
+        ("wire", cs_low + t["cs_gap_us"]),
+        ("director RX", cs_low + us(director_rx)),
+        ("worker RX and prepare", cs_low + us(worker_rx) + lead),
+    ]
+    for node in nodes:
+        spare = t["max_load"] - node["background"]
+        period = (node["cpu_us"] + node["dma_us"]) / spare if spare > 0 else math.inf
+        limits.append(("%s load" % node["name"], period))
+
+    checks = [("worker prepare", us(prepare), float(WORKER_PREPARE_LEAD_US))]
+    if stamping is not None:
+        checks.append(("setpoint stamping", stamping[0], stamping[1]))
+    if not prearm:
+        checks.append(("worker CS setup", us(setup), t["cs_setup_us"]))
+
+    bound, shortest = max(limits, key=lambda l: l[1])
+    period = timer_period(shortest) if shortest < math.inf else math.inf
+    return {"word_us": word_us, "cs_low_us": cs_low, "nodes": nodes, "limits": limits, "checks": checks,
+            "bound": bound, "shortest_us": shortest, "period_us": period,
+            "feasible": all(need <= have for _, need, have in checks) and period < math.inf}
+
+
+def timer_period(period_us):
+    """Period of the Director frame timer started with period_us: it expires on a tick."""
+    return math.ceil(period_us / TIMER_GRANULARITY_US) * TIMER_GRANULARITY_US
+
+
+def report(config, ring, t, result):
+    print("budget: %s, %d workers, FIFO level %d, chunks B %d S %d M %d, %d words clocked per frame" %
+          (config, ring["workers"], ring["fifo_level"], ring["broadcast"], ring["setpoint"], ring["measurement"],
+           ring["clocked"]))
+    print("wire:   SPI %d bit/s, %.2f us per word, CS low %.1f us, %.1f us with the CS gap" %
+          (t["spi_bit_rate"], result["word_us"], result["cs_low_us"], result["cs_low_us"] + t["cs_gap_us"]))
+
+    print("\n%-26s%12s%12s" % ("per frame", "director", "worker"))
+    for key in ("Interrupts", "Events", "DmaBursts", "DmaWords", "CrcCalls", "CrcWords"):
+        print("%-26s%12d%12d" % (key, result["nodes"][0]["counts"][key], result["nodes"][1]["counts"][key]))
+    print("%-26s%12.1f%12.1f" % ("CPU us", result["nodes"][0]["cpu_us"], result["nodes"][1]["cpu_us"]))
+    print("%-26s%12.1f%12.1f" % ("DMA us", result["nodes"][0]["dma_us"], result["nodes"][1]["dma_us"]))
+    print("%-26s%11.1f%%%11.1f%%" % ("ticks and services", 100 * result["nodes"][0]["background"],
+                                     100 * result["nodes"][1]["background"]))
+
+    print("\n%-26s%12s" % ("shortest period", "us"))
+    for name, period in result["limits"]:
+        print("%-26s%12.1f%s" % (name, period, "  <" if name == result["bound"] else ""))
+    print("\n%-26s%12s%12s" % ("within the frame", "need us", "have us"))
+    for name, need, have in result["checks"]:
+        print("%-26s%12.1f%12.1f%s" % (name, need, have, "" if need <= have else "  FAILS"))
+
+    if result["feasible"]:
+        print("\nmax frame rate %.1f Hz: period %d us (%d us timer steps), bound by %s" %
+              (1e6 / result["period_us"], result["period_us"], TIMER_GRANULARITY_US, result["bound"]))
+    elif result["period_us"] == math.inf:
+        print("\nno frame rate: the ticks and services alone take more than max_load")
+    else:
+        print("\nno frame rate: %s does not fit within the frame" %
+              ", ".join(name for name, need, have in result["checks"] if need > have))
+
+
+def plan_command(config, rate, period_us, prearm):
+    try:
+        ring = load_ring(config)
+        t = load_timing(config)
+    except (ConfigError, OSError, ValueError) as e:
+        print("budget: %s: %s" % (config, e), file=sys.stderr)
+        return 1
+    result = plan(ring, t, prearm)
+    report(config, ring, t, result)
+    if not result["feasible"]:
+        return 1
+
+    if rate is not None:
+        # The longest timer period at least as fast as the target
+        period_us = math.floor(1e6 / rate / TIMER_GRANULARITY_US) * TIMER_GRANULARITY_US
+        target = "%.1f Hz" % rate
+    elif period_us is not None:
+        period_us = timer_period(period_us)
+        target = "%d us" % period_us
+    else:
+        return 0
+    if period_us < result["period_us"]:
+        print("target %s: rejected, the period must be at least %d us (%s)" %
+              (target, result["period_us"], result["bound"]))
+        return 1
+    print("target %s: DIRECTOR_FRAME_PERIOD_US %d, %.0f%% of the period left" %
+          (target, period_us, 100.0 * (period_us - result["shortest_us"]) / period_us))
+    return 0
+
+
+def simulate(config, period_us, frames, build):
+    """Builds the simulator for config at period_us and runs it. Returns the JSON report, or None if the
+    simulator gave up on the ring. The period is built in, each one has its own build directory."""
+    build = os.path.join(build, "%dus" % period_us)
+    subprocess.run(["make", "-s", "-C", SIM, "BUILD=" + build, "CONFIG=" + os.path.abspath(config),
+                    "PERIOD_US=%d" % period_us], check=True, stdout=subprocess.DEVNULL)
+    run = subprocess.run([os.path.join(build, "ringsim"), "--dir", build, "--frames", str(frames), "--json"],
+                         stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, universal_newlines=True)
+    return json.loads(run.stdout) if run.returncode == 0 else None
+
+
+def link_errors(sim):
+    return sum(v for node in sim["nodes"] for k, v in node["link_stats"].items()
+               if "Errors" in k or k in ("CsOverruns", "DmaOverruns", "ShortFrames", "LateChunks")) + \
+        sum(node["cpu1"]["Mismatches"] for node in sim["nodes"])
+
+
+def check_command(config, frames, build):
+    try:
+        ring = load_ring(config)
+        t = load_timing(config)
+    except (ConfigError, OSError, ValueError) as e:
+        print("budget: %s: %s" % (config, e), file=sys.stderr)
+        return 1
+    if t["spi_bit_rate"] != SIM_SPI_BIT_RATE:
+        print("budget: the simulator runs the firmware SPI clock, %d bit/s, not %d" %
+              (SIM_SPI_BIT_RATE, t["spi_bit_rate"]))
+    t = dict(t, spi_bit_rate=SIM_SPI_BIT_RATE, cs_setup_us=SIM_CS_SETUP_US)
+    # The simulated nodes take no time, what happens within the frame does not depend on the period
+    result = plan(ring, t)
+    if result["period_us"] == math.inf:
+        print("budget: no frame rate to check, the nodes are busy all the time")
+        return 1
+    build = os.path.abspath(build)
+    failed = 0
+
+    def compare(name, planned, simulated, tolerance):
+        nonlocal failed
+        ok = abs(simulated - planned) <= tolerance * max(abs(planned), 1.0)
+        failed += not ok
+        print("%-26s%12.2f%12.2f%s" % (name, planned, simulated, "" if ok else "  DIFFERS"))
+
+    period = result["period_us"]
+    print("budget: simulating %d frames at the planned period, %d us" % (frames, period))
+    sim = simulate(config, period, frames, build)
+    if sim is None:
+        print("budget: the simulator gave up at %d us" % period)
+        return 1
+    print("\n%-26s%12s%12s" % ("", "planned", "simulated"))
+    compare("words per frame", ring["clocked"], sim["words_per_frame"]["avg"], 0.0)
+    compare("CS low us", result["cs_low_us"], sim["cs_low_ticks"]["avg"] * 1e6 / SYSCLK_HZ, 0.005)
+    compare("period us", period, sim["period_ticks"]["avg"] * 1e6 / SYSCLK_HZ, 0.005)
+    director, worker = frame_counts(ring)
+    n = sim["frames"]
+    for node in sim["nodes"]:
+        counts, services = (director, DIRECTOR_SERVICES_HZ) if node["name"] == "director" else \
+            (worker, WORKER_SERVICES_HZ)
+        per_second = second_counts(services)
+        for key in ("Interrupts", "Events", "DmaBursts", "DmaWords", "CrcCalls", "CrcWords"):
+            planned = counts[key] + per_second.get(key, 0) * period / 1e6
+            compare("%s %s" % (node["name"], key), planned, node["counters"][key] / n, 0.01)
+    errors = link_errors(sim)
+    failed += errors != 0
+    print("%-26s%12d%12d%s" % ("link errors", 0, errors, "" if errors == 0 else "  DIFFERS"))
+
+    # Nor does the period of the simulated ring depend on anything but the wire
+    wire = result["limits"][0][1]
+    below = timer_period(wire) - TIMER_GRANULARITY_US
+    if below > 0:
+        sim = simulate(config, below, frames, build)
+        broke = sim is None or link_errors(sim) != 0 or sim["words_per_frame"]["max"] != ring["clocked"]
+        failed += not broke
+        print("\nbelow the wire limit, %d us: %s" %
+              (below, "frames run into each other, as planned" if broke else "the ring still runs, the plan is wrong"))
+
+    print("\nbudget: %s" % ("simulation matches the plan" if not failed else "%d differences" % failed))
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Cycle budget of a ring configuration (system.json).")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("plan", help="wire and CPU time per frame, highest frame rate")
+    p.add_argument("--config", default=pre_build.CONFIG)
+    target = p.add_mutually_exclusive_group()
+    target.add_argument("--rate", type=float, help="frame rate to meet, in Hz")
+    target.add_argument("--period-us", type=float, help="Director frame period to meet")
+    p.add_argument("--prearm", action="store_true", help="workers built with WORKER_DMA_PREARM")
+
+    p = sub.add_parser("check", help="validate the plan against the host ring simulator")
+    p.add_argument("--config", default=pre_build.CONFIG)
+    p.add_argument("--frames", type=int, default=2000)
+    p.add_argument("--build", default=os.path.join(SIM, "build", "budget"), help="simulator build directory")
+
+    args = parser.parse_args()
+    if args.command == "plan":
+        return plan_command(args.config, args.rate, args.period_us, args.prearm)
+    return check_command(args.config, args.frames, args.build)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
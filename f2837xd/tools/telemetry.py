@@ -0,0 +1,320 @@
+"""
+Telemetry receiver for the Director measurement stream, see
+Communications/Director_comms_cpu2/Telemetry.h.
+
+  telemetry.py record PORT -o run.tlm [--decimation N] [--workers 0,1] [--words v_dc,i_d]
+  telemetry.py dump run.tlm > run.csv
+  telemetry.py loopback [--seconds S] [--unthrottled]
+
+record selects what the Director streams, then writes every frame that passes
+its CRC to the output file as received, until interrupted or --seconds. PORT is
+a serial port (pyserial, for the 892857 baud of the Director), a pty or FIFO,
+or - for stdin. Once per second it prints the throughput and the frames lost
+to CRC errors or dropped by the Director (gaps in the sequence numbers).
+
+dump decodes a recording to CSV, one row per frame and one column per signal of
+system/signals.py entirely covered by the selected words.
+
+loopback plays the Director through a pty, at the line rate or as fast as
+possible, with a corrupted byte now and then, and records from it as record
+does from a port; it reports the throughput sustained by the receiver.
+"""
+import argparse
+import binascii
+import os
+import random
+import struct
+import sys
+import threading
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "system"))
+try:
+    import signals
+except ImportError:
+    signals = None
+
+# Must match Telemetry.h
+SYNC = 0x5AA5
+SYNC_BYTES = struct.pack("<H", SYNC)
+HEADER_WORDS = 8
+BAUD = 892857
+MAX_MASK_BITS = 16
+
+
+def crc16(words):
+    """crc.c crcFast: CRC-16/CCITT-FALSE over the words, high byte first."""
+    return binascii.crc_hqx(struct.pack(">%dH" % len(words), *words), 0xFFFF)
+
+
+def bits(mask):
+    return [i for i in range(MAX_MASK_BITS) if (mask >> i) & 1]
+
+
+def signal_words(kind, word):
+    return [word, word + 1] if kind in ("int32", "uint32", "float32") else [word]
+
+
+def payload_words():
+    """MEASUREMENT_WORDS, the packed measurement payload."""
+    if not signals:
+        return MAX_MASK_BITS
+    return max(w for kind, word in (v[:2] for v in signals.MEASUREMENT_SIGNALS.values())
+               for w in signal_words(kind, word)) + 1
+
+
+def encode_frame(seq, token, launch, valid, workers, words, data):
+    frame = [seq & 0xFFFF, token & 0xFFFF, launch & 0xFFFF, (launch >> 16) & 0xFFFF, valid, workers, words] + list(data)
+    return struct.pack("<%dH" % (len(frame) + 2), SYNC, *frame, crc16(frame))
+
+
+def encode_command(decimation, workers, words):
+    command = [decimation, workers, words]
+    return struct.pack("<5H", SYNC, *command, crc16(command))
+
+
+class Stream:
+    """Splits a byte stream into frames, resynchronizing on the sync word after errors."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.frames = 0
+        self.crc_errors = 0
+        self.missed = 0
+        self.last_seq = None
+
+    def feed(self, data):
+        """Returns the frames completed by data, as (raw bytes, header dict, payload words)."""
+        self.buffer += data
+        frames = []
+        buf = self.buffer
+        at = 0
+        while True:
+            at = buf.find(SYNC_BYTES, at)
+            if at < 0:
+                at = max(len(buf) - 1, 0)
+                break
+            if len(buf) - at < 2 * HEADER_WORDS:
+                break
+            seq, token, lo, hi, valid, workers, words = struct.unpack_from("<7H", buf, at + 2)
+            length = HEADER_WORDS + len(bits(workers)) * len(bits(words)) + 1
+            if len(buf) - at < 2 * length:
+                break
+            body = struct.unpack_from("<%dH" % (length - 1), buf, at + 2)
+            if crc16(body[:-1]) != body[-1]:
+                self.crc_errors += 1
+                at += 1
+                continue
+            raw = bytes(buf[at:at + 2 * length])
+            at += 2 * length
+            if self.last_seq is not None:
+                self.missed += (seq - self.last_seq - 1) & 0xFFFF
+            self.last_seq = seq
+            self.frames += 1
+            header = {"seq": seq, "token": token, "time": lo | (hi << 16), "valid": valid,
+                      "workers": workers, "words": words}
+            frames.append((raw, header, body[HEADER_WORDS - 1:-1]))
+        del buf[:at]
+        return frames
+
+
+def open_port(port, baud):
+    """Returns (read(n), write(bytes) or None, close())."""
+    if port == "-":
+        fd = sys.stdin.buffer.fileno()
+        return (lambda n: os.read(fd, n)), None, (lambda: None)
+    try:
+        import serial
+    except ImportError:
+        serial = None
+    if serial is not None and not port.startswith("/dev/pts/"):
+        s = serial.Serial(port, baud, timeout=0.1)
+        return s.read, s.write, s.close
+    # pty, FIFO, or serial port without pyserial: the baud rate is left alone
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    try:
+        import tty
+        tty.setraw(fd)
+    except Exception:
+        pass
+    return (lambda n: os.read(fd, n)), (lambda b: os.write(fd, b)), (lambda: os.close(fd))
+
+
+def parse_words(spec):
+    """Measurement payload words from "all", indices and ranges, or signal names."""
+    if spec == "all":
+        return (1 << payload_words()) - 1
+    mask = 0
+    for item in spec.split(","):
+        if signals and item in signals.MEASUREMENT_SIGNALS:
+            mask |= sum(1 << w for w in signal_words(*signals.MEASUREMENT_SIGNALS[item][:2]))
+        elif "-" in item:
+            first, last = (int(x) for x in item.split("-"))
+            mask |= ((1 << (last + 1)) - 1) & ~((1 << first) - 1)
+        else:
+            mask |= 1 << int(item)
+    return mask
+
+
+def record(port, output, baud, seconds, selection, report=print):
+    read, write, close = open_port(port, baud)
+    if selection is not None and write is not None:
+        write(encode_command(*selection))
+    stream = Stream()
+    received = 0
+    start = last = time.monotonic()
+    try:
+        with open(output, "wb") as f:
+            while seconds is None or time.monotonic() - start < seconds:
+                data = read(4096)
+                if not data:
+                    if port == "-":
+                        break
+                    continue
+                received += len(data)
+                for raw, header, payload in stream.feed(data):
+                    f.write(raw)
+                now = time.monotonic()
+                if now - last >= 1.0:
+                    last = now
+                    report_stats(stream, received, now - start, report)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        close()
+    elapsed = time.monotonic() - start
+    report_stats(stream, received, elapsed, report)
+    return stream, received, elapsed
+
+
+def report_stats(stream, received, elapsed, report):
+    elapsed = max(elapsed, 1e-9)
+    report("telemetry: %.1f s, %d frames (%.0f/s), %.1f kB/s, %d CRC errors, %d missed" %
+           (elapsed, stream.frames, stream.frames / elapsed, received / elapsed / 1000.0,
+            stream.crc_errors, stream.missed))
+
+
+def dump(path):
+    with open(path, "rb") as f:
+        frames = Stream().feed(f.read())
+    ordered = sorted(signals.MEASUREMENT_SIGNALS.items(), key=lambda x: (x[1][1], x[1][2])) if signals else []
+    columns = None
+    out = sys.stdout
+    for raw, header, payload in frames:
+        workers, words = bits(header["workers"]), bits(header["words"])
+        row = [header["seq"], header["token"], header["time"], header["valid"]]
+        names = []
+        for k, w in enumerate(workers):
+            chunk = payload[k * len(words):(k + 1) * len(words)]
+            if signals:
+                full = [0] * MAX_MASK_BITS
+                for i, value in zip(words, chunk):
+                    full[i] = value
+                values = signals.decode_payload(full, "measurement")
+                for name, spec in ordered:
+                    if all(i in words for i in signal_words(*spec[:2])):
+                        names.append("w%d.%s" % (w, name))
+                        row.append(values[name])
+            else:
+                for i, value in zip(words, chunk):
+                    names.append("w%d.word%d" % (w, i))
+                    row.append(value)
+        if names != columns:
+            columns = names
+            out.write(",".join(["seq", "token", "time", "valid"] + names) + "\n")
+        out.write(",".join(str(v) for v in row) + "\n")
+    return 0
+
+
+def loopback(seconds, unthrottled, corrupt):
+    """Plays the Director through a pty and records from it."""
+    master, slave = os.openpty()
+    path = os.ttyname(slave)
+    stop = threading.Event()
+    sent = {"frames": 0, "corrupted": 0}
+    workers, words = 0x3, 0x7F
+    rng = random.Random(1)
+
+    def director():
+        seq = 0
+        due = time.monotonic()
+        while not stop.is_set():
+            batch = bytearray()
+            for _ in range(64):
+                data = [(seq * 7 + i) & 0xFFFF for i in range(len(bits(workers)) * len(bits(words)))]
+                frame = bytearray(encode_frame(seq, seq, seq * 20000, workers, workers, words, data))
+                if corrupt and rng.random() < corrupt:
+                    frame[rng.randrange(len(frame))] ^= 0x10
+                    sent["corrupted"] += 1
+                batch += frame
+                seq += 1
+            if not unthrottled:
+                # 10 bits per byte on the line
+                due += len(batch) * 10.0 / BAUD
+                time.sleep(max(due - time.monotonic(), 0.0))
+            try:
+                os.write(master, batch)
+            except OSError:
+                return
+            sent["frames"] += 64
+
+    thread = threading.Thread(target=director, daemon=True)
+    thread.start()
+    output = os.devnull
+    stream, received, elapsed = record(path, output, BAUD, seconds, None, report=lambda s: None)
+    stop.set()
+    thread.join(1.0)
+    os.close(master)
+    os.close(slave)
+
+    frame_bytes = 2 * (HEADER_WORDS + len(bits(workers)) * len(bits(words)) + 1)
+    print("telemetry: loopback %s, %d byte frames" % ("unthrottled" if unthrottled else "at %d baud" % BAUD, frame_bytes))
+    print("telemetry: %d frames received in %.1f s, %.0f frames/s, %.1f kB/s" %
+          (stream.frames, elapsed, stream.frames / elapsed, received / elapsed / 1000.0))
+    print("telemetry: %d CRC errors, %d missed, %d frames corrupted on the way" %
+          (stream.crc_errors, stream.missed, sent["corrupted"]))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Telemetry receiver for the Director measurement stream.")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("record", help="select and record the stream")
+    p.add_argument("port")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--baud", type=int, default=BAUD)
+    p.add_argument("--seconds", type=float)
+    p.add_argument("--decimation", type=int, default=1, help="frames per telemetry frame, 0 stops the stream")
+    p.add_argument("--workers", default="all", help="worker ids, e.g. 0,1")
+    p.add_argument("--words", default="all", help="payload words or signal names, e.g. 0-3 or v_dc,i_d")
+    p.add_argument("--listen", action="store_true", help="keep the selection of the Director")
+
+    p = sub.add_parser("dump", help="decode a recording to CSV")
+    p.add_argument("recording")
+
+    p = sub.add_parser("loopback", help="measure the receiver against a simulated Director")
+    p.add_argument("--seconds", type=float, default=5.0)
+    p.add_argument("--unthrottled", action="store_true", help="send as fast as possible instead of at the line rate")
+    p.add_argument("--corrupt", type=float, default=0.001, help="fraction of frames with a corrupted byte")
+
+    args = parser.parse_args()
+    if args.command == "dump":
+        return dump(args.recording)
+    if args.command == "loopback":
+        return loopback(args.seconds, args.unthrottled, args.corrupt)
+
+    selection = None
+    if not args.listen:
+        if args.workers == "all":
+            workers = (1 << (signals.NUM_WORKERS if signals else MAX_MASK_BITS)) - 1
+        else:
+            workers = sum(1 << int(w) for w in args.workers.split(","))
+        selection = (args.decimation, workers, parse_words(args.words))
+    record(args.port, args.output, args.baud, args.seconds, selection)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
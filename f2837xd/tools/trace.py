@@ -0,0 +1,277 @@
+"""
+Trace dump decoder and merger, see ring/Trace.h.
+
+Every core keeps its own trace ring. Save the `trace` symbol of each core from
+the debugger, TRACE_WORDS words, either as raw binary (16-bit little endian
+words) or in the CCS data format (.dat, one hex word per line), then:
+
+  trace.py merge -o run.trc director_cpu2.bin worker0_cpu1.dat worker0_cpu2.bin ...
+  trace.py show run.trc [--from-us T] [--to-us T] [--node W0] [--event RX_DONE]
+
+merge puts every record on the Director timeline and writes them sorted by
+time into one file of fixed size records, so show (or any other reader) can
+seek to a time with a binary search instead of reading the whole file.
+
+Times are recovered to 64 bits from the TIME_HIGH records and the header of
+each ring. Worker records are moved to cluster time with the TRACE_EV_CLOCK
+offsets logged by the worker, interpolated between records and extrapolated
+beyond them; cores of one node share the offsets. Cluster times are placed
+within 2^31 ticks of the last Director record, so dumps must be taken within a
+few seconds of each other.
+
+Merged file layout, little endian:
+  header  32 bytes: "RTRC", version u16, record size u16, record count u32,
+          ticks per microsecond u32, zero padding
+  record  24 bytes: cluster time u64, local time u64, node u8, core u8,
+          event u16, arg0 u16, arg1 u16
+Node is the worker id, or 255 for the Director.
+"""
+import argparse
+import bisect
+import mmap
+import os
+import re
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TRACE_H = os.path.join(HERE, "..", "ring", "Trace.h")
+
+# Must match Trace_t and TraceRecord_t in ring/Trace.h
+TRACE_MAGIC = 0x7ACE
+TRACE_HEADER_WORDS = 8
+TRACE_RECORD_WORDS = 6
+NODE_DIRECTOR = 0x00FF
+NODE_UNKNOWN = 0xFFFF
+
+FILE_MAGIC = b"RTRC"
+FILE_VERSION = 1
+FILE_HEADER = struct.Struct("<4sHHII16x")
+FILE_RECORD = struct.Struct("<QQBBHHH")
+
+DEFAULT_TICKS_PER_US = 200      # SYSCLK of the F2837xD
+
+
+class DumpError(Exception):
+    pass
+
+
+def event_names(path=TRACE_H):
+    names = {}
+    try:
+        with open(path) as f:
+            for m in re.finditer(r"#define\s+TRACE_EV_(\w+)\s+(0x[0-9A-Fa-f]+)U?", f.read()):
+                names[int(m.group(2), 16)] = m.group(1)
+    except OSError:
+        pass
+    return names
+
+
+_codes = {v: k for k, v in event_names().items()}
+TIME_HIGH = _codes.get("TIME_HIGH", 0x0001)
+CLOCK = _codes.get("CLOCK", 0x0002)
+
+
+def read_words(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    text = data.lstrip()
+    if text.startswith(b"1651"):
+        # CCS data format: header line, then one word per line
+        lines = text.decode("ascii", "replace").splitlines()[1:]
+        return [int(line.split()[0], 16) for line in lines if line.strip()]
+    if len(data) % 2:
+        raise DumpError("odd number of bytes")
+    return list(struct.unpack("<%dH" % (len(data) // 2), data))
+
+
+def decode_dump(path):
+    """Returns (node, core, records) with records as dicts, oldest first, time64 set."""
+    words = read_words(path)
+    if len(words) < TRACE_HEADER_WORDS or words[0] != TRACE_MAGIC:
+        raise DumpError("not a trace ring (magic %s)" % (hex(words[0]) if words else "missing"))
+    node, core, count, head = words[1], words[2], words[3], words[4]
+    high = words[6] | (words[7] << 16)
+    if count == 0 or count & (count - 1) or len(words) < TRACE_HEADER_WORDS + count * TRACE_RECORD_WORDS:
+        raise DumpError("truncated or bad record count %d" % count)
+
+    records = []
+    for slot in range(count):
+        w = words[TRACE_HEADER_WORDS + slot * TRACE_RECORD_WORDS:][:TRACE_RECORD_WORDS]
+        if w[0] == 0:
+            continue
+        seq = (w[0] - 1) & 0xFFFF
+        age = (head - 1 - seq) & 0xFFFF
+        # Half written records still carry the sequence number of the previous lap
+        if seq & (count - 1) != slot or age >= count:
+            continue
+        records.append({"age": age, "event": w[1], "low": w[2] | (w[3] << 16), "arg0": w[4], "arg1": w[5]})
+    records.sort(key=lambda r: -r["age"])
+
+    # Newest first: the header holds the high word of the newest record
+    newer_low = None
+    for r in reversed(records):
+        if r["event"] == TIME_HIGH:
+            r["time"] = r["low"] << 32
+            high = r["arg0"] | (r["arg1"] << 16)
+            newer_low = None
+            continue
+        if newer_low is not None and r["low"] > newer_low:
+            high -= 1       # Wrapped without a TIME_HIGH record in the dump
+        r["time"] = (high << 32) | r["low"]
+        newer_low = r["low"]
+    return node, core, records
+
+
+def signed32(x):
+    x &= 0xFFFFFFFF
+    return x - (1 << 32) if x & 0x80000000 else x
+
+
+def clock_offsets(records):
+    """Sorted (local time, cluster minus local) pairs of the TRACE_EV_CLOCK records."""
+    return sorted((r["time"], signed32(r["arg0"] | (r["arg1"] << 16))) for r in records if r["event"] == CLOCK)
+
+
+def offset_at(offsets, t):
+    """Offset at local time t, interpolated, or extrapolated from the first or last two records."""
+    if len(offsets) == 1:
+        return offsets[0][1]
+    i = bisect.bisect_left([o[0] for o in offsets], t)
+    i = min(max(i, 1), len(offsets) - 1)
+    (t0, o0), (t1, o1) = offsets[i - 1], offsets[i]
+    return o0 + (o1 - o0) * (t - t0) // (t1 - t0) if t1 != t0 else o1
+
+
+def merge(paths, output, ticks_per_us):
+    dumps = []
+    for path in paths:
+        try:
+            dumps.append(decode_dump(path))
+        except (DumpError, OSError, ValueError) as e:
+            print("trace: %s: %s" % (path, e), file=sys.stderr)
+            return 1
+
+    offsets = {}
+    for node, core, records in dumps:
+        if node != NODE_DIRECTOR:
+            offsets.setdefault(node, []).extend(clock_offsets(records))
+    director = [r["time"] for node, core, records in dumps if node == NODE_DIRECTOR for r in records]
+    reference = max(director) if director else None
+
+    merged = []
+    for node, core, records in dumps:
+        node_offsets = sorted(offsets.get(node, []))
+        if node != NODE_DIRECTOR and not node_offsets:
+            print("trace: node %s core %d has no clock records, kept on its local time" %
+                  ("unknown" if node == NODE_UNKNOWN else node, core), file=sys.stderr)
+        for r in records:
+            if r["event"] == TIME_HIGH:
+                continue
+            t = r["time"]
+            if node != NODE_DIRECTOR and node_offsets:
+                t += offset_at(node_offsets, t)
+                if reference is not None:
+                    t = reference + signed32(t - reference)
+            merged.append((t, r["time"], node & 0xFF, core, r["event"], r["arg0"], r["arg1"], -r["age"]))
+    merged.sort(key=lambda m: (m[0], m[2], m[3], m[7]))
+
+    with open(output, "wb") as f:
+        f.write(FILE_HEADER.pack(FILE_MAGIC, FILE_VERSION, FILE_RECORD.size, len(merged), ticks_per_us))
+        for m in merged:
+            f.write(FILE_RECORD.pack(*m[:7]))
+    print("trace: %d records from %d dumps written to %s" % (len(merged), len(dumps), output))
+    return 0
+
+
+class TraceFile:
+    """Random access to a merged trace."""
+
+    def __init__(self, path):
+        self.file = open(path, "rb")
+        self.map = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, size, self.count, self.ticks_per_us = FILE_HEADER.unpack_from(self.map, 0)
+        if magic != FILE_MAGIC or version != FILE_VERSION or size != FILE_RECORD.size:
+            raise DumpError("not a merged trace")
+        if len(self.map) < FILE_HEADER.size + self.count * size:
+            raise DumpError("truncated")
+
+    def __len__(self):
+        return self.count
+
+    def __getitem__(self, i):
+        return FILE_RECORD.unpack_from(self.map, FILE_HEADER.size + i * FILE_RECORD.size)
+
+    def time(self, i):
+        return struct.unpack_from("<Q", self.map, FILE_HEADER.size + i * FILE_RECORD.size)[0]
+
+    def seek(self, t):
+        """Index of the first record at or after cluster time t."""
+        lo, hi = 0, self.count
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self.time(mid) < t:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo
+
+
+def node_name(node):
+    return "D" if node == NODE_DIRECTOR else "W%d" % node
+
+
+def show(path, start_us, end_us, nodes, events):
+    try:
+        trace = TraceFile(path)
+    except (DumpError, OSError, ValueError) as e:
+        print("trace: %s: %s" % (path, e), file=sys.stderr)
+        return 1
+    if not len(trace):
+        return 0
+
+    names = event_names()
+    codes = {v: k for k, v in names.items()}
+    wanted = {codes.get(e.upper(), None) for e in events} if events else None
+    origin = trace.time(0)
+    tpu = trace.ticks_per_us
+
+    i = trace.seek(origin + int(start_us * tpu)) if start_us is not None else 0
+    end = origin + int(end_us * tpu) if end_us is not None else None
+    for i in range(i, len(trace)):
+        t, local, node, core, event, arg0, arg1 = trace[i]
+        if end is not None and t > end:
+            break
+        if nodes and node_name(node) not in nodes:
+            continue
+        if wanted is not None and event not in wanted:
+            continue
+        print("%14.3f us  %-3s cpu%d  %-10s 0x%04x 0x%04x" %
+              ((t - origin) / tpu, node_name(node), core, names.get(event, "0x%04x" % event), arg0, arg1))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode and merge trace ring dumps (ring/Trace.h).")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("merge", help="merge dumps into one time ordered trace")
+    p.add_argument("dumps", nargs="+")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--ticks-per-us", type=int, default=DEFAULT_TICKS_PER_US)
+
+    p = sub.add_parser("show", help="print a merged trace")
+    p.add_argument("trace")
+    p.add_argument("--from-us", type=float)
+    p.add_argument("--to-us", type=float)
+    p.add_argument("--node", action="append", default=[], help="D or W<id>, repeatable")
+    p.add_argument("--event", action="append", default=[], help="event name without TRACE_EV_, repeatable")
+
+    args = parser.parse_args()
+    if args.command == "merge":
+        return merge(args.dumps, args.output, args.ticks_per_us)
+    return show(args.trace, args.from_us, args.to_us, args.node, args.event)
+
+
+if __name__ == "__main__":
+    sys.exit(main())